@@ -148,10 +148,16 @@ void MAVLinkInspectorController::_refreshFrequency()
             continue;
         }
 
+        const Vehicle *const vehicle = MultiVehicleManager::instance()->getVehicleById(system->id());
+
         for (int i = 0; i < system->messages()->count(); i++) {
             QGCMAVLinkMessage *const msg = qobject_cast<QGCMAVLinkMessage*>(system->messages()->get(i));
             if (msg) {
                 msg->updateFreq();
+                if (vehicle) {
+                    const VehicleMessageDispatcher::HandlerStats stats = vehicle->messageDispatcher().handlerStats(msg->id());
+                    msg->updateHandlerTime(stats.messageCount, stats.handlerNsecs);
+                }
             }
         }
     }
@@ -190,6 +190,9 @@ AnalyzePage {
                         QGCLabel { text: qsTr("Actual Rate:") }
                         QGCLabel { text: curMessage ? curMessage.actualRateHz.toFixed(1) + qsTr("Hz") : "" }
 
+                        QGCLabel { text: qsTr("Handler Time:") }
+                        QGCLabel { text: curMessage ? curMessage.handlerTimeUsecs.toFixed(1) + qsTr("us") : "" }
+
                         QGCLabel { text: qsTr("Set Rate:") }
                         QGCComboBox {
                             id: msgRateCombo
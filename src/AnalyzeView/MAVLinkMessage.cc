@@ -88,6 +88,23 @@ void QGCMAVLinkMessage::updateFreq()
     }
 }
 
+void QGCMAVLinkMessage::updateHandlerTime(quint64 handledCount, qint64 handlerNsecs)
+{
+    const quint64 deltaCount = handledCount - _lastHandledCount;
+    const qint64 deltaNsecs = handlerNsecs - _lastHandlerNsecs;
+    _lastHandledCount = handledCount;
+    _lastHandlerNsecs = handlerNsecs;
+    if (deltaCount == 0) {
+        return;
+    }
+
+    const qreal lastHandlerTimeUsecs = _handlerTimeUsecs;
+    _handlerTimeUsecs = (static_cast<qreal>(deltaNsecs) / deltaCount) / 1000.0;
+    if (_handlerTimeUsecs != lastHandlerTimeUsecs) {
+        emit handlerTimeUsecsChanged();
+    }
+}
+
 void QGCMAVLinkMessage::setSelected(bool sel)
 {
     if (sel != _selected) {
@@ -32,6 +32,7 @@ class QGCMAVLinkMessage : public QObject
     Q_PROPERTY(qreal                actualRateHz    READ actualRateHz   NOTIFY actualRateHzChanged)
     Q_PROPERTY(int32_t              targetRateHz    READ targetRateHz   NOTIFY targetRateHzChanged)
     Q_PROPERTY(quint64              count           READ count          NOTIFY countChanged)
+    Q_PROPERTY(qreal                handlerTimeUsecs READ handlerTimeUsecs NOTIFY handlerTimeUsecsChanged)   ///< Average time the vehicle spends handling this message id
     Q_PROPERTY(QmlObjectListModel   *fields         READ fields         CONSTANT)
     Q_PROPERTY(bool                 fieldSelected   READ fieldSelected  NOTIFY fieldSelectedChanged)
     Q_PROPERTY(bool                 selected        READ selected       NOTIFY selectedChanged)
@@ -48,6 +49,7 @@ class QGCMAVLinkMessage : public QObject
     int32_t targetRateHz() const { return _targetRateHz; }
     quint64 count() const { return _count; }
     quint64 lastCount() const { return _lastCount; }
+    qreal handlerTimeUsecs() const { return _handlerTimeUsecs; }
     QmlObjectListModel *fields() const { return _fields; }
     bool fieldSelected() const { return _fieldSelected; }
     bool selected() const { return _selected; }
@@ -55,6 +57,8 @@ class QGCMAVLinkMessage : public QObject
     void updateFieldSelection();
     void update(const mavlink_message_t &message);
     void updateFreq();
+    /// Updates the average handler time from the cumulative handler statistics of the vehicle
+    void updateHandlerTime(quint64 handledCount, qint64 handlerNsecs);
     void setSelected(bool sel);
     void setTargetRateHz(int32_t rate);
 
@@ -62,6 +66,7 @@ class QGCMAVLinkMessage : public QObject
     void countChanged();
     void actualRateHzChanged();
     void targetRateHzChanged();
+    void handlerTimeUsecsChanged();
     void fieldSelectedChanged();
     void selectedChanged();
 
@@ -75,6 +80,9 @@ class QGCMAVLinkMessage : public QObject
     int32_t _targetRateHz = 0;
     uint64_t _count = 1;
     uint64_t _lastCount = 0;
+    qreal _handlerTimeUsecs = 0.0;
+    quint64 _lastHandledCount = 0;
+    qint64 _lastHandlerNsecs = 0;
     bool _fieldSelected = false;
     bool _selected = false;
 };
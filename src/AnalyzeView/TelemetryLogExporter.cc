@@ -0,0 +1,266 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogExporter.h"
+#include "QGCLoggingCategory.h"
+#include "TelemetryLogIndex.h"
+#include "VehicleDistanceSensorFactGroup.h"
+#include "VehicleEFIFactGroup.h"
+#include "VehicleEscStatusFactGroup.h"
+#include "VehicleEstimatorStatusFactGroup.h"
+#include "VehicleFactGroup.h"
+#include "VehicleGeneratorFactGroup.h"
+#include "VehicleGPS2FactGroup.h"
+#include "VehicleGPSFactGroup.h"
+#include "VehicleHygrometerFactGroup.h"
+#include "VehicleLocalPositionFactGroup.h"
+#include "VehicleLocalPositionSetpointFactGroup.h"
+#include "VehicleMessageDispatcher.h"
+#include "VehicleRPMFactGroup.h"
+#include "VehicleSetpointFactGroup.h"
+#include "VehicleTemperatureFactGroup.h"
+#include "VehicleVibrationFactGroup.h"
+#include "VehicleWindFactGroup.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include <memory>
+#include <vector>
+
+QGC_LOGGING_CATEGORY(TelemetryLogExporterLog, "qgc.analyzeview.telemetrylogexporter")
+
+namespace
+{
+
+/// CSV output of a single FactGroup
+struct CsvOutput
+{
+    QString name;
+    FactGroup *factGroup = nullptr;
+    QList<Fact*> facts;     ///< Column order
+    QFile file;
+    quint64 lastRowTimeUSecs = 0;
+};
+
+QByteArray _csvField(const QString &value)
+{
+    if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"'))) {
+        return value.toUtf8();
+    }
+
+    QString quoted = value;
+    (void) quoted.replace(QStringLiteral("\""), QStringLiteral("\"\""));
+    return ('"' + quoted.toUtf8() + '"');
+}
+
+/// @return false: Write failed
+bool _writeRow(CsvOutput &output, const QString &csvDir, quint64 timeUSecs, quint64 sampleIntervalUSecs)
+{
+    QByteArray row;
+    if (!output.file.isOpen()) {
+        output.file.setFileName(QDir(csvDir).filePath(output.name + QStringLiteral(".csv")));
+        if (!output.file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            return false;
+        }
+
+        row = "TimeUSecs";
+        for (const QString &factName : output.factGroup->factNames()) {
+            row += ',' + _csvField(factName);
+        }
+        row += '\n';
+    } else if ((timeUSecs - output.lastRowTimeUSecs) < sampleIntervalUSecs) {
+        return true;
+    }
+
+    output.lastRowTimeUSecs = timeUSecs;
+
+    row += QByteArray::number(timeUSecs);
+    for (const Fact *fact : std::as_const(output.facts)) {
+        row += ',' + _csvField(fact->rawValueString());
+    }
+    row += '\n';
+
+    return (output.file.write(row) == row.size());
+}
+
+} // namespace
+
+TelemetryLogExporter::TelemetryLogExporter(QObject *parent)
+    : QObject(parent)
+{
+    // qCDebug(TelemetryLogExporterLog) << Q_FUNC_INFO << this;
+
+    (void) connect(&_watcher, &QFutureWatcher<Result>::resultReadyAt, this, &TelemetryLogExporter::_resultReady);
+    (void) connect(&_watcher, &QFutureWatcher<Result>::finished, this, &TelemetryLogExporter::finished);
+}
+
+TelemetryLogExporter::~TelemetryLogExporter()
+{
+    cancel();
+    _watcher.waitForFinished();
+
+    // qCDebug(TelemetryLogExporterLog) << Q_FUNC_INFO << this;
+}
+
+void TelemetryLogExporter::exportLogs(const QStringList &logFilenames, const QString &outputDir)
+{
+    if (isRunning()) {
+        qCWarning(TelemetryLogExporterLog) << "Export already running";
+        return;
+    }
+
+    _canceled = false;
+
+    const quint64 sampleIntervalUSecs = _sampleIntervalUSecs;
+    const std::atomic_bool *const canceled = &_canceled;
+    _watcher.setFuture(QtConcurrent::mapped(logFilenames, [outputDir, sampleIntervalUSecs, canceled](const QString &logFilename) {
+        return exportLog(logFilename, outputDir, sampleIntervalUSecs, canceled);
+    }));
+}
+
+void TelemetryLogExporter::cancel()
+{
+    _canceled = true;
+    _watcher.cancel();
+}
+
+void TelemetryLogExporter::_resultReady(int index)
+{
+    const Result result = _watcher.resultAt(index);
+    if (result.errorString.isEmpty()) {
+        qCDebug(TelemetryLogExporterLog) << "Exported" << result.logFilename << result.messageCount << "messages," << result.csvFilenames.count() << "files";
+    } else {
+        qCWarning(TelemetryLogExporterLog) << "Export failed" << result.logFilename << result.errorString;
+    }
+
+    emit logExported(result.logFilename, result.errorString);
+}
+
+TelemetryLogExporter::Result TelemetryLogExporter::exportLog(const QString &logFilename, const QString &outputDir, quint64 sampleIntervalUSecs, const std::atomic_bool *canceled)
+{
+    Result result;
+    result.logFilename = logFilename;
+
+    QFile logFile(logFilename);
+    if (!logFile.open(QIODevice::ReadOnly)) {
+        result.errorString = tr("Unable to open log file: '%1', error: %2").arg(logFilename, logFile.errorString());
+        return result;
+    }
+
+    const QString csvDir = QDir(outputDir).filePath(QFileInfo(logFilename).completeBaseName());
+    if (!QDir().mkpath(csvDir)) {
+        result.errorString = tr("Unable to create directory: '%1'").arg(csvDir);
+        return result;
+    }
+
+    // The FactGroups live on this thread only, the parent deletes them
+    QObject factGroupParent;
+    std::vector<std::unique_ptr<CsvOutput>> outputs;
+    const auto addFactGroup = [&outputs](FactGroup *factGroup, const QString &name) {
+        auto output = std::make_unique<CsvOutput>();
+        output->name = name;
+        output->factGroup = factGroup;
+        for (const QString &factName : factGroup->factNames()) {
+            output->facts.append(factGroup->getFact(factName));
+        }
+        outputs.push_back(std::move(output));
+    };
+    // Same names as the Vehicle FactGroups
+    addFactGroup(new VehicleFactGroup(&factGroupParent),                    QStringLiteral("vehicle"));
+    addFactGroup(new VehicleGPSFactGroup(&factGroupParent),                 QStringLiteral("gps"));
+    addFactGroup(new VehicleGPS2FactGroup(&factGroupParent),                QStringLiteral("gps2"));
+    addFactGroup(new VehicleWindFactGroup(&factGroupParent),                QStringLiteral("wind"));
+    addFactGroup(new VehicleVibrationFactGroup(&factGroupParent),           QStringLiteral("vibration"));
+    addFactGroup(new VehicleTemperatureFactGroup(&factGroupParent),         QStringLiteral("temperature"));
+    addFactGroup(new VehicleSetpointFactGroup(&factGroupParent),            QStringLiteral("setpoint"));
+    addFactGroup(new VehicleDistanceSensorFactGroup(&factGroupParent),      QStringLiteral("distanceSensor"));
+    addFactGroup(new VehicleLocalPositionFactGroup(&factGroupParent),       QStringLiteral("localPosition"));
+    addFactGroup(new VehicleLocalPositionSetpointFactGroup(&factGroupParent), QStringLiteral("localPositionSetpoint"));
+    addFactGroup(new VehicleEscStatusFactGroup(&factGroupParent),           QStringLiteral("escStatus"));
+    addFactGroup(new VehicleEstimatorStatusFactGroup(&factGroupParent),     QStringLiteral("estimatorStatus"));
+    addFactGroup(new VehicleHygrometerFactGroup(&factGroupParent),          QStringLiteral("hygrometer"));
+    addFactGroup(new VehicleGeneratorFactGroup(&factGroupParent),           QStringLiteral("generator"));
+    addFactGroup(new VehicleEFIFactGroup(&factGroupParent),                 QStringLiteral("efi"));
+    addFactGroup(new VehicleRPMFactGroup(&factGroupParent),                 QStringLiteral("rpm"));
+
+    quint64 currentTimeUSecs = 0;
+    bool writeFailed = false;
+
+    VehicleMessageDispatcher dispatcher;
+    for (const std::unique_ptr<CsvOutput> &output : outputs) {
+        CsvOutput *const csvOutput = output.get();
+        const auto handler = [csvOutput, &csvDir, &currentTimeUSecs, sampleIntervalUSecs, &writeFailed](const mavlink_message_t &message) {
+            csvOutput->factGroup->handleMessage(nullptr, message);
+            if (!_writeRow(*csvOutput, csvDir, currentTimeUSecs, sampleIntervalUSecs)) {
+                writeFailed = true;
+            }
+        };
+
+        const QList<uint32_t> msgids = csvOutput->factGroup->handledMessageIds();
+        if (msgids.isEmpty()) {
+            dispatcher.addHandlerForAllMessages(handler);
+        } else {
+            dispatcher.addHandler(msgids, handler);
+        }
+    }
+
+    int vehicleId = -1;
+    uint8_t vehicleCompId = 0;
+    const bool scanned = TelemetryLogIndex::scan(&logFile, [&](qint64, qsizetype, quint64 timeUSecs, const mavlink_message_t &message) {
+        if (canceled && *canceled) {
+            return false;
+        }
+
+        // Same as the Vehicle, nothing is handled before the first heartbeat of the vehicle
+        if (vehicleId < 0) {
+            if ((message.msgid != MAVLINK_MSG_ID_HEARTBEAT) || (mavlink_msg_heartbeat_get_autopilot(&message) == MAV_AUTOPILOT_INVALID)) {
+                return true;
+            }
+            vehicleId = message.sysid;
+            vehicleCompId = message.compid;
+        }
+
+        if (message.sysid != vehicleId) {
+            return true;
+        }
+
+        // Without a Vehicle the VehicleFactGroup can not tell the attitude of the flight controller from other components
+        if (((message.msgid == MAVLINK_MSG_ID_ATTITUDE) || (message.msgid == MAVLINK_MSG_ID_ATTITUDE_QUATERNION)) && (message.compid != vehicleCompId)) {
+            return true;
+        }
+
+        currentTimeUSecs = timeUSecs;
+        result.messageCount++;
+        dispatcher.dispatch(message);
+
+        return !writeFailed;
+    });
+
+    for (const std::unique_ptr<CsvOutput> &output : outputs) {
+        if (output->file.isOpen()) {
+            output->file.close();
+            result.csvFilenames.append(output->file.fileName());
+        }
+    }
+
+    if (canceled && *canceled) {
+        result.errorString = tr("Export canceled");
+    } else if (writeFailed) {
+        result.errorString = tr("Unable to write to directory: '%1'").arg(csvDir);
+    } else if (!scanned) {
+        result.errorString = tr("Unable to read log file: '%1', error: %2").arg(logFilename, logFile.errorString());
+    } else if (vehicleId < 0) {
+        result.errorString = tr("The log file '%1' does not contain a vehicle.").arg(logFilename);
+    }
+
+    return result;
+}
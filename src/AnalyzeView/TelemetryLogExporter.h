@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <atomic>
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryLogExporterLog)
+
+/// Headless batch replay of telemetry logs (tlog) for post-flight analysis.
+/// A log is read as fast as possible, without links, timers or UI, and its messages are handed to the vehicle telemetry
+/// FactGroups through the same per message id dispatch the Vehicle uses. Every time a FactGroup handles a message, a
+/// row with the log time and the raw values of all its Facts is appended to a CSV file for that FactGroup:
+///     <outputDir>/<log base name>/<FactGroup name>.csv
+/// Only the first vehicle (autopilot heartbeat) found in a log is exported. Batteries are not exported since their
+/// FactGroups are created by the Vehicle.
+/// Multiple logs are exported in parallel on the global thread pool, each log is handled by a single thread.
+class TelemetryLogExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result
+    {
+        QString logFilename;
+        QString errorString;        ///< Empty: Export succeeded
+        quint64 messageCount = 0;   ///< Messages of the exported vehicle
+        QStringList csvFilenames;
+    };
+
+    explicit TelemetryLogExporter(QObject *parent = nullptr);
+    ~TelemetryLogExporter();
+
+    /// Minimum log time between two rows of a FactGroup, 0: one row per handled message
+    void setSampleIntervalUSecs(quint64 sampleIntervalUSecs) { _sampleIntervalUSecs = sampleIntervalUSecs; }
+
+    /// Starts exporting the logs in parallel. logExported is signalled for each log, finished once all are done.
+    void exportLogs(const QStringList &logFilenames, const QString &outputDir);
+    void cancel();
+    bool isRunning() const { return _watcher.isRunning(); }
+
+    /// Exports a single log on the calling thread. Thread safe.
+    ///     @param canceled Checked while replaying, nullptr: Can not be canceled
+    static Result exportLog(const QString &logFilename, const QString &outputDir, quint64 sampleIntervalUSecs = 0, const std::atomic_bool *canceled = nullptr);
+
+signals:
+    void logExported(const QString &logFilename, const QString &errorString);
+    void finished();
+
+private slots:
+    void _resultReady(int index);
+
+private:
+    QFutureWatcher<Result> _watcher;
+    quint64 _sampleIntervalUSecs = 0;
+    std::atomic_bool _canceled = false;
+};
@@ -38,6 +38,7 @@ LinkConfiguration::LinkConfiguration(const LinkConfiguration *copy, QObject *par
     , _dynamic(copy->isDynamic())
     , _autoConnect(copy->isAutoConnect())
     , _highLatency(copy->isHighLatency())
+    , _outboundByteRate(copy->outboundByteRate())
 {
     // qCDebug(AudioOutputLog) << Q_FUNC_INFO << this;
 
@@ -58,6 +59,7 @@ void LinkConfiguration::copyFrom(const LinkConfiguration *source)
     setDynamic(source->isDynamic());
     setAutoConnect(source->isAutoConnect());
     setHighLatency(source->isHighLatency());
+    setOutboundByteRate(source->outboundByteRate());
 }
 
 LinkConfiguration *LinkConfiguration::createSettings(int type, const QString &name)
@@ -185,3 +187,12 @@ void LinkConfiguration::setHighLatency(bool hl)
         emit highLatencyChanged();
     }
 }
+
+void LinkConfiguration::setOutboundByteRate(int bytesPerSecond)
+{
+    bytesPerSecond = qMax(0, bytesPerSecond);
+    if (bytesPerSecond != _outboundByteRate) {
+        _outboundByteRate = bytesPerSecond;
+        emit outboundByteRateChanged();
+    }
+}
@@ -28,6 +28,7 @@ class LinkConfiguration : public QObject
     Q_PROPERTY(QString          settingsURL     READ settingsURL                            CONSTANT)
     Q_PROPERTY(QString          settingsTitle   READ settingsTitle                          CONSTANT)
     Q_PROPERTY(bool             highLatency     READ isHighLatency  WRITE setHighLatency    NOTIFY highLatencyChanged)
+    Q_PROPERTY(int              outboundByteRate READ outboundByteRate WRITE setOutboundByteRate NOTIFY outboundByteRateChanged)
 
 public:
     LinkConfiguration(const QString &name, QObject *parent = nullptr);
@@ -66,6 +67,11 @@ class LinkConfiguration : public QObject
     /// Set if this is this an High Latency configuration.
     void setHighLatency(bool hl = false);
 
+    /// Bytes per second outbound traffic is paced to, 0: unlimited (or the baud rate of a serial link whose radio
+    /// reports RADIO_STATUS)
+    int outboundByteRate() const { return _outboundByteRate; }
+    void setOutboundByteRate(int bytesPerSecond);
+
     /// Copy instance data, When manipulating data, you create a copy of the configuration using the copy constructor,
     /// edit it and then transfer its content to the original using this method.
     ///     @param[in] source The source instance (the edited copy)
@@ -131,6 +137,7 @@ class LinkConfiguration : public QObject
     void dynamicChanged();
     void autoConnectChanged();
     void highLatencyChanged();
+    void outboundByteRateChanged();
 
 protected:
     std::weak_ptr<LinkInterface> _link; ///< Link currently using this configuration (if any)
@@ -141,6 +148,7 @@ class LinkConfiguration : public QObject
     bool _forwarding = false;  ///< Automatically added Mavlink forwarding connection
     bool _autoConnect = false; ///< This connection is started automatically at boot
     bool _highLatency = false;
+    int _outboundByteRate = 0;
 };
 
 typedef std::shared_ptr<LinkConfiguration> SharedLinkConfigurationPtr;
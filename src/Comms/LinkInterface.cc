@@ -15,15 +15,39 @@
 #include "SettingsManager.h"
 #include "MavlinkSettings.h"
 
+#include <QtCore/QThread>
 #include <QtQml/QQmlEngine>
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(LinkInterfaceLog, "qgc.comms.linkinterface")
 
+namespace
+{
+
+constexpr qsizetype kMaxOutboundBatchBytes = 4096;
+constexpr int kOutboundStatisticsIntervalMSecs = 10000;
+
+} // namespace
+
 LinkInterface::LinkInterface(SharedLinkConfigurationPtr &config, QObject *parent)
     : QObject(parent)
     , _config(config)
+    , _outboundScheduler(&_outboundQueue)
 {
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+
+    _outboundBudgetTimer.setSingleShot(true);
+    (void) connect(&_outboundBudgetTimer, &QTimer::timeout, this, &LinkInterface::_drainOutboundQueue);
+
+    _outboundStatisticsTimer.setInterval(kOutboundStatisticsIntervalMSecs);
+    (void) connect(&_outboundStatisticsTimer, &QTimer::timeout, this, &LinkInterface::_logOutboundStatistics);
+    _outboundStatisticsTimer.start();
+
+    _outboundScheduler.setConfiguredByteRate(_config->outboundByteRate());
+    (void) connect(_config.get(), &LinkConfiguration::outboundByteRateChanged, this, [this]() {
+        _outboundScheduler.setConfiguredByteRate(_config->outboundByteRate());
+    });
 }
 
 LinkInterface::~LinkInterface()
@@ -105,10 +129,93 @@ void LinkInterface::_freeMavlinkChannel()
     _mavlinkChannel = LinkManager::invalidMavlinkChannel();
 }
 
-void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
+void LinkInterface::writeBytesThreadSafe(const char *bytes, int length, LinkOutboundQueue::Priority priority)
+{
+    if ((QThread::currentThread() == thread()) && (_outboundScheduler.byteRate() == 0) && _outboundQueue.isEmpty()) {
+        // Nothing is waiting in front of these bytes and there is no budget to pace them
+        _writeBytes(QByteArray(bytes, length));
+        return;
+    }
+
+    if (!_outboundQueue.push(priority, bytes, length)) {
+        // Writing it around the queue would skip the byte budget and overtake the frames queued ahead of it. A full
+        // ring is counted by the queue and reported by _logOutboundStatistics.
+        if ((length <= 0) || (length > LinkOutboundQueue::kMaxFrameLength)) {
+            qCWarning(LinkInterfaceLog) << "dropping outbound bytes which are not a single MAVLink frame, length" << length;
+        }
+        return;
+    }
+
+    // Only the push which finds no drain pending posts one, everything else rides along with it
+    if (!_outboundDrainScheduled.exchange(true, std::memory_order_acq_rel)) {
+        (void) QMetaObject::invokeMethod(this, &LinkInterface::_drainOutboundQueue, Qt::QueuedConnection);
+    }
+}
+
+void LinkInterface::_drainOutboundQueue()
+{
+    // Cleared before popping: a frame pushed from now on is either popped below or posts the next drain
+    (void) _outboundDrainScheduled.exchange(false, std::memory_order_acq_rel);
+
+    const qint64 nowNSecs = LinkOutboundQueue::nowNSecs();
+    const bool batchFrames = _batchOutboundFrames();
+    QByteArray frame;
+    QByteArray batch;
+    while (_outboundScheduler.next(nowNSecs, frame)) {
+        if (!batchFrames) {
+            _writeBytes(frame);
+            continue;
+        }
+
+        batch.append(frame);
+        if (batch.size() >= kMaxOutboundBatchBytes) {
+            _writeBytes(batch);
+            batch.clear();
+        }
+    }
+
+    if (!batch.isEmpty()) {
+        _writeBytes(batch);
+    }
+
+    // Whatever is left waits for the byte budget to refill
+    const int waitMSecs = _outboundScheduler.waitMSecs();
+    if (waitMSecs >= 0) {
+        _outboundBudgetTimer.start(std::max(1, waitMSecs));
+    }
+}
+
+void LinkInterface::_logOutboundStatistics()
+{
+    const QString linkName = _config ? _config->name() : QString();
+
+    const quint64 overflowCount = outboundQueueOverflowCount();
+    if (overflowCount != _reportedOverflowCount) {
+        qCWarning(LinkInterfaceLog) << linkName << "dropped" << (overflowCount - _reportedOverflowCount) << "outbound frames, queue full";
+        _reportedOverflowCount = overflowCount;
+    }
+
+    if (!LinkOutboundSchedulerLog().isDebugEnabled()) {
+        return;
+    }
+
+    qCDebug(LinkOutboundSchedulerLog) << linkName << "byte rate" << outboundByteRate() << "overflows" << overflowCount;
+    for (int priority = 0; priority < LinkOutboundQueue::PriorityCount; priority++) {
+        const LinkOutboundScheduler::ClassStatistics statistics = outboundStatistics(static_cast<LinkOutboundQueue::Priority>(priority));
+        if ((statistics.sentFrames == 0) && (statistics.queuedFrames == 0)) {
+            continue;
+        }
+
+        qCDebug(LinkOutboundSchedulerLog) << linkName << "class" << priority
+                                          << "queued" << statistics.queuedFrames << "frames" << statistics.queuedBytes << "bytes"
+                                          << "sent" << statistics.sentFrames << "frames" << statistics.sentBytes << "bytes"
+                                          << "latency avg" << statistics.averageLatencyMSecs << "max" << statistics.maxLatencyMSecs << "ms";
+    }
+}
+
+void LinkInterface::radioStatusReceived(uint8_t txBufferPercent)
 {
-    const QByteArray data(bytes, length);
-    (void) QMetaObject::invokeMethod(this, "_writeBytes", Qt::AutoConnection, data);
+    _outboundScheduler.radioStatusReceived(txBufferPercent, _radioByteRate());
 }
 
 void LinkInterface::removeVehicleReference()
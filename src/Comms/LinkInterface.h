@@ -9,14 +9,28 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
+
+#include <atomic>
 
 #include "LinkConfiguration.h"
+#include "LinkOutboundQueue.h"
+#include "LinkOutboundScheduler.h"
 
 class LinkManager;
 
 Q_DECLARE_LOGGING_CATEGORY(LinkInterfaceLog)
 
+/// Data received from one remote endpoint of a link which talks to several endpoints (UDP)
+struct LinkEndpointBytes
+{
+    quint32 endpointId = 0;     ///< Stable while the link is connected, never 0
+    QByteArray data;
+};
+
 /// The link interface defines the interface for all links used to communicate with the ground station application.
 class LinkInterface : public QObject
 {
@@ -39,7 +53,19 @@ class LinkInterface : public QObject
     bool mavlinkChannelIsSet() const;
     bool decodedFirstMavlinkPacket() const { return _decodedFirstMavlinkPacket; }
     void setDecodedFirstMavlinkPacket(bool decodedFirstMavlinkPacket) { _decodedFirstMavlinkPacket = decodedFirstMavlinkPacket; }
-    void writeBytesThreadSafe(const char *bytes, int length);
+    /// Queues a MAVLink frame for writing in the thread of the link. Frames of a higher priority class overtake queued
+    /// frames of lower classes, frames of the same class keep their order. A frame which finds the ring of its class
+    /// full is dropped and counted in outboundQueueOverflowCount().
+    void writeBytesThreadSafe(const char *bytes, int length, LinkOutboundQueue::Priority priority = LinkOutboundQueue::PriorityNormal);
+    quint64 outboundQueueOverflowCount() const { return _outboundQueue.overflowCount(); }
+
+    /// The outbound budget accessors below must be called from the thread of the link
+    void radioStatusReceived(uint8_t txBufferPercent);
+    int outboundByteRate() const { return _outboundScheduler.byteRate(); }  ///< 0: unlimited
+    int outboundDelayMSecs(LinkOutboundQueue::Priority priority) const { return _outboundScheduler.estimatedDelayMSecs(priority); }
+    int outboundBulkFrameAllowance(int frameLength, int maxFrames) const { return _outboundScheduler.bulkFrameAllowance(frameLength, maxFrames); }
+    LinkOutboundScheduler::ClassStatistics outboundStatistics(LinkOutboundQueue::Priority priority) const { return _outboundScheduler.statistics(priority); }
+
     void addVehicleReference() { ++_vehicleReferenceCount; }
     void removeVehicleReference();
     bool initMavlinkSigning();
@@ -47,6 +73,9 @@ class LinkInterface : public QObject
 
 signals:
     void bytesReceived(LinkInterface *link, const QByteArray &data);
+    /// Emitted instead of bytesReceived by links with several remote endpoints. The data of each endpoint is parsed
+    /// separately, so senders sharing the link never interleave inside one MAVLink state machine.
+    void endpointBytesReceived(LinkInterface *link, const QList<LinkEndpointBytes> &endpointBytes);
     void bytesSent(LinkInterface *link, const QByteArray &data);
     void connected();
     void disconnected();
@@ -62,6 +91,13 @@ class LinkInterface : public QObject
 
     virtual void _freeMavlinkChannel();
 
+    /// Frames drained together are written as one buffer. Datagram links return false so each frame keeps its own datagram.
+    virtual bool _batchOutboundFrames() const { return true; }
+
+    /// Byte rate of a telemetry radio which reports RADIO_STATUS on this link, used if the user did not configure one.
+    /// 0: unknown, RADIO_STATUS only scales a configured rate. Only serial links know the rate of their radio.
+    virtual int _radioByteRate() const { return 0; }
+
     void _connectionRemoved();
 
     SharedLinkConfigurationPtr _config;
@@ -70,6 +106,10 @@ private slots:
     /// Not thread safe if called directly, only writeBytesThreadSafe is thread safe
     virtual void _writeBytes(const QByteArray &bytes) = 0;
 
+    void _drainOutboundQueue();
+    /// Outbound statistics go to LinkOutboundSchedulerLog, dropped frames are always reported
+    void _logOutboundStatistics();
+
 private:
     /// connect is private since all links should be created through LinkManager::createConnectedLink calls
     virtual bool _connect() = 0;
@@ -78,6 +118,13 @@ private slots:
     bool _decodedFirstMavlinkPacket = false;
     int _vehicleReferenceCount = 0;
     bool _signingSignatureFailure = false;
+
+    LinkOutboundQueue _outboundQueue;
+    LinkOutboundScheduler _outboundScheduler;
+    std::atomic<bool> _outboundDrainScheduled = false;
+    QTimer _outboundBudgetTimer;
+    QTimer _outboundStatisticsTimer;
+    quint64 _reportedOverflowCount = 0;
 };
 
 typedef std::shared_ptr<LinkInterface> SharedLinkInterfacePtr;
@@ -50,6 +50,7 @@
 #endif
 
 #include <QtCore/qapplicationstatic.h>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QTimer>
 #include <QtQml/qqml.h>
 
@@ -168,12 +169,13 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
         return false;
     }
 
+    _linksMutex.lock();
     _rgLinks.append(link);
+    _linksMutex.unlock();
     config->setLink(link);
 
     (void) connect(link.get(), &LinkInterface::communicationError, this, &LinkManager::_communicationError);
-    (void) connect(link.get(), &LinkInterface::bytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveBytes);
-    (void) connect(link.get(), &LinkInterface::bytesSent, MAVLinkProtocol::instance(), &MAVLinkProtocol::logSentBytes);
+    MAVLinkProtocol::instance()->connectLink(link);
     (void) connect(link.get(), &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
     MAVLinkProtocol::instance()->resetMetadataForLink(link.get());
@@ -181,7 +183,9 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
 
     if (!link->_connect()) {
         link->_freeMavlinkChannel();
+        _linksMutex.lock();
         _rgLinks.removeAt(_rgLinks.indexOf(link));
+        _linksMutex.unlock();
         config->setLink(nullptr);
         return false;
     }
@@ -196,6 +200,7 @@ void LinkManager::_communicationError(const QString &title, const QString &error
 
 SharedLinkInterfacePtr LinkManager::mavlinkForwardingLink()
 {
+    QMutexLocker locker(&_linksMutex);
     for (SharedLinkInterfacePtr &link : _rgLinks) {
         const SharedLinkConfigurationPtr linkConfig = link->linkConfiguration();
         if ((linkConfig->type() == LinkConfiguration::TypeUdp) && (linkConfig->name() == _mavlinkForwardingLinkName)) {
@@ -208,6 +213,7 @@ SharedLinkInterfacePtr LinkManager::mavlinkForwardingLink()
 
 SharedLinkInterfacePtr LinkManager::mavlinkForwardingSupportLink()
 {
+    QMutexLocker locker(&_linksMutex);
     for (SharedLinkInterfacePtr &link : _rgLinks) {
         const SharedLinkConfigurationPtr linkConfig = link->linkConfiguration();
         if ((linkConfig->type() == LinkConfiguration::TypeUdp) && (linkConfig->name() == _mavlinkForwardingSupportLinkName)) {
@@ -235,8 +241,7 @@ void LinkManager::_linkDisconnected()
     }
 
     (void) disconnect(link, &LinkInterface::communicationError, qgcApp(), &QGCApplication::showAppMessage);
-    (void) disconnect(link, &LinkInterface::bytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveBytes);
-    (void) disconnect(link, &LinkInterface::bytesSent, MAVLinkProtocol::instance(), &MAVLinkProtocol::logSentBytes);
+    MAVLinkProtocol::instance()->disconnectLink(link);
     (void) disconnect(link, &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
     link->_freeMavlinkChannel();
@@ -244,6 +249,7 @@ void LinkManager::_linkDisconnected()
     for (auto it = _rgLinks.begin(); it != _rgLinks.end(); ++it) {
         if (it->get() == link) {
             qCDebug(LinkManagerLog) << Q_FUNC_INFO << it->get()->linkConfiguration()->name() << it->use_count();
+            QMutexLocker locker(&_linksMutex);
             (void) _rgLinks.erase(it);
             return;
         }
@@ -294,6 +300,7 @@ void LinkManager::saveLinkConfigurationList()
         settings.setValue(root + "/type", linkConfig->type());
         settings.setValue(root + "/auto", linkConfig->isAutoConnect());
         settings.setValue(root + "/high_latency", linkConfig->isHighLatency());
+        settings.setValue(root + "/outbound_byte_rate", linkConfig->outboundByteRate());
         linkConfig->saveSettings(settings, root);
     }
 
@@ -373,6 +380,7 @@ void LinkManager::loadLinkConfigurationList()
                 link->setAutoConnect(autoConnect);
                 const bool highLatency = settings.value(root + "/high_latency").toBool();
                 link->setHighLatency(highLatency);
+                link->setOutboundByteRate(settings.value(root + "/outbound_byte_rate", 0).toInt());
                 link->loadSettings(settings, root);
                 addConfiguration(link);
             }
@@ -701,14 +709,14 @@ void LinkManager::startAutoConnectedLinks()
 uint8_t LinkManager::allocateMavlinkChannel()
 {
     for (uint8_t mavlinkChannel = 0; mavlinkChannel < MAVLINK_COMM_NUM_BUFFERS; mavlinkChannel++) {
-        if (_mavlinkChannelsUsedBitMask & (1 << mavlinkChannel)) {
+        if (_mavlinkChannelsUsed.test(mavlinkChannel)) {
             continue;
         }
 
         mavlink_reset_channel_status(mavlinkChannel);
         mavlink_status_t* const mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
         mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-        _mavlinkChannelsUsedBitMask |= (1 << mavlinkChannel);
+        (void) _mavlinkChannelsUsed.set(mavlinkChannel);
         qCDebug(LinkManagerLog) << "allocateMavlinkChannel" << mavlinkChannel;
         return mavlinkChannel;
     }
@@ -725,7 +733,7 @@ void LinkManager::freeMavlinkChannel(uint8_t channel)
         return;
     }
 
-    _mavlinkChannelsUsedBitMask &= ~(1 << channel);
+    (void) _mavlinkChannelsUsed.reset(channel);
 }
 
 LogReplayLink *LinkManager::startLogReplay(const QString &logFile)
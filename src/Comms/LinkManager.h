@@ -11,12 +11,16 @@
 
 #include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 #include <QtCore/QStringList>
 
+#include <atomic>
+#include <bitset>
 #include <limits>
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "MAVLinkLib.h"
 #ifndef QGC_NO_SERIAL_LINK
     #include "QGCSerialPortInfo.h"
 #endif
@@ -86,10 +90,10 @@ class LinkManager : public QObject
     /// Creates, connects (and adds) a link  based on the given configuration instance.
     bool createConnectedLink(SharedLinkConfigurationPtr &config);
 
-    /// Returns pointer to the mavlink forwarding link, or nullptr if it does not exist
+    /// Returns pointer to the mavlink forwarding link, or nullptr if it does not exist. Thread safe.
     SharedLinkInterfacePtr mavlinkForwardingLink();
 
-    /// Returns pointer to the mavlink support forwarding link, or nullptr if it does not exist
+    /// Returns pointer to the mavlink support forwarding link, or nullptr if it does not exist. Thread safe.
     SharedLinkInterfacePtr mavlinkForwardingSupportLink();
 
     /// Re-initilize the mavlink signing for all links. Used when the signing key changes.
@@ -146,10 +150,11 @@ private slots:
     bool _configUpdateSuspended = false;            ///< true: stop updating configuration list
     bool _configurationsLoaded = false;             ///< true: Link configurations have been loaded
     bool _connectionsSuspended = false;             ///< true: all new connections should not be allowed
-    bool _mavlinkSupportForwardingEnabled = false;
-    uint32_t _mavlinkChannelsUsedBitMask = 1;
+    std::atomic_bool _mavlinkSupportForwardingEnabled = false;
+    std::bitset<MAVLINK_COMM_NUM_BUFFERS> _mavlinkChannelsUsed = 1; ///< Channel 0 is reserved
     QString _connectionsSuspendedReason;            ///< User visible reason for suspension
 
+    QMutex _linksMutex;                             ///< Protects _rgLinks modifications against reads from link threads
     QList<SharedLinkInterfacePtr> _rgLinks;
     QList<SharedLinkConfigurationPtr> _rgLinkConfigs;
 
@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkOutboundQueue.h"
+#include "QGCLoggingCategory.h"
+
+#include <chrono>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(LinkOutboundQueueLog, "qgc.comms.linkoutboundqueue")
+
+namespace
+{
+
+// Ring sizes must be powers of two. Bulk transfers are request/response driven and never have many frames in flight.
+constexpr std::array<int, LinkOutboundQueue::PriorityCount> kCapacity = { 64, 64, 128, 256, 128 };
+
+} // namespace
+
+LinkOutboundQueue::Ring::Ring(int capacity)
+    : _mask(static_cast<size_t>(capacity) - 1)
+    , _slots(std::make_unique<Slot[]>(capacity))
+{
+    Q_ASSERT((capacity & (capacity - 1)) == 0);
+
+    for (size_t i = 0; i <= _mask; i++) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LinkOutboundQueue::Ring::push(const char *bytes, int length)
+{
+    size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot &slot = _slots[position & _mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                (void) memcpy(slot.data, bytes, length);
+                slot.length = length;
+                slot.enqueuedNSecs = LinkOutboundQueue::nowNSecs();
+                (void) _queuedBytes.fetch_add(length, std::memory_order_relaxed);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // The consumer has not released this slot yet
+            return false;
+        } else {
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool LinkOutboundQueue::Ring::pop(QByteArray &frame, qint64 &enqueuedNSecs)
+{
+    const size_t position = _dequeuePosition.load(std::memory_order_relaxed);
+    Slot &slot = _slots[position & _mask];
+    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != (position + 1)) {
+        return false;
+    }
+
+    frame = QByteArray(slot.data, slot.length);
+    enqueuedNSecs = slot.enqueuedNSecs;
+    (void) _queuedBytes.fetch_sub(slot.length, std::memory_order_relaxed);
+    slot.sequence.store(position + _mask + 1, std::memory_order_release);
+    _dequeuePosition.store(position + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+bool LinkOutboundQueue::Ring::peekLength(int &length) const
+{
+    const size_t position = _dequeuePosition.load(std::memory_order_relaxed);
+    const Slot &slot = _slots[position & _mask];
+    if (slot.sequence.load(std::memory_order_acquire) != (position + 1)) {
+        return false;
+    }
+
+    length = slot.length;
+    return true;
+}
+
+bool LinkOutboundQueue::Ring::isEmpty() const
+{
+    const size_t position = _dequeuePosition.load(std::memory_order_relaxed);
+    const Slot &slot = _slots[position & _mask];
+    return (slot.sequence.load(std::memory_order_acquire) != (position + 1));
+}
+
+qsizetype LinkOutboundQueue::Ring::queuedFrames() const
+{
+    // Claimed slots which are still being written count as queued
+    const size_t dequeuePosition = _dequeuePosition.load(std::memory_order_relaxed);
+    const size_t enqueuePosition = _enqueuePosition.load(std::memory_order_relaxed);
+    return (enqueuePosition > dequeuePosition) ? static_cast<qsizetype>(enqueuePosition - dequeuePosition) : 0;
+}
+
+/*===========================================================================*/
+
+LinkOutboundQueue::LinkOutboundQueue()
+{
+    for (int priority = 0; priority < PriorityCount; priority++) {
+        _rings[priority] = std::make_unique<Ring>(kCapacity[priority]);
+    }
+}
+
+bool LinkOutboundQueue::push(Priority priority, const char *bytes, int length)
+{
+    if ((length <= 0) || (length > kMaxFrameLength)) {
+        return false;
+    }
+
+    if (!_rings[priority]->push(bytes, length)) {
+        const quint64 overflowCount = _overflowCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        qCDebug(LinkOutboundQueueLog) << "ring full, priority" << priority << "overflows" << overflowCount;
+        return false;
+    }
+
+    return true;
+}
+
+bool LinkOutboundQueue::pop(QByteArray &frame)
+{
+    qint64 enqueuedNSecs = 0;
+    for (const std::unique_ptr<Ring> &ring : _rings) {
+        if (ring->pop(frame, enqueuedNSecs)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool LinkOutboundQueue::pop(Priority priority, QByteArray &frame, qint64 &enqueuedNSecs)
+{
+    return _rings[priority]->pop(frame, enqueuedNSecs);
+}
+
+bool LinkOutboundQueue::peekLength(Priority priority, int &length) const
+{
+    return _rings[priority]->peekLength(length);
+}
+
+bool LinkOutboundQueue::isEmpty() const
+{
+    for (const std::unique_ptr<Ring> &ring : _rings) {
+        if (!ring->isEmpty()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int LinkOutboundQueue::capacity(Priority priority)
+{
+    return kCapacity[priority];
+}
+
+qint64 LinkOutboundQueue::nowNSecs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+LinkOutboundQueue::Priority LinkOutboundQueue::priorityForMessage(uint32_t msgid)
+{
+    switch (msgid) {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
+    case MAVLINK_MSG_ID_SET_ATTITUDE_TARGET:
+        return PriorityHigh;
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+    case MAVLINK_MSG_ID_COMMAND_INT:
+    case MAVLINK_MSG_ID_COMMAND_CANCEL:
+    case MAVLINK_MSG_ID_SET_MODE:
+        return PriorityCommand;
+    case MAVLINK_MSG_ID_GPS_RTCM_DATA:
+        return PriorityRtk;
+    case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+    case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+    case MAVLINK_MSG_ID_PARAM_SET:
+    case MAVLINK_MSG_ID_PARAM_EXT_REQUEST_LIST:
+    case MAVLINK_MSG_ID_PARAM_EXT_REQUEST_READ:
+    case MAVLINK_MSG_ID_PARAM_EXT_SET:
+    case MAVLINK_MSG_ID_MISSION_COUNT:
+    case MAVLINK_MSG_ID_MISSION_ITEM:
+    case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+    case MAVLINK_MSG_ID_MISSION_REQUEST:
+    case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+    case MAVLINK_MSG_ID_MISSION_ACK:
+    case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+    case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+    case MAVLINK_MSG_ID_LOG_REQUEST_LIST:
+    case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+    case MAVLINK_MSG_ID_LOG_REQUEST_END:
+    case MAVLINK_MSG_ID_LOG_ERASE:
+        return PriorityBulk;
+    default:
+        return PriorityNormal;
+    }
+}
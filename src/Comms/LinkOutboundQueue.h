@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLoggingCategory>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(LinkOutboundQueueLog)
+
+/// Serialized MAVLink frames waiting to be written by a link. Any thread can push without taking a lock, the link
+/// pops them in its own thread. Each priority class has its own bounded ring, so a burst of bulk traffic never
+/// delays MANUAL_CONTROL or heartbeats.
+class LinkOutboundQueue
+{
+public:
+    /// Traffic classes in decreasing priority
+    enum Priority {
+        PriorityHigh,       ///< Pilot input, heartbeats and setpoints
+        PriorityCommand,    ///< Commands and mode changes
+        PriorityRtk,        ///< RTCM correction data
+        PriorityNormal,
+        PriorityBulk,       ///< Parameter, mission, FTP and log transfers
+        PriorityCount
+    };
+
+    static constexpr int kMaxFrameLength = MAVLINK_MAX_PACKET_LEN;
+
+    LinkOutboundQueue();
+
+    /// Thread safe, never blocks
+    ///     @return false: frame is longer than kMaxFrameLength or the ring of the priority class is full
+    bool push(Priority priority, const char *bytes, int length);
+
+    /// Consumer thread only. Takes the oldest frame of the highest priority class which has one.
+    ///     @return false: queue is empty
+    bool pop(QByteArray &frame);
+
+    /// Consumer thread only. Takes the oldest frame of a class.
+    ///     @param enqueuedNSecs Set to the nowNSecs() value at push time
+    ///     @return false: class is empty
+    bool pop(Priority priority, QByteArray &frame, qint64 &enqueuedNSecs);
+
+    /// Consumer thread only. Length of the oldest frame of a class.
+    ///     @return false: class is empty
+    bool peekLength(Priority priority, int &length) const;
+
+    /// Consumer thread only
+    bool isEmpty() const;
+    bool isEmpty(Priority priority) const { return _rings[priority]->isEmpty(); }
+
+    /// Frames and bytes waiting in a class. Exact in the consumer thread, a snapshot anywhere else.
+    qsizetype queuedFrames(Priority priority) const { return _rings[priority]->queuedFrames(); }
+    qint64 queuedBytes(Priority priority) const { return _rings[priority]->queuedBytes(); }
+
+    /// Number of frames push rejected because their ring was full
+    quint64 overflowCount() const { return _overflowCount.load(std::memory_order_relaxed); }
+
+    static int capacity(Priority priority);
+    static Priority priorityForMessage(uint32_t msgid);
+
+    /// Monotonic clock used for the enqueue time stamps
+    static qint64 nowNSecs();
+
+private:
+    /// Bounded multi producer, single consumer ring of fixed size frame slots. Producers claim a slot with a CAS on
+    /// the enqueue position, the slot sequence number publishes the frame to the consumer.
+    class Ring
+    {
+    public:
+        explicit Ring(int capacity);
+
+        bool push(const char *bytes, int length);
+        bool pop(QByteArray &frame, qint64 &enqueuedNSecs);
+        bool peekLength(int &length) const;
+        bool isEmpty() const;
+        qsizetype queuedFrames() const;
+        qint64 queuedBytes() const { return _queuedBytes.load(std::memory_order_relaxed); }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence = 0;
+            int length = 0;
+            qint64 enqueuedNSecs = 0;
+            char data[kMaxFrameLength];
+        };
+
+        const size_t _mask;
+        std::unique_ptr<Slot[]> _slots;
+        alignas(64) std::atomic<size_t> _enqueuePosition = 0;
+        std::atomic<qint64> _queuedBytes = 0;
+        alignas(64) std::atomic<size_t> _dequeuePosition = 0;
+    };
+
+    std::array<std::unique_ptr<Ring>, PriorityCount> _rings;
+    std::atomic<quint64> _overflowCount = 0;
+};
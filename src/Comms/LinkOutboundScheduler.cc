@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkOutboundScheduler.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QtMath>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(LinkOutboundSchedulerLog, "qgc.comms.linkoutboundscheduler")
+
+namespace
+{
+
+constexpr std::array<int, LinkOutboundQueue::PriorityCount> kWeights = { 0, 4, 3, 2, 1 };
+constexpr int kFirstFairClass = LinkOutboundQueue::PriorityCommand;
+constexpr int kFairClassCount = LinkOutboundQueue::PriorityCount - kFirstFairClass;
+
+/// The bucket holds at most this much time worth of bytes, but always at least two full frames
+constexpr qint64 kBurstMSecs = 100;
+
+constexpr double kMinRadioRateFactor = 0.1;
+constexpr double kLatencyAverageWeight = 1. / 16.;
+
+} // namespace
+
+LinkOutboundScheduler::LinkOutboundScheduler(LinkOutboundQueue *queue)
+    : _queue(queue)
+{
+
+}
+
+void LinkOutboundScheduler::setConfiguredByteRate(int bytesPerSecond)
+{
+    _configuredByteRate = std::max(0, bytesPerSecond);
+    qCDebug(LinkOutboundSchedulerLog) << "byte rate" << byteRate();
+}
+
+void LinkOutboundScheduler::radioStatusReceived(uint8_t txBufferPercent, int radioByteRate)
+{
+    _radioByteRate = std::max(0, radioByteRate);
+
+    // Same thresholds ArduPilot uses to slow its own streams down on SiK radios
+    if (txBufferPercent < 20) {
+        _radioRateFactor = std::max(kMinRadioRateFactor, _radioRateFactor * 0.5);
+    } else if (txBufferPercent < 50) {
+        _radioRateFactor = std::max(kMinRadioRateFactor, _radioRateFactor * 0.8);
+    } else if (txBufferPercent > 90) {
+        _radioRateFactor = std::min(1., _radioRateFactor + 0.05);
+    }
+
+    qCDebug(LinkOutboundSchedulerLog) << "txbuf" << txBufferPercent << "byte rate" << byteRate();
+}
+
+int LinkOutboundScheduler::byteRate() const
+{
+    const int baseRate = (_configuredByteRate > 0) ? _configuredByteRate : _radioByteRate;
+    if (baseRate == 0) {
+        return 0;
+    }
+
+    return std::max(1, static_cast<int>(baseRate * _radioRateFactor));
+}
+
+void LinkOutboundScheduler::_refill(qint64 nowNSecs)
+{
+    const int rate = byteRate();
+    if (rate == 0) {
+        _lastRefillNSecs = nowNSecs;
+        return;
+    }
+
+    const double burst = std::max((rate * kBurstMSecs) / 1000., 2. * LinkOutboundQueue::kMaxFrameLength);
+    if (_lastRefillNSecs == 0) {
+        _tokens = burst;
+    } else if (nowNSecs > _lastRefillNSecs) {
+        _tokens = std::min(burst, _tokens + ((rate * static_cast<double>(nowNSecs - _lastRefillNSecs)) / 1e9));
+    }
+    _lastRefillNSecs = nowNSecs;
+}
+
+bool LinkOutboundScheduler::next(qint64 nowNSecs, QByteArray &frame)
+{
+    _refill(nowNSecs);
+
+    qint64 enqueuedNSecs = 0;
+    if (_queue->pop(LinkOutboundQueue::PriorityHigh, frame, enqueuedNSecs)) {
+        _sent(LinkOutboundQueue::PriorityHigh, frame, enqueuedNSecs, nowNSecs);
+        return true;
+    }
+
+    if ((byteRate() > 0) && (_tokens <= 0.)) {
+        return false;
+    }
+
+    // Every busy class can send at least one frame per visit since a quantum is never smaller than a frame, so two
+    // rounds always find one if there is any
+    for (int step = 0; step < (2 * kFairClassCount); step++) {
+        const LinkOutboundQueue::Priority priority = static_cast<LinkOutboundQueue::Priority>(_currentClass);
+        int length = 0;
+        if (_queue->peekLength(priority, length)) {
+            if (!_quantumGranted) {
+                _deficit[priority] += kWeights[priority] * LinkOutboundQueue::kMaxFrameLength;
+                _quantumGranted = true;
+            }
+            if (length <= _deficit[priority]) {
+                (void) _queue->pop(priority, frame, enqueuedNSecs);
+                _deficit[priority] -= length;
+                _sent(priority, frame, enqueuedNSecs, nowNSecs);
+                return true;
+            }
+        } else {
+            // Idle classes do not save up credit
+            _deficit[priority] = 0;
+        }
+        _advanceClass();
+    }
+
+    return false;
+}
+
+void LinkOutboundScheduler::_advanceClass()
+{
+    _currentClass = kFirstFairClass + (((_currentClass - kFirstFairClass) + 1) % kFairClassCount);
+    _quantumGranted = false;
+}
+
+void LinkOutboundScheduler::_sent(LinkOutboundQueue::Priority priority, const QByteArray &frame, qint64 enqueuedNSecs, qint64 nowNSecs)
+{
+    if (byteRate() > 0) {
+        _tokens -= frame.size();
+    }
+
+    ClassStatistics &statistics = _statistics[priority];
+    statistics.sentFrames++;
+    statistics.sentBytes += frame.size();
+
+    const double latencyMSecs = std::max<qint64>(0, nowNSecs - enqueuedNSecs) / 1e6;
+    if (statistics.sentFrames == 1) {
+        statistics.averageLatencyMSecs = latencyMSecs;
+    } else {
+        statistics.averageLatencyMSecs += (latencyMSecs - statistics.averageLatencyMSecs) * kLatencyAverageWeight;
+    }
+    statistics.maxLatencyMSecs = std::max(statistics.maxLatencyMSecs, latencyMSecs);
+}
+
+int LinkOutboundScheduler::waitMSecs() const
+{
+    if (_queue->isEmpty()) {
+        return -1;
+    }
+
+    const int rate = byteRate();
+    if ((rate == 0) || (_tokens > 0.)) {
+        return 0;
+    }
+
+    return std::max(1, qCeil((-_tokens * 1000.) / rate));
+}
+
+double LinkOutboundScheduler::_share(LinkOutboundQueue::Priority priority) const
+{
+    int activeWeight = kWeights[priority];
+    for (int other = kFirstFairClass; other < LinkOutboundQueue::PriorityCount; other++) {
+        if ((other != priority) && !_queue->isEmpty(static_cast<LinkOutboundQueue::Priority>(other))) {
+            activeWeight += kWeights[other];
+        }
+    }
+
+    return static_cast<double>(kWeights[priority]) / activeWeight;
+}
+
+int LinkOutboundScheduler::estimatedDelayMSecs(LinkOutboundQueue::Priority priority) const
+{
+    const int rate = byteRate();
+    if ((rate == 0) || (priority == LinkOutboundQueue::PriorityHigh)) {
+        return 0;
+    }
+
+    const double debtMSecs = (std::max(0., -_tokens) * 1000.) / rate;
+    const double backlogMSecs = (_queue->queuedBytes(priority) * 1000.) / (rate * _share(priority));
+    return qCeil(debtMSecs + backlogMSecs);
+}
+
+int LinkOutboundScheduler::bulkFrameAllowance(int frameLength, int maxFrames) const
+{
+    const int rate = byteRate();
+    if ((rate == 0) || (frameLength <= 0)) {
+        return maxFrames;
+    }
+
+    const double budgetBytes = ((rate * _share(LinkOutboundQueue::PriorityBulk) * kBulkBacklogMSecs) / 1000.) - _queue->queuedBytes(LinkOutboundQueue::PriorityBulk);
+    return std::clamp(static_cast<int>(budgetBytes / frameLength), 1, std::max(1, maxFrames));
+}
+
+LinkOutboundScheduler::ClassStatistics LinkOutboundScheduler::statistics(LinkOutboundQueue::Priority priority) const
+{
+    ClassStatistics statistics = _statistics[priority];
+    statistics.queuedFrames = _queue->queuedFrames(priority);
+    statistics.queuedBytes = _queue->queuedBytes(priority);
+    return statistics;
+}
+
+int LinkOutboundScheduler::weight(LinkOutboundQueue::Priority priority)
+{
+    return kWeights[priority];
+}
@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLoggingCategory>
+
+#include <array>
+
+#include "LinkOutboundQueue.h"
+
+Q_DECLARE_LOGGING_CATEGORY(LinkOutboundSchedulerLog)
+
+/// Decides which queued frame a link writes next. Pilot input always goes first. The other classes share the link
+/// through deficit round robin, a weighted fair queuing scheme which serves each busy class in proportion to its
+/// weight in bytes. With a byte rate set, a token bucket paces everything to that rate. Pilot input is charged to
+/// the bucket but never waits for it.
+///
+/// Not thread safe, only used from the thread of the link.
+class LinkOutboundScheduler
+{
+public:
+    struct ClassStatistics {
+        qsizetype queuedFrames = 0;         ///< Occupancy of the ring
+        qint64 queuedBytes = 0;
+        quint64 sentFrames = 0;
+        quint64 sentBytes = 0;
+        double averageLatencyMSecs = 0.;    ///< Moving average of the time frames spent queued
+        double maxLatencyMSecs = 0.;
+    };
+
+    explicit LinkOutboundScheduler(LinkOutboundQueue *queue);
+
+    /// Byte rate the user configured for the link, 0: none
+    void setConfiguredByteRate(int bytesPerSecond);
+
+    /// Adapts the rate to the free transmit buffer reported by a telemetry radio
+    ///     @param txBufferPercent RADIO_STATUS.txbuf
+    ///     @param radioByteRate Rate of the radio, used if the user did not configure one
+    void radioStatusReceived(uint8_t txBufferPercent, int radioByteRate);
+
+    /// Rate frames are paced to in bytes per second, 0: unlimited
+    int byteRate() const;
+
+    /// Takes the next frame which may be written at nowNSecs
+    ///     @return false: queue is empty or the byte budget is used up
+    bool next(qint64 nowNSecs, QByteArray &frame);
+
+    /// @return msecs until next can return a frame again, -1: queue is empty
+    int waitMSecs() const;
+
+    /// Estimated msecs a frame of the class queued now waits before it is written
+    int estimatedDelayMSecs(LinkOutboundQueue::Priority priority) const;
+
+    /// Number of bulk frames, between 1 and maxFrames, which can be queued without the bulk backlog growing past
+    /// kBulkBacklogMSecs of its share of the byte rate. Bulk transfers size their request batches with it.
+    int bulkFrameAllowance(int frameLength, int maxFrames) const;
+
+    ClassStatistics statistics(LinkOutboundQueue::Priority priority) const;
+
+    static int weight(LinkOutboundQueue::Priority priority);
+
+    static constexpr int kBulkBacklogMSecs = 250;
+
+private:
+    void _refill(qint64 nowNSecs);
+    void _sent(LinkOutboundQueue::Priority priority, const QByteArray &frame, qint64 enqueuedNSecs, qint64 nowNSecs);
+    void _advanceClass();
+    double _share(LinkOutboundQueue::Priority priority) const;
+
+    LinkOutboundQueue *_queue = nullptr;
+
+    int _configuredByteRate = 0;
+    int _radioByteRate = 0;
+    double _radioRateFactor = 1.;
+
+    double _tokens = 0.;
+    qint64 _lastRefillNSecs = 0;
+
+    std::array<int, LinkOutboundQueue::PriorityCount> _deficit{};
+    int _currentClass = LinkOutboundQueue::PriorityCommand;
+    bool _quantumGranted = false;
+
+    std::array<ClassStatistics, LinkOutboundQueue::PriorityCount> _statistics{};
+};
@@ -12,9 +12,9 @@
 #include "MAVLinkProtocol.h"
 #include "MultiVehicleManager.h"
 #include "QGCLoggingCategory.h"
+#include "QGCSignalCoalescer.h"
 
 #include <QtCore/QFileInfo>
-#include <QtCore/QtEndian>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
@@ -183,39 +183,94 @@ void LogReplayWorker::setPlaybackSpeed(qreal playbackSpeed)
 
 void LogReplayWorker::movePlayhead(qreal percentComplete)
 {
-    if (isPlaying()) {
-        pause();
-        if (_readTickTimer->isActive()) {
-            return;
-        }
+    if (!_pauseForSeek()) {
+        return;
     }
 
     percentComplete = qBound(0., percentComplete, 100.);
-    const qreal percentCompleteMult = percentComplete / 100.0;
-    const qint64 newFilePos = static_cast<qint64>(percentCompleteMult * static_cast<qreal>(_logFile.size()));
-    if (!_logFile.seek(newFilePos)) {
+    const quint64 desiredTimeUSecs = _logStartTimeUSecs + static_cast<quint64>((percentComplete / 100.0) * _logDurationUSecs);
+    if (!_seekToLogTime(desiredTimeUSecs)) {
         emit errorOccurred(tr("Unable to seek to new position"));
         return;
     }
 
-    mavlink_message_t dummy{};
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(dummy);
+    _signalCurrentLogTimeSecs();
+    _signalPlaybackPercentComplete();
+}
+
+void LogReplayWorker::movePlayheadToEvent(int eventIndex)
+{
+    if ((eventIndex < 0) || (eventIndex >= _logIndex.events().count())) {
+        qCWarning(LogReplayLinkLog) << "Invalid event index" << eventIndex;
+        return;
+    }
 
-    qreal newRelativeTimeUSecs = static_cast<qreal>(_logCurrentTimeUSecs - _logStartTimeUSecs);
-    const qreal baudRate = _logFile.size() / static_cast<qreal>(_logDurationUSecs) / 1e6;
-    const qreal desiredTimeUSecs = percentCompleteMult * _logDurationUSecs;
-    const qint64 offset = (newRelativeTimeUSecs - desiredTimeUSecs) * baudRate;
-    if (!_logFile.seek(_logFile.pos() + offset)) {
+    if (!_pauseForSeek()) {
+        return;
+    }
+
+    if (!_seekToRecord(_logIndex.events()[eventIndex].offset)) {
         emit errorOccurred(tr("Unable to seek to new position"));
         return;
     }
 
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(dummy);
     _signalCurrentLogTimeSecs();
+    _signalPlaybackPercentComplete();
+}
+
+/// @return false: Playback could not be paused
+bool LogReplayWorker::_pauseForSeek()
+{
+    if (isPlaying()) {
+        pause();
+        if (_readTickTimer->isActive()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Positions the log at the frame of the record at offset and makes its time the current time
+bool LogReplayWorker::_seekToRecord(qint64 offset)
+{
+    if (!_logFile.seek(offset)) {
+        qCWarning(LogReplayLinkLog) << "Failed to seek record:" << _logFile.error() << _logFile.errorString();
+        return false;
+    }
+
+    const QByteArray rawTime = _logFile.read(kTimestamp);
+    if (rawTime.size() != static_cast<qsizetype>(kTimestamp)) {
+        return false;
+    }
+
+    mavlink_reset_channel_status(_mavlinkChannel);
+    _logCurrentTimeUSecs = TelemetryLogIndex::parseTimestamp(rawTime.constData());
+
+    return true;
+}
+
+/// Positions the log at the first record at or after the log time. Starts at the closest index checkpoint, so at
+/// most one checkpoint interval of records is read.
+bool LogReplayWorker::_seekToLogTime(quint64 logTimeUSecs)
+{
+    const qint64 checkpointOffset = _logIndex.checkpointOffset(logTimeUSecs);
+    if ((checkpointOffset < 0) || !_seekToRecord(checkpointOffset)) {
+        return false;
+    }
+
+    QByteArray bytes;
+    while (_logCurrentTimeUSecs < logTimeUSecs) {
+        const qint64 framePos = _logFile.pos();
+        const quint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
+        if (_logFile.atEnd()) {
+            // Stay on the last record
+            return _logFile.seek(framePos);
+        }
+        _logCurrentTimeUSecs = nextTimeUSecs;
+    }
 
-    newRelativeTimeUSecs = static_cast<qreal>(_logCurrentTimeUSecs - _logStartTimeUSecs);
-    percentComplete = ((newRelativeTimeUSecs / _logDurationUSecs) * 100);
-    emit playbackPercentCompleteChanged(percentComplete);
+    return true;
 }
 
 void LogReplayWorker::_resetPlaybackToBeginning()
@@ -239,7 +294,7 @@ void LogReplayWorker::_readNextLogEntry()
         bytes.reserve(_logFile.bytesAvailable());
         const qint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
         emit dataReceived(bytes);
-        emit playbackPercentCompleteChanged((static_cast<float>(_logCurrentTimeUSecs - _logStartTimeUSecs) / static_cast<float>(_logDurationUSecs)) * 100);
+        _signalPlaybackPercentComplete();
 
         if (_logFile.atEnd()) {
             pause();
@@ -265,6 +320,11 @@ void LogReplayWorker::_signalCurrentLogTimeSecs()
     emit currentLogTimeSecs((_logCurrentTimeUSecs - _logStartTimeUSecs) / 1000000);
 }
 
+void LogReplayWorker::_signalPlaybackPercentComplete()
+{
+    emit playbackPercentCompleteChanged((static_cast<float>(_logCurrentTimeUSecs - _logStartTimeUSecs) / static_cast<float>(_logDurationUSecs)) * 100);
+}
+
 bool LogReplayWorker::_loadLogFile()
 {
     if (_logFile.isOpen()) {
@@ -284,18 +344,16 @@ bool LogReplayWorker::_loadLogFile()
     logFileInfo.setFile(logFilename);
     _logFileSize = logFileInfo.size();
 
-    const quint64 startTimeUSecs = _parseTimestamp(_logFile.read(kTimestamp));
-    const quint64 endTimeUSecs = _findLastTimestamp();
-    if (endTimeUSecs <= startTimeUSecs) {
+    if (!_loadLogIndex()) {
         _logFile.close();
         emit errorOccurred(tr("The log file '%1' is corrupt or empty.").arg(logFilename));
         return false;
     }
 
-    _logEndTimeUSecs = endTimeUSecs;
-    _logStartTimeUSecs = startTimeUSecs;
-    _logDurationUSecs = endTimeUSecs - startTimeUSecs;
-    _logCurrentTimeUSecs = startTimeUSecs;
+    _logEndTimeUSecs = _logIndex.endTimeUSecs();
+    _logStartTimeUSecs = _logIndex.startTimeUSecs();
+    _logDurationUSecs = _logIndex.durationUSecs();
+    _logCurrentTimeUSecs = _logStartTimeUSecs;
 
     if (!_logFile.reset()) {
         qCWarning(LogReplayLinkLog) << "failed to reset log file:" << _logFile.error() << _logFile.errorString();
@@ -304,18 +362,40 @@ bool LogReplayWorker::_loadLogFile()
     const quint64 logDurationSecondsTotal = _logDurationUSecs / 1000000;
     emit logFileStats(logDurationSecondsTotal);
 
+    QVariantList events;
+    for (const TelemetryLogIndex::Event &event : _logIndex.events()) {
+        const quint64 eventTimeUSecs = qMax(event.timeUSecs, _logStartTimeUSecs) - _logStartTimeUSecs;
+        events.append(QVariantMap{
+            { QStringLiteral("timeSecs"), static_cast<uint>(eventTimeUSecs / 1000000) },
+            { QStringLiteral("type"), static_cast<int>(event.type) },
+            { QStringLiteral("sysid"), event.sysid },
+            { QStringLiteral("autopilot"), event.autopilot },
+            { QStringLiteral("vehicleType"), event.vehicleType },
+            { QStringLiteral("baseMode"), event.baseMode },
+            { QStringLiteral("customMode"), event.customMode },
+        });
+    }
+    emit logEvents(events);
+
     return true;
 }
 
-quint64 LogReplayWorker::_parseTimestamp(const QByteArray &bytes)
+/// Loads the sidecar index of the log, the index is built and saved if it is missing or out of date
+bool LogReplayWorker::_loadLogIndex()
 {
-    const quint64 currentTimestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
-    quint64 timestamp = qFromBigEndian(*reinterpret_cast<const quint64*>(bytes.constData()));
-    if (timestamp > currentTimestamp) {
-        timestamp = qbswap(timestamp);
+    const QString indexFilename = TelemetryLogIndex::sidecarFileName(_logFile.fileName());
+    if (_logIndex.load(indexFilename, _logFile.size())) {
+        qCDebug(LogReplayLinkLog) << "Loaded log index" << indexFilename;
+    } else {
+        qCDebug(LogReplayLinkLog) << "Building log index" << indexFilename;
+        if (!_logIndex.build(&_logFile)) {
+            return false;
+        }
+        // Logs in read only locations are simply indexed again next time
+        (void) _logIndex.save(indexFilename);
     }
 
-    return timestamp;
+    return (_logIndex.endTimeUSecs() > _logIndex.startTimeUSecs());
 }
 
 quint64 LogReplayWorker::_readNextMavlinkMessage(QByteArray &bytes)
@@ -335,66 +415,13 @@ quint64 LogReplayWorker::_readNextMavlinkMessage(QByteArray &bytes)
 
         if (messageFound) {
             const QByteArray rawTime = _logFile.read(kTimestamp);
-            return _parseTimestamp(rawTime);
+            return ((rawTime.size() == static_cast<qsizetype>(kTimestamp)) ? TelemetryLogIndex::parseTimestamp(rawTime.constData()) : 0);
         }
     }
 
     return 0;
 }
 
-quint64 LogReplayWorker::_seekToNextMavlinkMessage(mavlink_message_t &nextMsg)
-{
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    qint64 messageStartPos = -1;
-    char nextByte;
-    while (_logFile.getChar(&nextByte)) {
-        mavlink_status_t status{};
-        const bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &nextMsg, &status);
-
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            messageStartPos = _logFile.pos() - 1;
-        }
-
-        if (messageFound && (messageStartPos != -1)) {
-            if (!_logFile.seek(messageStartPos - kTimestamp)) {
-                qCWarning(LogReplayLinkLog) << "Failed to seek next message:" << _logFile.error() << _logFile.errorString();
-                break;
-            }
-
-            const QByteArray rawTime = _logFile.read(kTimestamp);
-            return _parseTimestamp(rawTime);
-        }
-    }
-
-    return 0;
-}
-
-quint64 LogReplayWorker::_findLastTimestamp()
-{
-    if (!_logFile.reset()) {
-        qCWarning(LogReplayLinkLog) << "failed to reset log file:" << _logFile.error() << _logFile.errorString();
-    }
-
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    quint64 lastTimestamp = 0;
-
-    while (_logFile.bytesAvailable() > kTimestamp) {
-        lastTimestamp = _parseTimestamp(_logFile.read(kTimestamp));
-
-        bool endOfMessage = false;
-        char nextByte;
-        while (!endOfMessage && _logFile.getChar(&nextByte)) {
-            mavlink_message_t msg{};
-            mavlink_status_t status{};
-            endOfMessage = mavlink_parse_char(_mavlinkChannel, nextByte, &msg, &status);
-        }
-    }
-
-    return lastTimestamp;
-}
-
 /*===========================================================================*/
 
 LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr &config, QObject *parent)
@@ -418,10 +445,12 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr &config, QObject *parent
     (void) connect(_worker, &LogReplayWorker::dataReceived, this, &LogReplayLink::_onDataReceived, Qt::QueuedConnection);
 
     (void) connect(_worker, &LogReplayWorker::logFileStats, this, &LogReplayLink::logFileStats, Qt::QueuedConnection);
+    (void) connect(_worker, &LogReplayWorker::logEvents, this, &LogReplayLink::logEvents, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::playbackStarted, this, &LogReplayLink::playbackStarted, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::playbackPaused, this, &LogReplayLink::playbackPaused, Qt::QueuedConnection);
-    (void) connect(_worker, &LogReplayWorker::playbackPercentCompleteChanged, this, &LogReplayLink::playbackPercentCompleteChanged, Qt::QueuedConnection);
-    (void) connect(_worker, &LogReplayWorker::currentLogTimeSecs, this, &LogReplayLink::currentLogTimeSecs, Qt::QueuedConnection);
+    // Progress is signalled for every replayed message, the UI only needs the latest
+    (void) QGCSignalCoalescer::connect(_worker, &LogReplayWorker::playbackPercentCompleteChanged, this, &LogReplayLink::playbackPercentCompleteChanged);
+    (void) QGCSignalCoalescer::connect(_worker, &LogReplayWorker::currentLogTimeSecs, this, &LogReplayLink::currentLogTimeSecs);
     (void) connect(_worker, &LogReplayWorker::disconnected, this, &LogReplayLink::disconnected, Qt::QueuedConnection);
 
     _workerThread->start();
@@ -479,3 +508,8 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
 {
     (void) QMetaObject::invokeMethod(_worker, "movePlayhead", Qt::QueuedConnection, percentComplete);
 }
+
+void LogReplayLink::movePlayheadToEvent(int eventIndex)
+{
+    (void) QMetaObject::invokeMethod(_worker, "movePlayheadToEvent", Qt::QueuedConnection, eventIndex);
+}
@@ -11,14 +11,14 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QVariant>
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "TelemetryLogIndex.h"
 
 class QTimer;
 
-typedef struct __mavlink_message mavlink_message_t;
-
 Q_DECLARE_LOGGING_CATEGORY(LogReplayLinkLog)
 
 /*===========================================================================*/
@@ -77,6 +77,10 @@ class LogReplayWorker : public QObject
     void playbackPercentCompleteChanged(qreal percentComplete);
     void currentLogTimeSecs(uint32_t secs);
 
+    /// Vehicle events found in the log (arm/disarm, flight mode changes), in log order. Each entry is a map with the
+    /// keys: timeSecs, type (TelemetryLogIndex::EventType), sysid, autopilot, vehicleType, baseMode, customMode.
+    void logEvents(const QVariantList &events);
+
 public slots:
     void setup();
     void connectToLog();
@@ -85,18 +89,21 @@ public slots:
     void pause();
     void setPlaybackSpeed(qreal playbackSpeed);
     void movePlayhead(qreal percentComplete);
+    void movePlayheadToEvent(int eventIndex);
 
 private slots:
     void _readNextLogEntry();
 
 private:
-    quint64 _parseTimestamp(const QByteArray &bytes);
-    quint64 _seekToNextMavlinkMessage(mavlink_message_t &nextMsg);
-    quint64 _findLastTimestamp();
     quint64 _readNextMavlinkMessage(QByteArray &bytes);
     bool _loadLogFile();
+    bool _loadLogIndex();
+    bool _pauseForSeek();
+    bool _seekToRecord(qint64 offset);
+    bool _seekToLogTime(quint64 logTimeUSecs);
     void _resetPlaybackToBeginning();
     void _signalCurrentLogTimeSecs();
+    void _signalPlaybackPercentComplete();
 
     const LogReplayConfiguration *_logReplayConfig = nullptr;
     QTimer *_readTickTimer = nullptr;
@@ -115,6 +122,7 @@ private slots:
 
     QFile _logFile;
     quint64 _logFileSize = 0;
+    TelemetryLogIndex _logIndex;
 
     static constexpr size_t kTimestamp = sizeof(quint64);
 };
@@ -138,9 +146,11 @@ class LogReplayLink : public LinkInterface
     void pause();
     void setPlaybackSpeed(qreal playbackSpeed);
     void movePlayhead(qreal percentComplete);
+    void movePlayheadToEvent(int eventIndex);
 
 signals:
     void logFileStats(uint32_t logDurationSecs);
+    void logEvents(const QVariantList &events);
     void playbackStarted();
     void playbackPaused();
     void playbackAtEnd();
@@ -8,6 +8,8 @@
  ****************************************************************************/
 
 #include "LogReplayLinkController.h"
+#include "FirmwarePlugin.h"
+#include "FirmwarePluginManager.h"
 #include "QGCLoggingCategory.h"
 
 QGC_LOGGING_CATEGORY(LogReplayLinkControllerLog, "qgc.comms.logreplaylink")
@@ -41,6 +43,9 @@ void LogReplayLinkController::setLink(LogReplayLink *link)
         _totalTime.clear();
         emit totalTimeChanged(_totalTime);
 
+        _events.clear();
+        emit eventsChanged();
+
         _link = nullptr;
         emit linkChanged(_link);
     }
@@ -49,6 +54,7 @@ void LogReplayLinkController::setLink(LogReplayLink *link)
         _link = link;
 
         (void) connect(_link, &LogReplayLink::logFileStats, this, &LogReplayLinkController::_logFileStats);
+        (void) connect(_link, &LogReplayLink::logEvents, this, &LogReplayLinkController::_logEvents);
         (void) connect(_link, &LogReplayLink::playbackStarted, this, &LogReplayLinkController::_playbackStarted);
         (void) connect(_link, &LogReplayLink::playbackPaused, this, &LogReplayLinkController::_playbackPaused);
         (void) connect(_link, &LogReplayLink::playbackPercentCompleteChanged, this, &LogReplayLinkController::_playbackPercentCompleteChanged);
@@ -75,6 +81,11 @@ void LogReplayLinkController::setPercentComplete(qreal percentComplete) const
     _link->movePlayhead(percentComplete);
 }
 
+void LogReplayLinkController::seekToEvent(int index) const
+{
+    _link->movePlayheadToEvent(index);
+}
+
 void LogReplayLinkController::_logFileStats(uint32_t logDurationSecs)
 {
     const QString totalTime = _secondsToHMS(logDurationSecs);
@@ -84,6 +95,39 @@ void LogReplayLinkController::_logFileStats(uint32_t logDurationSecs)
     }
 }
 
+void LogReplayLinkController::_logEvents(const QVariantList &events)
+{
+    _events.clear();
+
+    for (const QVariant &eventVariant : events) {
+        const QVariantMap event = eventVariant.toMap();
+        const uint8_t sysid = event[QStringLiteral("sysid")].toUInt();
+
+        QString description;
+        switch (static_cast<TelemetryLogIndex::EventType>(event[QStringLiteral("type")].toInt())) {
+        case TelemetryLogIndex::EventType::Armed:
+            description = tr("Vehicle %1: Armed").arg(sysid);
+            break;
+        case TelemetryLogIndex::EventType::Disarmed:
+            description = tr("Vehicle %1: Disarmed").arg(sysid);
+            break;
+        case TelemetryLogIndex::EventType::ModeChanged: {
+            const MAV_AUTOPILOT autopilot = static_cast<MAV_AUTOPILOT>(event[QStringLiteral("autopilot")].toUInt());
+            const MAV_TYPE vehicleType = static_cast<MAV_TYPE>(event[QStringLiteral("vehicleType")].toUInt());
+            const FirmwarePlugin *const firmwarePlugin = FirmwarePluginManager::instance()->firmwarePluginForAutopilot(autopilot, vehicleType);
+            const QString flightMode = firmwarePlugin->flightMode(event[QStringLiteral("baseMode")].toUInt(), event[QStringLiteral("customMode")].toUInt());
+            description = tr("Vehicle %1: %2").arg(sysid).arg(flightMode);
+            break;
+        }
+        }
+
+        const QString time = _secondsToHMS(event[QStringLiteral("timeSecs")].toUInt());
+        _events.append(QVariantMap{ { QStringLiteral("text"), QStringLiteral("%1 %2").arg(time, description) } });
+    }
+
+    emit eventsChanged();
+}
+
 void LogReplayLinkController::_playbackStarted()
 {
     if (!_isPlaying) {
@@ -25,6 +25,7 @@ class LogReplayLinkController : public QObject
     Q_PROPERTY(QString          totalTime       MEMBER  _totalTime                                  NOTIFY totalTimeChanged)
     Q_PROPERTY(QString          playheadTime    MEMBER  _playheadTime                               NOTIFY playheadTimeChanged)
     Q_PROPERTY(qreal            playbackSpeed   MEMBER  _playbackSpeed                              NOTIFY playbackSpeedChanged)
+    Q_PROPERTY(QVariantList     events          MEMBER  _events                                     NOTIFY eventsChanged)
 
 public:
     explicit LogReplayLinkController(QObject *parent = nullptr);
@@ -39,6 +40,9 @@ class LogReplayLinkController : public QObject
     qreal percentComplete() const { return _percentComplete; }
     void setPercentComplete(qreal percentComplete) const;
 
+    /// Moves the playhead to an entry of the events list
+    Q_INVOKABLE void seekToEvent(int index) const;
+
 signals:
     void isPlayingChanged(bool isPlaying);
     void linkChanged(LogReplayLink *link);
@@ -46,11 +50,13 @@ class LogReplayLinkController : public QObject
     void playbackSpeedChanged(qreal playbackSpeed);
     void playheadTimeChanged(const QString &playheadTime);
     void totalTimeChanged(const QString &totalTime);
+    void eventsChanged();
 
 private slots:
     void _currentLogTimeSecs(uint32_t secs);
     void _linkDisconnected() { setLink(nullptr); }
     void _logFileStats(uint32_t logDurationSecs);
+    void _logEvents(const QVariantList &events);
     void _playbackAtEnd();
     void _playbackPaused();
     void _playbackPercentCompleteChanged(qreal percentComplete);
@@ -65,5 +71,6 @@ private slots:
     qreal _playbackSpeed = 1;
     QString _playheadTime;
     QString _totalTime;
+    QVariantList _events;
     LogReplayLink *_link = nullptr;
 };
@@ -8,12 +8,16 @@
  ****************************************************************************/
 
 #include "MAVLinkProtocol.h"
+#include "Fact.h"
 #include "LinkManager.h"
+#include "MAVLinkReceiveWorker.h"
 #include "MultiVehicleManager.h"
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
+#include "QGCMAVLink.h"
 #include "QGCTemporaryFile.h"
 #include "SettingsManager.h"
+#include "TelemetryLogWriter.h"
 #include "MavlinkSettings.h"
 #include "AppSettings.h"
 #include "QmlObjectListModel.h"
@@ -22,6 +26,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMetaType>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
 
@@ -32,12 +37,16 @@ Q_APPLICATION_STATIC(MAVLinkProtocol, _mavlinkProtocolInstance);
 MAVLinkProtocol::MAVLinkProtocol(QObject *parent)
     : QObject(parent)
     , _tempLogFile(new QGCTemporaryFile(QStringLiteral("%2.%3").arg(_tempLogFileTemplate, _logFileExtension), this))
+    , _logWriter(new TelemetryLogWriter(this))
 {
     // qCDebug(MAVLinkProtocolLog) << Q_FUNC_INFO << this;
+
+    (void) connect(_logWriter, &TelemetryLogWriter::writeFailed, this, &MAVLinkProtocol::_logWriteFailed, Qt::QueuedConnection);
 }
 
 MAVLinkProtocol::~MAVLinkProtocol()
 {
+    _logWriter->stopLogging();
     _closeLogFile();
 
     // qCDebug(MAVLinkProtocolLog) << Q_FUNC_INFO << this;
@@ -56,6 +65,12 @@ void MAVLinkProtocol::init()
 
     (void) connect(MultiVehicleManager::instance(), &MultiVehicleManager::vehicleRemoved, this, &MAVLinkProtocol::_vehicleCountChanged);
 
+    Fact *const forwardMavlinkFact = SettingsManager::instance()->mavlinkSettings()->forwardMavlink();
+    _forwardMavlink = forwardMavlinkFact->rawValue().toBool();
+    (void) connect(forwardMavlinkFact, &Fact::rawValueChanged, this, [this](const QVariant &value) {
+        _forwardMavlink = value.toBool();
+    });
+
     _initialized = true;
 }
 
@@ -72,34 +87,120 @@ void MAVLinkProtocol::setVersion(unsigned version)
 void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
 {
     const uint8_t channel = link->mavlinkChannel();
-    _totalReceiveCounter[channel] = 0;
-    _totalLossCounter[channel] = 0;
-    _runningLossPercent[channel] = 0.f;
+
+    _resetEndpoints(channel);
 
     link->setDecodedFirstMavlinkPacket(false);
 }
 
+void MAVLinkProtocol::_resetEndpoints(uint8_t mavlinkChannel)
+{
+    const auto isChannelKey = [mavlinkChannel](quint64 endpointKey) {
+        return ((endpointKey >> 32) == mavlinkChannel);
+    };
+
+    QMutexLocker locker(&_statisticsMutex);
+    (void) _statistics.removeIf([&isChannelKey](QHash<quint64, std::shared_ptr<MAVLinkStatistics>>::iterator it) { return isChannelKey(it.key()); });
+    locker.unlock();
+
+    (void) _frameParsers.removeIf([&isChannelKey](QHash<quint64, MAVLinkFrameParser>::iterator it) { return isChannelKey(it.key()); });
+}
+
+std::shared_ptr<MAVLinkStatistics> MAVLinkProtocol::_endpointStatistics(uint8_t mavlinkChannel, quint32 endpointId)
+{
+    const quint64 endpointKey = _endpointKey(mavlinkChannel, endpointId);
+
+    QMutexLocker locker(&_statisticsMutex);
+    std::shared_ptr<MAVLinkStatistics> &statistics = _statistics[endpointKey];
+    if (!statistics) {
+        statistics = std::make_shared<MAVLinkStatistics>();
+    }
+
+    return statistics;
+}
+
+MAVLinkStatistics::Snapshot MAVLinkProtocol::statistics(uint8_t mavlinkChannel, uint8_t sysid, uint8_t compid) const
+{
+    const qint64 timeUSecs = MAVLinkStatistics::currentTimeUSecs();
+
+    QList<std::shared_ptr<MAVLinkStatistics>> endpointStatistics;
+    {
+        QMutexLocker locker(&_statisticsMutex);
+        for (auto it = _statistics.cbegin(); it != _statistics.cend(); ++it) {
+            if ((it.key() >> 32) == mavlinkChannel) {
+                endpointStatistics.append(it.value());
+            }
+        }
+    }
+
+    MAVLinkStatistics::Snapshot snapshot;
+    snapshot.timeUSecs = timeUSecs;
+    for (const std::shared_ptr<MAVLinkStatistics> &statistics : std::as_const(endpointStatistics)) {
+        snapshot.add(statistics->snapshot(sysid, compid, timeUSecs));
+    }
+
+    return snapshot;
+}
+
+MAVLinkFrameParser &MAVLinkProtocol::_frameParser(uint8_t mavlinkChannel, quint32 endpointId)
+{
+    const quint64 endpointKey = _endpointKey(mavlinkChannel, endpointId);
+    auto parser = _frameParsers.find(endpointKey);
+    if (parser == _frameParsers.end()) {
+        parser = _frameParsers.insert(endpointKey, MAVLinkFrameParser(mavlinkChannel, endpointId != 0));
+    }
+
+    return parser.value();
+}
+
+void MAVLinkProtocol::connectLink(const SharedLinkInterfacePtr &link)
+{
+    if (SettingsManager::instance()->mavlinkSettings()->decodeOnLinkThreads()->rawValue().toBool()) {
+        // The connection owns the worker, it goes away together with the link
+        const std::shared_ptr<MAVLinkReceiveWorker> receiveWorker = std::make_shared<MAVLinkReceiveWorker>(link);
+        (void) connect(link.get(), &LinkInterface::bytesReceived, link.get(), [receiveWorker](LinkInterface *link, const QByteArray &data) {
+            Q_UNUSED(link);
+            receiveWorker->receiveBytes(data);
+        }, Qt::DirectConnection);
+        (void) connect(link.get(), &LinkInterface::endpointBytesReceived, link.get(), [receiveWorker](LinkInterface *link, const QList<LinkEndpointBytes> &endpointBytes) {
+            Q_UNUSED(link);
+            receiveWorker->receiveEndpointBytes(endpointBytes);
+        }, Qt::DirectConnection);
+    } else {
+        (void) connect(link.get(), &LinkInterface::bytesReceived, this, &MAVLinkProtocol::receiveBytes);
+        (void) connect(link.get(), &LinkInterface::endpointBytesReceived, this, &MAVLinkProtocol::receiveEndpointBytes);
+    }
+
+    (void) connect(link.get(), &LinkInterface::bytesSent, this, &MAVLinkProtocol::logSentBytes);
+}
+
+void MAVLinkProtocol::disconnectLink(LinkInterface *link)
+{
+    (void) disconnect(link, &LinkInterface::bytesReceived, this, &MAVLinkProtocol::receiveBytes);
+    (void) disconnect(link, &LinkInterface::bytesReceived, link, nullptr);
+    (void) disconnect(link, &LinkInterface::endpointBytesReceived, this, &MAVLinkProtocol::receiveEndpointBytes);
+    (void) disconnect(link, &LinkInterface::endpointBytesReceived, link, nullptr);
+    (void) disconnect(link, &LinkInterface::bytesSent, this, &MAVLinkProtocol::logSentBytes);
+
+    if (QGCMAVLink::isValidChannel(link->mavlinkChannel())) {
+        _resetEndpoints(link->mavlinkChannel());
+    }
+}
+
+void MAVLinkProtocol::suspendLogForReplay(bool suspend)
+{
+    _logSuspendReplay = suspend;
+}
+
 void MAVLinkProtocol::logSentBytes(const LinkInterface *link, const QByteArray &data)
 {
     Q_UNUSED(link);
 
-    if (_logSuspendError || _logSuspendReplay || !_tempLogFile->isOpen()) {
+    if (_logSuspendReplay) {
         return;
     }
 
-    const quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-    uint8_t bytes_time[sizeof(quint64)]{};
-    qToBigEndian(time, bytes_time);
-
-    QByteArray logData = data;
-    QByteArray timeData = QByteArray::fromRawData(reinterpret_cast<const char*>(bytes_time), sizeof(bytes_time));
-    (void) logData.prepend(timeData);
-    if (_tempLogFile->write(logData) != logData.length()) {
-        const QString message = QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile->fileName());
-        qgcApp()->showAppMessage(message, getName());
-        _stopLogging();
-        _logSuspendError = true;
-    }
+    (void) _logWriter->logBytes(data);
 }
 
 void MAVLinkProtocol::receiveBytes(LinkInterface *link, const QByteArray &data)
@@ -110,76 +211,101 @@ void MAVLinkProtocol::receiveBytes(LinkInterface *link, const QByteArray &data)
         return;
     }
 
-    for (const uint8_t &byte: data) {
-        const uint8_t mavlinkChannel = link->mavlinkChannel();
-        mavlink_message_t message{};
-        mavlink_status_t status{};
+    const uint8_t mavlinkChannel = link->mavlinkChannel();
+    if (!QGCMAVLink::isValidChannel(mavlinkChannel)) {
+        return;
+    }
+
+    // Copy of the decoded frames, emitting messageReceived can cause receiveBytes to be re-entered
+    QList<mavlink_message_t> messages;
+    if (_frameParser(mavlinkChannel, 0).parse(data, messages) == 0) {
+        return;
+    }
+
+    _receiveParsedMessages(link, linkPtr, 0, messages);
+}
+
+void MAVLinkProtocol::receiveEndpointBytes(LinkInterface *link, const QList<LinkEndpointBytes> &endpointBytes)
+{
+    const SharedLinkInterfacePtr linkPtr = LinkManager::instance()->sharedLinkInterfacePointerForLink(link);
+    if (!linkPtr) {
+        qCDebug(MAVLinkProtocolLog) << "receiveEndpointBytes: link gone!" << endpointBytes.size() << "blocks arrived too late";
+        return;
+    }
+
+    const uint8_t mavlinkChannel = link->mavlinkChannel();
+    if (!QGCMAVLink::isValidChannel(mavlinkChannel)) {
+        return;
+    }
 
-        if (mavlink_parse_char(mavlinkChannel, byte, &message, &status) != MAVLINK_FRAMING_OK) {
+    for (const LinkEndpointBytes &bytes : endpointBytes) {
+        QList<mavlink_message_t> messages;
+        if (_frameParser(mavlinkChannel, bytes.endpointId).parse(bytes.data, messages) == 0) {
             continue;
         }
 
-        _updateVersion(link, mavlinkChannel);
-        _updateCounters(mavlinkChannel, message);
-        if (!linkPtr->linkConfiguration()->isForwarding()) {
-            _forward(message);
-            _forwardSupport(message);
+        _receiveParsedMessages(link, linkPtr, bytes.endpointId, messages);
+        if (linkPtr.use_count() == 1) {
+            break;
         }
-        _logData(link, message);
+    }
+}
 
-        if (!_updateStatus(link, linkPtr, mavlinkChannel, message)) {
+void MAVLinkProtocol::_receiveParsedMessages(LinkInterface *link, const SharedLinkInterfacePtr &linkPtr, quint32 endpointId, const QList<mavlink_message_t> &messages)
+{
+    const std::shared_ptr<MAVLinkStatistics> statistics = _endpointStatistics(link->mavlinkChannel(), endpointId);
+    const qint64 timeUSecs = MAVLinkStatistics::currentTimeUSecs();
+    const bool forward = !linkPtr->linkConfiguration()->isForwarding();
+    for (const mavlink_message_t &message : messages) {
+        _receiveMessage(*statistics, timeUSecs, forward, message);
+        if (!_deliverMessage(link, linkPtr, message)) {
             break;
         }
     }
 }
 
-void MAVLinkProtocol::_updateVersion(LinkInterface *link, uint8_t mavlinkChannel)
+void MAVLinkProtocol::_receiveMessage(MAVLinkStatistics &statistics, qint64 timeUSecs, bool forward, const mavlink_message_t &message)
 {
-    if (link->decodedFirstMavlinkPacket()) {
-        return;
+    statistics.record(message, timeUSecs);
+    if (forward) {
+        _forward(message);
+        _forwardSupport(message);
     }
+    _logData(message);
+}
 
-    link->setDecodedFirstMavlinkPacket(true);
-    const mavlink_status_t *const mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+bool MAVLinkProtocol::_deliverMessage(LinkInterface *link, const SharedLinkInterfacePtr &linkPtr, const mavlink_message_t &message)
+{
+    _updateVersion(link, message);
+    _handleHeartbeat(link, message);
+    _handleRadioStatus(link, message);
 
-    if (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) {
-        return;
-    }
+    emit messageReceived(link, message);
 
-    if (mavlink_get_proto_version(mavlinkChannel) == 1) {
-        qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkChannel;
-        setVersion(200);
+    if (linkPtr.use_count() == 1) {
+        return false;
     }
+
+    return true;
 }
 
-void MAVLinkProtocol::_updateCounters(uint8_t mavlinkChannel, const mavlink_message_t &message)
+void MAVLinkProtocol::_updateVersion(LinkInterface *link, const mavlink_message_t &message)
 {
-    _totalReceiveCounter[mavlinkChannel]++;
+    if (link->decodedFirstMavlinkPacket()) {
+        return;
+    }
 
-    uint8_t &lastSeq = _lastIndex[message.sysid][message.compid];
+    link->setDecodedFirstMavlinkPacket(true);
 
-    const QPair<uint8_t,uint8_t> key(message.sysid, message.compid);
-    uint8_t expectedSeq;
-    if (!_firstMessageSeen.contains(key)) {
-        _firstMessageSeen.insert(key);
-        expectedSeq = message.seq;
-    } else {
-        expectedSeq = lastSeq + 1;
+    if (message.magic == MAVLINK_STX_MAVLINK1) {
+        return;
     }
 
-    uint64_t lostMessages;
-    if (message.seq >= expectedSeq) {
-        lostMessages = message.seq - expectedSeq;
-    } else {
-        lostMessages = static_cast<uint64_t>(message.seq) + 256ULL - expectedSeq;
+    const uint8_t mavlinkChannel = link->mavlinkChannel();
+    if (mavlink_get_proto_version(mavlinkChannel) == 1) {
+        qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkChannel;
+        setVersion(200);
     }
-    _totalLossCounter[mavlinkChannel] += lostMessages;
-
-    lastSeq = message.seq;
-
-    const uint64_t totalSent = _totalReceiveCounter[mavlinkChannel] + _totalLossCounter[mavlinkChannel];
-    const float currentLossPercent = (static_cast<double>(_totalLossCounter[mavlinkChannel]) / totalSent) * 100.0f;
-    _runningLossPercent[mavlinkChannel] = (currentLossPercent + _runningLossPercent[mavlinkChannel]) * 0.5f;
 }
 
 void MAVLinkProtocol::_forward(const mavlink_message_t &message)
@@ -188,7 +314,7 @@ void MAVLinkProtocol::_forward(const mavlink_message_t &message)
         return;
     }
 
-    if (!SettingsManager::instance()->mavlinkSettings()->forwardMavlink()->rawValue().toBool()) {
+    if (!_forwardMavlink) {
         return;
     }
 
@@ -222,29 +348,30 @@ void MAVLinkProtocol::_forwardSupport(const mavlink_message_t &message)
     (void) forwardingSupportLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buf), len);
 }
 
-void MAVLinkProtocol::_logData(LinkInterface *link, const mavlink_message_t &message)
+void MAVLinkProtocol::_logData(const mavlink_message_t &message)
 {
-    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile->isOpen()) {
-        const quint64 timestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-        uint8_t buf[MAVLINK_MAX_PACKET_LEN + sizeof(timestamp)]{};
-        qToBigEndian(timestamp, buf);
+    if (_logSuspendReplay || !_logWriter->isLogging()) {
+        return;
+    }
 
-        const qsizetype len = mavlink_msg_to_send_buffer(buf + sizeof(timestamp), &message) + sizeof(timestamp);
-        const QByteArray log_data(reinterpret_cast<const char*>(buf), len);
-        if (_tempLogFile->write(log_data) != len) {
-            const QString message = QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile->fileName());
-            qgcApp()->showAppMessage(message, getName());
-            _stopLogging();
-            _logSuspendError = true;
-        }
+    (void) _logWriter->logMessage(message);
 
-        if ((message.msgid == MAVLINK_MSG_ID_HEARTBEAT) && !_vehicleWasArmed) {
-            if (mavlink_msg_heartbeat_get_base_mode(&message) & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
-                _vehicleWasArmed = true;
-            }
+    if ((message.msgid == MAVLINK_MSG_ID_HEARTBEAT) && !_vehicleWasArmed) {
+        if (mavlink_msg_heartbeat_get_base_mode(&message) & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
+            _vehicleWasArmed = true;
         }
     }
+}
+
+void MAVLinkProtocol::_logWriteFailed()
+{
+    const QString message = QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile->fileName());
+    qgcApp()->showAppMessage(message, getName());
+    _stopLogging();
+}
 
+void MAVLinkProtocol::_handleHeartbeat(LinkInterface *link, const mavlink_message_t &message)
+{
     switch (message.msgid) {
     case MAVLINK_MSG_ID_HEARTBEAT: {
         _startLogging();
@@ -273,22 +400,24 @@ void MAVLinkProtocol::_logData(LinkInterface *link, const mavlink_message_t &mes
     }
 }
 
-bool MAVLinkProtocol::_updateStatus(LinkInterface *link, const SharedLinkInterfacePtr linkPtr, uint8_t mavlinkChannel, const mavlink_message_t &message)
+void MAVLinkProtocol::_handleRadioStatus(LinkInterface *link, const mavlink_message_t &message)
 {
-    if ((_totalReceiveCounter[mavlinkChannel] % 31) == 0) {
-        const uint64_t totalSent = _totalReceiveCounter[mavlinkChannel] + _totalLossCounter[mavlinkChannel];
-        emit mavlinkMessageStatus(message.sysid, totalSent, _totalReceiveCounter[mavlinkChannel], _totalLossCounter[mavlinkChannel], _runningLossPercent[mavlinkChannel]);
+    if (message.msgid != MAVLINK_MSG_ID_RADIO_STATUS) {
+        return;
     }
 
-    emit messageReceived(link, message);
-
-    if (linkPtr.use_count() == 1) {
-        return false;
+    // Only the radio attached to this end of the link reports its own transmit buffer. Vehicles forward the status of
+    // their radios, and of other links, with their own ids.
+    if ((message.sysid != kTelemetryRadioSysId) || (message.compid != MAV_COMP_ID_TELEMETRY_RADIO)) {
+        return;
     }
 
-    return true;
+    mavlink_radio_status_t radioStatus{};
+    mavlink_msg_radio_status_decode(&message, &radioStatus);
+    link->radioStatusReceived(radioStatus.txbuf);
 }
 
+/// The log writer must be stopped
 bool MAVLinkProtocol::_closeLogFile()
 {
     if (!_tempLogFile->isOpen()) {
@@ -331,34 +460,36 @@ void MAVLinkProtocol::_startLogging()
     }
 
     if (!_tempLogFile->open()) {
+        _closeLogFile();
         const QString message = QStringLiteral("Opening Flight Data file for writing failed. Unable to write to %1. Please choose a different file location.").arg(_tempLogFile->fileName());
         qgcApp()->showAppMessage(message, getName());
-        _closeLogFile();
-        _logSuspendError = true;
         return;
     }
 
+    const int syncIntervalSecs = SettingsManager::instance()->mavlinkSettings()->telemetryLogSyncInterval()->rawValue().toInt();
+    _logWriter->startLogging(_tempLogFile, syncIntervalSecs * 1000);
+
     qCDebug(MAVLinkProtocolLog) << "Temp log" << _tempLogFile->fileName();
     (void) _checkTelemetrySavePath();
-
-    _logSuspendError = false;
 }
 
 void MAVLinkProtocol::_stopLogging()
 {
-    if (_tempLogFile->isOpen() && _closeLogFile()) {
+    _logWriter->stopLogging();
+    const bool logClosed = _tempLogFile->isOpen() && _closeLogFile();
+    const bool vehicleWasArmed = _vehicleWasArmed.exchange(false);
+
+    if (logClosed) {
         auto appSettings = SettingsManager::instance()->appSettings();
         auto mavlinkSettings = SettingsManager::instance()->mavlinkSettings();
-        if ((_vehicleWasArmed || mavlinkSettings->telemetrySaveNotArmed()->rawValue().toBool()) && 
+        if ((vehicleWasArmed || mavlinkSettings->telemetrySaveNotArmed()->rawValue().toBool()) && 
                 mavlinkSettings->telemetrySave()->rawValue().toBool() && 
                 !appSettings->disableAllPersistence()->rawValue().toBool()) {
-            _saveTelemetryLog(_tempLogFile->fileName());
+            _saveTelemetryLog(_tempLogFile->fileName(), &_logWriter->logIndex());
         } else {
             (void) QFile::remove(_tempLogFile->fileName());
         }
     }
-
-    _vehicleWasArmed = false;
 }
 
 void MAVLinkProtocol::checkForLostLogFiles()
@@ -394,7 +525,7 @@ void MAVLinkProtocol::deleteTempLogFiles()
     }
 }
 
-void MAVLinkProtocol::_saveTelemetryLog(const QString &tempLogfile)
+void MAVLinkProtocol::_saveTelemetryLog(const QString &tempLogfile, const TelemetryLogIndex *logIndex)
 {
     if (_checkTelemetrySavePath()) {
         const QString saveDirPath = SettingsManager::instance()->appSettings()->telemetrySavePath();
@@ -414,6 +545,8 @@ void MAVLinkProtocol::_saveTelemetryLog(const QString &tempLogfile)
         if (!tempFile.copy(saveFilePath)) {
             const QString error = tr("Unable to save telemetry log. Error copying telemetry to '%1': '%2'.").arg(saveFilePath, tempFile.errorString());
             qgcApp()->showAppMessage(error);
+        } else if (logIndex && !logIndex->isEmpty() && (logIndex->logFileSize() == QFileInfo(saveFilePath).size())) {
+            (void) logIndex->save(TelemetryLogIndex::sidecarFileName(saveFilePath));
         }
     }
 
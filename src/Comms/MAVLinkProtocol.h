@@ -10,14 +10,24 @@
 #pragma once
 
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 
+#include <atomic>
+#include <memory>
+
 #include "LinkInterface.h"
+#include "MAVLinkFrameParser.h"
 #include "MAVLinkLib.h"
+#include "MAVLinkStatistics.h"
 
+class MAVLinkReceiveWorker;
 class QGCTemporaryFile;
+class TelemetryLogIndex;
+class TelemetryLogWriter;
 
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkProtocolLog)
 
@@ -28,6 +38,8 @@ class MAVLinkProtocol : public QObject
 {
     Q_OBJECT
 
+    friend class MAVLinkReceiveWorker;
+
 public:
     /// Constructs an MAVLinkProtocol object.
     ///     @param parent The parent QObject.
@@ -60,8 +72,19 @@ class MAVLinkProtocol : public QObject
     /// Reset the counters for all metadata for this link.
     void resetMetadataForLink(LinkInterface *link);
 
+    /// Connects the receive and send paths of a new link. Depending on the decodeOnLinkThreads setting
+    /// incoming data is decoded on the main thread or on the thread the link receives data on.
+    void connectLink(const SharedLinkInterfacePtr &link);
+    void disconnectLink(LinkInterface *link);
+
     /// Suspend/Restart logging during replay.
-    void suspendLogForReplay(bool suspend) { _logSuspendReplay = suspend; }
+    void suspendLogForReplay(bool suspend);
+
+    /// Receive statistics of a system/component, merged over all endpoints of the link. Thread safe.
+    MAVLinkStatistics::Snapshot statistics(uint8_t mavlinkChannel, uint8_t sysid, uint8_t compid) const;
+
+    /// Background writer of the telemetry log, provides queue and drop statistics
+    const TelemetryLogWriter *telemetryLogWriter() const { return _logWriter; }
 
     /// Set protocol version
     void setVersion(unsigned version);
@@ -78,13 +101,14 @@ class MAVLinkProtocol : public QObject
     /// Message received and directly copied via signal
     void messageReceived(LinkInterface *link, const mavlink_message_t &message);
 
-    void mavlinkMessageStatus(int sysid, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent);
-
 public slots:
     /// Receive bytes from a communication interface and constructs a MAVLink packet
     ///     @param link The interface to read from
     void receiveBytes(LinkInterface *link, const QByteArray &data);
 
+    /// Receive bytes from a link with several remote endpoints, each endpoint has its own parser state and statistics
+    void receiveEndpointBytes(LinkInterface *link, const QList<LinkEndpointBytes> &endpointBytes);
+
     /// Log bytes sent from a communication interface and logs a MAVLink packet.
     /// It can handle multiple links in parallel, as each link has it's own buffer/parsing state machine.
     ///     @param link The interface to read from
@@ -97,32 +121,56 @@ private slots:
     void _vehicleCountChanged();
 
 private:
-    void _logData(LinkInterface *link, const mavlink_message_t &message);
+    /// Thread safe processing of a decoded message, runs on the thread which decoded the message
+    ///     @param statistics Statistics of the link endpoint the message came from
+    ///     @param timeUSecs Arrival time, MAVLinkStatistics::currentTimeUSecs
+    void _receiveMessage(MAVLinkStatistics &statistics, qint64 timeUSecs, bool forward, const mavlink_message_t &message);
+    void _receiveParsedMessages(LinkInterface *link, const SharedLinkInterfacePtr &linkPtr, quint32 endpointId, const QList<mavlink_message_t> &messages);
+    /// Main thread processing of a decoded message
+    ///     @return false: link has gone away
+    bool _deliverMessage(LinkInterface *link, const SharedLinkInterfacePtr &linkPtr, const mavlink_message_t &message);
+
+    void _logData(const mavlink_message_t &message);
+    void _logWriteFailed();
     bool _closeLogFile();
     void _startLogging();
     void _stopLogging();
+    void _handleHeartbeat(LinkInterface *link, const mavlink_message_t &message);
+    /// Telemetry radios report how free their transmit buffer is, the link paces its outbound traffic with it. Only
+    /// RADIO_STATUS of the local radio is used.
+    static void _handleRadioStatus(LinkInterface *link, const mavlink_message_t &message);
 
     void _forward(const mavlink_message_t &message);
     void _forwardSupport(const mavlink_message_t &message);
 
-    void _updateCounters(uint8_t mavlinkChannel, const mavlink_message_t &message);
-    bool _updateStatus(LinkInterface *link, const SharedLinkInterfacePtr linkPtr, uint8_t mavlinkChannel, const mavlink_message_t &message);
-    void _updateVersion(LinkInterface *link, uint8_t mavlinkChannel);
+    /// Thread safe, creates the statistics on first use
+    ///     @param endpointId Remote endpoint of the link, 0: link has a single endpoint
+    std::shared_ptr<MAVLinkStatistics> _endpointStatistics(uint8_t mavlinkChannel, quint32 endpointId);
+    void _resetEndpoints(uint8_t mavlinkChannel);
+
+    MAVLinkFrameParser &_frameParser(uint8_t mavlinkChannel, quint32 endpointId);
+
+    static quint64 _endpointKey(uint8_t mavlinkChannel, quint32 endpointId) { return ((static_cast<quint64>(mavlinkChannel) << 32) | endpointId); }
+    void _updateVersion(LinkInterface *link, const mavlink_message_t &message);
 
-    void _saveTelemetryLog(const QString &tempLogfile);
+    /// @param logIndex Index built while recording, saved next to the log. nullptr: Index is built on first replay.
+    void _saveTelemetryLog(const QString &tempLogfile, const TelemetryLogIndex *logIndex = nullptr);
     bool _checkTelemetrySavePath();
 
     QGCTemporaryFile * const _tempLogFile = nullptr;
+    TelemetryLogWriter * const _logWriter = nullptr;
+
+    /// Receive side frame parser of each link endpoint decoded on the main thread, created on first use, key: _endpointKey.
+    /// Endpoint 0 parses with the channel status, the other endpoints of a link with a private status.
+    QHash<quint64, MAVLinkFrameParser> _frameParsers;
+
+    std::atomic_bool _logSuspendReplay = false; ///< true: Logging suspended due to replay
+    std::atomic_bool _vehicleWasArmed = false;  ///< true: Vehicle was armed during log sequence
 
-    bool _logSuspendError = false;  ///< true: Logging suspended due to error
-    bool _logSuspendReplay = false; ///< true: Logging suspended due to replay
-    bool _vehicleWasArmed = false;  ///< true: Vehicle was armed during log sequence
+    std::atomic_bool _forwardMavlink = false;   ///< Cached forwardMavlink setting, read from link threads
 
-    uint8_t _lastIndex[256][256]{};                             ///< Store the last received sequence ID for each system/component pair
-    QSet<QPair<uint8_t,uint8_t>> _firstMessageSeen;
-    uint64_t _totalReceiveCounter[MAVLINK_COMM_NUM_BUFFERS]{};  ///< The total number of successfully received messages
-    uint64_t _totalLossCounter[MAVLINK_COMM_NUM_BUFFERS]{};     ///< Total messages lost during transmission.
-    float _runningLossPercent[MAVLINK_COMM_NUM_BUFFERS]{};      ///< Loss rate
+    mutable QMutex _statisticsMutex;                                    ///< Protects _statistics, not the statistics themselves
+    QHash<quint64, std::shared_ptr<MAVLinkStatistics>> _statistics;     ///< Statistics of each link endpoint, key: _endpointKey
 
     unsigned _currentVersion = 100;
     bool _initialized = false;
@@ -131,4 +179,5 @@ private slots:
     static constexpr const char *_logFileExtension = "mavlink";             ///< Extension for log files
 
     static constexpr uint8_t kMaxCompId = MAV_COMPONENT_ENUM_END - 1;
+    static constexpr uint8_t kTelemetryRadioSysId = '3';    ///< SiK and compatible radios report as '3' 'D'
 };
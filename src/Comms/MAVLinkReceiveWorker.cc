@@ -0,0 +1,165 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkReceiveWorker.h"
+#include "LinkManager.h"
+#include "MAVLinkProtocol.h"
+#include "QGCLoggingCategory.h"
+#include "QGCMAVLink.h"
+
+#include <QtCore/QMutexLocker>
+
+QGC_LOGGING_CATEGORY(MAVLinkReceiveWorkerLog, "qgc.comms.mavlinkreceiveworker")
+
+MAVLinkReceiveWorker::MAVLinkReceiveWorker(const SharedLinkInterfacePtr &link)
+    : _link(link)
+    , _mavlinkChannel(link->mavlinkChannel())
+    , _isForwarding(link->linkConfiguration()->isForwarding())
+    , _frameParser(_mavlinkChannel, true)
+{
+    // qCDebug(MAVLinkReceiveWorkerLog) << Q_FUNC_INFO << this;
+}
+
+MAVLinkReceiveWorker::~MAVLinkReceiveWorker()
+{
+    // qCDebug(MAVLinkReceiveWorkerLog) << Q_FUNC_INFO << this;
+}
+
+void MAVLinkReceiveWorker::receiveBytes(const QByteArray &data)
+{
+    _parsedMessages.clear();
+    if (_frameParser.parse(data, _parsedMessages) == 0) {
+        return;
+    }
+
+    _receiveParsedMessages(0, 0);
+    _queueParsedMessages();
+}
+
+void MAVLinkReceiveWorker::receiveEndpointBytes(const QList<LinkEndpointBytes> &endpointBytes)
+{
+    _parsedMessages.clear();
+    for (const LinkEndpointBytes &bytes : endpointBytes) {
+        auto parser = _endpointParsers.find(bytes.endpointId);
+        if (parser == _endpointParsers.end()) {
+            parser = _endpointParsers.insert(bytes.endpointId, MAVLinkFrameParser(_mavlinkChannel, true));
+        }
+
+        const qsizetype firstNew = _parsedMessages.size();
+        if (parser->parse(bytes.data, _parsedMessages) > 0) {
+            _receiveParsedMessages(bytes.endpointId, firstNew);
+        }
+    }
+
+    if (!_parsedMessages.isEmpty()) {
+        _queueParsedMessages();
+    }
+}
+
+void MAVLinkReceiveWorker::_receiveParsedMessages(quint32 endpointId, qsizetype firstIndex)
+{
+    MAVLinkProtocol *const mavlinkProtocol = MAVLinkProtocol::instance();
+    const std::shared_ptr<MAVLinkStatistics> statistics = mavlinkProtocol->_endpointStatistics(_mavlinkChannel, endpointId);
+    const qint64 timeUSecs = MAVLinkStatistics::currentTimeUSecs();
+    for (qsizetype i = firstIndex; i < _parsedMessages.size(); i++) {
+        mavlinkProtocol->_receiveMessage(*statistics, timeUSecs, !_isForwarding, _parsedMessages.at(i));
+    }
+}
+
+void MAVLinkReceiveWorker::_queueParsedMessages()
+{
+    QMutexLocker locker(&_queueMutex);
+
+    _queue.append(_parsedMessages);
+
+    qsizetype overflow = _queue.size() - maxQueueDepth;
+    if (overflow > 0) {
+        // Drop the oldest telemetry first, newer samples supersede it. Messages which need every sample (commands,
+        // parameters, missions, FTP, ...) are always delivered, the protocols built on them would stall otherwise.
+        qsizetype kept = 0;
+        for (qsizetype i = 0; i < _queue.size(); i++) {
+            if ((overflow > 0) && !QGCMAVLink::isLosslessMessage(_queue.at(i).msgid)) {
+                overflow--;
+                _droppedMessages++;
+                continue;
+            }
+            if (kept != i) {
+                _queue[kept] = _queue.at(i);
+            }
+            kept++;
+        }
+        _queue.resize(kept);
+    }
+
+    if (_deliveryPending) {
+        return;
+    }
+    _deliveryPending = true;
+    locker.unlock();
+
+    const std::weak_ptr<MAVLinkReceiveWorker> weakThis = weak_from_this();
+    (void) QMetaObject::invokeMethod(MAVLinkProtocol::instance(), [weakThis]() {
+        if (const std::shared_ptr<MAVLinkReceiveWorker> worker = weakThis.lock()) {
+            worker->_deliverMessages();
+        }
+    }, Qt::QueuedConnection);
+}
+
+/// Runs on the main thread
+void MAVLinkReceiveWorker::_deliverMessages()
+{
+    QList<mavlink_message_t> messages;
+    quint64 droppedMessages = 0;
+    {
+        QMutexLocker locker(&_queueMutex);
+        messages.swap(_queue);
+        _deliveryPending = false;
+        droppedMessages = _droppedMessages;
+    }
+
+    LinkInterface *link = nullptr;
+    {
+        const SharedLinkInterfacePtr sharedLink = _link.lock();
+        if (!sharedLink) {
+            return;
+        }
+        link = sharedLink.get();
+    }
+
+    // Only the LinkManager reference tells whether the link is still active
+    const SharedLinkInterfacePtr linkPtr = LinkManager::instance()->sharedLinkInterfacePointerForLink(link);
+    if (!linkPtr) {
+        qCDebug(MAVLinkReceiveWorkerLog) << "link gone!" << messages.size() << "messages arrived too late";
+        return;
+    }
+
+    if (droppedMessages != _reportedDroppedMessages) {
+        qCWarning(MAVLinkReceiveWorkerLog) << linkPtr->linkConfiguration()->name() << "receive queue overflow, dropped" << (droppedMessages - _reportedDroppedMessages) << "messages";
+        _reportedDroppedMessages = droppedMessages;
+    }
+
+    MAVLinkProtocol *const mavlinkProtocol = MAVLinkProtocol::instance();
+    for (const mavlink_message_t &message : std::as_const(messages)) {
+        if (!mavlinkProtocol->_deliverMessage(link, linkPtr, message)) {
+            break;
+        }
+    }
+}
+
+quint64 MAVLinkReceiveWorker::droppedMessages() const
+{
+    QMutexLocker locker(&_queueMutex);
+    return _droppedMessages;
+}
+
+qsizetype MAVLinkReceiveWorker::queueDepth() const
+{
+    QMutexLocker locker(&_queueMutex);
+    return _queue.size();
+}
@@ -0,0 +1,66 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+
+#include <memory>
+
+#include "LinkInterface.h"
+#include "MAVLinkFrameParser.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkReceiveWorkerLog)
+
+/// Decodes the incoming MAVLink traffic of a single link on the thread which received the data.
+/// Parsing, receive statistics, forwarding and telemetry logging happen on that thread. Decoded messages
+/// are handed to the main thread through a bounded queue which drops the oldest telemetry when full. Messages which
+/// need every sample (QGCMAVLink::isLosslessMessage) are never dropped and may take the queue past its bound.
+/// Owned through a shared pointer by the bytesReceived connection, so it lives as long as the link.
+class MAVLinkReceiveWorker : public std::enable_shared_from_this<MAVLinkReceiveWorker>
+{
+public:
+    explicit MAVLinkReceiveWorker(const SharedLinkInterfacePtr &link);
+    ~MAVLinkReceiveWorker();
+
+    /// Called on the link thread
+    void receiveBytes(const QByteArray &data);
+    void receiveEndpointBytes(const QList<LinkEndpointBytes> &endpointBytes);
+
+    /// Number of telemetry messages dropped because the main thread did not keep up
+    quint64 droppedMessages() const;
+
+    /// Number of messages waiting to be delivered to the main thread
+    qsizetype queueDepth() const;
+
+    static constexpr qsizetype maxQueueDepth = 1024;    ///< Bound for droppable telemetry
+
+private:
+    /// Thread safe processing of _parsedMessages starting at firstIndex
+    void _receiveParsedMessages(quint32 endpointId, qsizetype firstIndex);
+    void _queueParsedMessages();
+    void _deliverMessages();
+
+    const WeakLinkInterfacePtr _link;
+    const uint8_t _mavlinkChannel;
+    const bool _isForwarding;
+    MAVLinkFrameParser _frameParser;                        ///< Private status, the channel status belongs to the main thread which packs with it
+    QHash<quint32, MAVLinkFrameParser> _endpointParsers;    ///< Private status parser for each remote endpoint of the link
+    QList<mavlink_message_t> _parsedMessages;
+
+    mutable QMutex _queueMutex;
+    QList<mavlink_message_t> _queue;
+    bool _deliveryPending = false;
+    quint64 _droppedMessages = 0;
+    quint64 _reportedDroppedMessages = 0;   ///< Only accessed from the main thread
+};
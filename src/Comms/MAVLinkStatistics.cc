@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkStatistics.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutexLocker>
+
+#include <bit>
+
+QGC_LOGGING_CATEGORY(MAVLinkStatisticsLog, "qgc.comms.mavlinkstatistics")
+
+void MAVLinkStatistics::Snapshot::add(const Snapshot &other)
+{
+    received += other.received;
+    lost += other.lost;
+    windowReceived += other.windowReceived;
+    windowLost += other.windowLost;
+    jitterMSecs = qMax(jitterMSecs, other.jitterMSecs);
+    for (int i = 0; i < kBurstBinCount; i++) {
+        burstLoss[i] += other.burstLoss[i];
+    }
+    for (auto it = other.messageCounts.cbegin(); it != other.messageCounts.cend(); ++it) {
+        messageCounts[it.key()] += it.value();
+    }
+}
+
+MAVLinkStatistics::MAVLinkStatistics()
+{
+    // qCDebug(MAVLinkStatisticsLog) << Q_FUNC_INFO << this;
+}
+
+MAVLinkStatistics::~MAVLinkStatistics()
+{
+    // qCDebug(MAVLinkStatisticsLog) << Q_FUNC_INFO << this;
+}
+
+qint64 MAVLinkStatistics::currentTimeUSecs()
+{
+    static QElapsedTimer timer;
+    static const bool started = (timer.start(), true);
+    Q_UNUSED(started);
+
+    return (timer.nsecsElapsed() / 1000);
+}
+
+int MAVLinkStatistics::burstBin(uint32_t lostCount)
+{
+    if (lostCount == 0) {
+        return 0;
+    }
+
+    return qMin(static_cast<int>(std::bit_width(lostCount - 1)), kBurstBinCount - 1);
+}
+
+void MAVLinkStatistics::record(const mavlink_message_t &message, qint64 timeUSecs)
+{
+    QMutexLocker locker(&_mutex);
+
+    std::unique_ptr<System> &system = _systems[message.sysid];
+    if (!system) {
+        system = std::make_unique<System>();
+    }
+
+    std::unique_ptr<Component> &component = system->components[message.compid];
+    if (!component) {
+        component = std::make_unique<Component>();
+        qCDebug(MAVLinkStatisticsLog) << "New component" << message.sysid << message.compid;
+    }
+
+    _record(*component, message, timeUSecs);
+}
+
+void MAVLinkStatistics::_record(Component &component, const mavlink_message_t &message, qint64 timeUSecs)
+{
+    uint32_t lostCount = 0;
+    if (component.seqValid) {
+        // Sequence numbers wrap at 256, a gap can not be told apart from a multiple of 256 lost messages
+        lostCount = static_cast<uint8_t>(message.seq - static_cast<uint8_t>(component.lastSeq + 1));
+    }
+    component.seqValid = true;
+    component.lastSeq = message.seq;
+
+    component.received++;
+    if (lostCount > 0) {
+        component.lost += lostCount;
+        component.burstLoss[burstBin(lostCount)]++;
+    }
+
+    const qint64 second = timeUSecs / 1000000;
+    Component::WindowBucket &bucket = component.window[second % kWindowSeconds];
+    if (bucket.second != second) {
+        bucket = { second, 0, 0 };
+    }
+    bucket.received++;
+    bucket.lost += lostCount;
+
+    // RFC 3550 style estimator, the change between consecutive arrival intervals stands in for the transit time
+    // difference since messages carry no common send time
+    if (component.lastArrivalUSecs >= 0) {
+        const qint64 intervalUSecs = timeUSecs - component.lastArrivalUSecs;
+        if (component.lastIntervalUSecs >= 0) {
+            const double deltaUSecs = qAbs(intervalUSecs - component.lastIntervalUSecs);
+            component.jitterUSecs += (deltaUSecs - component.jitterUSecs) / 16.0;
+        }
+        component.lastIntervalUSecs = intervalUSecs;
+    }
+    component.lastArrivalUSecs = timeUSecs;
+
+    if (message.msgid < kPagedMessageIds) {
+        std::unique_ptr<MessageCountPage> &page = component.messageCountPages[message.msgid >> 8];
+        if (!page) {
+            page = std::make_unique<MessageCountPage>();
+            page->fill(0);
+        }
+        (*page)[message.msgid & 0xFF]++;
+    } else {
+        component.otherMessageCount++;
+    }
+}
+
+MAVLinkStatistics::Snapshot MAVLinkStatistics::snapshot(uint8_t sysid, uint8_t compid, qint64 timeUSecs) const
+{
+    Snapshot snapshot;
+    snapshot.timeUSecs = timeUSecs;
+
+    QMutexLocker locker(&_mutex);
+
+    const System *const system = _systems[sysid].get();
+    const Component *const component = system ? system->components[compid].get() : nullptr;
+    if (!component) {
+        return snapshot;
+    }
+
+    snapshot.received = component->received;
+    snapshot.lost = component->lost;
+    snapshot.burstLoss = component->burstLoss;
+    snapshot.jitterMSecs = component->jitterUSecs / 1000.0;
+
+    const qint64 second = timeUSecs / 1000000;
+    for (const Component::WindowBucket &bucket : component->window) {
+        if ((bucket.second >= 0) && ((second - bucket.second) < kWindowSeconds)) {
+            snapshot.windowReceived += bucket.received;
+            snapshot.windowLost += bucket.lost;
+        }
+    }
+
+    for (uint32_t pageIndex = 0; pageIndex < component->messageCountPages.size(); pageIndex++) {
+        const MessageCountPage *const page = component->messageCountPages[pageIndex].get();
+        if (!page) {
+            continue;
+        }
+        for (uint32_t i = 0; i < page->size(); i++) {
+            if ((*page)[i] > 0) {
+                (void) snapshot.messageCounts.insert((pageIndex << 8) | i, (*page)[i]);
+            }
+        }
+    }
+    if (component->otherMessageCount > 0) {
+        (void) snapshot.messageCounts.insert(kOtherMessageIds, component->otherMessageCount);
+    }
+
+    return snapshot;
+}
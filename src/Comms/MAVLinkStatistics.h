@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+
+#include <array>
+#include <limits>
+#include <memory>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkStatisticsLog)
+
+/// Receive statistics of a single link endpoint, kept separately for each system/component seen on it.
+/// Recording a message is O(1): the component is found by direct indexing with sysid/compid and the counters
+/// are fixed size. Memory is only allocated the first time a system, component or range of message ids shows up.
+/// A single thread records, snapshots may be taken from any thread.
+class MAVLinkStatistics
+{
+public:
+    /// Burst loss histogram bins: 1, 2, 3-4, 5-8, 9-16, 17-32, 33-64, 65+ consecutive lost messages
+    static constexpr int kBurstBinCount = 8;
+    /// Windowed loss covers the last kWindowSeconds seconds
+    static constexpr int kWindowSeconds = 10;
+    /// Snapshot::messageCounts key for message ids above 65535, these are counted together
+    static constexpr uint32_t kOtherMessageIds = std::numeric_limits<uint32_t>::max();
+
+    struct Snapshot
+    {
+        /// Merges the statistics of another endpoint or component
+        void add(const Snapshot &other);
+
+        qint64 timeUSecs = 0;               ///< Time the snapshot was taken
+        quint64 received = 0;
+        quint64 lost = 0;
+        quint64 windowReceived = 0;         ///< Received within the window
+        quint64 windowLost = 0;             ///< Lost within the window
+        double jitterMSecs = 0;             ///< Inter-arrival jitter
+        std::array<quint64, kBurstBinCount> burstLoss{};
+        QHash<uint32_t, quint64> messageCounts; ///< Received messages for each message id
+
+        double lossPercent() const { return _percent(lost, received); }
+        double windowLossPercent() const { return _percent(windowLost, windowReceived); }
+
+    private:
+        static double _percent(quint64 lost, quint64 received) { return ((lost + received) ? ((100.0 * lost) / (lost + received)) : 0.0); }
+    };
+
+    MAVLinkStatistics();
+    ~MAVLinkStatistics();
+
+    /// Records a received message
+    ///     @param timeUSecs Monotonic arrival time
+    void record(const mavlink_message_t &message, qint64 timeUSecs);
+
+    /// @return Statistics of a system/component, empty if nothing was received from it
+    Snapshot snapshot(uint8_t sysid, uint8_t compid, qint64 timeUSecs) const;
+
+    /// @return Monotonic time to record and snapshot with
+    static qint64 currentTimeUSecs();
+
+    /// @return Burst loss histogram bin for a number of consecutive lost messages
+    static int burstBin(uint32_t lostCount);
+
+private:
+    /// Message counts for ids below kPagedMessageIds are kept in pages of 256 ids, allocated on first use
+    static constexpr uint32_t kPagedMessageIds = 65536;
+    using MessageCountPage = std::array<quint32, 256>;
+
+    struct Component
+    {
+        struct WindowBucket
+        {
+            qint64 second = -1;
+            quint32 received = 0;
+            quint32 lost = 0;
+        };
+
+        bool seqValid = false;
+        uint8_t lastSeq = 0;
+        quint64 received = 0;
+        quint64 lost = 0;
+        std::array<quint64, kBurstBinCount> burstLoss{};
+        std::array<WindowBucket, kWindowSeconds> window{};
+
+        qint64 lastArrivalUSecs = -1;
+        qint64 lastIntervalUSecs = -1;
+        double jitterUSecs = 0;
+
+        std::array<std::unique_ptr<MessageCountPage>, kPagedMessageIds / 256> messageCountPages;
+        quint64 otherMessageCount = 0;      ///< Message ids above the paged range
+    };
+
+    struct System
+    {
+        std::array<std::unique_ptr<Component>, 256> components;
+    };
+
+    static void _record(Component &component, const mavlink_message_t &message, qint64 timeUSecs);
+
+    mutable QMutex _mutex;
+    std::array<std::unique_ptr<System>, 256> _systems;
+};
@@ -169,6 +169,7 @@ private slots:
 private:
     bool _connect() override;
     void _writeBytes(const QByteArray &data) override;
+    int _radioByteRate() const override { return _serialConfig->baud() / 10; }
 
     const SerialConfiguration *_serialConfig = nullptr;
     SerialWorker *_worker = nullptr;
@@ -0,0 +1,331 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogIndex.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(TelemetryLogIndexLog, "qgc.comms.telemetrylogindex")
+
+namespace
+{
+
+constexpr qint64 kReadChunkSize = 1024 * 1024;
+
+} // namespace
+
+void TelemetryLogIndex::clear()
+{
+    _startTimeUSecs = 0;
+    _endTimeUSecs = 0;
+    _logFileSize = 0;
+    _recordCount = 0;
+    _checkpoints.clear();
+    _messageCounts.clear();
+    _events.clear();
+    _vehicleStates.clear();
+}
+
+void TelemetryLogIndex::addRecord(qint64 offset, qsizetype recordSize, quint64 timeUSecs, const mavlink_message_t &message)
+{
+    if (_recordCount == 0) {
+        _startTimeUSecs = timeUSecs;
+        _endTimeUSecs = timeUSecs;
+    }
+
+    // Checkpoints stay sorted by time even if the log clock jumped backwards
+    if (_checkpoints.isEmpty() || (timeUSecs >= (_checkpoints.last().timeUSecs + kCheckpointIntervalUSecs))) {
+        _checkpoints.append({ timeUSecs, offset });
+    }
+
+    _endTimeUSecs = qMax(_endTimeUSecs, timeUSecs);
+    _logFileSize = qMax(_logFileSize, offset + recordSize);
+    _recordCount++;
+    _messageCounts[message.msgid]++;
+
+    if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        _checkHeartbeat(offset, timeUSecs, message);
+    }
+}
+
+bool TelemetryLogIndex::addRecord(qint64 offset, const char *data, qsizetype size)
+{
+    quint64 timeUSecs = 0;
+    mavlink_message_t message{};
+    const qsizetype recordSize = parseRecord(data, size, timeUSecs, message);
+    if (recordSize == 0) {
+        return false;
+    }
+
+    addRecord(offset, recordSize, timeUSecs, message);
+    return true;
+}
+
+void TelemetryLogIndex::_checkHeartbeat(qint64 offset, quint64 timeUSecs, const mavlink_message_t &message)
+{
+    mavlink_heartbeat_t heartbeat{};
+    mavlink_msg_heartbeat_decode(&message, &heartbeat);
+
+    // Ground stations and components without an autopilot do not have a flight state. Cameras, gimbals and
+    // companion computers share the vehicle's sysid but report their own modes, only the autopilot's count.
+    if ((heartbeat.autopilot == MAV_AUTOPILOT_INVALID) || (heartbeat.type == MAV_TYPE_GCS) || (message.compid != MAV_COMP_ID_AUTOPILOT1)) {
+        return;
+    }
+
+    Event event;
+    event.timeUSecs = timeUSecs;
+    event.offset = offset;
+    event.sysid = message.sysid;
+    event.autopilot = heartbeat.autopilot;
+    event.vehicleType = heartbeat.type;
+    event.baseMode = heartbeat.base_mode;
+    event.customMode = heartbeat.custom_mode;
+
+    const bool armed = (heartbeat.base_mode & MAV_MODE_FLAG_SAFETY_ARMED);
+
+    const auto it = _vehicleStates.find(message.sysid);
+    if (it == _vehicleStates.end()) {
+        (void) _vehicleStates.insert(message.sysid, { heartbeat.base_mode, heartbeat.custom_mode });
+
+        event.type = EventType::ModeChanged;
+        _events.append(event);
+        if (armed) {
+            event.type = EventType::Armed;
+            _events.append(event);
+        }
+        return;
+    }
+
+    const bool wasArmed = (it->baseMode & MAV_MODE_FLAG_SAFETY_ARMED);
+    if (armed != wasArmed) {
+        event.type = armed ? EventType::Armed : EventType::Disarmed;
+        _events.append(event);
+    }
+    if (heartbeat.custom_mode != it->customMode) {
+        event.type = EventType::ModeChanged;
+        _events.append(event);
+    }
+
+    it->baseMode = heartbeat.base_mode;
+    it->customMode = heartbeat.custom_mode;
+}
+
+bool TelemetryLogIndex::build(QIODevice *device)
+{
+    clear();
+
+    const bool scanned = scan(device, [this](qint64 offset, qsizetype recordSize, quint64 timeUSecs, const mavlink_message_t &message) {
+        addRecord(offset, recordSize, timeUSecs, message);
+        return true;
+    });
+
+    _logFileSize = device->size();
+    _vehicleStates.clear();
+
+    qCDebug(TelemetryLogIndexLog) << "Indexed" << _recordCount << "records," << _checkpoints.count() << "checkpoints," << _events.count() << "events";
+
+    return (scanned && !isEmpty());
+}
+
+bool TelemetryLogIndex::scan(QIODevice *device, const RecordCallback &callback)
+{
+    if (!device->seek(0)) {
+        qCWarning(TelemetryLogIndexLog) << "Failed to seek log:" << device->errorString();
+        return false;
+    }
+
+    QByteArray buffer;
+    qint64 bufferOffset = 0;    ///< File offset of the first byte in buffer
+    qsizetype pos = 0;
+    bool atEnd = false;
+
+    mavlink_message_t message{};
+    while (true) {
+        if (!atEnd && ((buffer.size() - pos) < kMaxRecordSize)) {
+            buffer.remove(0, pos);
+            bufferOffset += pos;
+            pos = 0;
+
+            const QByteArray chunk = device->read(kReadChunkSize);
+            if (chunk.isEmpty()) {
+                atEnd = true;
+            } else {
+                buffer.append(chunk);
+            }
+            continue;
+        }
+
+        if (pos >= buffer.size()) {
+            break;
+        }
+
+        quint64 timeUSecs = 0;
+        const qsizetype recordSize = parseRecord(buffer.constData() + pos, buffer.size() - pos, timeUSecs, message);
+        if (recordSize == 0) {
+            // Resync on the next byte, same as a byte by byte parse of the log would
+            pos++;
+            continue;
+        }
+
+        if (!callback(bufferOffset + pos, recordSize, timeUSecs, message)) {
+            return false;
+        }
+        pos += recordSize;
+    }
+
+    return true;
+}
+
+qint64 TelemetryLogIndex::checkpointOffset(quint64 timeUSecs) const
+{
+    if (_checkpoints.isEmpty()) {
+        return -1;
+    }
+
+    const auto it = std::upper_bound(_checkpoints.cbegin(), _checkpoints.cend(), timeUSecs, [](quint64 time, const Checkpoint &checkpoint) {
+        return (time < checkpoint.timeUSecs);
+    });
+
+    return ((it == _checkpoints.cbegin()) ? _checkpoints.first().offset : std::prev(it)->offset);
+}
+
+bool TelemetryLogIndex::save(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(TelemetryLogIndexLog) << "Unable to write index" << fileName << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << kFileMagic << kFileVersion << _logFileSize;
+    stream << _startTimeUSecs << _endTimeUSecs << _recordCount;
+
+    stream << static_cast<quint32>(_checkpoints.count());
+    for (const Checkpoint &checkpoint : _checkpoints) {
+        stream << checkpoint.timeUSecs << checkpoint.offset;
+    }
+
+    stream << _messageCounts;
+
+    stream << static_cast<quint32>(_events.count());
+    for (const Event &event : _events) {
+        stream << event.timeUSecs << event.offset << static_cast<quint8>(event.type) << event.sysid << event.autopilot << event.vehicleType << event.baseMode << event.customMode;
+    }
+
+    if ((stream.status() != QDataStream::Ok) || !file.commit()) {
+        qCWarning(TelemetryLogIndexLog) << "Unable to write index" << fileName << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool TelemetryLogIndex::load(const QString &fileName, qint64 logFileSize)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 indexedFileSize = 0;
+    stream >> magic >> version >> indexedFileSize;
+    if ((magic != kFileMagic) || (version != kFileVersion) || (indexedFileSize != logFileSize)) {
+        qCDebug(TelemetryLogIndexLog) << "Index does not match log" << fileName << version << indexedFileSize << logFileSize;
+        return false;
+    }
+
+    TelemetryLogIndex index;
+    index._logFileSize = indexedFileSize;
+    stream >> index._startTimeUSecs >> index._endTimeUSecs >> index._recordCount;
+
+    // Each entry takes at least 16 bytes, do not trust the count for the allocation
+    quint32 count = 0;
+    stream >> count;
+    index._checkpoints.reserve(qMin<qint64>(count, file.size() / 16));
+    for (quint32 i = 0; (i < count) && (stream.status() == QDataStream::Ok); i++) {
+        Checkpoint checkpoint;
+        stream >> checkpoint.timeUSecs >> checkpoint.offset;
+        index._checkpoints.append(checkpoint);
+    }
+
+    stream >> index._messageCounts;
+
+    stream >> count;
+    for (quint32 i = 0; (i < count) && (stream.status() == QDataStream::Ok); i++) {
+        Event event;
+        quint8 type = 0;
+        stream >> event.timeUSecs >> event.offset >> type >> event.sysid >> event.autopilot >> event.vehicleType >> event.baseMode >> event.customMode;
+        event.type = static_cast<EventType>(type);
+        index._events.append(event);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(TelemetryLogIndexLog) << "Index is corrupt" << fileName;
+        return false;
+    }
+
+    *this = std::move(index);
+    return true;
+}
+
+qsizetype TelemetryLogIndex::parseRecord(const char *data, qsizetype size, quint64 &timeUSecs, mavlink_message_t &message)
+{
+    constexpr qsizetype timestampSize = sizeof(quint64);
+    if (size <= timestampSize) {
+        return 0;
+    }
+
+    const uint8_t stx = static_cast<uint8_t>(data[timestampSize]);
+    if ((stx != MAVLINK_STX) && (stx != MAVLINK_STX_MAVLINK1)) {
+        return 0;
+    }
+
+    // Private parser state, the index is built without touching any MAVLink channel
+    mavlink_status_t status{};
+    mavlink_message_t rxMessage{};
+    const qsizetype maxFrameSize = qMin<qsizetype>(size - timestampSize, MAVLINK_MAX_PACKET_LEN);
+    for (qsizetype i = 0; i < maxFrameSize; i++) {
+        const uint8_t result = mavlink_frame_char_buffer(&rxMessage, &status, static_cast<uint8_t>(data[timestampSize + i]), &message, nullptr);
+        if (result == MAVLINK_FRAMING_OK) {
+            timeUSecs = parseTimestamp(data);
+            return (timestampSize + i + 1);
+        }
+        if ((result != MAVLINK_FRAMING_INCOMPLETE) || (status.parse_state == MAVLINK_PARSE_STATE_IDLE)) {
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+quint64 TelemetryLogIndex::parseTimestamp(const char *data)
+{
+    const quint64 currentTimestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+    quint64 timestamp = qFromBigEndian<quint64>(data);
+    if (timestamp > currentTimestamp) {
+        timestamp = qbswap(timestamp);
+    }
+
+    return timestamp;
+}
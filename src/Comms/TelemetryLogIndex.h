@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+
+#include <functional>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryLogIndexLog)
+
+class QIODevice;
+
+/// Time index for a telemetry log (tlog), stored next to the log as a sidecar file.
+/// A checkpoint (log time -> file offset of the record) is kept every kCheckpointIntervalUSecs of log time, which
+/// allows seeking by time with a binary search plus a short forward scan. The index also holds the log start/end
+/// time, the number of records per message id and a list of vehicle events (arm/disarm, flight mode changes).
+/// The index is either built while the log is recorded or by scanning the log the first time it is opened.
+class TelemetryLogIndex
+{
+public:
+    enum class EventType : uint8_t {
+        Armed,
+        Disarmed,
+        ModeChanged,
+    };
+
+    struct Checkpoint
+    {
+        quint64 timeUSecs = 0;
+        qint64 offset = 0;      ///< File offset of the record (timestamp) start
+    };
+
+    struct Event
+    {
+        quint64 timeUSecs = 0;
+        qint64 offset = 0;
+        EventType type = EventType::ModeChanged;
+        uint8_t sysid = 0;
+        uint8_t autopilot = MAV_AUTOPILOT_GENERIC;
+        uint8_t vehicleType = MAV_TYPE_GENERIC;
+        uint8_t baseMode = 0;
+        uint32_t customMode = 0;
+    };
+
+    /// @return false: Stop scanning
+    using RecordCallback = std::function<bool(qint64 offset, qsizetype recordSize, quint64 timeUSecs, const mavlink_message_t &message)>;
+
+    TelemetryLogIndex() = default;
+
+    void clear();
+    bool isEmpty() const { return (_recordCount == 0); }
+
+    /// Adds a record to the index. Records must be added in file order.
+    ///     @param offset File offset of the record start
+    ///     @param recordSize Size of the record (timestamp + frame)
+    void addRecord(qint64 offset, qsizetype recordSize, quint64 timeUSecs, const mavlink_message_t &message);
+
+    /// Adds a serialized record (big endian timestamp + frame) to the index
+    ///     @return false: Data does not hold a valid record
+    bool addRecord(qint64 offset, const char *data, qsizetype size);
+
+    /// Builds the index by scanning the whole log. The device position is changed.
+    ///     @return false: Log does not contain any valid record
+    bool build(QIODevice *device);
+
+    /// Loads the index from the file, fails if the index does not match the log size
+    bool load(const QString &fileName, qint64 logFileSize);
+    bool save(const QString &fileName) const;
+
+    /// @return Offset of the last checkpoint at or before the specified log time, -1 if the index is empty
+    qint64 checkpointOffset(quint64 timeUSecs) const;
+
+    quint64 startTimeUSecs() const { return _startTimeUSecs; }
+    quint64 endTimeUSecs() const { return _endTimeUSecs; }
+    quint64 durationUSecs() const { return (_endTimeUSecs - _startTimeUSecs); }
+    qint64 logFileSize() const { return _logFileSize; }
+    quint64 recordCount() const { return _recordCount; }
+    const QList<Checkpoint> &checkpoints() const { return _checkpoints; }
+    const QMap<uint32_t, quint64> &messageCounts() const { return _messageCounts; }
+    const QList<Event> &events() const { return _events; }
+
+    /// Reads all valid records of a log from the start, garbage between records is skipped.
+    /// Does not use any MAVLink channel, so logs can be scanned from multiple threads.
+    ///     @return false: Log could not be read or the callback stopped the scan
+    static bool scan(QIODevice *device, const RecordCallback &callback);
+
+    /// Parses the record at the start of data
+    ///     @return Size of the record, 0 if data does not start with a valid record
+    static qsizetype parseRecord(const char *data, qsizetype size, quint64 &timeUSecs, mavlink_message_t &message);
+
+    /// Reads a tlog timestamp, logs written with the wrong byte order are detected and swapped
+    static quint64 parseTimestamp(const char *data);
+
+    static QString sidecarFileName(const QString &logFileName) { return (logFileName + QStringLiteral(".idx")); }
+
+    static constexpr quint64 kCheckpointIntervalUSecs = 100000;
+    static constexpr qsizetype kMaxRecordSize = sizeof(quint64) + MAVLINK_MAX_PACKET_LEN;
+
+private:
+    void _checkHeartbeat(qint64 offset, quint64 timeUSecs, const mavlink_message_t &message);
+
+    struct VehicleState
+    {
+        uint8_t baseMode = 0;
+        uint32_t customMode = 0;
+    };
+
+    quint64 _startTimeUSecs = 0;
+    quint64 _endTimeUSecs = 0;
+    qint64 _logFileSize = 0;
+    quint64 _recordCount = 0;
+    QList<Checkpoint> _checkpoints;
+    QMap<uint32_t, quint64> _messageCounts;
+    QList<Event> _events;
+    QHash<uint8_t, VehicleState> _vehicleStates;   ///< Only used while adding records
+
+    static constexpr quint32 kFileMagic = 0x51544c49;   ///< "QTLI"
+    static constexpr quint32 kFileVersion = 1;
+};
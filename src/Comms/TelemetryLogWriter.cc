@@ -0,0 +1,335 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogWriter.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFileDevice>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QtEndian>
+
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+QGC_LOGGING_CATEGORY(TelemetryLogWriterLog, "qgc.comms.telemetrylogwriter")
+
+namespace
+{
+
+/// @return Length of the MAVLink frame at the start of data, 0 if data does not start with a complete frame
+qsizetype _frameLength(const char *data, qsizetype size)
+{
+    if (size < 3) {
+        return 0;
+    }
+
+    const uint8_t payloadLen = static_cast<uint8_t>(data[1]);
+    qsizetype frameLen = 0;
+    switch (static_cast<uint8_t>(data[0])) {
+    case MAVLINK_STX_MAVLINK1:
+        frameLen = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + payloadLen + MAVLINK_NUM_CHECKSUM_BYTES;
+        break;
+    case MAVLINK_STX:
+        frameLen = MAVLINK_CORE_HEADER_LEN + 1 + payloadLen + MAVLINK_NUM_CHECKSUM_BYTES;
+        if (static_cast<uint8_t>(data[2]) & MAVLINK_IFLAG_SIGNED) {
+            frameLen += MAVLINK_SIGNATURE_BLOCK_LEN;
+        }
+        break;
+    default:
+        return 0;
+    }
+
+    return ((frameLen <= size) ? frameLen : 0);
+}
+
+} // namespace
+
+TelemetryLogWriter::TelemetryLogWriter(QObject *parent)
+    : QThread(parent)
+    , _slots(new Slot[kRingSlots])
+{
+    // qCDebug(TelemetryLogWriterLog) << Q_FUNC_INFO << this;
+
+    static_assert((kRingSlots & (kRingSlots - 1)) == 0, "kRingSlots must be a power of two");
+
+    for (int i = 0; i < kRingSlots; i++) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    _monotonicClock.start();
+    _anchorClock();
+
+    _writeBuffer.reserve(kWriteBufferSize + sizeof(Slot::data));
+}
+
+TelemetryLogWriter::~TelemetryLogWriter()
+{
+    stopLogging();
+
+    // qCDebug(TelemetryLogWriterLog) << Q_FUNC_INFO << this;
+}
+
+quint64 TelemetryLogWriter::timestampUsecs() const
+{
+    return (_clockBaseUsecs.load(std::memory_order_relaxed) + static_cast<quint64>(_monotonicClock.nsecsElapsed() / 1000));
+}
+
+void TelemetryLogWriter::_anchorClock()
+{
+    const quint64 wallClockUsecs = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+    _clockBaseUsecs = wallClockUsecs - static_cast<quint64>(_monotonicClock.nsecsElapsed() / 1000);
+}
+
+int TelemetryLogWriter::queueDepth() const
+{
+    return static_cast<int>(_enqueuePos.load(std::memory_order_relaxed) - _dequeuePos.load(std::memory_order_relaxed));
+}
+
+void TelemetryLogWriter::startLogging(QFileDevice *file, int syncIntervalMSecs)
+{
+    if (isRunning()) {
+        qCWarning(TelemetryLogWriterLog) << "Already logging";
+        return;
+    }
+
+    // Left overs of a previous log must not end up in this one
+    _discardQueuedRecords();
+
+    _file = file;
+    _syncIntervalMSecs = syncIntervalMSecs;
+    _stopRequested = false;
+    _maxQueueDepth = 0;
+    _writtenBytes = 0;
+    _writeBuffer.clear();
+    _logIndex.clear();
+
+    // The wall clock may have been adjusted since the last log, this one starts from the current time
+    _anchorClock();
+
+    _logging = true;
+    start(QThread::LowPriority);
+}
+
+void TelemetryLogWriter::stopLogging()
+{
+    if (!isRunning()) {
+        _logging = false;
+        return;
+    }
+
+    _logging = false;
+
+    _wakeMutex.lock();
+    _stopRequested = true;
+    _wakeCondition.wakeAll();
+    _wakeMutex.unlock();
+
+    (void) wait();
+
+    qCDebug(TelemetryLogWriterLog) << "Stopped - written bytes" << writtenBytes() << "max queue depth" << maxQueueDepth() << "dropped records" << droppedRecords();
+
+    _file = nullptr;
+}
+
+bool TelemetryLogWriter::logMessage(const mavlink_message_t &message)
+{
+    if (!_logging) {
+        return false;
+    }
+
+    const quint64 timestamp = timestampUsecs();
+    return _push([&message, timestamp](char *data) -> quint16 {
+        qToBigEndian(timestamp, data);
+        return static_cast<quint16>(sizeof(timestamp) + mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t*>(data + sizeof(timestamp)), &message));
+    });
+}
+
+bool TelemetryLogWriter::logBytes(const QByteArray &data)
+{
+    if (!_logging) {
+        return false;
+    }
+
+    const quint64 timestamp = timestampUsecs();
+    bool queued = true;
+
+    qsizetype offset = 0;
+    while (offset < data.size()) {
+        const char *const bytes = data.constData() + offset;
+        const qsizetype remaining = data.size() - offset;
+
+        // Keep frames whole, anything unrecognized goes out in packet sized chunks
+        qsizetype recordLen = _frameLength(bytes, remaining);
+        if (recordLen == 0) {
+            recordLen = qMin<qsizetype>(remaining, MAVLINK_MAX_PACKET_LEN);
+        }
+
+        queued &= _push([bytes, recordLen, timestamp](char *slotData) -> quint16 {
+            qToBigEndian(timestamp, slotData);
+            (void) memcpy(slotData + sizeof(timestamp), bytes, recordLen);
+            return static_cast<quint16>(sizeof(timestamp) + recordLen);
+        });
+
+        offset += recordLen;
+    }
+
+    return queued;
+}
+
+/// Bounded multi producer queue (Vyukov). Each slot carries a sequence number telling whether it is free for the
+/// producer at that position or holds a record for the consumer.
+template<typename Serializer>
+bool TelemetryLogWriter::_push(Serializer serializer)
+{
+    quint64 pos = _enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    while (true) {
+        slot = &_slots[pos & (kRingSlots - 1)];
+        const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        const qint64 diff = static_cast<qint64>(sequence) - static_cast<qint64>(pos);
+        if (diff == 0) {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            _droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->length = serializer(slot->data);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+void TelemetryLogWriter::run()
+{
+    _syncTimer.start();
+
+    bool ok = true;
+    while (ok) {
+        _wakeMutex.lock();
+        if (!_stopRequested) {
+            (void) _wakeCondition.wait(&_wakeMutex, kFlushIntervalMSecs);
+        }
+        const bool stopRequested = _stopRequested;
+        _wakeMutex.unlock();
+
+        ok = _writeQueuedRecords() && _flushWriteBuffer();
+        if (!ok || stopRequested) {
+            break;
+        }
+
+        if ((_syncIntervalMSecs > 0) && _syncTimer.hasExpired(_syncIntervalMSecs)) {
+            _syncToStorage();
+            _syncTimer.restart();
+        }
+
+        const quint64 dropped = droppedRecords();
+        if (dropped != _reportedDroppedRecords) {
+            qCWarning(TelemetryLogWriterLog) << "Log queue full, dropped" << (dropped - _reportedDroppedRecords) << "records";
+            _reportedDroppedRecords = dropped;
+        }
+    }
+
+    if (!ok) {
+        _logging = false;
+        qCWarning(TelemetryLogWriterLog) << "Write failed" << _file->errorString();
+        emit writeFailed();
+        return;
+    }
+
+    _syncToStorage();
+}
+
+bool TelemetryLogWriter::_writeQueuedRecords()
+{
+    const int depth = queueDepth();
+    if (depth > _maxQueueDepth) {
+        _maxQueueDepth = depth;
+    }
+
+    quint64 pos = _dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = _slots[pos & (kRingSlots - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != (pos + 1)) {
+            break;
+        }
+
+        (void) _logIndex.addRecord(static_cast<qint64>(_writtenBytes + _writeBuffer.size()), slot.data, slot.length);
+        (void) _writeBuffer.append(slot.data, slot.length);
+        slot.sequence.store(pos + kRingSlots, std::memory_order_release);
+        _dequeuePos.store(++pos, std::memory_order_relaxed);
+
+        if ((_writeBuffer.size() >= kWriteBufferSize) && !_flushWriteBuffer()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TelemetryLogWriter::_flushWriteBuffer()
+{
+    if (_writeBuffer.isEmpty()) {
+        return true;
+    }
+
+    const qint64 written = _file->write(_writeBuffer);
+    if (written != _writeBuffer.size()) {
+        return false;
+    }
+
+    _writtenBytes += written;
+    _writeBuffer.clear();
+
+    return true;
+}
+
+void TelemetryLogWriter::_syncToStorage()
+{
+    if (!_file->flush()) {
+        return;
+    }
+
+    const int handle = _file->handle();
+    if (handle < 0) {
+        return;
+    }
+
+#ifdef Q_OS_WIN
+    (void) _commit(handle);
+#else
+    (void) ::fsync(handle);
+#endif
+}
+
+/// Only called while the writer thread is not running
+void TelemetryLogWriter::_discardQueuedRecords()
+{
+    quint64 pos = _dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = _slots[pos & (kRingSlots - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != (pos + 1)) {
+            break;
+        }
+
+        slot.sequence.store(pos + kRingSlots, std::memory_order_release);
+        _dequeuePos.store(++pos, std::memory_order_relaxed);
+    }
+}
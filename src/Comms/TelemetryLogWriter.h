@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+#include "MAVLinkLib.h"
+#include "TelemetryLogIndex.h"
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryLogWriterLog)
+
+class QFileDevice;
+
+/// Writes the telemetry log (tlog) from a background thread.
+/// Producers serialize timestamped frames straight into the slots of a lock-free ring, they never wait on the disk.
+/// The writer thread drains the ring into large sequential writes and syncs the file to storage at a configurable
+/// interval. When the ring is full new records are dropped and counted.
+/// The tlog timestamps come from a monotonic clock anchored to the wall clock when logging starts.
+/// While writing, the writer thread also builds the time index of the log.
+class TelemetryLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit TelemetryLogWriter(QObject *parent = nullptr);
+    ~TelemetryLogWriter();
+
+    /// Starts writing to the already open file
+    ///     @param syncIntervalMSecs Interval for syncing the file to storage, 0: only when stopped
+    void startLogging(QFileDevice *file, int syncIntervalMSecs);
+
+    /// Writes out all queued records and stops the writer thread. The file can be closed afterwards.
+    void stopLogging();
+
+    /// true: Writer accepts records. Thread safe.
+    bool isLogging() const { return _logging; }
+
+    /// Queues a message for the log. Thread safe, does not block.
+    ///     @return false: Record was dropped
+    bool logMessage(const mavlink_message_t &message);
+
+    /// Queues raw outgoing bytes for the log, one record per MAVLink frame. Thread safe, does not block.
+    ///     @return false: At least one record was dropped
+    bool logBytes(const QByteArray &data);
+
+    /// Microseconds since the unix epoch, monotonic while logging. Thread safe.
+    quint64 timestampUsecs() const;
+
+    quint64 droppedRecords() const { return _droppedRecords; }
+    quint64 writtenBytes() const { return _writtenBytes; }
+    int queueDepth() const;
+    int maxQueueDepth() const { return _maxQueueDepth; }
+
+    /// Index of the records written since logging was started. Only valid while the writer is stopped.
+    const TelemetryLogIndex &logIndex() const { return _logIndex; }
+
+    static constexpr int kRingSlots = 4096;     ///< Must be a power of two
+
+signals:
+    /// Emitted from the writer thread when a write to the file fails. Logging is stopped.
+    void writeFailed();
+
+protected:
+    void run() final;
+
+private:
+    struct Slot {
+        std::atomic<quint64> sequence;
+        quint16 length;
+        char data[sizeof(quint64) + MAVLINK_MAX_PACKET_LEN];
+    };
+
+    /// Reserves a slot, lets the producer serialize into it and publishes it
+    template<typename Serializer>
+    bool _push(Serializer serializer);
+
+    /// Drains the ring into the file
+    ///     @return false: Write failed
+    bool _writeQueuedRecords();
+    bool _flushWriteBuffer();
+    void _syncToStorage();
+    void _discardQueuedRecords();
+    /// Lines the monotonic clock up with the wall clock
+    void _anchorClock();
+
+    std::unique_ptr<Slot[]> _slots;
+    alignas(64) std::atomic<quint64> _enqueuePos = 0;
+    alignas(64) std::atomic<quint64> _dequeuePos = 0;   ///< Only advanced by the consumer
+
+    QFileDevice *_file = nullptr;
+    QByteArray _writeBuffer;
+    TelemetryLogIndex _logIndex;
+    int _syncIntervalMSecs = 0;
+    QElapsedTimer _syncTimer;
+
+    QMutex _wakeMutex;
+    QWaitCondition _wakeCondition;
+    bool _stopRequested = false;
+
+    QElapsedTimer _monotonicClock;                  ///< Runs from construction, never restarted
+    std::atomic<quint64> _clockBaseUsecs = 0;       ///< Wall clock time of _monotonicClock's start
+
+    std::atomic_bool _logging = false;
+    std::atomic<quint64> _droppedRecords = 0;
+    std::atomic<quint64> _writtenBytes = 0;
+    std::atomic_int _maxQueueDepth = 0;
+    quint64 _reportedDroppedRecords = 0;
+
+    static constexpr int kFlushIntervalMSecs = 100;        ///< Writer thread wake up interval
+    static constexpr qsizetype kWriteBufferSize = 64 * 1024;
+};
@@ -0,0 +1,191 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UDPBatchIO.h"
+#include "UDPLink.h"
+
+#include <QtCore/QtEndian>
+#include <QtNetwork/QNetworkDatagram>
+#include <QtNetwork/QUdpSocket>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <vector>
+#endif
+
+UDPBatchIO::UDPBatchIO()
+{
+    // qCDebug(UDPLinkLog) << Q_FUNC_INFO << this;
+}
+
+UDPBatchIO::~UDPBatchIO()
+{
+    // qCDebug(UDPLinkLog) << Q_FUNC_INFO << this;
+}
+
+bool UDPBatchIO::isBatchingSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+qsizetype UDPBatchIO::receive(QUdpSocket *socket, QList<UDPDatagram> &datagrams, qsizetype maxDatagrams)
+{
+    qsizetype count = 0;
+
+    // The first datagram always goes through the socket. QUdpSocket disables its read notifier until a datagram is
+    // read through it, reading only from the descriptor would stop readyRead for good.
+    while ((count < maxDatagrams) && socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = socket->receiveDatagram();
+        count++;
+        if (!datagram.isNull() && !datagram.data().isEmpty()) {
+            datagrams.append({ datagram.data(), datagram.senderAddress(), static_cast<quint16>(datagram.senderPort()) });
+        }
+#ifdef Q_OS_LINUX
+        break;
+#endif
+    }
+
+#ifdef Q_OS_LINUX
+    const qintptr socketDescriptor = socket->socketDescriptor();
+    if ((count > 0) && (socketDescriptor != -1)) {
+        while (count < maxDatagrams) {
+            const qsizetype batchSize = qMin(maxDatagrams - count, kMaxBatchSize);
+            const qsizetype received = _receiveBatch(socketDescriptor, datagrams, batchSize);
+            count += received;
+            if (received < batchSize) {
+                break;
+            }
+        }
+    }
+#endif
+
+    return count;
+}
+
+#ifdef Q_OS_LINUX
+qsizetype UDPBatchIO::_receiveBatch(qintptr socketDescriptor, QList<UDPDatagram> &datagrams, qsizetype maxDatagrams)
+{
+    if (_receiveBuffer.isEmpty()) {
+        _receiveBuffer.resize(kMaxBatchSize * kMaxDatagramSize);
+    }
+
+    mmsghdr messages[kMaxBatchSize]{};
+    iovec iovecs[kMaxBatchSize]{};
+    sockaddr_storage senders[kMaxBatchSize]{};
+    for (qsizetype i = 0; i < maxDatagrams; i++) {
+        iovecs[i].iov_base = _receiveBuffer.data() + (i * kMaxDatagramSize);
+        iovecs[i].iov_len = kMaxDatagramSize;
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &senders[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+    }
+
+    int received = -1;
+    do {
+        received = ::recvmmsg(static_cast<int>(socketDescriptor), messages, static_cast<unsigned int>(maxDatagrams), MSG_DONTWAIT, nullptr);
+    } while ((received < 0) && (errno == EINTR));
+
+    if (received <= 0) {
+        if ((received < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+            qCWarning(UDPLinkLog) << "recvmmsg failed:" << qt_error_string(errno);
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < received; i++) {
+        const mmsghdr &message = messages[i];
+        if (message.msg_len == 0) {
+            continue;
+        }
+        if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+            qCWarning(UDPLinkLog) << "Datagram truncated to" << kMaxDatagramSize << "bytes";
+        }
+
+        const QHostAddress senderAddress(reinterpret_cast<const sockaddr*>(&senders[i]));
+        quint16 senderPort = 0;
+        if (senders[i].ss_family == AF_INET) {
+            senderPort = qFromBigEndian(reinterpret_cast<const sockaddr_in*>(&senders[i])->sin_port);
+        } else if (senders[i].ss_family == AF_INET6) {
+            senderPort = qFromBigEndian(reinterpret_cast<const sockaddr_in6*>(&senders[i])->sin6_port);
+        }
+
+        datagrams.append({ QByteArray(static_cast<const char*>(iovecs[i].iov_base), message.msg_len), senderAddress, senderPort });
+    }
+
+    return received;
+}
+#endif
+
+qsizetype UDPBatchIO::send(QUdpSocket *socket, const QByteArray &data, const QList<std::shared_ptr<UDPClient>> &targets)
+{
+    qsizetype failed = 0;
+
+#ifdef Q_OS_LINUX
+    const qintptr socketDescriptor = socket->socketDescriptor();
+
+    // The socket is bound to IPv4, anything else takes the QUdpSocket path
+    std::vector<sockaddr_in> addresses;
+    addresses.reserve(targets.size());
+    for (const std::shared_ptr<UDPClient> &target : targets) {
+        if ((socketDescriptor != -1) && (target->address.protocol() == QAbstractSocket::IPv4Protocol)) {
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = qToBigEndian(target->port);
+            address.sin_addr.s_addr = qToBigEndian(target->address.toIPv4Address());
+            addresses.push_back(address);
+        } else if (socket->writeDatagram(data, target->address, target->port) < 0) {
+            failed++;
+        }
+    }
+
+    if (addresses.empty()) {
+        return failed;
+    }
+
+    // All messages share the payload
+    iovec payload{ const_cast<char*>(data.constData()), static_cast<size_t>(data.size()) };
+    std::vector<mmsghdr> messages(addresses.size());
+    for (size_t i = 0; i < addresses.size(); i++) {
+        messages[i].msg_hdr.msg_iov = &payload;
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    size_t sentCount = 0;
+    while (sentCount < messages.size()) {
+        const int sent = ::sendmmsg(static_cast<int>(socketDescriptor), messages.data() + sentCount, static_cast<unsigned int>(messages.size() - sentCount), MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Same as a failed writeDatagram, the datagram is lost for this target only
+            failed++;
+            sentCount++;
+            continue;
+        }
+        sentCount += static_cast<size_t>(sent);
+    }
+#else
+    for (const std::shared_ptr<UDPClient> &target : targets) {
+        if (socket->writeDatagram(data, target->address, target->port) < 0) {
+            failed++;
+        }
+    }
+#endif
+
+    return failed;
+}
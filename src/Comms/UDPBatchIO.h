@@ -0,0 +1,60 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtNetwork/QHostAddress>
+
+#include <memory>
+
+struct UDPClient;
+class QUdpSocket;
+
+struct UDPDatagram
+{
+    QByteArray data;
+    QHostAddress senderAddress;
+    quint16 senderPort = 0;
+    quint32 endpointId = 0;     ///< Session target of the sender, set by UDPWorker
+};
+
+/// Batched datagram I/O for a bound QUdpSocket.
+/// On Linux (and Android) many datagrams are moved per system call with recvmmsg/sendmmsg, other platforms fall
+/// back to one QUdpSocket call per datagram. Must be used on the thread which owns the socket.
+class UDPBatchIO
+{
+public:
+    UDPBatchIO();
+    ~UDPBatchIO();
+
+    /// Reads pending datagrams without blocking, empty datagrams are dropped
+    ///     @param datagrams Received datagrams are appended
+    ///     @return Number of datagrams read, a value below maxDatagrams means no datagram is pending anymore
+    qsizetype receive(QUdpSocket *socket, QList<UDPDatagram> &datagrams, qsizetype maxDatagrams = kMaxBatchSize);
+
+    /// Sends the same datagram to all targets
+    ///     @return Number of targets the datagram could not be sent to
+    static qsizetype send(QUdpSocket *socket, const QByteArray &data, const QList<std::shared_ptr<UDPClient>> &targets);
+
+    /// @return true: recvmmsg/sendmmsg are used
+    static bool isBatchingSupported();
+
+    static constexpr qsizetype kMaxBatchSize = 64;
+    /// Larger datagrams are truncated on the batched path, MAVLink senders stay far below this
+    static constexpr qsizetype kMaxDatagramSize = 8 * 1024;
+
+private:
+#ifdef Q_OS_LINUX
+    qsizetype _receiveBatch(qintptr socketDescriptor, QList<UDPDatagram> &datagrams, qsizetype maxDatagrams);
+
+    QByteArray _receiveBuffer;  ///< kMaxBatchSize slots of kMaxDatagramSize, allocated on first use
+#endif
+};
@@ -16,7 +16,6 @@
 #include <QtCore/QMutexLocker>
 #include <QtCore/QThread>
 #include <QtNetwork/QHostInfo>
-#include <QtNetwork/QNetworkDatagram>
 #include <QtNetwork/QNetworkInterface>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QUdpSocket>
@@ -371,7 +370,9 @@ void UDPWorker::disconnectLink()
         _socket->close();
     }
 
+    QMutexLocker locker(&_sessionTargetsMutex);
     _sessionTargets.clear();
+    _sessionTargetEndpointIds.clear();
 }
 
 void UDPWorker::writeData(const QByteArray &data)
@@ -381,26 +382,27 @@ void UDPWorker::writeData(const QByteArray &data)
         return;
     }
 
+    // Snapshot the targets, the lock is not held during the send
+    QList<std::shared_ptr<UDPClient>> targets;
     QMutexLocker locker(&_sessionTargetsMutex);
 
     // Send to all manually targeted systems
     for (const std::shared_ptr<UDPClient> &target : _udpConfig->targetHosts()) {
         if (!containsTarget(_sessionTargets, target->address, target->port)) {
-            if (_socket->writeDatagram(data, target->address, target->port) < 0) {
-                qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
-            }
+            targets.append(target);
         }
     }
 
     // Send to all connected systems
-    for (const std::shared_ptr<UDPClient> &target: _sessionTargets) {
-        if (_socket->writeDatagram(data, target->address, target->port) < 0) {
-            qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
-        }
-    }
+    targets.append(_sessionTargets);
 
     locker.unlock();
 
+    const qsizetype failedCount = UDPBatchIO::send(_socket, data, targets);
+    if (failedCount > 0) {
+        qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!" << failedCount << "of" << targets.size() << "targets";
+    }
+
     emit dataSent(data);
 }
 
@@ -427,49 +429,70 @@ void UDPWorker::_onSocketReadyRead()
         return;
     }
 
-    const qint64 byteCount = _socket->pendingDatagramSize();
-    if (byteCount <= 0) {
-        emit errorOccurred(tr("Could Not Read Data - No Data Available!"));
-        return;
-    }
-
-    QByteArray buffer;
-    buffer.reserve(BUFFER_TRIGGER_SIZE);
+    QList<UDPDatagram> datagrams;
+    datagrams.reserve(UDPBatchIO::kMaxBatchSize);
+    qsizetype byteCount = 0;
+    bool received = false;
     QElapsedTimer timer;
     timer.start();
-    bool received = false;
-    while (_socket->hasPendingDatagrams()) {
-        const QNetworkDatagram datagramIn = _socket->receiveDatagram();
-        if (datagramIn.isNull() || datagramIn.data().isEmpty()) {
-            continue;
+    while (true) {
+        const qsizetype firstNew = datagrams.size();
+        const qsizetype readCount = _batchIO.receive(_socket, datagrams);
+        for (qsizetype i = firstNew; i < datagrams.size(); i++) {
+            byteCount += datagrams.at(i).data.size();
         }
 
-        (void) buffer.append(datagramIn.data());
-
-        if ((buffer.size() > BUFFER_TRIGGER_SIZE) || (timer.elapsed() > RECEIVE_TIME_LIMIT_MS)) {
+        if (!datagrams.isEmpty() && ((byteCount > BUFFER_TRIGGER_SIZE) || (timer.elapsed() > RECEIVE_TIME_LIMIT_MS))) {
             received = true;
-            emit dataReceived(buffer);
-            buffer.clear();
+            _emitDatagrams(datagrams);
+            datagrams.clear();
+            byteCount = 0;
             (void) timer.restart();
         }
 
-        const bool ipLocal = datagramIn.senderAddress().isLoopback() || _localAddresses.contains(datagramIn.senderAddress());
-        const QHostAddress senderAddress = ipLocal ? QHostAddress(QHostAddress::SpecialAddress::LocalHost) : datagramIn.senderAddress();
-
-        QMutexLocker locker(&_sessionTargetsMutex);
-        if (!containsTarget(_sessionTargets, senderAddress, datagramIn.senderPort())) {
-            qCDebug(UDPLinkLog) << "UDP Adding target:" << senderAddress << datagramIn.senderPort();
-            _sessionTargets.append(std::make_shared<UDPClient>(senderAddress, datagramIn.senderPort()));
+        if (readCount < UDPBatchIO::kMaxBatchSize) {
+            break;
         }
-        locker.unlock();
     }
 
-    if (!received && buffer.isEmpty()) {
+    if (!datagrams.isEmpty()) {
+        _emitDatagrams(datagrams);
+    } else if (!received) {
         qCWarning(UDPLinkLog) << "No Data Available to Read!";
-        return;
     }
+}
+
+void UDPWorker::_emitDatagrams(QList<UDPDatagram> &datagrams)
+{
+    // One lock per batch, consecutive datagrams mostly come from the same sender
+    const QHostAddress *lastAddress = nullptr;
+    quint16 lastPort = 0;
+    quint32 endpointId = 0;
+
+    QMutexLocker locker(&_sessionTargetsMutex);
+    for (UDPDatagram &datagram : datagrams) {
+        if (lastAddress && (datagram.senderPort == lastPort) && (datagram.senderAddress == *lastAddress)) {
+            datagram.endpointId = endpointId;
+            continue;
+        }
+        lastAddress = &datagram.senderAddress;
+        lastPort = datagram.senderPort;
+
+        const bool ipLocal = datagram.senderAddress.isLoopback() || _localAddresses.contains(datagram.senderAddress);
+        const QHostAddress senderAddress = ipLocal ? QHostAddress(QHostAddress::SpecialAddress::LocalHost) : datagram.senderAddress;
+        const QPair<QHostAddress, quint16> sessionTarget(senderAddress, datagram.senderPort);
+        endpointId = _sessionTargetEndpointIds.value(sessionTarget);
+        if (endpointId == 0) {
+            endpointId = _nextEndpointId++;
+            qCDebug(UDPLinkLog) << "UDP Adding target:" << senderAddress << datagram.senderPort << "endpoint" << endpointId;
+            _sessionTargets.append(std::make_shared<UDPClient>(senderAddress, datagram.senderPort));
+            _sessionTargetEndpointIds.insert(sessionTarget, endpointId);
+        }
+        datagram.endpointId = endpointId;
+    }
+    locker.unlock();
 
-    emit dataReceived(buffer);
+    emit datagramsReceived(datagrams);
 }
 
 void UDPWorker::_onSocketBytesWritten(qint64 bytes)
@@ -576,7 +599,8 @@ UDPLink::UDPLink(SharedLinkConfigurationPtr &config, QObject *parent)
     (void) connect(_worker, &UDPWorker::connected, this, &UDPLink::_onConnected, Qt::QueuedConnection);
     (void) connect(_worker, &UDPWorker::disconnected, this, &UDPLink::_onDisconnected, Qt::QueuedConnection);
     (void) connect(_worker, &UDPWorker::errorOccurred, this, &UDPLink::_onErrorOccurred, Qt::QueuedConnection);
-    (void) connect(_worker, &UDPWorker::dataReceived, this, &UDPLink::_onDataReceived, Qt::QueuedConnection);
+    // Emitted on the worker thread so the receive path can decode there without a hop through the main thread
+    (void) connect(_worker, &UDPWorker::datagramsReceived, this, &UDPLink::_onDatagramsReceived, Qt::DirectConnection);
     (void) connect(_worker, &UDPWorker::dataSent, this, &UDPLink::_onDataSent, Qt::QueuedConnection);
 
     _workerThread->start();
@@ -625,9 +649,19 @@ void UDPLink::_onErrorOccurred(const QString &errorString)
     emit communicationError(tr("UDP Link Error"), tr("Link %1: %2").arg(_udpConfig->name(), errorString));
 }
 
-void UDPLink::_onDataReceived(const QByteArray &data)
+void UDPLink::_onDatagramsReceived(const QList<UDPDatagram> &datagrams)
 {
-    emit bytesReceived(this, data);
+    // Consecutive datagrams of the same sender are parsed as one block
+    QList<LinkEndpointBytes> endpointBytes;
+    for (const UDPDatagram &datagram : datagrams) {
+        if (!endpointBytes.isEmpty() && (endpointBytes.last().endpointId == datagram.endpointId)) {
+            (void) endpointBytes.last().data.append(datagram.data);
+        } else {
+            endpointBytes.append({ datagram.endpointId, datagram.data });
+        }
+    }
+
+    emit endpointBytesReceived(this, endpointBytes);
 }
 
 void UDPLink::_onDataSent(const QByteArray &data)
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
@@ -25,6 +26,7 @@
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "UDPBatchIO.h"
 
 class QUdpSocket;
 class QThread;
@@ -130,7 +132,8 @@ public slots:
     void connected();
     void disconnected();
     void errorOccurred(const QString &errorString);
-    void dataReceived(const QByteArray &data);
+    /// All datagrams read by one readyRead, in arrival order
+    void datagramsReceived(const QList<UDPDatagram> &datagrams);
     void dataSent(const QByteArray &data);
 
 private slots:
@@ -141,10 +144,15 @@ private slots:
     void _onSocketErrorOccurred(QAbstractSocket::SocketError socketError);
 
 private:
+    void _emitDatagrams(QList<UDPDatagram> &datagrams);
+
     const UDPConfiguration *_udpConfig = nullptr;
     QUdpSocket *_socket = nullptr;
+    UDPBatchIO _batchIO;
     QMutex _sessionTargetsMutex;
     QList<std::shared_ptr<UDPClient>> _sessionTargets;
+    QHash<QPair<QHostAddress, quint16>, quint32> _sessionTargetEndpointIds;   ///< Only accessed from the worker thread
+    quint32 _nextEndpointId = 1;                                                ///< Never reused, stale parser state can not leak into a new sender
     bool _isConnected = false;
     bool _errorEmitted = false;
     QSet<QHostAddress> _localAddresses;
@@ -176,13 +184,14 @@ class UDPLink : public LinkInterface
 
 protected:
     bool _connect() override;
+    bool _batchOutboundFrames() const override { return false; }
 
 private slots:
     void _writeBytes(const QByteArray &data) override;
     void _onConnected();
     void _onDisconnected();
     void _onErrorOccurred(const QString &errorString);
-    void _onDataReceived(const QByteArray &data);
+    void _onDatagramsReceived(const QList<UDPDatagram> &datagrams);
     void _onDataSent(const QByteArray &data);
 
 private:
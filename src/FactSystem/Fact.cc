@@ -8,11 +8,14 @@
  ****************************************************************************/
 
 #include "Fact.h"
+#include "FactGroup.h"
 #include "FactValueSliderListModel.h"
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QMetaMethod>
+
 QGC_LOGGING_CATEGORY(FactLog, "qgc.factsystem.fact")
 
 Fact::Fact(QObject *parent)
@@ -66,6 +69,10 @@ Fact::Fact(const Fact &other, QObject *parent)
 
 Fact::~Fact()
 {
+    if (_deferredValueChangeSignal && _factGroup) {
+        _factGroup->_removeDeferredFact(this);
+    }
+
     // qCDebug(FactLog) << Q_FUNC_INFO << this;
 }
 
@@ -78,13 +85,20 @@ const Fact &Fact::operator=(const Fact& other)
 {
     _name = other._name;
     _componentId = other._componentId;
-    _rawValue = other._rawValue;
     _type = other._type;
+    // The inline storage is picked again from the new type on the next setTelemetryValue
+    _typedStorage = TypedStorage::None;
+    _setRawValue(other.rawValue());
     _sendValueChangedSignals = other._sendValueChangedSignals;
     _deferredValueChangeSignal = other._deferredValueChangeSignal;
     _valueSliderModel = nullptr;
     if (_metaData && other._metaData) {
-        *_metaData = *other._metaData;
+        if (!_metaData->isShared()) {
+            *_metaData = *other._metaData;
+        } else if (_metaData != other._metaData) {
+            // Never write through to shared meta data, other Facts are using it
+            _metaData = other._metaData->isShared() ? other._metaData : new FactMetaData(*other._metaData, this);
+        }
     } else {
         _metaData = nullptr;
     }
@@ -99,8 +113,8 @@ void Fact::forceSetRawValue(const QVariant &value)
         QString errorString;
 
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
-            _rawValue.setValue(typedValue);
-            _sendValueChangedSignal(cookedValue());
+            _setRawValue(typedValue);
+            _sendValueChangedSignal();
             //-- Must be in this order
             emit containerRawValueChanged(rawValue());
             emit rawValueChanged(_rawValue);
@@ -117,9 +131,9 @@ void Fact::setRawValue(const QVariant &value)
         QString errorString;
 
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
-            if (typedValue != _rawValue) {
-                _rawValue.setValue(typedValue);
-                _sendValueChangedSignal(cookedValue());
+            if (typedValue != rawValue()) {
+                _setRawValue(typedValue);
+                _sendValueChangedSignal();
                 //-- Must be in this order
                 emit containerRawValueChanged(rawValue());
                 emit rawValueChanged(_rawValue);
@@ -167,9 +181,9 @@ void Fact::setEnumIndex(int index)
 
 void Fact::containerSetRawValue(const QVariant &value)
 {
-    if (_rawValue != value) {
-        _rawValue = value;
-        _sendValueChangedSignal(cookedValue());
+    if (rawValue() != value) {
+        _setRawValue(value);
+        _sendValueChangedSignal();
         emit rawValueChanged(_rawValue);
     }
 
@@ -177,13 +191,206 @@ void Fact::containerSetRawValue(const QVariant &value)
     emit vehicleUpdated(_rawValue);
 }
 
+void Fact::_setRawValue(const QVariant &value)
+{
+    _rawValue = value;
+    _rawValueDirty = false;
+    if ((_typedStorage != TypedStorage::None) && (_typedStorage != TypedStorage::Unsupported)) {
+        _typedValue = _typedValueFromVariant(_rawValue);
+    }
+}
+
+void Fact::_setTelemetryValue(TypedValue value, TypedStorage valueStorage)
+{
+    if (_typedStorage == TypedStorage::None) {
+        switch (_valueType()) {
+        case FactMetaData::valueTypeFloat:
+        case FactMetaData::valueTypeDouble:
+        case FactMetaData::valueTypeElapsedTimeInSeconds:
+            _typedStorage = TypedStorage::Double;
+            break;
+        case FactMetaData::valueTypeUint8:
+        case FactMetaData::valueTypeInt8:
+        case FactMetaData::valueTypeUint16:
+        case FactMetaData::valueTypeInt16:
+        case FactMetaData::valueTypeUint32:
+        case FactMetaData::valueTypeInt32:
+        case FactMetaData::valueTypeUint64:
+        case FactMetaData::valueTypeInt64:
+            _typedStorage = TypedStorage::Int;
+            break;
+        case FactMetaData::valueTypeBool:
+            _typedStorage = TypedStorage::Bool;
+            break;
+        default:
+            _typedStorage = TypedStorage::Unsupported;
+            break;
+        }
+
+        if (_typedStorage != TypedStorage::Unsupported) {
+            _typedValue = _typedValueFromVariant(rawValue());
+        }
+    }
+
+    if (_typedStorage == TypedStorage::Unsupported) {
+        switch (valueStorage) {
+        case TypedStorage::Double:
+            setRawValue(value.doubleValue);
+            break;
+        case TypedStorage::Int:
+            setRawValue(value.intValue);
+            break;
+        default:
+            setRawValue(value.boolValue);
+            break;
+        }
+        return;
+    }
+
+    const TypedValue typedValue = _convertTypedValue(value, valueStorage);
+    if (_typedValueEquals(typedValue)) {
+        return;
+    }
+
+    _typedValue = typedValue;
+    _rawValueDirty = true;
+
+    _sendValueChangedSignal();
+    if (isSignalConnected(QMetaMethod::fromSignal(&Fact::rawValueChanged))) {
+        emit rawValueChanged(rawValue());
+    }
+}
+
+Fact::TypedValue Fact::_convertTypedValue(TypedValue value, TypedStorage valueStorage) const
+{
+    // Same conversion as FactMetaData::convertAndValidateRaw in setRawValue: QVariant rounds doubles to integers and
+    // keeps 8 and 16 bit types in an int or uint
+    double doubleValue = 0;
+    qint64 intValue = 0;
+    switch (valueStorage) {
+    case TypedStorage::Double:
+        doubleValue = value.doubleValue;
+        intValue = qIsFinite(doubleValue) ? qRound64(doubleValue) : 0;
+        break;
+    case TypedStorage::Int:
+        intValue = value.intValue;
+        doubleValue = static_cast<double>(intValue);
+        break;
+    default:
+        intValue = value.boolValue ? 1 : 0;
+        doubleValue = intValue;
+        break;
+    }
+
+    const FactMetaData::ValueType_t valueType = _valueType();
+    TypedValue typedValue{};
+    switch (_typedStorage) {
+    case TypedStorage::Double:
+        typedValue.doubleValue = (valueType == FactMetaData::valueTypeFloat) ? static_cast<float>(doubleValue) : doubleValue;
+        break;
+    case TypedStorage::Int:
+        switch (valueType) {
+        case FactMetaData::valueTypeUint8:
+        case FactMetaData::valueTypeUint16:
+        case FactMetaData::valueTypeUint32:
+            intValue = static_cast<uint>(intValue);
+            break;
+        case FactMetaData::valueTypeInt8:
+        case FactMetaData::valueTypeInt16:
+        case FactMetaData::valueTypeInt32:
+            intValue = static_cast<int>(intValue);
+            break;
+        default:
+            break;
+        }
+        typedValue.intValue = intValue;
+        break;
+    default:
+        typedValue.boolValue = (valueStorage == TypedStorage::Double) ? (doubleValue != 0) : (intValue != 0);
+        break;
+    }
+
+    return typedValue;
+}
+
+Fact::TypedValue Fact::_typedValueFromVariant(const QVariant &value) const
+{
+    TypedValue typedValue{};
+    switch (_typedStorage) {
+    case TypedStorage::Double:
+        typedValue.doubleValue = value.toDouble();
+        break;
+    case TypedStorage::Int:
+        typedValue.intValue = (_valueType() == FactMetaData::valueTypeUint64) ? static_cast<qint64>(value.toULongLong()) : value.toLongLong();
+        break;
+    case TypedStorage::Bool:
+        typedValue.boolValue = value.toBool();
+        break;
+    default:
+        break;
+    }
+
+    return typedValue;
+}
+
+bool Fact::_typedValueEquals(TypedValue value) const
+{
+    switch (_typedStorage) {
+    case TypedStorage::Double:
+        // NaN means no value, repeating it is no change
+        return ((value.doubleValue == _typedValue.doubleValue) || (qIsNaN(value.doubleValue) && qIsNaN(_typedValue.doubleValue)));
+    case TypedStorage::Int:
+        return (value.intValue == _typedValue.intValue);
+    case TypedStorage::Bool:
+        return (value.boolValue == _typedValue.boolValue);
+    default:
+        return false;
+    }
+}
+
+void Fact::_updateRawValue() const
+{
+    _rawValueDirty = false;
+
+    switch (_valueType()) {
+    case FactMetaData::valueTypeFloat:
+        _rawValue = QVariant(static_cast<float>(_typedValue.doubleValue));
+        break;
+    case FactMetaData::valueTypeDouble:
+    case FactMetaData::valueTypeElapsedTimeInSeconds:
+        _rawValue = QVariant(_typedValue.doubleValue);
+        break;
+    case FactMetaData::valueTypeUint8:
+    case FactMetaData::valueTypeUint16:
+    case FactMetaData::valueTypeUint32:
+        _rawValue = QVariant(static_cast<uint>(_typedValue.intValue));
+        break;
+    case FactMetaData::valueTypeInt8:
+    case FactMetaData::valueTypeInt16:
+    case FactMetaData::valueTypeInt32:
+        _rawValue = QVariant(static_cast<int>(_typedValue.intValue));
+        break;
+    case FactMetaData::valueTypeUint64:
+        _rawValue = QVariant(static_cast<qulonglong>(_typedValue.intValue));
+        break;
+    case FactMetaData::valueTypeInt64:
+        _rawValue = QVariant(static_cast<qlonglong>(_typedValue.intValue));
+        break;
+    case FactMetaData::valueTypeBool:
+        _rawValue = QVariant(_typedValue.boolValue);
+        break;
+    default:
+        break;
+    }
+}
+
 QVariant Fact::cookedValue() const
 {
     if (_metaData) {
-        return _metaData->rawTranslator()(_rawValue);
+        return _metaData->rawTranslator()(rawValue());
     } else {
         qCWarning(FactLog) << kMissingMetadata << name();
-        return _rawValue;
+        return rawValue();
     }
 }
 
@@ -222,6 +429,7 @@ int Fact::enumIndex()
                 index++;
             }
             // Current value is not in list, add it manually
+            detachMetaData();
             _metaData->addEnumInfo(tr("Unknown: %1").arg(rawValue().toString()), rawValue());
             emit enumsChanged();
             return index;
@@ -255,6 +463,7 @@ QVariantList Fact::enumValues() const
 void Fact::setEnumInfo(const QStringList &strings, const QVariantList &values)
 {
     if (_metaData) {
+        detachMetaData();
         _metaData->setEnumInfo(strings, values);
         emit enumsChanged();
     } else {
@@ -546,6 +755,10 @@ QString Fact::group() const
 
 void Fact::setMetaData(FactMetaData *metaData, bool setDefaultFromMetaData)
 {
+    // The inline storage follows the meta data type, it is picked again on the next setTelemetryValue
+    (void) rawValue();
+    _typedStorage = TypedStorage::None;
+
     _metaData = metaData;
     if (setDefaultFromMetaData && metaData->defaultValueAvailable()) {
         setRawValue(rawDefaultValue());
@@ -553,6 +766,13 @@ void Fact::setMetaData(FactMetaData *metaData, bool setDefaultFromMetaData)
     emit valueChanged(cookedValue());
 }
 
+void Fact::detachMetaData()
+{
+    if (_metaData && _metaData->isShared()) {
+        _metaData = new FactMetaData(*_metaData, this);
+    }
+}
+
 bool Fact::valueEqualsDefault() const
 {
     if (_metaData) {
@@ -636,13 +856,18 @@ void Fact::setSendValueChangedSignals(bool sendValueChangedSignals)
     }
 }
 
-void Fact::_sendValueChangedSignal(const QVariant &value)
+void Fact::_sendValueChangedSignal()
 {
     if (_sendValueChangedSignals) {
-        emit valueChanged(value);
         _deferredValueChangeSignal = false;
-    } else {
+        if (isSignalConnected(QMetaMethod::fromSignal(&Fact::valueChanged))) {
+            emit valueChanged(cookedValue());
+        }
+    } else if (!_deferredValueChangeSignal) {
         _deferredValueChangeSignal = true;
+        if (_factGroup) {
+            _factGroup->_deferValueChangedSignal(this);
+        }
     }
 }
 
@@ -650,7 +875,9 @@ void Fact::sendDeferredValueChangedSignal()
 {
     if (_deferredValueChangeSignal) {
         _deferredValueChangeSignal = false;
-        emit valueChanged(cookedValue());
+        if (isSignalConnected(QMetaMethod::fromSignal(&Fact::valueChanged))) {
+            emit valueChanged(cookedValue());
+        }
     }
 }
 
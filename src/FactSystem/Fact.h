@@ -11,11 +11,15 @@
 
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
 #include <QtCore/QString>
 #include <QtCore/QVariant>
 
+#include <type_traits>
+
 #include "FactMetaData.h"
 
+class FactGroup;
 class FactValueSliderListModel;
 
 Q_DECLARE_LOGGING_CATEGORY(FactLog)
@@ -82,7 +86,7 @@ class Fact : public QObject
     /// Convert and clamp value
     Q_INVOKABLE QVariant clamp(const QString &cookedValue);
     QVariant cookedValue() const; /// Value after translation
-    QVariant rawValue() const { return _rawValue; }  /// value prior to translation, careful
+    QVariant rawValue() const { if (_rawValueDirty) { _updateRawValue(); } return _rawValue; }  /// value prior to translation, careful
     int componentId() const { return _componentId; }
     int decimalPlaces() const;
     QVariant rawDefaultValue() const;
@@ -135,6 +139,25 @@ class Fact : public QObject
 
     void setRawValue(const QVariant &value);
     void setCookedValue(const QVariant &value);
+
+    /// Fast path for telemetry values received from the vehicle. Numeric and bool values are kept inline without
+    /// QVariant conversion or meta data validation, so the value must already be in raw units. The raw QVariant,
+    /// the cooked value and strings are only built when read. containerRawValueChanged is not signalled.
+    /// Other types, string for example, go through setRawValue.
+    template<typename T>
+    void setTelemetryValue(T value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            _setTelemetryValue(TypedValue{ .boolValue = value }, TypedStorage::Bool);
+        } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            _setTelemetryValue(TypedValue{ .intValue = static_cast<qint64>(value) }, TypedStorage::Int);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            _setTelemetryValue(TypedValue{ .doubleValue = static_cast<double>(value) }, TypedStorage::Double);
+        } else {
+            setRawValue(QVariant(value));
+        }
+    }
+
     void setEnumIndex(int index);
     void setEnumStringValue(const QString &value);
     int valueIndex(const QString &value) const;
@@ -157,6 +180,9 @@ class Fact : public QObject
 
     FactMetaData *metaData() { return _metaData; }
 
+    /// Replaces shared meta data with a private copy owned by the Fact. Call before modifying metaData().
+    void detachMetaData();
+
     /// Value coming from Vehicle. This does NOT send a _containerRawValueChanged signal.
     void containerSetRawValue(const QVariant &value);
 
@@ -184,11 +210,15 @@ class Fact : public QObject
 
 protected:
     QString _variantToString(const QVariant &variant, int decimalPlaces) const;
-    void _sendValueChangedSignal(const QVariant &value);
+    /// Sends valueChanged now or defers it, see setSendValueChangedSignals. The cooked value is only translated
+    /// when something is connected.
+    void _sendValueChangedSignal();
+    /// Stores a new raw value, keeps the inline telemetry storage in sync
+    void _setRawValue(const QVariant &value);
 
     QString _name;
     int _componentId = -1;
-    QVariant _rawValue = 0;
+    mutable QVariant _rawValue = 0;     ///< Use rawValue() to read, it may be out of date while _rawValueDirty
     FactMetaData::ValueType_t _type = FactMetaData::valueTypeInt32;
     FactMetaData *_metaData = nullptr;
     bool _sendValueChangedSignals = true;
@@ -201,5 +231,34 @@ private slots:
     void _checkForRebootMessaging();
 
 private:
+    friend class FactGroup;
+
+    /// Inline storage of telemetry values, chosen from the meta data type on the first setTelemetryValue
+    enum class TypedStorage : uint8_t {
+        None,           ///< setTelemetryValue not used yet
+        Unsupported,    ///< Type can not be stored inline
+        Double,
+        Int,
+        Bool
+    };
+
+    union TypedValue {
+        double doubleValue;
+        qint64 intValue;
+        bool boolValue;
+    };
+
     void _init();
+    /// Type values are converted to by setRawValue
+    FactMetaData::ValueType_t _valueType() const { return (_metaData ? _metaData->type() : _type); }
+    void _setTelemetryValue(TypedValue value, TypedStorage valueStorage);
+    void _updateRawValue() const;
+    TypedValue _typedValueFromVariant(const QVariant &value) const;
+    TypedValue _convertTypedValue(TypedValue value, TypedStorage valueStorage) const;
+    bool _typedValueEquals(TypedValue value) const;
+
+    TypedStorage _typedStorage = TypedStorage::None;
+    TypedValue _typedValue{};
+    mutable bool _rawValueDirty = false;    ///< _typedValue is newer than _rawValue
+    QPointer<FactGroup> _factGroup;         ///< Collects the deferred valueChanged signal, set by FactGroup::_addFact
 };
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "FactGroup.h"
+#include "FactGroupUpdateScheduler.h"
 #include "QGCLoggingCategory.h"
 
 QGC_LOGGING_CATEGORY(FactGroupLog, "qgc.factsystem.factgroup")
@@ -18,8 +19,7 @@ FactGroup::FactGroup(int updateRateMsecs, const QString &metaDataFile, QObject *
     , _ignoreCamelCase(ignoreCamelCase)
 {
     // qCDebug(FactGroupLog) << Q_FUNC_INFO << this;
-    _setupTimer();
-    _nameToFactMetaDataMap = FactMetaData::createMapFromJsonFile(metaDataFile, this);
+    _nameToFactMetaDataMap = FactMetaData::sharedMapFromJsonFile(metaDataFile);
 }
 
 FactGroup::FactGroup(int updateRateMsecs, QObject *parent, bool ignoreCamelCase)
@@ -28,11 +28,21 @@ FactGroup::FactGroup(int updateRateMsecs, QObject *parent, bool ignoreCamelCase)
     , _ignoreCamelCase(ignoreCamelCase)
 {
     // qCDebug(FactGroupLog) << Q_FUNC_INFO << this;
-    _setupTimer();
 }
 
 FactGroup::~FactGroup()
 {
+    if (!_deferredFacts.isEmpty()) {
+        FactGroupUpdateScheduler::instance()->unschedule(this);
+    }
+
+    if (_telemetryHistory) {
+        // Only used as keys, member Facts are already gone
+        for (const Fact *fact : std::as_const(_nameToFactMap)) {
+            _telemetryHistory->removeFact(fact);
+        }
+    }
+
     // qCDebug(FactGroupLog) << Q_FUNC_INFO << this;
 }
 
@@ -42,16 +52,6 @@ void FactGroup::_loadFromJsonArray(const QJsonArray &jsonArray)
     _nameToFactMetaDataMap = FactMetaData::createMapFromJsonArray(jsonArray, defineMap, this);
 }
 
-void FactGroup::_setupTimer()
-{
-    if (_updateRateMSecs > 0) {
-        (void) connect(&_updateTimer, &QTimer::timeout, this, &FactGroup::_updateAllValues);
-        _updateTimer.setSingleShot(false);
-        _updateTimer.setInterval(_updateRateMSecs);
-        _updateTimer.start();
-    }
-}
-
 bool FactGroup::factExists(const QString &name) const
 {
     if (name.contains(".")) {
@@ -112,6 +112,9 @@ FactGroup *FactGroup::getFactGroup(const QString &name) const
 
     if (_nameToFactGroupMap.contains(camelCaseName)) {
         factGroup = _nameToFactGroupMap[camelCaseName];
+    } else if (_lazyFactGroups.contains(camelCaseName)) {
+        // Creating a sub group on first access does not change what the group represents
+        factGroup = const_cast<FactGroup*>(this)->_createLazyFactGroup(camelCaseName);
     } else {
         qCWarning(FactGroupLog) << "Unknown FactGroup" << camelCaseName;
     }
@@ -126,16 +129,48 @@ void FactGroup::_addFact(Fact *fact, const QString &name)
         return;
     }
 
-    fact->setSendValueChangedSignals(_updateRateMSecs == 0);
+    fact->setSendValueChangedSignals((_updateRateMSecs == 0) || _liveUpdates);
+    fact->_factGroup = this;
     if (_nameToFactMetaDataMap.contains(name)) {
+        FactMetaData *const placeholderMetaData = fact->metaData();
         fact->setMetaData(_nameToFactMetaDataMap[name], true /* setDefaultFromMetaData */);
+        // Facts created by type come with their own meta data, which is unused from here on
+        if (placeholderMetaData && (placeholderMetaData->parent() == fact) && (placeholderMetaData != fact->metaData())) {
+            delete placeholderMetaData;
+        }
     }
     _nameToFactMap[name] = fact;
     _factNames.append(name);
 
+    if (_telemetryHistory) {
+        _telemetryHistory->addFact(fact, _telemetryHistoryPrefix + name, _updateRateMSecs);
+    }
+
     emit factNamesChanged();
 }
 
+QStringList FactGroup::factGroupNames() const
+{
+    QStringList names = _nameToFactGroupMap.keys();
+    if (!_lazyFactGroups.isEmpty()) {
+        names.append(_lazyFactGroups.keys());
+        names.sort();
+    }
+
+    return names;
+}
+
+FactGroup *FactGroup::_createLazyFactGroup(const QString &name)
+{
+    const LazyFactGroup lazyFactGroup = _lazyFactGroups.take(name);
+    FactGroup *const factGroup = lazyFactGroup.create();
+    qCDebug(FactGroupLog) << "Created FactGroup" << name;
+
+    _addFactGroup(factGroup, name);
+
+    return factGroup;
+}
+
 void FactGroup::_addFactGroup(FactGroup *factGroup, const QString &name)
 {
     if (_nameToFactGroupMap.contains(name)) {
@@ -145,31 +180,78 @@ void FactGroup::_addFactGroup(FactGroup *factGroup, const QString &name)
 
     _nameToFactGroupMap[name] = factGroup;
 
+    if (_telemetryHistory) {
+        factGroup->setTelemetryHistory(_telemetryHistory, _telemetryHistoryPrefix + name + QLatin1Char('.'));
+    }
+
     emit factGroupNamesChanged();
 }
 
-void FactGroup::_updateAllValues()
+void FactGroup::_deferValueChangedSignal(Fact *fact)
 {
-    for (Fact *fact: _nameToFactMap) {
+    if (_deferredFacts.isEmpty()) {
+        FactGroupUpdateScheduler::instance()->schedule(this);
+    }
+    _deferredFacts.append(fact);
+}
+
+void FactGroup::_removeDeferredFact(Fact *fact)
+{
+    (void) _deferredFacts.removeOne(fact);
+    if (_deferredFacts.isEmpty()) {
+        FactGroupUpdateScheduler::instance()->unschedule(this);
+    }
+}
+
+void FactGroup::_sendDeferredValueChangedSignals()
+{
+    // Value change handlers may change Facts again, those go into the next update
+    const QList<Fact*> deferredFacts = std::exchange(_deferredFacts, {});
+
+    if (_telemetryHistory) {
+        const qint64 nowMSecs = _telemetryHistory->nowMSecs();
+        for (const Fact *fact : deferredFacts) {
+            _telemetryHistory->record(fact, nowMSecs);
+        }
+    }
+
+    for (Fact *fact : deferredFacts) {
         fact->sendDeferredValueChangedSignal();
     }
 }
 
-void FactGroup::setLiveUpdates(bool liveUpdates)
+void FactGroup::setTelemetryHistory(TelemetryHistory *telemetryHistory, const QString &prefix)
 {
-    if (_updateTimer.interval() == 0) {
+    _telemetryHistory = telemetryHistory;
+    _telemetryHistoryPrefix = prefix;
+
+    if (!_telemetryHistory) {
         return;
     }
 
-    if (liveUpdates) {
-        _updateTimer.stop();
-    } else {
-        _updateTimer.start();
+    for (auto it = _nameToFactMap.cbegin(); it != _nameToFactMap.cend(); ++it) {
+        _telemetryHistory->addFact(it.value(), _telemetryHistoryPrefix + it.key(), _updateRateMSecs);
+    }
+    for (auto it = _nameToFactGroupMap.cbegin(); it != _nameToFactGroupMap.cend(); ++it) {
+        it.value()->setTelemetryHistory(_telemetryHistory, _telemetryHistoryPrefix + it.key() + QLatin1Char('.'));
+    }
+}
+
+void FactGroup::setLiveUpdates(bool liveUpdates)
+{
+    if ((_updateRateMSecs == 0) || (liveUpdates == _liveUpdates)) {
+        return;
     }
 
+    _liveUpdates = liveUpdates;
     for (Fact *fact: _nameToFactMap) {
         fact->setSendValueChangedSignals(liveUpdates);
     }
+
+    if (liveUpdates && !_deferredFacts.isEmpty()) {
+        FactGroupUpdateScheduler::instance()->unschedule(this);
+        _sendDeferredValueChangedSignals();
+    }
 }
 
 
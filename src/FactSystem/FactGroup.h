@@ -11,12 +11,16 @@
 
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QJsonArray>
+#include <QtCore/QList>
 #include <QtCore/QMap>
+#include <QtCore/QPointer>
 #include <QtCore/QStringList>
-#include <QtCore/QTimer>
+
+#include <functional>
 
 #include "Fact.h"
 #include "MAVLinkLib.h"
+#include "TelemetryHistory.h"
 
 class Vehicle;
 
@@ -26,6 +30,10 @@ Q_DECLARE_LOGGING_CATEGORY(FactGroupLog)
 class FactGroup : public QObject
 {
     Q_OBJECT
+
+    friend class Fact;
+    friend class FactGroupUpdateScheduler;
+
     Q_PROPERTY(QStringList  factNames           READ factNames          NOTIFY factNamesChanged)
     Q_PROPERTY(QStringList  factGroupNames      READ factGroupNames     NOTIFY factGroupNamesChanged)
     Q_PROPERTY(bool         telemetryAvailable  READ telemetryAvailable NOTIFY telemetryAvailableChanged)   ///< false: No telemetry for these values has been received
@@ -50,41 +58,77 @@ class FactGroup : public QObject
     Q_INVOKABLE void setLiveUpdates(bool liveUpdates);
 
     QStringList factNames() const { return _factNames; }
-    QStringList factGroupNames() const { return _nameToFactGroupMap.keys(); }
+    QStringList factGroupNames() const;
     bool telemetryAvailable() const { return _telemetryAvailable; }
+    /// Sub groups which exist, see lazyFactGroups for the ones not created yet
     const QMap<QString, FactGroup*> &factGroups() const { return _nameToFactGroupMap; }
 
+    /// Sub group which is only created on first access through getFactGroup, usually its first message
+    struct LazyFactGroup
+    {
+        QList<uint32_t> handledMessageIds;
+        std::function<FactGroup*()> create;
+    };
+    const QMap<QString, LazyFactGroup> &lazyFactGroups() const { return _lazyFactGroups; }
+
+    /// Records the value changes of all Facts of this group and its sub groups, including ones added later.
+    /// Only value changes sent through the update rate are recorded, not live updates.
+    ///     @param prefix Prepended to the Fact names for the series names
+    void setTelemetryHistory(TelemetryHistory *telemetryHistory, const QString &prefix = QString());
+
     /// Allows a FactGroup to parse incoming messages and fill in values
+    ///     @param vehicle nullptr: Headless log replay, the caller only passes messages of the vehicle
     virtual void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) {}
 
+    /// Message ids handled by handleMessage. Vehicle only dispatches these ids to the FactGroup.
+    /// An empty list dispatches every message.
+    virtual QList<uint32_t> handledMessageIds() const { return {}; }
+
 signals:
     void factNamesChanged();
     void factGroupNamesChanged();
     void telemetryAvailableChanged(bool telemetryAvailable);
 
-protected slots:
-    virtual void _updateAllValues();
-
 protected:
     void _addFact(Fact *fact, const QString &name);
     void _addFact(Fact *fact) { _addFact(fact, fact->name()); }
     void _addFactGroup(FactGroup *factGroup, const QString &name);
     void _addFactGroup(FactGroup *factGroup) { _addFactGroup(factGroup, factGroup->objectName()); }
+
+    /// Adds a sub group which is created on first access. It is listed in factGroupNames right away.
+    template<typename T>
+    void _addLazyFactGroup(const QString &name)
+    {
+        // The message ids are taken once from a temporary instance
+        static const QList<uint32_t> handledMessageIds = T().handledMessageIds();
+        _lazyFactGroups[name] = { handledMessageIds, [this]() -> FactGroup* { return new T(this); } };
+        emit factGroupNamesChanged();
+    }
     void _loadFromJsonArray(const QJsonArray &jsonArray);
     void _setTelemetryAvailable(bool telemetryAvailable);
 
-    const int _updateRateMSecs = 0;   ///< Update rate for Fact::valueChanged signals, 0: immediate update
+    const int _updateRateMSecs = 0;   ///< Update rate for Fact::valueChanged signals, 0: immediate update, see FactGroupUpdateScheduler
 
     QMap<QString, Fact*> _nameToFactMap;
     QMap<QString, FactGroup*> _nameToFactGroupMap;
+    QMap<QString, LazyFactGroup> _lazyFactGroups;
     QMap<QString, FactMetaData*> _nameToFactMetaDataMap;
     QStringList _factNames;
 
 private:
-    void _setupTimer();
+    /// Called by a Fact the first time its valueChanged signal is deferred
+    void _deferValueChangedSignal(Fact *fact);
+    /// Called by a Fact which is destroyed with a deferred valueChanged signal
+    void _removeDeferredFact(Fact *fact);
+    /// Sends the deferred valueChanged signals, called by FactGroupUpdateScheduler
+    void _sendDeferredValueChangedSignals();
+    FactGroup *_createLazyFactGroup(const QString &name);
     static QString _camelCase(const QString &text);
 
-    QTimer _updateTimer;
+    QList<Fact*> _deferredFacts;    ///< Facts with a deferred valueChanged signal
+    bool _liveUpdates = false;
+    QPointer<TelemetryHistory> _telemetryHistory;
+    QString _telemetryHistoryPrefix;
     const bool _ignoreCamelCase = false;
     bool _telemetryAvailable = false;
 };
@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactGroupUpdateScheduler.h"
+#include "FactGroup.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/qapplicationstatic.h>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QScreen>
+
+QGC_LOGGING_CATEGORY(FactGroupUpdateSchedulerLog, "qgc.factsystem.factgroupupdatescheduler")
+
+Q_APPLICATION_STATIC(FactGroupUpdateScheduler, _factGroupUpdateSchedulerInstance);
+
+FactGroupUpdateScheduler::FactGroupUpdateScheduler(QObject *parent)
+    : QObject(parent)
+    , _timer(this)
+{
+    // qCDebug(FactGroupUpdateSchedulerLog) << Q_FUNC_INFO << this;
+
+    // May be first used from a log export thread, the updates always run on the main thread
+    if (QCoreApplication::instance() && (thread() != QCoreApplication::instance()->thread())) {
+        moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    _clock.start();
+
+    _timer.setSingleShot(true);
+    (void) connect(&_timer, &QTimer::timeout, this, &FactGroupUpdateScheduler::_timeout);
+}
+
+FactGroupUpdateScheduler::~FactGroupUpdateScheduler()
+{
+    // qCDebug(FactGroupUpdateSchedulerLog) << Q_FUNC_INFO << this;
+}
+
+FactGroupUpdateScheduler *FactGroupUpdateScheduler::instance()
+{
+    return _factGroupUpdateSchedulerInstance();
+}
+
+void FactGroupUpdateScheduler::setTickIntervalMSecs(int tickIntervalMSecs)
+{
+    _tickIntervalMSecs = qMax(1, tickIntervalMSecs);
+    _tickIntervalSet = true;
+}
+
+void FactGroupUpdateScheduler::_initTickInterval()
+{
+    // QScreen may only be used on the GUI thread, while the scheduler may be created from a log export thread
+    if (_tickIntervalSet || (QThread::currentThread() != thread())) {
+        return;
+    }
+    _tickIntervalSet = true;
+
+    if (qobject_cast<QGuiApplication*>(QCoreApplication::instance())) {
+        const QScreen *const screen = QGuiApplication::primaryScreen();
+        if (screen && (screen->refreshRate() > 1.0)) {
+            _tickIntervalMSecs = qMax(1, qRound(1000.0 / screen->refreshRate()));
+        }
+    }
+}
+
+void FactGroupUpdateScheduler::schedule(FactGroup *factGroup)
+{
+    if (factGroup->thread() != thread()) {
+        return;
+    }
+
+    for (const Scheduled &scheduled : std::as_const(_scheduled)) {
+        if (scheduled.factGroup == factGroup) {
+            return;
+        }
+    }
+
+    _initTickInterval();
+
+    // Due on the next multiple of the update rate, groups sharing a rate come due together
+    const qint64 rateMSecs = qMax(factGroup->_updateRateMSecs, _tickIntervalMSecs);
+    const qint64 dueMSecs = ((_clock.elapsed() / rateMSecs) + 1) * rateMSecs;
+    _scheduled.append({ factGroup, dueMSecs });
+
+    if ((_timerDueMSecs < 0) || (dueMSecs < _timerDueMSecs)) {
+        _startTimer();
+    }
+}
+
+void FactGroupUpdateScheduler::unschedule(FactGroup *factGroup)
+{
+    if (factGroup->thread() != thread()) {
+        return;
+    }
+
+    for (qsizetype i = 0; i < _scheduled.count(); i++) {
+        if (_scheduled[i].factGroup == factGroup) {
+            _scheduled.removeAt(i);
+            break;
+        }
+    }
+
+    if (_scheduled.isEmpty()) {
+        _timer.stop();
+        _timerDueMSecs = -1;
+    }
+}
+
+void FactGroupUpdateScheduler::flush()
+{
+    _runUpdates(true);
+}
+
+void FactGroupUpdateScheduler::_runUpdates(bool force)
+{
+    const qint64 nowMSecs = _clock.elapsed();
+
+    // Groups are taken out first, value change handlers may schedule or delete groups
+    QList<QPointer<FactGroup>> dueGroups;
+    for (qsizetype i = 0; i < _scheduled.count();) {
+        if (force || (_scheduled[i].dueMSecs <= nowMSecs)) {
+            dueGroups.append(_scheduled[i].factGroup);
+            _scheduled.removeAt(i);
+        } else {
+            i++;
+        }
+    }
+
+    qCDebug(FactGroupUpdateSchedulerLog) << "Updating" << dueGroups.count() << "FactGroups," << _scheduled.count() << "waiting";
+
+    for (const QPointer<FactGroup> &factGroup : std::as_const(dueGroups)) {
+        if (factGroup) {
+            factGroup->_sendDeferredValueChangedSignals();
+        }
+    }
+
+    _startTimer();
+}
+
+void FactGroupUpdateScheduler::_startTimer()
+{
+    if (_scheduled.isEmpty()) {
+        _timer.stop();
+        _timerDueMSecs = -1;
+        return;
+    }
+
+    qint64 dueMSecs = _scheduled.first().dueMSecs;
+    for (const Scheduled &scheduled : std::as_const(_scheduled)) {
+        dueMSecs = qMin(dueMSecs, scheduled.dueMSecs);
+    }
+
+    _timerDueMSecs = dueMSecs;
+    _timer.start(static_cast<int>(qMax(dueMSecs - _clock.elapsed(), static_cast<qint64>(0))));
+}
@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+class FactGroup;
+
+Q_DECLARE_LOGGING_CATEGORY(FactGroupUpdateSchedulerLog)
+
+/// Sends the deferred Fact::valueChanged signals of all FactGroups from a single timer.
+/// A FactGroup is only scheduled while it has changed Facts. Its update is due on the next multiple of its update
+/// rate, so all groups with the same rate are flushed together in one pass. The timer only runs while a group is
+/// scheduled. Only FactGroups living on the main thread are scheduled.
+class FactGroupUpdateScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FactGroupUpdateScheduler(QObject *parent = nullptr);
+    ~FactGroupUpdateScheduler();
+
+    static FactGroupUpdateScheduler *instance();
+
+    /// Shortest time between two update passes, defaults to one frame of the primary screen. The screen is read when
+    /// the first FactGroup is scheduled on the main thread.
+    int tickIntervalMSecs() const { return _tickIntervalMSecs; }
+    void setTickIntervalMSecs(int tickIntervalMSecs);
+
+    /// Schedules the deferred value changes of a FactGroup, does nothing if already scheduled
+    void schedule(FactGroup *factGroup);
+    void unschedule(FactGroup *factGroup);
+
+    /// @return Number of FactGroups waiting for their update
+    qsizetype scheduledCount() const { return _scheduled.count(); }
+
+    /// Runs the update pass for all scheduled FactGroups now, regardless of their update rate
+    void flush();
+
+private slots:
+    void _timeout() { _runUpdates(false); }
+
+private:
+    struct Scheduled
+    {
+        FactGroup *factGroup = nullptr;
+        qint64 dueMSecs = 0;
+    };
+
+    void _runUpdates(bool force);
+    void _startTimer();
+    void _initTickInterval();
+
+    QTimer _timer;
+    QElapsedTimer _clock;
+    QList<Scheduled> _scheduled;
+    qint64 _timerDueMSecs = -1;     ///< Time the timer fires at, -1: Not running
+    int _tickIntervalMSecs = 16;
+    bool _tickIntervalSet = false;  ///< Set explicitly or read from the screen
+};
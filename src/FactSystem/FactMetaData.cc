@@ -14,10 +14,36 @@
 #include "SettingsManager.h"
 #include "UnitsSettings.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
 #include <QtCore/QtMath>
 
 QGC_LOGGING_CATEGORY(FactMetaDataLog, "qgc.factsystem.factmetadata")
 
+namespace
+{
+
+/// Parsed meta data json file, the Facts of a group are created from it for every instance
+struct JsonFileCacheEntry
+{
+    QJsonArray factArray;
+    QMap<QString, QString> defineMap;
+};
+
+/// Internal json files are parsed once. Translations are applied while parsing, a language change requires a
+/// restart anyway.
+QMutex _jsonFileCacheMutex;
+QHash<QString, JsonFileCacheEntry> _jsonFileCache;
+
+/// Meta data handed out by FactMetaData::sharedMapFromJsonFile, lives until process exit
+QHash<QString, QMap<QString, FactMetaData*>> _sharedMetaDataMaps;
+qsizetype _sharedMetaDataCount = 0;
+
+} // namespace
+
 // Built in translations for all Facts
 const FactMetaData::BuiltInTranslation_s FactMetaData::_rgBuiltInTranslations[] = {
     { "centi-degrees",  "deg",  FactMetaData::_centiDegreesToDegrees,                   FactMetaData::_degreesToCentiDegrees },
@@ -1339,6 +1365,15 @@ QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonFile(const QString &
 {
     QMap<QString, FactMetaData*> metaDataMap;
 
+    QMutexLocker locker(&_jsonFileCacheMutex);
+    const auto it = _jsonFileCache.constFind(jsonFilename);
+    if (it != _jsonFileCache.constEnd()) {
+        const JsonFileCacheEntry entry = it.value();
+        locker.unlock();
+        return createMapFromJsonArray(entry.factArray, entry.defineMap, metaDataParent);
+    }
+    locker.unlock();
+
     QString errorString;
     int version;
     const QJsonObject jsonObject = JsonHelper::openInternalQGCJsonFile(jsonFilename, qgcFileType, 1, 1, version, errorString);
@@ -1360,9 +1395,53 @@ QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonFile(const QString &
     _loadJsonDefines(jsonObject[FactMetaData::_jsonMetaDataDefinesName].toObject(), defineMap);
     const QJsonArray factArray = jsonObject[FactMetaData::_jsonMetaDataFactsName].toArray();
 
+    if (jsonFilename.startsWith(QStringLiteral(":/"))) {
+        locker.relock();
+        _jsonFileCache.insert(jsonFilename, { factArray, defineMap });
+        locker.unlock();
+    }
+
     return createMapFromJsonArray(factArray, defineMap, metaDataParent);
 }
 
+QMap<QString, FactMetaData*> FactMetaData::sharedMapFromJsonFile(const QString &jsonFilename)
+{
+    QMutexLocker locker(&_jsonFileCacheMutex);
+    const auto it = _sharedMetaDataMaps.constFind(jsonFilename);
+    if (it != _sharedMetaDataMaps.constEnd()) {
+        return it.value();
+    }
+    locker.unlock();
+
+    const QMap<QString, FactMetaData*> metaDataMap = createMapFromJsonFile(jsonFilename, nullptr);
+    QThread *const appThread = QCoreApplication::instance() ? QCoreApplication::instance()->thread() : nullptr;
+    for (FactMetaData *const metaData : metaDataMap) {
+        metaData->_shared = true;
+        // Groups are also created on worker threads, keep the instances away from thread lifetimes
+        if (appThread && (metaData->thread() != appThread)) {
+            metaData->moveToThread(appThread);
+        }
+    }
+
+    locker.relock();
+    const auto existing = _sharedMetaDataMaps.constFind(jsonFilename);
+    if (existing != _sharedMetaDataMaps.constEnd()) {
+        // Lost the race against another thread parsing the same file
+        qDeleteAll(metaDataMap);
+        return existing.value();
+    }
+    (void) _sharedMetaDataMaps.insert(jsonFilename, metaDataMap);
+    _sharedMetaDataCount += metaDataMap.count();
+
+    return metaDataMap;
+}
+
+qsizetype FactMetaData::sharedMetaDataCount()
+{
+    QMutexLocker locker(&_jsonFileCacheMutex);
+    return _sharedMetaDataCount;
+}
+
 QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonArray(const QJsonArray &jsonArray, const QMap<QString, QString> &defineMap, QObject *metaDataParent)
 {
     QMap<QString, FactMetaData*> metaDataMap;
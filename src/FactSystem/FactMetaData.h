@@ -63,10 +63,20 @@ class FactMetaData : public QObject
     static QMap<QString, FactMetaData*> createMapFromJsonFile(const QString &jsonFilename, QObject *metaDataParent);
     static QMap<QString, FactMetaData*> createMapFromJsonArray(const QJsonArray &jsonArray, const DefineMap_t &defineMap, QObject *metaDataParent);
 
+    /// Returns the meta data for a json file from a process wide registry. The file is parsed once and all callers get
+    /// the same instances, which are owned by the registry and must not be modified (see Fact::detachMetaData).
+    static QMap<QString, FactMetaData*> sharedMapFromJsonFile(const QString &jsonFilename);
+
+    /// @return Number of meta data instances held by the shared registry
+    static qsizetype sharedMetaDataCount();
+
     static FactMetaData *createFromJsonObject(const QJsonObject &json, const QMap<QString, QString> &defineMap, QObject *metaDataParent);
 
     const FactMetaData &operator=(const FactMetaData &other);
 
+    /// Shared meta data comes from sharedMapFromJsonFile and is immutable
+    bool isShared() const { return _shared; }
+
     /// Converts from meters to the user specified horizontal distance unit
     static QVariant metersToAppSettingsHorizontalDistanceUnits(const QVariant &meters);
 
@@ -345,6 +355,7 @@ class FactMetaData : public QObject
     bool _readOnly = false;
     bool _writeOnly = false;
     bool _volatile = false;
+    bool _shared = false;
     CustomCookedValidator _customCookedValidator = nullptr;
 
     // Exact conversion constants
@@ -601,7 +601,7 @@ bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
         return false;
     }
 
-    constexpr int maxBatchSize = 10;
+    const int maxBatchSize = _requestBatchSize();
 
     if (waitingParamTimeout) {
         // We timed out, clear the queue and try again
@@ -670,7 +670,7 @@ void ParameterManager::_waitingParamTimeout()
 
     _checkInitialLoadComplete();
 
-    constexpr int maxBatchSize = 10;
+    const int maxBatchSize = _requestBatchSize();
     int batchCount = 0;
     if (!paramsRequested) {
         for (const int componentId: _waitingWriteParamNameMap.keys()) {
@@ -1298,6 +1298,18 @@ QString ParameterManager::_logVehiclePrefix(int componentId) const
     }
 }
 
+int ParameterManager::_requestBatchSize() const
+{
+    static constexpr int maxBatchSize = 10;
+
+    const SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (!sharedLink) {
+        return maxBatchSize;
+    }
+
+    return sharedLink->outboundBulkFrameAllowance(MAVLINK_MSG_ID_PARAM_SET_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES, maxBatchSize);
+}
+
 void ParameterManager::_setLoadProgress(double loadProgress)
 {
     if (_loadProgress != loadProgress) {
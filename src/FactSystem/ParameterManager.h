@@ -128,6 +128,8 @@ private slots:
     /// The offline editing vehicle can have custom loaded params bolted into it.
     void _loadOfflineEditingParams();
     QString _logVehiclePrefix(int componentId) const;
+    /// Number of parameter requests to send in one batch, fewer when the outbound budget of the link is tight
+    int _requestBatchSize() const;
     void _setLoadProgress(double loadProgress);
     /// Requests missing index based parameters from the vehicle.
     ///     @param waitingParamTimeout: true: being called due to timeout, false: being called to re-fill the batch queue
@@ -0,0 +1,340 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryHistory.h"
+#include "Fact.h"
+#include "QGCLoggingCategory.h"
+
+#include <cmath>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(TelemetryHistoryLog, "qgc.factsystem.telemetryhistory")
+
+namespace
+{
+
+/// @return Range [first, last] of finite values, first > last if there are none
+std::pair<qsizetype, qsizetype> _finiteRange(const TelemetryHistory::Samples &samples)
+{
+    qsizetype first = 0;
+    qsizetype last = samples.count() - 1;
+    while ((first <= last) && !std::isfinite(samples.value(first))) {
+        first++;
+    }
+    while ((last >= first) && !std::isfinite(samples.value(last))) {
+        last--;
+    }
+
+    return { first, last };
+}
+
+QPointF _point(const TelemetryHistory::Samples &samples, qsizetype index)
+{
+    return QPointF(static_cast<qreal>(samples.timeMSecs(index)), samples.value(index));
+}
+
+} // namespace
+
+TelemetryHistory::TelemetryHistory(int historySeconds, QObject *parent)
+    : QObject(parent)
+    , _historySeconds(historySeconds)
+{
+    // qCDebug(TelemetryHistoryLog) << Q_FUNC_INFO << this;
+
+    _clock.start();
+}
+
+TelemetryHistory::~TelemetryHistory()
+{
+    // qCDebug(TelemetryHistoryLog) << Q_FUNC_INFO << this;
+}
+
+QStringList TelemetryHistory::seriesNames() const
+{
+    QStringList names = _seriesNameToIndex.keys();
+    names.sort();
+    return names;
+}
+
+void TelemetryHistory::addFact(const Fact *fact, const QString &name, int intervalMSecs)
+{
+    switch (fact->type()) {
+    case FactMetaData::valueTypeString:
+    case FactMetaData::valueTypeCustom:
+        return;
+    default:
+        break;
+    }
+
+    int index = _seriesNameToIndex.value(name, -1);
+    if (index < 0) {
+        Series series;
+        series.capacity = ((static_cast<qint64>(_historySeconds) * 1000) / qMax(intervalMSecs, kMinIntervalMSecs)) + 1;
+        index = static_cast<int>(_series.size());
+        _series.push_back(std::move(series));
+        _seriesNameToIndex[name] = index;
+        emit seriesNamesChanged();
+    }
+
+    _factToSeriesIndex[fact] = index;
+}
+
+void TelemetryHistory::removeFact(const Fact *fact)
+{
+    (void) _factToSeriesIndex.remove(fact);
+}
+
+void TelemetryHistory::record(const Fact *fact, qint64 timeMSecs)
+{
+    const auto it = _factToSeriesIndex.constFind(fact);
+    if (it != _factToSeriesIndex.constEnd()) {
+        bool ok = false;
+        const double value = fact->rawValue().toDouble(&ok);
+        record(it.value(), timeMSecs, ok ? value : std::nan(""));
+    }
+}
+
+void TelemetryHistory::record(int seriesIndex, qint64 timeMSecs, double value)
+{
+    Series &series = _series[seriesIndex];
+    if (series.timesMSecs.empty()) {
+        series.timesMSecs.resize(series.capacity);
+        series.values.resize(series.capacity);
+    }
+
+    // _lowerBound relies on the times being sorted
+    if (series.count > 0) {
+        timeMSecs = qMax(timeMSecs, series.timesMSecs[(series.start + series.count - 1) % series.capacity]);
+    }
+
+    qsizetype index;
+    if (series.count < series.capacity) {
+        index = (series.start + series.count) % series.capacity;
+        series.count++;
+    } else {
+        index = series.start;
+        series.start = (series.start + 1) % series.capacity;
+    }
+
+    series.timesMSecs[index] = timeMSecs;
+    series.values[index] = value;
+}
+
+qsizetype TelemetryHistory::_lowerBound(const Series &series, qint64 timeMSecs) const
+{
+    qsizetype low = 0;
+    qsizetype high = series.count;
+    while (low < high) {
+        const qsizetype middle = (low + high) / 2;
+        if (series.timesMSecs[(series.start + middle) % series.capacity] < timeMSecs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+TelemetryHistory::Samples TelemetryHistory::samples(int seriesIndex, qint64 fromMSecs, qint64 toMSecs) const
+{
+    Samples samples;
+    if ((seriesIndex < 0) || (seriesIndex >= static_cast<int>(_series.size())) || (fromMSecs > toMSecs)) {
+        return samples;
+    }
+
+    const Series &series = _series[seriesIndex];
+    if (series.count == 0) {
+        return samples;
+    }
+
+    const qsizetype first = _lowerBound(series, fromMSecs);
+    const qsizetype end = (toMSecs == std::numeric_limits<qint64>::max()) ? series.count : _lowerBound(series, toMSecs + 1);
+    if (first >= end) {
+        return samples;
+    }
+
+    // Logical indices [first, end) map to at most two contiguous ranges of the buffer
+    const qsizetype bufferFirst = (series.start + first) % series.capacity;
+    const qsizetype count = end - first;
+    const qsizetype firstPartCount = qMin(count, series.capacity - bufferFirst);
+
+    samples.timesMSecs[0] = std::span<const qint64>(series.timesMSecs.data() + bufferFirst, firstPartCount);
+    samples.values[0] = std::span<const double>(series.values.data() + bufferFirst, firstPartCount);
+    if (firstPartCount < count) {
+        samples.timesMSecs[1] = std::span<const qint64>(series.timesMSecs.data(), count - firstPartCount);
+        samples.values[1] = std::span<const double>(series.values.data(), count - firstPartCount);
+    }
+
+    return samples;
+}
+
+QList<QPointF> TelemetryHistory::downsample(int seriesIndex, qint64 fromMSecs, qint64 toMSecs, int maxPoints, Downsample method) const
+{
+    const Samples samples = this->samples(seriesIndex, fromMSecs, toMSecs);
+    return ((method == DownsampleMinMax) ? downsampleMinMax(samples, maxPoints) : downsampleLTTB(samples, maxPoints));
+}
+
+QVariantList TelemetryHistory::history(const QString &name, int seconds, int maxPoints, Downsample method) const
+{
+    const qint64 nowMSecs = this->nowMSecs();
+    const QList<QPointF> points = downsample(seriesIndex(name), nowMSecs - (static_cast<qint64>(seconds) * 1000), nowMSecs, maxPoints, method);
+
+    QVariantList history;
+    history.reserve(points.count());
+    for (const QPointF &point : points) {
+        history.append(point);
+    }
+
+    return history;
+}
+
+QList<QPointF> TelemetryHistory::downsampleMinMax(const Samples &samples, int maxPoints)
+{
+    QList<QPointF> points;
+
+    const auto [first, last] = _finiteRange(samples);
+    if (first > last) {
+        return points;
+    }
+
+    const qsizetype count = last - first + 1;
+    const int bucketCount = maxPoints / 2;
+    if ((count <= maxPoints) || (bucketCount < 1)) {
+        for (qsizetype i = first; i <= last; i++) {
+            if (std::isfinite(samples.value(i))) {
+                points.append(_point(samples, i));
+            }
+        }
+        return points;
+    }
+
+    points.reserve(bucketCount * 2);
+
+    // Buckets are equal time slices, empty ones are left out
+    const qint64 firstMSecs = samples.timeMSecs(first);
+    const double bucketMSecs = qMax(1.0, static_cast<double>(samples.timeMSecs(last) - firstMSecs + 1) / bucketCount);
+
+    qsizetype minIndex = -1;
+    qsizetype maxIndex = -1;
+    int bucket = 0;
+    const auto flushBucket = [&]() {
+        if (minIndex < 0) {
+            return;
+        }
+        const qsizetype lowIndex = qMin(minIndex, maxIndex);
+        const qsizetype highIndex = qMax(minIndex, maxIndex);
+        points.append(_point(samples, lowIndex));
+        if (highIndex != lowIndex) {
+            points.append(_point(samples, highIndex));
+        }
+        minIndex = maxIndex = -1;
+    };
+
+    for (qsizetype i = first; i <= last; i++) {
+        const double value = samples.value(i);
+        if (!std::isfinite(value)) {
+            continue;
+        }
+
+        const int sampleBucket = qMin(static_cast<int>((samples.timeMSecs(i) - firstMSecs) / bucketMSecs), bucketCount - 1);
+        if (sampleBucket != bucket) {
+            flushBucket();
+            bucket = sampleBucket;
+        }
+
+        if ((minIndex < 0) || (value < samples.value(minIndex))) {
+            minIndex = i;
+        }
+        if ((maxIndex < 0) || (value > samples.value(maxIndex))) {
+            maxIndex = i;
+        }
+    }
+    flushBucket();
+
+    return points;
+}
+
+QList<QPointF> TelemetryHistory::downsampleLTTB(const Samples &samples, int maxPoints)
+{
+    QList<QPointF> points;
+
+    const auto [first, last] = _finiteRange(samples);
+    if (first > last) {
+        return points;
+    }
+
+    const qsizetype count = last - first + 1;
+    if ((count <= maxPoints) || (maxPoints < 3)) {
+        for (qsizetype i = first; i <= last; i++) {
+            if (std::isfinite(samples.value(i))) {
+                points.append(_point(samples, i));
+            }
+        }
+        return points;
+    }
+
+    points.reserve(maxPoints);
+
+    // First and last point are always kept, the others are split into maxPoints - 2 buckets. From each bucket the
+    // point forming the largest triangle with the previously selected point and the average of the next bucket is kept.
+    const double bucketSize = static_cast<double>(count - 2) / (maxPoints - 2);
+    qsizetype selected = first;
+    points.append(_point(samples, first));
+
+    for (int bucket = 0; bucket < (maxPoints - 2); bucket++) {
+        const qsizetype bucketStart = first + static_cast<qsizetype>(bucket * bucketSize) + 1;
+        const qsizetype bucketEnd = first + static_cast<qsizetype>((bucket + 1) * bucketSize) + 1;
+
+        const qsizetype nextStart = bucketEnd;
+        const qsizetype nextEnd = qMin(first + static_cast<qsizetype>((bucket + 2) * bucketSize) + 1, last + 1);
+        double nextTime = 0;
+        double nextValue = 0;
+        int nextCount = 0;
+        for (qsizetype i = nextStart; i < nextEnd; i++) {
+            if (std::isfinite(samples.value(i))) {
+                nextTime += samples.timeMSecs(i);
+                nextValue += samples.value(i);
+                nextCount++;
+            }
+        }
+        if (nextCount > 0) {
+            nextTime /= nextCount;
+            nextValue /= nextCount;
+        } else {
+            nextTime = samples.timeMSecs(last);
+            nextValue = samples.value(last);
+        }
+
+        const double selectedTime = samples.timeMSecs(selected);
+        const double selectedValue = samples.value(selected);
+        double maxArea = -1;
+        qsizetype maxAreaIndex = -1;
+        for (qsizetype i = bucketStart; i < bucketEnd; i++) {
+            const double value = samples.value(i);
+            if (!std::isfinite(value)) {
+                continue;
+            }
+            const double area = std::abs(((selectedTime - nextTime) * (value - selectedValue)) - ((selectedTime - samples.timeMSecs(i)) * (nextValue - selectedValue)));
+            if (area > maxArea) {
+                maxArea = area;
+                maxAreaIndex = i;
+            }
+        }
+
+        if (maxAreaIndex >= 0) {
+            points.append(_point(samples, maxAreaIndex));
+            selected = maxAreaIndex;
+        }
+    }
+
+    points.append(_point(samples, last));
+
+    return points;
+}
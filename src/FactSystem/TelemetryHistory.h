@@ -0,0 +1,119 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QPointF>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantList>
+
+#include <span>
+#include <vector>
+
+class Fact;
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryHistoryLog)
+
+/// Keeps the values of the last historySeconds of numeric Facts in fixed size ring buffers, one series per Fact.
+/// FactGroups attached with FactGroup::setTelemetryHistory record every value change they send out, so a series
+/// holds at most one sample per update interval of its FactGroup. Times and values are kept in separate arrays
+/// which queries hand out directly. Times are msecs of a monotonic clock, see nowMSecs(), so wall clock changes can not
+/// reorder a series. Must only be used on the main thread.
+class TelemetryHistory : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QStringList  seriesNames     READ seriesNames    NOTIFY seriesNamesChanged)
+    Q_PROPERTY(int          historySeconds  READ historySeconds CONSTANT)
+
+public:
+    enum Downsample {
+        DownsampleMinMax,   ///< Minimum and maximum of each bucket, keeps spikes
+        DownsampleLTTB      ///< Largest triangle three buckets, keeps the visual shape
+    };
+    Q_ENUM(Downsample)
+
+    /// Samples of a time range, in up to two contiguous parts since the ring buffer may wrap.
+    /// Only valid until the next sample is recorded.
+    struct Samples
+    {
+        std::span<const qint64> timesMSecs[2];
+        std::span<const double> values[2];
+
+        qsizetype count() const { return (timesMSecs[0].size() + timesMSecs[1].size()); }
+        qint64 timeMSecs(qsizetype index) const { return ((index < static_cast<qsizetype>(timesMSecs[0].size())) ? timesMSecs[0][index] : timesMSecs[1][index - timesMSecs[0].size()]); }
+        double value(qsizetype index) const { return ((index < static_cast<qsizetype>(values[0].size())) ? values[0][index] : values[1][index - values[0].size()]); }
+    };
+
+    explicit TelemetryHistory(int historySeconds = kDefaultHistorySeconds, QObject *parent = nullptr);
+    ~TelemetryHistory();
+
+    int historySeconds() const { return _historySeconds; }
+    QStringList seriesNames() const;
+
+    /// Starts keeping the history of a Fact, does nothing for non-numeric Facts.
+    /// A Fact added again under a name which already exists continues that series.
+    ///     @param name Series name, FactGroup path and Fact name: "gps.hdop"
+    ///     @param intervalMSecs Shortest interval between two samples, sizes the ring buffer
+    void addFact(const Fact *fact, const QString &name, int intervalMSecs);
+    /// Stops recording a Fact, its history stays available
+    void removeFact(const Fact *fact);
+
+    /// Current time of the history's clock, msecs since it was created
+    qint64 nowMSecs() const { return _clock.elapsed(); }
+
+    /// Records the current raw value of a Fact added with addFact
+    void record(const Fact *fact, qint64 timeMSecs);
+    /// Times before the last sample of the series are recorded as the time of the last sample
+    void record(int seriesIndex, qint64 timeMSecs, double value);
+
+    /// @return Series index for use with samples(), -1 if unknown
+    int seriesIndex(const QString &name) const { return _seriesNameToIndex.value(name, -1); }
+
+    /// @return Samples with times in [fromMSecs, toMSecs]
+    Samples samples(int seriesIndex, qint64 fromMSecs, qint64 toMSecs) const;
+
+    /// Downsampled samples of a time range as QPointF(time in msecs, value), NaN values are left out
+    QList<QPointF> downsample(int seriesIndex, qint64 fromMSecs, qint64 toMSecs, int maxPoints, Downsample method) const;
+
+    /// QML helper: downsampled history of the last seconds
+    Q_INVOKABLE QVariantList history(const QString &name, int seconds, int maxPoints, Downsample method = DownsampleLTTB) const;
+
+    static QList<QPointF> downsampleMinMax(const Samples &samples, int maxPoints);
+    static QList<QPointF> downsampleLTTB(const Samples &samples, int maxPoints);
+
+    static constexpr int kDefaultHistorySeconds = 5 * 60;
+
+signals:
+    void seriesNamesChanged();
+
+private:
+    struct Series
+    {
+        qsizetype capacity = 0;
+        qsizetype start = 0;        ///< Index of the oldest sample
+        qsizetype count = 0;
+        std::vector<qint64> timesMSecs; ///< Allocated to capacity on the first sample
+        std::vector<double> values;
+    };
+
+    qsizetype _lowerBound(const Series &series, qint64 timeMSecs) const;
+
+    const int _historySeconds;
+    QElapsedTimer _clock;
+    std::vector<Series> _series;
+    QHash<QString, int> _seriesNameToIndex;
+    QHash<const Fact*, int> _factToSeriesIndex;
+
+    static constexpr int kMinIntervalMSecs = 10;
+};
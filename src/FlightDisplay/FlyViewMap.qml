@@ -42,7 +42,7 @@ FlightMap {
     property var    _planMasterController:      planMasterController
     property var    _geoFenceController:        planMasterController.geoFenceController
     property var    _rallyPointController:      planMasterController.rallyPointController
-    property var    _activeVehicleCoordinate:   _activeVehicle ? _activeVehicle.coordinate : QtPositioning.coordinate()
+    property var    _activeVehicleCoordinate:   _activeVehicle ? _activeVehicle.stateSnapshot.coordinate : QtPositioning.coordinate()
     property real   _toolButtonTopMargin:       parent.height - mainWindow.height + (ScreenTools.defaultFontPixelHeight / 2)
     property real   _toolsMargin:               ScreenTools.defaultFontPixelWidth * 0.75
     property var    _flyViewSettings:           QGroundControl.settingsManager.flyViewSettings
@@ -276,7 +276,7 @@ FlightMap {
         model: QGroundControl.multiVehicleManager.vehicles
         delegate: VehicleMapItem {
             vehicle:        object
-            coordinate:     object.coordinate
+            coordinate:     object.stateSnapshot.coordinate
             map:            _root
             size:           pipMode ? ScreenTools.defaultFontPixelHeight : ScreenTools.defaultFontPixelHeight * 3
             z:              QGroundControl.zOrderVehicles
@@ -287,7 +287,7 @@ FlightMap {
         model: QGroundControl.multiVehicleManager.vehicles
         delegate: ProximityRadarMapView {
             vehicle:        object
-            coordinate:     object.coordinate
+            coordinate:     object.stateSnapshot.coordinate
             map:            _root
             z:              QGroundControl.zOrderVehicles
         }
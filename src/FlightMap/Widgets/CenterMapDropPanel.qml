@@ -63,7 +63,7 @@ ColumnLayout {
     QGCButton {
         text:               qsTr("Vehicle")
         Layout.fillWidth:   true
-        enabled:            globals.activeVehicle && globals.activeVehicle.coordinate.isValid
+        enabled:            globals.activeVehicle && globals.activeVehicle.stateSnapshot.coordinate.isValid
 
         onClicked: {
             dropPanel.hide()
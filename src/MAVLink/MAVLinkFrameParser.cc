@@ -0,0 +1,201 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFrameParser.h"
+#include "QGCLoggingCategory.h"
+#include "QGCMAVLink.h"
+
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(MAVLinkFrameParserLog, "qgc.mavlink.mavlinkframeparser")
+
+namespace
+{
+
+constexpr qsizetype kHeaderLenV1 = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1;
+constexpr qsizetype kHeaderLenV2 = MAVLINK_CORE_HEADER_LEN + 1;
+
+bool _parserIdle(const mavlink_status_t *status)
+{
+    return (status->parse_state == MAVLINK_PARSE_STATE_UNINIT) || (status->parse_state == MAVLINK_PARSE_STATE_IDLE);
+}
+
+bool _isStx(uint8_t byte)
+{
+    return (byte == MAVLINK_STX) || (byte == MAVLINK_STX_MAVLINK1);
+}
+
+} // namespace
+
+MAVLinkFrameParser::MAVLinkFrameParser(uint8_t mavlinkChannel, bool privateStatus)
+    : _mavlinkChannel(mavlinkChannel)
+    , _privateStatus(privateStatus)
+{
+
+}
+
+void MAVLinkFrameParser::reset(uint8_t mavlinkChannel)
+{
+    _mavlinkChannel = mavlinkChannel;
+    (void) memset(&_status, 0, sizeof(_status));
+    (void) memset(&_rxMessage, 0, sizeof(_rxMessage));
+    _bulkFrameCount = 0;
+    _byteFrameCount = 0;
+}
+
+qsizetype MAVLinkFrameParser::parse(const QByteArray &data, QList<mavlink_message_t> &messages)
+{
+    return parse(reinterpret_cast<const uint8_t*>(data.constData()), data.size(), messages);
+}
+
+qsizetype MAVLinkFrameParser::parse(const uint8_t *data, qsizetype size, QList<mavlink_message_t> &messages)
+{
+    if (!QGCMAVLink::isValidChannel(_mavlinkChannel)) {
+        qCWarning(MAVLinkFrameParserLog) << Q_FUNC_INFO << "Invalid Channel Number:" << _mavlinkChannel;
+        return 0;
+    }
+
+    mavlink_status_t *status = mavlink_get_channel_status(_mavlinkChannel);
+    if (_privateStatus) {
+        // Signing can be set up or torn down on the channel at any time
+        _status.signing = status->signing;
+        _status.signing_streams = status->signing_streams;
+        status = &_status;
+    }
+
+    const qsizetype startCount = messages.size();
+
+    qsizetype index = 0;
+    while (index < size) {
+        if (_parserIdle(status)) {
+            // Bytes outside of a frame have no effect on the state machine, skip straight to the next STX
+            while ((index < size) && !_isStx(data[index])) {
+                index++;
+            }
+            if (index == size) {
+                break;
+            }
+
+            const qsizetype frameLen = _parseFrame(data + index, size - index, status, _scratchMessage);
+            if (frameLen > 0) {
+                messages.append(_scratchMessage);
+                _bulkFrameCount++;
+                index += frameLen;
+                continue;
+            }
+        }
+
+        // Partial, signed or damaged frame: run the state machine until it is back to idle
+        do {
+            if (_parseChar(data[index++], status, _scratchMessage) == MAVLINK_FRAMING_OK) {
+                messages.append(_scratchMessage);
+                _byteFrameCount++;
+            }
+        } while ((index < size) && !_parserIdle(status));
+    }
+
+    return (messages.size() - startCount);
+}
+
+/// Decodes a complete frame starting at data[0] in a single pass.
+///     @return Length of the frame, 0 if the frame must go through the per-byte state machine
+qsizetype MAVLinkFrameParser::_parseFrame(const uint8_t *data, qsizetype size, mavlink_status_t *status, mavlink_message_t &message) const
+{
+    if (status->signing) {
+        return 0;
+    }
+
+    const bool mavlink1 = (data[0] == MAVLINK_STX_MAVLINK1);
+    const qsizetype headerLen = mavlink1 ? kHeaderLenV1 : kHeaderLenV2;
+    if (size < headerLen) {
+        return 0;
+    }
+
+    const uint8_t payloadLen = data[1];
+    if (!mavlink1 && (data[2] != 0)) {
+        // Signed or carrying unknown incompatibility flags
+        return 0;
+    }
+
+    const qsizetype frameLen = headerLen + payloadLen + MAVLINK_NUM_CHECKSUM_BYTES;
+    if (size < frameLen) {
+        return 0;
+    }
+
+    const uint32_t msgid = mavlink1 ? data[5] : (data[7] | (data[8] << 8) | (static_cast<uint32_t>(data[9]) << 16));
+    const mavlink_msg_entry_t *const entry = mavlink_get_msg_entry(msgid);
+    if (!entry) {
+        return 0;
+    }
+
+    uint16_t crc = crc_calculate(data + 1, static_cast<uint16_t>(headerLen - 1 + payloadLen));
+    crc_accumulate(entry->crc_extra, &crc);
+    const uint8_t ck0 = data[frameLen - 2];
+    const uint8_t ck1 = data[frameLen - 1];
+    if ((ck0 != (crc & 0xFF)) || (ck1 != (crc >> 8))) {
+        return 0;
+    }
+
+    message.checksum = crc;
+    message.magic = data[0];
+    message.len = payloadLen;
+    message.incompat_flags = 0;
+    message.compat_flags = mavlink1 ? 0 : data[3];
+    message.seq = data[mavlink1 ? 2 : 4];
+    message.sysid = data[mavlink1 ? 3 : 5];
+    message.compid = data[mavlink1 ? 4 : 6];
+    message.msgid = msgid;
+    char *const payload = _MAV_PAYLOAD_NON_CONST(&message);
+    (void) memcpy(payload, data + headerLen, payloadLen);
+    if (payloadLen < entry->max_msg_len) {
+        // Same zero-fill the state machine does for truncated MAVLink 2 payloads
+        (void) memset(payload + payloadLen, 0, entry->max_msg_len - payloadLen);
+    }
+    message.ck[0] = ck0;
+    message.ck[1] = ck1;
+
+    // Leave the channel status exactly as mavlink_frame_char_buffer would after this frame
+    if (mavlink1) {
+        status->flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    } else {
+        status->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    }
+    status->parse_state = MAVLINK_PARSE_STATE_IDLE;
+    status->packet_idx = payloadLen;
+    status->msg_received = MAVLINK_FRAMING_OK;
+    status->current_rx_seq = message.seq;
+    if (status->packet_rx_success_count == 0) {
+        status->packet_rx_drop_count = 0;
+    }
+    status->packet_rx_success_count++;
+    status->parse_error = 0;
+
+    return frameLen;
+}
+
+/// Equivalent of mavlink_parse_char using the parser owned frame buffer
+uint8_t MAVLinkFrameParser::_parseChar(uint8_t byte, mavlink_status_t *status, mavlink_message_t &message)
+{
+    const uint8_t result = mavlink_frame_char_buffer(&_rxMessage, status, byte, &message, nullptr);
+    if ((result != MAVLINK_FRAMING_BAD_CRC) && (result != MAVLINK_FRAMING_BAD_SIGNATURE)) {
+        return result;
+    }
+
+    // Treat bad frames as a parse failure and resync
+    status->parse_error++;
+    status->msg_received = MAVLINK_FRAMING_INCOMPLETE;
+    status->parse_state = MAVLINK_PARSE_STATE_IDLE;
+    if (byte == MAVLINK_STX) {
+        status->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+        _rxMessage.len = 0;
+        mavlink_start_checksum(&_rxMessage);
+    }
+
+    return MAVLINK_FRAMING_INCOMPLETE;
+}
@@ -0,0 +1,66 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkFrameParserLog)
+
+/// Frame level MAVLink parser which works on whole receive buffers instead of single bytes.
+/// Between frames the buffer is scanned for the next STX. Frames which are fully contained in the
+/// buffer, unsigned and have no incompatibility flags are length/CRC checked in one pass and copied
+/// out directly. Everything else (frames split across buffers, signed frames, signing enabled channels,
+/// bad CRCs) is handed to the MAVLink per-byte state machine so the results are identical to feeding
+/// every byte through mavlink_parse_char.
+/// The channel status (signing, protocol version flags, counters) is shared with the mavlink library,
+/// the partial frame buffer is owned by the parser.
+/// A parser with a private status keeps its own state machine and counters and only takes the signing setup from
+/// the channel. Links which multiplex several senders use one of those per sender, so a damaged frame of one
+/// sender can not swallow frames of another one. Parsers running on link threads use one as well, the channel status
+/// is written by the main thread when it switches the protocol version and packs outgoing messages.
+class MAVLinkFrameParser
+{
+public:
+    MAVLinkFrameParser() = default;
+    explicit MAVLinkFrameParser(uint8_t mavlinkChannel, bool privateStatus = false);
+
+    uint8_t mavlinkChannel() const { return _mavlinkChannel; }
+    bool hasPrivateStatus() const { return _privateStatus; }
+
+    /// Re-targets the parser to the specified channel and drops any partially received frame
+    void reset(uint8_t mavlinkChannel);
+
+    /// Parses the buffer and appends all complete frames to messages
+    ///     @return Number of frames appended
+    qsizetype parse(const QByteArray &data, QList<mavlink_message_t> &messages);
+    qsizetype parse(const uint8_t *data, qsizetype size, QList<mavlink_message_t> &messages);
+
+    /// Number of frames which were decoded through the bulk path since the last reset
+    quint64 bulkFrameCount() const { return _bulkFrameCount; }
+
+    /// Number of frames which were decoded through the per-byte path since the last reset
+    quint64 byteFrameCount() const { return _byteFrameCount; }
+
+private:
+    qsizetype _parseFrame(const uint8_t *data, qsizetype size, mavlink_status_t *status, mavlink_message_t &message) const;
+    uint8_t _parseChar(uint8_t byte, mavlink_status_t *status, mavlink_message_t &message);
+
+    uint8_t _mavlinkChannel = 0;
+    bool _privateStatus = false;
+    mavlink_status_t _status{};         ///< Only used with a private status
+    mavlink_message_t _rxMessage{};     ///< Partial frame buffer for the per-byte state machine
+    mavlink_message_t _scratchMessage{};
+    quint64 _bulkFrameCount = 0;
+    quint64 _byteFrameCount = 0;
+};
@@ -33,21 +33,23 @@ typedef enum : uint8_t {
 } mavlink_channel_t;
 #endif
 
-#define MAVLINK_COMM_NUM_BUFFERS 16
-#define MAVLINK_MAX_SIGNING_STREAMS MAVLINK_COMM_NUM_BUFFERS
+// Every uint8_t channel id except 255 (LinkManager::invalidMavlinkChannel) is usable. The library state of a
+// channel is only allocated when the channel is first used, see QGCMAVLink.cc.
+#define MAVLINK_COMM_NUM_BUFFERS 255
+#define MAVLINK_MAX_SIGNING_STREAMS 256
 
 #include <mavlink_types.h>
 
-#define MAVLINK_EXTERNAL_RX_STATUS
-#ifdef MAVLINK_EXTERNAL_RX_STATUS
-    extern mavlink_status_t m_mavlink_status[MAVLINK_COMM_NUM_BUFFERS];
-#endif
-
 #define MAVLINK_GET_CHANNEL_STATUS
 #ifdef MAVLINK_GET_CHANNEL_STATUS
     extern mavlink_status_t* mavlink_get_channel_status(uint8_t chan);
 #endif
 
+#define MAVLINK_GET_CHANNEL_BUFFER
+#ifdef MAVLINK_GET_CHANNEL_BUFFER
+    extern mavlink_message_t* mavlink_get_channel_buffer(uint8_t chan);
+#endif
+
 // #define MAVLINK_NO_SIGN_PACKET
 // #define MAVLINK_NO_SIGNATURE_CHECK
 #define MAVLINK_USE_MESSAGE_INFO
@@ -88,10 +88,9 @@ bool initSigning(mavlink_channel_t channel, QByteArrayView key, mavlink_accept_u
         status->signing = nullptr;
         status->signing_streams = nullptr;
     } else {
-        static mavlink_signing_t s_signing[MAVLINK_COMM_NUM_BUFFERS];
         static mavlink_signing_streams_t s_signing_streams;
 
-        mavlink_signing_t* const signing = &s_signing[channel];
+        mavlink_signing_t* const signing = QGCMAVLink::getChannelSigning(channel);
         signing->link_id = channel;
         signing->flags |= MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
         signing->accept_unsigned_callback = callback;
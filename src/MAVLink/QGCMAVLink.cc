@@ -10,6 +10,10 @@
 #include "QGCMAVLink.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QSet>
+
+#include <atomic>
+
 QGC_LOGGING_CATEGORY(QGCMAVLinkLog, "qgc.mavlink.qgcmavlink")
 
 const QHash<int, QString> QGCMAVLink::mavlinkCompIdHash {
@@ -49,24 +53,81 @@ const QHash<int, QString> QGCMAVLink::mavlinkCompIdHash {
     { MAV_COMP_ID_GPS2,     "GPS2" }
 };
 
-#ifdef MAVLINK_EXTERNAL_RX_STATUS
-    mavlink_status_t m_mavlink_status[MAVLINK_COMM_NUM_BUFFERS];
-#endif
+namespace
+{
 
-#ifdef MAVLINK_GET_CHANNEL_STATUS
-mavlink_status_t* mavlink_get_channel_status(uint8_t channel)
+/// State the mavlink library keeps for a channel
+struct ChannelState
+{
+    mavlink_status_t status{};
+    mavlink_message_t buffer{};     ///< Partial frame of mavlink_parse_char
+    mavlink_signing_t signing{};
+};
+
+/// Channel states are created the first time a channel is used and then stay at the same address, the mavlink
+/// library and the links hold on to the pointers. Lookups are lock free, links use their channels from their own threads.
+class ChannelRegistry
+{
+public:
+    ~ChannelRegistry()
+    {
+        for (std::atomic<ChannelState*> &state : _states) {
+            delete state.load();
+        }
+    }
+
+    ChannelState *state(uint8_t channel)
+    {
+        ChannelState *state = _states[channel].load(std::memory_order_acquire);
+        if (state) {
+            return state;
+        }
+
+        ChannelState *const newState = new ChannelState();
+        if (_states[channel].compare_exchange_strong(state, newState, std::memory_order_acq_rel)) {
+            return newState;
+        }
+
+        // Another thread got there first
+        delete newState;
+        return state;
+    }
+
+private:
+    std::atomic<ChannelState*> _states[MAVLINK_COMM_NUM_BUFFERS]{};
+};
+
+ChannelState *_channelState(uint8_t channel)
 {
-#ifndef MAVLINK_EXTERNAL_RX_STATUS
-    static QList<mavlink_status_t> m_mavlink_status(MAVLINK_COMM_NUM_BUFFERS);
-#endif
+    static ChannelRegistry registry;
+
     if (!QGCMAVLink::isValidChannel(channel)) {
         qCWarning(QGCMAVLinkLog) << Q_FUNC_INFO << "Invalid Channel Number:" << channel;
         return nullptr;
     }
 
-    return &m_mavlink_status[channel];
+    return registry.state(channel);
+}
+
+} // namespace
+
+mavlink_status_t* mavlink_get_channel_status(uint8_t channel)
+{
+    ChannelState *const state = _channelState(channel);
+    return (state ? &state->status : nullptr);
+}
+
+mavlink_message_t* mavlink_get_channel_buffer(uint8_t channel)
+{
+    ChannelState *const state = _channelState(channel);
+    return (state ? &state->buffer : nullptr);
+}
+
+mavlink_signing_t* QGCMAVLink::getChannelSigning(uint8_t channel)
+{
+    ChannelState *const state = _channelState(channel);
+    return (state ? &state->signing : nullptr);
 }
-#endif
 
 QGCMAVLink::QGCMAVLink(QObject *parent)
     : QObject(parent)
@@ -425,6 +486,48 @@ int QGCMAVLink::motorCount(MAV_TYPE mavType, uint8_t frameType)
     }
 }
 
+bool QGCMAVLink::isLosslessMessage(uint32_t msgid)
+{
+    static const QSet<uint32_t> msgids = {
+        MAVLINK_MSG_ID_HEARTBEAT,
+        MAVLINK_MSG_ID_COMMAND_ACK,
+        MAVLINK_MSG_ID_COMMAND_LONG,
+        MAVLINK_MSG_ID_COMMAND_INT,
+        MAVLINK_MSG_ID_PARAM_VALUE,
+        MAVLINK_MSG_ID_PARAM_EXT_VALUE,
+        MAVLINK_MSG_ID_PARAM_EXT_ACK,
+        MAVLINK_MSG_ID_MISSION_ITEM,
+        MAVLINK_MSG_ID_MISSION_ITEM_INT,
+        MAVLINK_MSG_ID_MISSION_REQUEST,
+        MAVLINK_MSG_ID_MISSION_REQUEST_INT,
+        MAVLINK_MSG_ID_MISSION_REQUEST_LIST,
+        MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST,
+        MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST,
+        MAVLINK_MSG_ID_MISSION_COUNT,
+        MAVLINK_MSG_ID_MISSION_ACK,
+        MAVLINK_MSG_ID_MISSION_CLEAR_ALL,
+        MAVLINK_MSG_ID_MISSION_CURRENT,
+        MAVLINK_MSG_ID_MISSION_SET_CURRENT,
+        MAVLINK_MSG_ID_MISSION_ITEM_REACHED,
+        MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
+        MAVLINK_MSG_ID_STATUSTEXT,
+        MAVLINK_MSG_ID_EVENT,
+        MAVLINK_MSG_ID_CURRENT_EVENT_SEQUENCE,
+        MAVLINK_MSG_ID_RESPONSE_EVENT_ERROR,
+        MAVLINK_MSG_ID_LOG_ENTRY,
+        MAVLINK_MSG_ID_LOG_DATA,
+        MAVLINK_MSG_ID_LOGGING_DATA,
+        MAVLINK_MSG_ID_LOGGING_DATA_ACKED,
+        MAVLINK_MSG_ID_SERIAL_CONTROL,
+        MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE,
+        MAVLINK_MSG_ID_ENCAPSULATED_DATA,
+        MAVLINK_MSG_ID_TERRAIN_REQUEST,
+        MAVLINK_MSG_ID_TERRAIN_CHECK,
+    };
+
+    return msgids.contains(msgid);
+}
+
 uint32_t QGCMAVLink::highLatencyFailuresToMavSysStatus(mavlink_high_latency2_t& highLatency2)
 {
     struct failure2Sensor_s {
@@ -78,6 +78,10 @@ class QGCMAVLink : public QObject
     static int                      motorCount                  (MAV_TYPE mavType, uint8_t frameType = 0);
     static uint32_t                 highLatencyFailuresToMavSysStatus(mavlink_high_latency2_t& highLatency2);
 
+    /// Messages which need every sample (commands, parameters, missions, FTP, status text, events, ...). The protocols
+    /// built on them stall if one is lost, so they are never dropped or decimated on the receive path.
+    static bool                     isLosslessMessage           (uint32_t msgid);
+
     // Expose mavlink enums to Qml. I've tried various way to make this work without duping, but haven't found anything that works.
 
     enum MAV_BATTERY_FUNCTION {
@@ -163,6 +167,9 @@ class QGCMAVLink : public QObject
 
     static mavlink_status_t* getChannelStatus(mavlink_channel_t channel) { return mavlink_get_channel_status(static_cast<uint8_t>(channel)); }
 
+    /// Signing storage of the channel, only in use while the channel status points to it
+    static mavlink_signing_t* getChannelSigning(uint8_t channel);
+
     static const QHash<int, QString> mavlinkCompIdHash;
 };
 Q_DECLARE_METATYPE(GRIPPER_ACTIONS)
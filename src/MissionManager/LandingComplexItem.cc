@@ -21,6 +21,7 @@
 #include "CameraSection.h"
 #include "Vehicle.h"
 #include "QGCLoggingCategory.h"
+#include "QGCSignalCoalescer.h"
 
 QGC_LOGGING_CATEGORY(LandingComplexItemLog, "LandingComplexItemLog")
 
@@ -30,8 +31,7 @@ LandingComplexItem::LandingComplexItem(PlanMasterController* masterController, b
     _isIncomplete = false;
 
     // The following is used to compress multiple recalc calls in a row to into a single call.
-    connect(this, &LandingComplexItem::_updateFlightPathSegmentsSignal, this, &LandingComplexItem::_updateFlightPathSegmentsDontCallDirectly,   Qt::QueuedConnection);
-    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&LandingComplexItem::_updateFlightPathSegmentsSignal));
+    (void) QGCSignalCoalescer::connect(this, &LandingComplexItem::_updateFlightPathSegmentsSignal, this, &LandingComplexItem::_updateFlightPathSegmentsDontCallDirectly);
 }
 
 void LandingComplexItem::_init(void)
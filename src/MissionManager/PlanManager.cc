@@ -267,6 +267,12 @@ void PlanManager::_startAckTimeout(AckType_t ack)
         break;
     }
 
+    // Our own request may still sit in the outbound queue of a link which is paced to a byte budget
+    const SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (sharedLink) {
+        _ackTimeoutTimer->setInterval(_ackTimeoutTimer->interval() + sharedLink->outboundDelayMSecs(LinkOutboundQueue::PriorityBulk));
+    }
+
     _expectedAck = ack;
     _ackTimeoutTimer->start();
 }
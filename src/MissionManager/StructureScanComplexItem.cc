@@ -17,6 +17,7 @@
 #include "FlightPathSegment.h"
 #include "QGC.h"
 #include "QGCLoggingCategory.h"
+#include "QGCSignalCoalescer.h"
 
 #include <QtCore/QJsonArray>
 
@@ -103,8 +104,7 @@ StructureScanComplexItem::StructureScanComplexItem(PlanMasterController* masterC
     connect(_missionController,                     &MissionController::plannedHomePositionChanged, this, &StructureScanComplexItem::_updateFlightPathSegmentsSignal);
 
     // The follow is used to compress multiple recalc calls in a row to into a single call.
-    connect(this, &StructureScanComplexItem::_updateFlightPathSegmentsSignal, this, &StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly,   Qt::QueuedConnection);
-    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&StructureScanComplexItem::_updateFlightPathSegmentsSignal));
+    (void) QGCSignalCoalescer::connect(this, &StructureScanComplexItem::_updateFlightPathSegmentsSignal, this, &StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly);
 
     _recalcLayerInfo();
 
@@ -22,8 +22,6 @@ class QQuickWindow;
 class QGCImageProvider;
 class QGCApplication;
 class QEvent;
-class QPostEventList;
-class QMetaMethod;
 class QMetaObject;
 
 #if defined(qApp)
@@ -77,11 +75,6 @@ class QGCApplication : public QApplication
     QString bigSizeToString(quint64 size);
     QString bigSizeMBToString(quint64 size_MB);
 
-    /// Registers the signal such that only the last duplicate signal added is left in the queue.
-    void addCompressedSignal(const QMetaMethod &method);
-
-    void removeCompressedSignal(const QMetaMethod &method);
-
     bool event(QEvent *e) final;
 
     static QString cachedParameterMetaDataFile();
@@ -126,8 +119,6 @@ private slots:
     void _showDelayedAppMessages();
 
 private:
-    bool compressEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents) final;
-
     void _initVideo();
     
     /// Initialize the application for normal application boot. Or in other words we are not going to run unit tests.
@@ -160,25 +151,6 @@ private slots:
 
     QList<QPair<QString /* title */, QString /* message */>> _delayedAppMessages;
 
-    class CompressedSignalList
-    {
-    public:
-        CompressedSignalList() {}
-        void add(const QMetaMethod &method);
-        void remove(const QMetaMethod &method);
-        bool contains(const QMetaObject *metaObject, int signalIndex);
-
-    private:
-        /// Returns a signal index that is can be compared to QMetaCallEvent.signalId
-        static int _signalIndex(const QMetaMethod &method);
-
-        QMap<const QMetaObject*, QSet<int>> _signalMap;
-
-        Q_DISABLE_COPY(CompressedSignalList)
-    };
-
-    CompressedSignalList _compressedSignals;
-
     const QString _settingsVersionKey = QStringLiteral("SettingsVersion"); ///< Settings key which hold settings version
     static constexpr const char *_deleteAllSettingsKey = "DeleteAllSettingsNextBoot"; ///< If this settings key is set on boot, all settings will be deleted
 
@@ -102,6 +102,15 @@ Rectangle {
 
         QGCLabel { text: controller.totalTime }
 
+        QGCComboBox {
+            model: controller.events
+            textRole: "text"
+            displayText: qsTr("Events")
+            currentIndex: -1
+            visible: controller.events.length > 0
+            onActivated: (index) => controller.seekToEvent(index)
+        }
+
         QGCButton {
             text: qsTr("Load Telemetry Log")
             onClicked: pickLogFile()
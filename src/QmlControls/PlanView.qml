@@ -1112,6 +1112,19 @@ Item {
                         _planMasterController.saveKmlToSelectedFile()
                     }
                 }
+
+                QGCButton {
+                    Layout.columnSpan:  3
+                    Layout.fillWidth:   true
+                    text:               qsTr("Download Terrain For Plan")
+                    enabled:            !_planMasterController.syncInProgress && _visualItems.count > 1 && _missionController.travelBoundingCube.isValid()
+                    onClicked: {
+                        dropPanel.hide()
+                        var planName = _planMasterController.currentPlanFile !== "" ? _planMasterController.currentPlanFile.replace(/^.*[\\\/]/, "") : qsTr("Plan")
+                        QGroundControl.mapEngineManager.downloadTerrain(planName, _missionController.travelBoundingCube.pointNW, _missionController.travelBoundingCube.pointSE)
+                        mainWindow.showMessageDialog(qsTr("Download Terrain"), qsTr("Terrain for the plan area is being downloaded. Progress is shown with the offline tile sets in the map settings."))
+                    }
+                }
             }
 
             SectionHeader {
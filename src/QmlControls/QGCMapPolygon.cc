@@ -16,7 +16,6 @@
 #include "KMLDomDocument.h"
 
 #include <QtCore/QLineF>
-#include <QMetaMethod>
 
 QGCMapPolygon::QGCMapPolygon(QObject* parent)
     : QObject               (parent)
@@ -44,7 +43,6 @@ QGCMapPolygon::QGCMapPolygon(const QGCMapPolygon& other, QObject* parent)
 
 QGCMapPolygon::~QGCMapPolygon()
 {
-    qgcApp()->removeCompressedSignal(QMetaMethod::fromSignal(&QGCMapPolygon::pathChanged));
 }
 
 void QGCMapPolygon::_init(void)
@@ -55,8 +53,6 @@ void QGCMapPolygon::_init(void)
     connect(this, &QGCMapPolygon::pathChanged,  this, &QGCMapPolygon::_updateCenter);
     connect(this, &QGCMapPolygon::countChanged, this, &QGCMapPolygon::isValidChanged);
     connect(this, &QGCMapPolygon::countChanged, this, &QGCMapPolygon::isEmptyChanged);
-
-    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&QGCMapPolygon::pathChanged));
 }
 
 const QGCMapPolygon& QGCMapPolygon::operator=(const QGCMapPolygon& other)
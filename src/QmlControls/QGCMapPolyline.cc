@@ -16,7 +16,6 @@
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QLineF>
-#include <QMetaMethod>
 
 QGCMapPolyline::QGCMapPolyline(QObject* parent)
     : QObject               (parent)
@@ -40,7 +39,6 @@ QGCMapPolyline::QGCMapPolyline(const QGCMapPolyline& other, QObject* parent)
 
 QGCMapPolyline::~QGCMapPolyline()
 {
-    qgcApp()->removeCompressedSignal(QMetaMethod::fromSignal(&QGCMapPolyline::pathChanged));
 }
 
 const QGCMapPolyline& QGCMapPolyline::operator=(const QGCMapPolyline& other)
@@ -64,8 +62,6 @@ void QGCMapPolyline::_init(void)
 
     connect(this, &QGCMapPolyline::countChanged, this, &QGCMapPolyline::isValidChanged);
     connect(this, &QGCMapPolyline::countChanged, this, &QGCMapPolyline::isEmptyChanged);
-
-    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&QGCMapPolyline::pathChanged));
 }
 
 void QGCMapPolyline::clear(void)
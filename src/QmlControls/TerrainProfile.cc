@@ -14,6 +14,7 @@
 #include "ComplexMissionItem.h"
 #include "QGCLoggingCategory.h"
 #include "QGCApplication.h"
+#include "QGCSignalCoalescer.h"
 
 #include <QtQuick/QSGFlatColorMaterial>
 
@@ -28,8 +29,7 @@ TerrainProfile::TerrainProfile(QQuickItem* parent)
     connect(this, &TerrainProfile::visibleWidthChanged, this, &QQuickItem::update);
 
     // This collapse multiple _updateSignals in a row to a single update
-    connect(this, &TerrainProfile::_updateSignal, this, &QQuickItem::update, Qt::QueuedConnection);
-    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&TerrainProfile::_updateSignal));
+    (void) QGCSignalCoalescer::connect(this, &TerrainProfile::_updateSignal, this, &QQuickItem::update);
 }
 
 void TerrainProfile::componentComplete(void)
@@ -48,7 +48,7 @@ void TerrainProfile::setMissionController(MissionController* missionController)
         connect(_missionController, &MissionController::visualItemsChanged,         this, &TerrainProfile::_newVisualItems);
 
         connect(this,               &TerrainProfile::visibleWidthChanged,           this, &TerrainProfile::_updateSignal, Qt::QueuedConnection);
-        connect(_missionController, &MissionController::recalcTerrainProfile,       this, &TerrainProfile::_updateSignal, Qt::QueuedConnection);
+        (void) QGCSignalCoalescer::connect(_missionController, &MissionController::recalcTerrainProfile, this, &TerrainProfile::_updateSignal);
     }
 }
 
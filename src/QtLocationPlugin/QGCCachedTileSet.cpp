@@ -24,6 +24,7 @@
 #include "QGCMapUrlEngine.h"
 #include "QGeoFileTileCacheQGC.h"
 #include "QGeoTileFetcherQGC.h"
+#include "TerrainOfflineDatabase.h"
 
 #include <QGCApplication.h>
 #include <QGCFileDownload.h>
@@ -236,6 +237,9 @@ void QGCCachedTileSet::_networkReplyFinished()
     }
 
     QGeoFileTileCacheQGC::cacheTile(type, hash, image, format, _id);
+    if (mapProvider->isElevationProvider()) {
+        (void) TerrainOfflineDatabase::instance()->addCachedTile(hash, image);
+    }
 
     QGCUpdateTileDownloadStateTask* const task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateComplete, hash);
     getQGCMapEngine()->addTask(task);
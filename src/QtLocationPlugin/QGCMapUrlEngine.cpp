@@ -280,6 +280,19 @@ QString UrlFactory::tileHashToType(QStringView tileHash)
     return providerTypeFromHash(providerHash);
 }
 
+bool UrlFactory::tileHashToTile(QStringView tileHash, int &x, int &y, int &z)
+{
+    if (tileHash.size() != 29) {
+        return false;
+    }
+
+    bool xOk, yOk, zOk;
+    x = tileHash.mid(10, 8).toInt(&xOk);
+    y = tileHash.mid(18, 8).toInt(&yOk);
+    z = tileHash.mid(26, 3).toInt(&zOk);
+    return (xOk && yOk && zOk);
+}
+
 QString UrlFactory::getTileHash(QStringView type, int x, int y, int z)
 {
     const int hash = hashFromProviderType(type);
@@ -55,6 +55,7 @@ class UrlFactory
 
     static int hashFromProviderType(QStringView type);
     static QString tileHashToType(QStringView tileHash);
+    static bool tileHashToTile(QStringView tileHash, int &x, int &y, int &z);
     static QString getTileHash(QStringView type, int x, int y, int z);
 
 private:
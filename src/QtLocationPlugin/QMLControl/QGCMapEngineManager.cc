@@ -18,6 +18,8 @@
 #include "QGeoFileTileCacheQGC.h"
 #include "ElevationMapProvider.h"
 #include "QmlObjectListModel.h"
+#include "TerrainLocalDem.h"
+#include "TerrainOfflineDatabase.h"
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "FlightMapSettings.h"
@@ -45,6 +47,10 @@ QGCMapEngineManager::QGCMapEngineManager(QObject *parent)
     (void) qmlRegisterUncreatableType<QGCMapEngineManager>("QGroundControl.QGCMapEngineManager", 1, 0, "QGCMapEngineManager", "Reference only");
 
     (void) connect(getQGCMapEngine(), &QGCMapEngine::updateTotals, this, &QGCMapEngineManager::_updateTotals);
+    (void) connect(TerrainLocalDem::instance(), &TerrainLocalDem::dataChanged, this, &QGCMapEngineManager::elevationDataImportedChanged);
+    (void) connect(TerrainLocalDem::instance(), &TerrainLocalDem::importingChanged, this, &QGCMapEngineManager::elevationDataImportingChanged);
+    (void) connect(TerrainLocalDem::instance(), &TerrainLocalDem::importProgress, this, &QGCMapEngineManager::_actionProgressHandler);
+    (void) connect(TerrainLocalDem::instance(), &TerrainLocalDem::importFinished, this, &QGCMapEngineManager::_elevationImportFinished);
 
     // qCDebug(QGCMapEngineManagerLog) << Q_FUNC_INFO << this;
 }
@@ -166,6 +172,47 @@ void QGCMapEngineManager::startDownload(const QString &name, const QString &mapT
     }
 }
 
+void QGCMapEngineManager::downloadTerrain(const QString &name, const QGeoCoordinate &topLeft, const QGeoCoordinate &bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid()) {
+        qCWarning(QGCMapEngineManagerLog) << Q_FUNC_INFO << "Invalid area";
+        return;
+    }
+
+    const double north = qMax(topLeft.latitude(), bottomRight.latitude());
+    const double south = qMin(topLeft.latitude(), bottomRight.latitude());
+    const double west = qMin(topLeft.longitude(), bottomRight.longitude());
+    const double east = qMax(topLeft.longitude(), bottomRight.longitude());
+
+    const QString elevationProviderName = SettingsManager::instance()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
+
+    // Tiles already in the map cache are not downloaded again by the tile set, so they are copied over directly
+    TerrainOfflineDatabase::instance()->importFromTileCache(elevationProviderName, QGeoCoordinate(north, west), QGeoCoordinate(south, east));
+
+    const QGCTileSet elevationSet = UrlFactory::getTileCount(1, west, north, east, south, elevationProviderName);
+    if (elevationSet.tileCount == 0) {
+        qCWarning(QGCMapEngineManagerLog) << Q_FUNC_INFO << "No Tiles to save";
+        return;
+    }
+
+    QGCCachedTileSet* const set = new QGCCachedTileSet(name + QStringLiteral(" Terrain"));
+    set->setMapTypeStr(elevationProviderName);
+    set->setTopleftLat(north);
+    set->setTopleftLon(west);
+    set->setBottomRightLat(south);
+    set->setBottomRightLon(east);
+    set->setMinZoom(1);
+    set->setMaxZoom(1);
+    set->setTotalTileSize(elevationSet.tileSize);
+    set->setTotalTileCount(static_cast<quint32>(elevationSet.tileCount));
+    set->setType(elevationProviderName);
+
+    QGCCreateTileSetTask* const task = new QGCCreateTileSetTask(set);
+    (void) connect(task, &QGCCreateTileSetTask::tileSetSaved, this, &QGCMapEngineManager::_tileSetSaved);
+    (void) connect(task, &QGCMapTask::error, this, &QGCMapEngineManager::taskError);
+    (void) getQGCMapEngine()->addTask(task);
+}
+
 void QGCMapEngineManager::_tileSetSaved(QGCCachedTileSet *set)
 {
     qCDebug(QGCMapEngineManagerLog) << "New tile set saved (" << set->name() << "). Starting download...";
@@ -375,6 +422,54 @@ bool QGCMapEngineManager::importSets(const QString &path)
     return true;
 }
 
+bool QGCMapEngineManager::importElevationData(const QString &path)
+{
+    setImportAction(ActionNone);
+
+    if (path.isEmpty() || !TerrainLocalDem::instance()->startImport(path)) {
+        return false;
+    }
+
+    _elevationImportCanceled = false;
+    setActionProgress(0);
+    setImportAction(ActionImporting);
+
+    return true;
+}
+
+void QGCMapEngineManager::cancelElevationDataImport()
+{
+    _elevationImportCanceled = true;
+    TerrainLocalDem::instance()->cancelImport();
+}
+
+void QGCMapEngineManager::_elevationImportFinished(bool success, const QString &errorString)
+{
+    setImportAction(ActionDone);
+
+    if (!success && !_elevationImportCanceled) {
+        qCWarning(QGCMapEngineManagerLog) << Q_FUNC_INFO << errorString;
+        setErrorMessage(tr("Elevation data import failed: %1").arg(errorString));
+    }
+}
+
+void QGCMapEngineManager::clearElevationData()
+{
+    // Clearing cancels a running import
+    _elevationImportCanceled = true;
+    TerrainLocalDem::instance()->clear();
+}
+
+bool QGCMapEngineManager::elevationDataImported() const
+{
+    return !TerrainLocalDem::instance()->isEmpty();
+}
+
+bool QGCMapEngineManager::elevationDataImporting() const
+{
+    return TerrainLocalDem::instance()->importing();
+}
+
 bool QGCMapEngineManager::exportSets(const QString &path)
 {
     setImportAction(ActionNone);
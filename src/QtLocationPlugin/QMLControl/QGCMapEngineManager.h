@@ -18,6 +18,7 @@
 
 // #include <QtQmlIntegration/QtQmlIntegration>
 #include <QtCore/QLoggingCategory>
+#include <QtPositioning/QGeoCoordinate>
 
 Q_DECLARE_LOGGING_CATEGORY(QGCMapEngineManagerLog)
 
@@ -45,6 +46,8 @@ class QGCMapEngineManager : public QObject
     Q_PROPERTY(QStringList          elevationProviderList   READ elevationProviderList              CONSTANT)
     Q_PROPERTY(quint64              tileCount       READ tileCount                                  NOTIFY tileCountChanged)
     Q_PROPERTY(quint64              tileSize        READ tileSize                                   NOTIFY tileSizeChanged)
+    Q_PROPERTY(bool                 elevationDataImported   READ elevationDataImported              NOTIFY elevationDataImportedChanged)
+    Q_PROPERTY(bool                 elevationDataImporting  READ elevationDataImporting             NOTIFY elevationDataImportingChanged)
 
 public:
     QGCMapEngineManager(QObject *parent = nullptr);
@@ -62,8 +65,14 @@ class QGCMapEngineManager : public QObject
     Q_INVOKABLE bool exportSets(const QString &path = QString());
     Q_INVOKABLE bool findName(const QString &name) const;
     Q_INVOKABLE bool importSets(const QString &path = QString());
+    /// Starts importing a local elevation raster (SRTM .hgt, GeoTIFF) into the terrain used for queries, progress is
+    /// reported through actionProgress
+    Q_INVOKABLE bool importElevationData(const QString &path);
+    Q_INVOKABLE void cancelElevationDataImport();
+    Q_INVOKABLE void clearElevationData();
     Q_INVOKABLE QString getUniqueName() const;
     Q_INVOKABLE void deleteTileSet(QGCCachedTileSet *tileSet);
+    Q_INVOKABLE void downloadTerrain(const QString &name, const QGeoCoordinate &topLeft, const QGeoCoordinate &bottomRight);
     Q_INVOKABLE void loadTileSets();
     Q_INVOKABLE void renameTileSet(QGCCachedTileSet *tileSet, const QString &newName);
     Q_INVOKABLE void resetAction() { setImportAction(ActionNone); }
@@ -85,6 +94,8 @@ class QGCMapEngineManager : public QObject
     QString tileSizeStr() const;
     quint64 tileCount() const { return (_imageSet.tileCount + _elevationSet.tileCount); }
     quint64 tileSize() const { return (_imageSet.tileSize + _elevationSet.tileSize); }
+    bool elevationDataImported() const;
+    bool elevationDataImporting() const;
 
     void setActionProgress(int percentage) { if (percentage != _actionProgress) { _actionProgress = percentage; emit actionProgressChanged(); } }
     void setErrorMessage(const QString &error) { if (error != _errorMessage) { _errorMessage = error; emit errorMessageChanged(); } }
@@ -96,6 +107,8 @@ class QGCMapEngineManager : public QObject
 
 signals:
     void actionProgressChanged();
+    void elevationDataImportedChanged();
+    void elevationDataImportingChanged();
     void errorMessageChanged();
     void fetchElevationChanged();
     void freeDiskSpaceChanged();
@@ -112,6 +125,7 @@ public slots:
 private slots:
     void _actionCompleted();
     void _actionProgressHandler(int percentage) { setActionProgress(percentage); }
+    void _elevationImportFinished(bool success, const QString &errorString);
     void _resetCompleted() { loadTileSets(); }
     void _tileSetDeleted(quint64 setID);
     void _tileSetFetched(QGCCachedTileSet *tileSets);
@@ -134,6 +148,7 @@ private slots:
     QString _errorMessage;
     bool _fetchElevation = true;
     bool _importReplace = false;
+    bool _elevationImportCanceled = false;
 
     static constexpr const char *kQmlOfflineMapKeyName = "QGCOfflineMap";
 };
@@ -21,4 +21,5 @@ class MapsSettings : public SettingsGroup
 
     DEFINE_SETTINGFACT(maxCacheDiskSize)
     DEFINE_SETTINGFACT(maxCacheMemorySize)
+    DEFINE_SETTINGFACT(maxTerrainCacheMemorySize)
 };
@@ -44,6 +44,7 @@ DECLARE_SETTINGGROUP(Mavlink, "")
 
 DECLARE_SETTINGSFACT(MavlinkSettings, telemetrySave)
 DECLARE_SETTINGSFACT(MavlinkSettings, telemetrySaveNotArmed)
+DECLARE_SETTINGSFACT(MavlinkSettings, telemetryLogSyncInterval)
 DECLARE_SETTINGSFACT(MavlinkSettings, apmStartMavlinkStreams)
 DECLARE_SETTINGSFACT(MavlinkSettings, saveCsvTelemetry)
 DECLARE_SETTINGSFACT(MavlinkSettings, forwardMavlink)
@@ -52,6 +53,8 @@ DECLARE_SETTINGSFACT(MavlinkSettings, forwardMavlinkAPMSupportHostName)
 DECLARE_SETTINGSFACT(MavlinkSettings, sendGCSHeartbeat)
 DECLARE_SETTINGSFACT(MavlinkSettings, gcsMavlinkSystemID)
 DECLARE_SETTINGSFACT(MavlinkSettings, requireMatchingMavlinkVersions)
+DECLARE_SETTINGSFACT(MavlinkSettings, decodeOnLinkThreads)
+DECLARE_SETTINGSFACT(MavlinkSettings, telemetryDecimationRate)
 
 DECLARE_SETTINGSFACT_NO_FUNC(MavlinkSettings, mavlink2SigningKey)
 {
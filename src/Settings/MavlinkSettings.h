@@ -23,6 +23,7 @@ class MavlinkSettings : public SettingsGroup
 
     DEFINE_SETTINGFACT(telemetrySave)
     DEFINE_SETTINGFACT(telemetrySaveNotArmed)
+    DEFINE_SETTINGFACT(telemetryLogSyncInterval)
     DEFINE_SETTINGFACT(saveCsvTelemetry)
     DEFINE_SETTINGFACT(forwardMavlink)
     DEFINE_SETTINGFACT(forwardMavlinkHostName)
@@ -31,6 +32,8 @@ class MavlinkSettings : public SettingsGroup
     DEFINE_SETTINGFACT(sendGCSHeartbeat)
     DEFINE_SETTINGFACT(gcsMavlinkSystemID)
     DEFINE_SETTINGFACT(requireMatchingMavlinkVersions)
+    DEFINE_SETTINGFACT(decodeOnLinkThreads)
+    DEFINE_SETTINGFACT(telemetryDecimationRate)
 
     // Although this is a global setting it only affects ArduPilot vehicle since PX4 automatically starts the stream from the vehicle side
     DEFINE_SETTINGFACT(apmStartMavlinkStreams)
@@ -0,0 +1,639 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainDemFile.h"
+#include "QGCGeo.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QtEndian>
+#include <QtCore/QtMath>
+#include <QtPositioning/QGeoCoordinate>
+
+#include <algorithm>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TerrainDemFileLog, "qgc.terrain.terraindemfile")
+
+namespace
+{
+
+constexpr double kMetersPerDegree = 111320.;
+
+constexpr int kHgtNoData = -32768;
+
+/// TIFF tags
+constexpr int kTagImageWidth = 256;
+constexpr int kTagImageLength = 257;
+constexpr int kTagBitsPerSample = 258;
+constexpr int kTagCompression = 259;
+constexpr int kTagStripOffsets = 273;
+constexpr int kTagSamplesPerPixel = 277;
+constexpr int kTagRowsPerStrip = 278;
+constexpr int kTagPlanarConfiguration = 284;
+constexpr int kTagTileWidth = 322;
+constexpr int kTagTileLength = 323;
+constexpr int kTagTileOffsets = 324;
+constexpr int kTagSampleFormat = 339;
+constexpr int kTagModelPixelScale = 33550;
+constexpr int kTagModelTiepoint = 33922;
+constexpr int kTagModelTransformation = 34264;
+constexpr int kTagGeoKeyDirectory = 34735;
+constexpr int kTagGdalNoData = 42113;
+
+/// GeoTIFF keys
+constexpr int kKeyModelType = 1024;
+constexpr int kKeyRasterType = 1025;
+constexpr int kKeyGeographicType = 2048;
+constexpr int kKeyProjectedType = 3072;
+constexpr int kKeyProjectedLinearUnits = 3076;
+
+constexpr int kModelTypeProjected = 1;
+constexpr int kModelTypeGeographic = 2;
+constexpr int kRasterPixelIsPoint = 2;
+constexpr int kLinearUnitMeter = 9001;
+
+template<typename T>
+T readValue(const uchar *data, bool bigEndian)
+{
+    return (bigEndian ? qFromBigEndian<T>(data) : qFromLittleEndian<T>(data));
+}
+
+int tiffTypeSize(int type)
+{
+    switch (type) {
+    case 1:     // BYTE
+    case 2:     // ASCII
+    case 6:     // SBYTE
+    case 7:     // UNDEFINED
+        return 1;
+    case 3:     // SHORT
+    case 8:     // SSHORT
+        return 2;
+    case 4:     // LONG
+    case 9:     // SLONG
+    case 11:    // FLOAT
+        return 4;
+    case 5:     // RATIONAL
+    case 10:    // SRATIONAL
+    case 12:    // DOUBLE
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+TerrainDemFile::TerrainDemFile(const QString &filePath)
+    : _file(filePath)
+{
+    // qCDebug(TerrainDemFileLog) << Q_FUNC_INFO << this;
+
+    if (!_file.open(QIODevice::ReadOnly)) {
+        (void) _fail(QObject::tr("Unable to open %1: %2").arg(filePath, _file.errorString()));
+        return;
+    }
+
+    _size = _file.size();
+    _data = (_size > 0) ? _file.map(0, _size) : nullptr;
+    if (!_data) {
+        (void) _fail(QObject::tr("Unable to map %1: %2").arg(filePath, _file.errorString()));
+        return;
+    }
+
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == QStringLiteral("hgt")) {
+        _isValid = _openHgt();
+    } else if ((suffix == QStringLiteral("tif")) || (suffix == QStringLiteral("tiff"))) {
+        _isValid = _openGeoTiff();
+    } else {
+        (void) _fail(QObject::tr("Unsupported file type: %1").arg(suffix));
+    }
+
+    if (_isValid) {
+        _isValid = _setBounds();
+    }
+
+    if (_isValid) {
+        qCDebug(TerrainDemFileLog) << "opened" << filePath << _width << "x" << _height
+                                   << "bounds" << _southLat << _westLon << _northLat << _eastLon
+                                   << "spacing" << _sampleSpacingMeters << "utm zone" << _utmZone;
+    }
+}
+
+TerrainDemFile::~TerrainDemFile()
+{
+    if (_data) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+    }
+
+    // qCDebug(TerrainDemFileLog) << Q_FUNC_INFO << this;
+}
+
+bool TerrainDemFile::_fail(const QString &errorString)
+{
+    qCWarning(TerrainDemFileLog) << errorString;
+    _errorString = errorString;
+    _isValid = false;
+    return false;
+}
+
+bool TerrainDemFile::_openHgt()
+{
+    // The name is the south west corner of the 1x1 degree cell, e.g. N47E008.hgt
+    static const QRegularExpression nameRegExp(QStringLiteral("^([NS])(\\d{2})([EW])(\\d{3})$"), QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = nameRegExp.match(QFileInfo(_file.fileName()).completeBaseName());
+    if (!match.hasMatch()) {
+        return _fail(QObject::tr("SRTM file name must name the south west corner, like N47E008.hgt"));
+    }
+
+    int lat = match.captured(2).toInt();
+    int lon = match.captured(4).toInt();
+    if (match.captured(1).compare(QStringLiteral("S"), Qt::CaseInsensitive) == 0) {
+        lat = -lat;
+    }
+    if (match.captured(3).compare(QStringLiteral("W"), Qt::CaseInsensitive) == 0) {
+        lon = -lon;
+    }
+
+    // SRTM3 or SRTM1, the outermost rows and columns are shared with the neighbouring cells
+    int samples = 0;
+    for (const int size : { 1201, 3601 }) {
+        if (_size == (static_cast<qint64>(size) * size * 2)) {
+            samples = size;
+        }
+    }
+    if (samples == 0) {
+        return _fail(QObject::tr("Unexpected SRTM file size %1").arg(_size));
+    }
+
+    _width = samples;
+    _height = samples;
+    _bigEndian = true;
+    _sampleFormat = SampleFormat::Int16;
+    _bytesPerSample = 2;
+    _noDataValue = kHgtNoData;
+
+    _blockWidth = _width;
+    _blockHeight = _height;
+    _blocksAcross = 1;
+    _blockOffsets = { 0 };
+
+    _originX = lon;
+    _originY = lat + 1;
+    _scaleX = 1. / (samples - 1);
+    _scaleY = 1. / (samples - 1);
+
+    return true;
+}
+
+bool TerrainDemFile::_readTiffTags(QHash<int, Tag> &tags)
+{
+    if (_size < 8) {
+        return _fail(QObject::tr("Not a TIFF file"));
+    }
+
+    if ((_data[0] == 'I') && (_data[1] == 'I')) {
+        _bigEndian = false;
+    } else if ((_data[0] == 'M') && (_data[1] == 'M')) {
+        _bigEndian = true;
+    } else {
+        return _fail(QObject::tr("Not a TIFF file"));
+    }
+
+    const quint16 magic = readValue<quint16>(_data + 2, _bigEndian);
+    if (magic == 43) {
+        return _fail(QObject::tr("BigTIFF files are not supported"));
+    }
+    if (magic != 42) {
+        return _fail(QObject::tr("Not a TIFF file"));
+    }
+
+    // Only the first image is used
+    const qint64 ifdOffset = readValue<quint32>(_data + 4, _bigEndian);
+    if ((ifdOffset + 2) > _size) {
+        return _fail(QObject::tr("Corrupt TIFF file"));
+    }
+
+    const int entryCount = readValue<quint16>(_data + ifdOffset, _bigEndian);
+    if ((ifdOffset + 2 + (static_cast<qint64>(entryCount) * 12)) > _size) {
+        return _fail(QObject::tr("Corrupt TIFF file"));
+    }
+
+    for (int i = 0; i < entryCount; i++) {
+        const uchar* const entry = _data + ifdOffset + 2 + (i * 12);
+
+        Tag tag;
+        tag.type = readValue<quint16>(entry + 2, _bigEndian);
+        tag.count = readValue<quint32>(entry + 4, _bigEndian);
+
+        const int typeSize = tiffTypeSize(tag.type);
+        if (typeSize == 0) {
+            continue;
+        }
+
+        const qint64 byteCount = static_cast<qint64>(typeSize) * tag.count;
+        tag.valueOffset = (byteCount <= 4) ? (entry + 8 - _data) : static_cast<qint64>(readValue<quint32>(entry + 8, _bigEndian));
+        if ((tag.valueOffset + byteCount) > _size) {
+            return _fail(QObject::tr("Corrupt TIFF file"));
+        }
+
+        tags.insert(readValue<quint16>(entry, _bigEndian), tag);
+    }
+
+    return true;
+}
+
+QList<double> TerrainDemFile::_tagValues(const Tag &tag) const
+{
+    QList<double> values;
+    values.reserve(tag.count);
+
+    const int typeSize = tiffTypeSize(tag.type);
+    for (quint32 i = 0; i < tag.count; i++) {
+        const uchar* const value = _data + tag.valueOffset + (static_cast<qint64>(i) * typeSize);
+        switch (tag.type) {
+        case 1:
+        case 7:
+            values.append(*value);
+            break;
+        case 6:
+            values.append(static_cast<qint8>(*value));
+            break;
+        case 3:
+            values.append(readValue<quint16>(value, _bigEndian));
+            break;
+        case 8:
+            values.append(readValue<qint16>(value, _bigEndian));
+            break;
+        case 4:
+            values.append(readValue<quint32>(value, _bigEndian));
+            break;
+        case 9:
+            values.append(readValue<qint32>(value, _bigEndian));
+            break;
+        case 11:
+            values.append(readValue<float>(value, _bigEndian));
+            break;
+        case 12:
+            values.append(readValue<double>(value, _bigEndian));
+            break;
+        default:
+            return QList<double>();
+        }
+    }
+
+    return values;
+}
+
+bool TerrainDemFile::_readGeoKeys(const QHash<int, Tag> &tags, int &modelType, int &rasterType, int &geographicType, int &projectedType, int &linearUnits)
+{
+    modelType = 0;
+    rasterType = 1;
+    geographicType = 0;
+    projectedType = 0;
+    linearUnits = kLinearUnitMeter;
+
+    if (!tags.contains(kTagGeoKeyDirectory)) {
+        return _fail(QObject::tr("TIFF file has no georeference"));
+    }
+
+    // Header of four values followed by four values per key, only keys with a value of their own are of interest
+    const QList<double> directory = _tagValues(tags[kTagGeoKeyDirectory]);
+    if (directory.count() < 4) {
+        return _fail(QObject::tr("Corrupt GeoTIFF key directory"));
+    }
+
+    const int keyCount = static_cast<int>(directory[3]);
+    for (int i = 0; (i < keyCount) && (((i + 2) * 4) <= directory.count()); i++) {
+        const int keyId = static_cast<int>(directory[(i + 1) * 4]);
+        const int location = static_cast<int>(directory[((i + 1) * 4) + 1]);
+        const int value = static_cast<int>(directory[((i + 1) * 4) + 3]);
+        if (location != 0) {
+            continue;
+        }
+
+        switch (keyId) {
+        case kKeyModelType:
+            modelType = value;
+            break;
+        case kKeyRasterType:
+            rasterType = value;
+            break;
+        case kKeyGeographicType:
+            geographicType = value;
+            break;
+        case kKeyProjectedType:
+            projectedType = value;
+            break;
+        case kKeyProjectedLinearUnits:
+            linearUnits = value;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool TerrainDemFile::_setBlocks(const QList<double> &offsets, int blockWidth, int blockHeight)
+{
+    if ((blockWidth <= 0) || (blockHeight <= 0)) {
+        return _fail(QObject::tr("Corrupt TIFF file"));
+    }
+
+    _blockWidth = blockWidth;
+    _blockHeight = blockHeight;
+    _blocksAcross = (_width + blockWidth - 1) / blockWidth;
+    const int blocksDown = (_height + blockHeight - 1) / blockHeight;
+    if (offsets.count() != (static_cast<qsizetype>(_blocksAcross) * blocksDown)) {
+        return _fail(QObject::tr("Corrupt TIFF file"));
+    }
+
+    // Every sample which can be read has to be inside the file, so reads need no checks later on
+    const bool strips = (blockWidth == _width);
+    _blockOffsets.clear();
+    _blockOffsets.reserve(offsets.count());
+    for (qsizetype i = 0; i < offsets.count(); i++) {
+        const int blockRows = strips ? std::min(blockHeight, _height - static_cast<int>(i / _blocksAcross) * blockHeight) : blockHeight;
+        const qint64 blockBytes = static_cast<qint64>(blockRows) * blockWidth * _bytesPerSample;
+        const qint64 offset = static_cast<qint64>(offsets[i]);
+        if ((offset < 0) || ((offset + blockBytes) > _size)) {
+            return _fail(QObject::tr("Corrupt TIFF file"));
+        }
+        _blockOffsets.append(offset);
+    }
+
+    return true;
+}
+
+bool TerrainDemFile::_openGeoTiff()
+{
+    QHash<int, Tag> tags;
+    if (!_readTiffTags(tags)) {
+        return false;
+    }
+
+    const auto firstValue = [this, &tags](int tagId, double defaultValue) {
+        const QList<double> values = tags.contains(tagId) ? _tagValues(tags[tagId]) : QList<double>();
+        return (values.isEmpty() ? defaultValue : values.first());
+    };
+
+    _width = static_cast<int>(firstValue(kTagImageWidth, 0));
+    _height = static_cast<int>(firstValue(kTagImageLength, 0));
+    if ((_width < 2) || (_height < 2)) {
+        return _fail(QObject::tr("TIFF image is empty"));
+    }
+
+    if (firstValue(kTagCompression, 1) != 1) {
+        return _fail(QObject::tr("Compressed GeoTIFF files are not supported, convert it with: gdal_translate -co COMPRESS=NONE"));
+    }
+    if ((firstValue(kTagSamplesPerPixel, 1) != 1) || (firstValue(kTagPlanarConfiguration, 1) != 1)) {
+        return _fail(QObject::tr("GeoTIFF must have a single band"));
+    }
+
+    const int bitsPerSample = static_cast<int>(firstValue(kTagBitsPerSample, 1));
+    const int sampleFormat = static_cast<int>(firstValue(kTagSampleFormat, 1));
+    if ((sampleFormat == 1) && (bitsPerSample == 16)) {
+        _sampleFormat = SampleFormat::UInt16;
+    } else if ((sampleFormat == 2) && (bitsPerSample == 16)) {
+        _sampleFormat = SampleFormat::Int16;
+    } else if ((sampleFormat == 1) && (bitsPerSample == 32)) {
+        _sampleFormat = SampleFormat::UInt32;
+    } else if ((sampleFormat == 2) && (bitsPerSample == 32)) {
+        _sampleFormat = SampleFormat::Int32;
+    } else if ((sampleFormat == 3) && (bitsPerSample == 32)) {
+        _sampleFormat = SampleFormat::Float32;
+    } else if ((sampleFormat == 3) && (bitsPerSample == 64)) {
+        _sampleFormat = SampleFormat::Float64;
+    } else {
+        return _fail(QObject::tr("Unsupported GeoTIFF sample format"));
+    }
+    _bytesPerSample = bitsPerSample / 8;
+
+    if (tags.contains(kTagGdalNoData)) {
+        const Tag &tag = tags[kTagGdalNoData];
+        bool ok = false;
+        const double noData = QByteArray(reinterpret_cast<const char*>(_data + tag.valueOffset), tag.count).trimmed().toDouble(&ok);
+        if (ok) {
+            _noDataValue = noData;
+        }
+    }
+
+    bool blocksSet = false;
+    if (tags.contains(kTagTileOffsets)) {
+        blocksSet = _setBlocks(_tagValues(tags[kTagTileOffsets]), static_cast<int>(firstValue(kTagTileWidth, 0)), static_cast<int>(firstValue(kTagTileLength, 0)));
+    } else if (tags.contains(kTagStripOffsets)) {
+        const int rowsPerStrip = static_cast<int>(std::min<double>(firstValue(kTagRowsPerStrip, _height), _height));
+        blocksSet = _setBlocks(_tagValues(tags[kTagStripOffsets]), _width, rowsPerStrip);
+    } else {
+        return _fail(QObject::tr("Corrupt TIFF file"));
+    }
+    if (!blocksSet) {
+        return false;
+    }
+
+    int modelType, rasterType, geographicType, projectedType, linearUnits;
+    if (!_readGeoKeys(tags, modelType, rasterType, geographicType, projectedType, linearUnits)) {
+        return false;
+    }
+
+    if (modelType == kModelTypeGeographic) {
+        // NAD83 and ETRS89 are within a meter or two of WGS84, less than terrain data is accurate to
+        if ((geographicType != 4326) && (geographicType != 4258) && (geographicType != 4269)) {
+            return _fail(QObject::tr("Unsupported geographic coordinate system %1, reproject to EPSG:4326").arg(geographicType));
+        }
+    } else if (modelType == kModelTypeProjected) {
+        if ((projectedType > 32600) && (projectedType <= 32660)) {
+            _utmZone = projectedType - 32600;
+        } else if ((projectedType > 32700) && (projectedType <= 32760)) {
+            _utmZone = projectedType - 32700;
+            _utmSouth = true;
+        } else if ((projectedType >= 25828) && (projectedType <= 25838)) {
+            _utmZone = projectedType - 25800;
+        } else if ((projectedType >= 26901) && (projectedType <= 26923)) {
+            _utmZone = projectedType - 26900;
+        } else {
+            return _fail(QObject::tr("Unsupported projection %1, reproject to EPSG:4326 or a UTM zone").arg(projectedType));
+        }
+        if (linearUnits != kLinearUnitMeter) {
+            return _fail(QObject::tr("GeoTIFF projection must use meters"));
+        }
+    } else {
+        return _fail(QObject::tr("Unsupported GeoTIFF model type %1").arg(modelType));
+    }
+
+    if (!tags.contains(kTagModelTiepoint) || !tags.contains(kTagModelPixelScale)) {
+        if (tags.contains(kTagModelTransformation)) {
+            return _fail(QObject::tr("Rotated GeoTIFF rasters are not supported"));
+        }
+        return _fail(QObject::tr("TIFF file has no georeference"));
+    }
+
+    const QList<double> tiepoint = _tagValues(tags[kTagModelTiepoint]);
+    const QList<double> pixelScale = _tagValues(tags[kTagModelPixelScale]);
+    if ((tiepoint.count() < 6) || (pixelScale.count() < 2) || (pixelScale[0] <= 0.) || (pixelScale[1] <= 0.)) {
+        return _fail(QObject::tr("Corrupt GeoTIFF georeference"));
+    }
+
+    // Sample values are for the pixel center, the tie point is at the pixel corner unless the raster is point based
+    const double centerOffset = (rasterType == kRasterPixelIsPoint) ? 0. : 0.5;
+    _scaleX = pixelScale[0];
+    _scaleY = pixelScale[1];
+    _originX = tiepoint[3] + ((centerOffset - tiepoint[0]) * _scaleX);
+    _originY = tiepoint[4] - ((centerOffset - tiepoint[1]) * _scaleY);
+
+    return true;
+}
+
+bool TerrainDemFile::_setBounds()
+{
+    // The edges of the outermost samples, along the border since UTM edges are not straight in geographic coordinates
+    constexpr int kBorderSteps = 8;
+
+    _southLat = 90.;
+    _northLat = -90.;
+    _westLon = 180.;
+    _eastLon = -180.;
+
+    const double west = _originX - (0.5 * _scaleX);
+    const double east = _originX + ((_width - 0.5) * _scaleX);
+    const double north = _originY + (0.5 * _scaleY);
+    const double south = _originY - ((_height - 0.5) * _scaleY);
+
+    for (int i = 0; i <= kBorderSteps; i++) {
+        const double x = west + (((east - west) * i) / kBorderSteps);
+        const double y = south + (((north - south) * i) / kBorderSteps);
+        const double border[4][2] = { { x, south }, { x, north }, { west, y }, { east, y } };
+
+        for (const auto &point : border) {
+            QGeoCoordinate coordinate(point[1], point[0]);
+            if ((_utmZone != 0) && !QGCGeo::convertUTMToGeo(point[0], point[1], _utmZone, _utmSouth, coordinate)) {
+                return _fail(QObject::tr("GeoTIFF coordinates are outside of the UTM zone"));
+            }
+            _southLat = std::min(_southLat, coordinate.latitude());
+            _northLat = std::max(_northLat, coordinate.latitude());
+            _westLon = std::min(_westLon, coordinate.longitude());
+            _eastLon = std::max(_eastLon, coordinate.longitude());
+        }
+    }
+
+    if ((_southLat < -90.) || (_northLat > 90.) || (_westLon < -180.) || (_eastLon > 180.) || (_southLat >= _northLat) || (_westLon >= _eastLon)) {
+        return _fail(QObject::tr("Raster bounds are not valid geographic coordinates"));
+    }
+
+    if (_utmZone != 0) {
+        _sampleSpacingMeters = std::min(_scaleX, _scaleY);
+    } else {
+        const double centerLat = (_southLat + _northLat) / 2.;
+        _sampleSpacingMeters = std::min(_scaleY, _scaleX * qCos(qDegreesToRadians(centerLat))) * kMetersPerDegree;
+    }
+
+    return true;
+}
+
+bool TerrainDemFile::rasterPosition(double lat, double lon, double &column, double &row) const
+{
+    double x = lon;
+    double y = lat;
+    if ((_utmZone != 0) && !QGCGeo::convertGeoToUTM(QGeoCoordinate(lat, lon), _utmZone, _utmSouth, x, y)) {
+        return false;
+    }
+
+    column = (x - _originX) / _scaleX;
+    row = (_originY - y) / _scaleY;
+
+    return true;
+}
+
+double TerrainDemFile::_sample(int column, int row) const
+{
+    const int blockIndex = ((row / _blockHeight) * _blocksAcross) + (column / _blockWidth);
+    const qint64 sampleIndex = (static_cast<qint64>(row % _blockHeight) * _blockWidth) + (column % _blockWidth);
+    const uchar* const sample = _data + _blockOffsets[blockIndex] + (sampleIndex * _bytesPerSample);
+
+    double value;
+    switch (_sampleFormat) {
+    case SampleFormat::Int16:
+        value = readValue<qint16>(sample, _bigEndian);
+        break;
+    case SampleFormat::UInt16:
+        value = readValue<quint16>(sample, _bigEndian);
+        break;
+    case SampleFormat::Int32:
+        value = readValue<qint32>(sample, _bigEndian);
+        break;
+    case SampleFormat::UInt32:
+        value = readValue<quint32>(sample, _bigEndian);
+        break;
+    case SampleFormat::Float32:
+        value = readValue<float>(sample, _bigEndian);
+        break;
+    case SampleFormat::Float64:
+    default:
+        value = readValue<double>(sample, _bigEndian);
+        break;
+    }
+
+    return (((value == _noDataValue) || !qIsFinite(value)) ? qQNaN() : value);
+}
+
+double TerrainDemFile::elevation(double column, double row) const
+{
+    // The outermost samples reach half a sample further, up to the edge of their pixel
+    if (!_isValid || !(column >= -0.5) || !(column <= (_width - 0.5)) || !(row >= -0.5) || !(row <= (_height - 0.5))) {
+        return qQNaN();
+    }
+
+    const double clampedColumn = std::clamp(column, 0., _width - 1.);
+    const double clampedRow = std::clamp(row, 0., _height - 1.);
+    const int column0 = std::min(static_cast<int>(clampedColumn), _width - 2);
+    const int row0 = std::min(static_cast<int>(clampedRow), _height - 2);
+    const double columnFraction = clampedColumn - column0;
+    const double rowFraction = clampedRow - row0;
+
+    const double samples[4] = {
+        _sample(column0, row0),
+        _sample(column0 + 1, row0),
+        _sample(column0, row0 + 1),
+        _sample(column0 + 1, row0 + 1),
+    };
+    const double weights[4] = {
+        (1. - columnFraction) * (1. - rowFraction),
+        columnFraction * (1. - rowFraction),
+        (1. - columnFraction) * rowFraction,
+        columnFraction * rowFraction,
+    };
+
+    // Missing samples are left out and the others weighted up, so data reaches up to the edge of a hole
+    double sum = 0.;
+    double weightSum = 0.;
+    double nearest = qQNaN();
+    double nearestWeight = -1.;
+    for (int i = 0; i < 4; i++) {
+        if (qIsNaN(samples[i])) {
+            continue;
+        }
+        sum += samples[i] * weights[i];
+        weightSum += weights[i];
+        if (weights[i] > nearestWeight) {
+            nearest = samples[i];
+            nearestWeight = weights[i];
+        }
+    }
+
+    if (qIsNaN(nearest)) {
+        return qQNaN();
+    }
+
+    return ((weightSum > 1e-6) ? (sum / weightSum) : nearest);
+}
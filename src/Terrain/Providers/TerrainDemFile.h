@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QtNumeric>
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainDemFileLog)
+
+/// Read access to a local elevation raster, the file is memory mapped and never loaded as a whole.
+///
+/// Supported are SRTM .hgt files and single band GeoTIFFs which are not compressed, stored in strips or tiles with
+/// 16/32 bit integer or 32/64 bit float samples. The GeoTIFF has to be georeferenced by tie point and pixel scale,
+/// either in WGS84 geographic coordinates or in WGS84/ETRS89 UTM. Elevations are expected in meters.
+class TerrainDemFile
+{
+public:
+    explicit TerrainDemFile(const QString &filePath);
+    ~TerrainDemFile();
+
+    bool isValid() const { return _isValid; }
+    QString errorString() const { return _errorString; }
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    /// Geographic bounds of the raster
+    double southLat() const { return _southLat; }
+    double westLon() const { return _westLon; }
+    double northLat() const { return _northLat; }
+    double eastLon() const { return _eastLon; }
+
+    /// Approximate distance between neighbouring samples in meters
+    double sampleSpacingMeters() const { return _sampleSpacingMeters; }
+
+    /// Position of a coordinate in the raster, in samples. Sample (0, 0) is the north west one.
+    ///     @return false: the position could not be computed
+    bool rasterPosition(double lat, double lon, double &column, double &row) const;
+
+    /// Elevation at a raster position, bilinear between the surrounding samples. Missing samples are left out.
+    ///     @return NaN: position is outside of the raster or there is no data
+    double elevation(double column, double row) const;
+
+private:
+    enum class SampleFormat {
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float32,
+        Float64
+    };
+
+    struct Tag {
+        int type = 0;
+        quint32 count = 0;
+        qint64 valueOffset = 0;         ///< Where the values are in the file
+    };
+
+    bool _openHgt();
+    bool _openGeoTiff();
+    bool _readTiffTags(QHash<int, Tag> &tags);
+    QList<double> _tagValues(const Tag &tag) const;
+    bool _readGeoKeys(const QHash<int, Tag> &tags, int &modelType, int &rasterType, int &geographicType, int &projectedType, int &linearUnits);
+    bool _setBlocks(const QList<double> &offsets, int blockWidth, int blockHeight);
+    bool _setBounds();
+    bool _fail(const QString &errorString);
+
+    /// NaN for missing samples, indices are not checked
+    double _sample(int column, int row) const;
+
+    QFile _file;
+    const uchar *_data = nullptr;
+    qint64 _size = 0;
+    bool _isValid = false;
+    QString _errorString;
+
+    int _width = 0;
+    int _height = 0;
+    bool _bigEndian = false;
+    SampleFormat _sampleFormat = SampleFormat::Int16;
+    int _bytesPerSample = 2;
+    double _noDataValue = qQNaN();
+
+    /// The samples are stored in blocks, strips are blocks which span the whole width
+    int _blockWidth = 0;
+    int _blockHeight = 0;
+    int _blocksAcross = 0;
+    QList<qint64> _blockOffsets;
+
+    /// Model coordinates of the center of sample (0, 0) and the distance between samples. Model coordinates are
+    /// longitude/latitude or UTM easting/northing.
+    double _originX = 0.;
+    double _originY = 0.;
+    double _scaleX = 0.;
+    double _scaleY = 0.;
+    int _utmZone = 0;                   ///< 0: geographic coordinates
+    bool _utmSouth = false;
+
+    double _southLat = 0.;
+    double _westLon = 0.;
+    double _northLat = 0.;
+    double _eastLon = 0.;
+    double _sampleSpacingMeters = 0.;
+};
@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileLocalDem.h"
+#include "QGCLoggingCategory.h"
+
+#include <algorithm>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TerrainTileLocalDemLog, "qgc.terrain.terraintilelocaldem");
+
+TerrainTileLocalDem::TerrainTileLocalDem(const QByteArray &byteArray)
+    : TerrainTile(byteArray)
+{
+    // qCDebug(TerrainTileLocalDemLog) << Q_FUNC_INFO << this;
+}
+
+TerrainTileLocalDem::~TerrainTileLocalDem()
+{
+    // qCDebug(TerrainTileLocalDemLog) << Q_FUNC_INFO << this;
+}
+
+QByteArray TerrainTileLocalDem::serializeFromGrid(double swLat, double swLon, double neLat, double neLon, int gridSizeLat, int gridSizeLon, const QList<int16_t> &grid)
+{
+    if ((gridSizeLat <= 0) || (gridSizeLon <= 0) || (gridSizeLat > std::numeric_limits<int16_t>::max()) || (gridSizeLon > std::numeric_limits<int16_t>::max())
+            || (grid.count() != (static_cast<qsizetype>(gridSizeLat) * gridSizeLon))) {
+        qCWarning(TerrainTileLocalDemLog) << Q_FUNC_INFO << "grid size mismatch" << gridSizeLat << gridSizeLon << grid.count();
+        return QByteArray();
+    }
+
+    int16_t minElevation = std::numeric_limits<int16_t>::max();
+    int16_t maxElevation = std::numeric_limits<int16_t>::min();
+    double sum = 0.;
+    qsizetype count = 0;
+    for (const int16_t value : grid) {
+        if (value == kNoDataElevation) {
+            continue;
+        }
+        minElevation = std::min(minElevation, value);
+        maxElevation = std::max(maxElevation, value);
+        sum += value;
+        count++;
+    }
+
+    if (count == 0) {
+        return QByteArray();
+    }
+
+    TerrainTile::TileInfo_t tileInfo;
+    tileInfo.swLat = swLat;
+    tileInfo.swLon = swLon;
+    tileInfo.neLat = neLat;
+    tileInfo.neLon = neLon;
+    tileInfo.minElevation = minElevation;
+    tileInfo.maxElevation = maxElevation;
+    tileInfo.avgElevation = sum / count;
+    tileInfo.gridSizeLat = static_cast<int16_t>(gridSizeLat);
+    tileInfo.gridSizeLon = static_cast<int16_t>(gridSizeLon);
+
+    constexpr int cTileNumHeaderBytes = static_cast<int>(sizeof(TileInfo_t));
+    const qsizetype cTileNumDataBytes = static_cast<qsizetype>(sizeof(int16_t)) * grid.count();
+
+    QByteArray result(cTileNumHeaderBytes + cTileNumDataBytes, Qt::Uninitialized);
+    (void) memcpy(result.data(), &tileInfo, cTileNumHeaderBytes);
+    (void) memcpy(result.data() + cTileNumHeaderBytes, grid.constData(), cTileNumDataBytes);
+
+    return result;
+}
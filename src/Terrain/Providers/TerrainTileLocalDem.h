@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+#include <limits>
+
+#include "TerrainTile.h"
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainTileLocalDemLog)
+
+/// Terrain tiles made from imported elevation rasters, see TerrainLocalDem
+class TerrainTileLocalDem : public TerrainTile
+{
+public:
+    /// Constructor from serialized elevation data
+    ///    @param byteArray
+    explicit TerrainTileLocalDem(const QByteArray &byteArray);
+    ~TerrainTileLocalDem();
+
+    /// Serializes an elevation grid, rows run from south to north. Cells without data hold kNoDataElevation and are
+    /// left out of the tile statistics.
+    ///    @return empty: no cell has data
+    static QByteArray serializeFromGrid(double swLat, double swLon, double neLat, double neLon, int gridSizeLat, int gridSizeLon, const QList<int16_t> &grid);
+
+    static constexpr int16_t kNoDataElevation = std::numeric_limits<int16_t>::min();
+};
@@ -0,0 +1,657 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainLocalDem.h"
+#include "TerrainDemFile.h"
+#include "TerrainTile.h"
+#include "TerrainTileLocalDem.h"
+#include "TerrainTileManager.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QPoint>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QtMath>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(TerrainLocalDemLog, "qgc.terrain.terrainlocaldem")
+
+Q_GLOBAL_STATIC(TerrainLocalDem, _terrainLocalDem)
+
+namespace
+{
+
+constexpr double kMetersPerDegree = 111320.;
+
+/// Looks coordinates up in a tile, values without data and coordinates outside the tile or a missing tile give NaN
+void tileElevations(const TerrainTile *tile, std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations)
+{
+    if (!tile) {
+        std::fill(elevations.begin(), elevations.end(), qQNaN());
+        return;
+    }
+
+    tile->elevations(latitudes, longitudes, elevations);
+    for (double &elevation : elevations) {
+        if (elevation == TerrainTileLocalDem::kNoDataElevation) {
+            elevation = qQNaN();
+        }
+    }
+}
+
+/// Index of the tile holding a coordinate, matching the bounds the tiles are built with. The division alone can be
+/// off by one for coordinates on a tile edge.
+int tileIndex(double value, double offset, double tileSize)
+{
+    int index = qFloor((value + offset) / tileSize);
+    if (value < ((index * tileSize) - offset)) {
+        index--;
+    } else if (value >= (((index + 1) * tileSize) - offset)) {
+        index++;
+    }
+
+    return index;
+}
+
+int16_t toGridValue(double elevation)
+{
+    if (qIsNaN(elevation)) {
+        return TerrainTileLocalDem::kNoDataElevation;
+    }
+
+    return static_cast<int16_t>(std::clamp(qRound(elevation), -std::numeric_limits<int16_t>::max(), static_cast<int>(std::numeric_limits<int16_t>::max())));
+}
+
+} // namespace
+
+TerrainLocalDem *TerrainLocalDem::instance()
+{
+    return _terrainLocalDem();
+}
+
+TerrainLocalDem::TerrainLocalDem(const QString &filePath, QObject *parent)
+    : QObject(parent)
+    , _database(filePath.isEmpty() ? (QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/Terrain/") + QString(kFileName)) : filePath)
+    , _tileCache(kTileCacheBudgetBytes)
+{
+    // qCDebug(TerrainLocalDemLog) << Q_FUNC_INFO << this;
+
+    (void) connect(&_importWatcher, &QFutureWatcher<ImportResult>::finished, this, [this]() {
+        QString errorString;
+        const bool success = _finishImport(_importWatcher.result(), errorString);
+        if (!success) {
+            qCWarning(TerrainLocalDemLog) << "import failed" << errorString;
+        }
+
+        _importing = false;
+        emit importingChanged();
+        emit importFinished(success, errorString);
+    });
+}
+
+TerrainLocalDem::~TerrainLocalDem()
+{
+    cancelImport();
+    _importWatcher.waitForFinished();
+    if (_importing) {
+        (void) QFile::remove(_importFilePath());
+    }
+
+    // qCDebug(TerrainLocalDemLog) << Q_FUNC_INFO << this;
+}
+
+int TerrainLocalDem::tileX(double lon, int level)
+{
+    return tileIndex(lon, 180., tileSizeDegrees(level));
+}
+
+int TerrainLocalDem::tileY(double lat, int level)
+{
+    return tileIndex(lat, 90., tileSizeDegrees(level));
+}
+
+std::shared_ptr<const TerrainTile> TerrainLocalDem::_tile(int level, int x, int y)
+{
+    const quint64 id = tileId(level, x, y);
+
+    std::shared_ptr<const TerrainTile> tile = _tileCache.tile(id);
+    if (!tile) {
+        tile = _database.tile(id);
+        if (tile) {
+            _tileCache.insert(id, tile);
+        }
+    }
+
+    return tile;
+}
+
+bool TerrainLocalDem::_elevations(int level, std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations)
+{
+    // Neighbouring coordinates mostly fall into the same tile, each run of them is looked up in one go
+    size_t start = 0;
+    while (start < latitudes.size()) {
+        const int x = tileX(longitudes[start], level);
+        const int y = tileY(latitudes[start], level);
+
+        size_t end = start + 1;
+        while ((end < latitudes.size()) && (tileX(longitudes[end], level) == x) && (tileY(latitudes[end], level) == y)) {
+            end++;
+        }
+
+        const std::shared_ptr<const TerrainTile> tile = _tile(level, x, y);
+        if (!tile) {
+            return false;
+        }
+
+        const std::span<double> runElevations = elevations.subspan(start, end - start);
+        tileElevations(tile.get(), latitudes.subspan(start, end - start), longitudes.subspan(start, end - start), runElevations);
+        if (std::any_of(runElevations.begin(), runElevations.end(), [](double elevation) { return qIsNaN(elevation); })) {
+            return false;
+        }
+
+        start = end;
+    }
+
+    return true;
+}
+
+bool TerrainLocalDem::altitudes(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, int level)
+{
+    altitudes.clear();
+    if (coordinates.isEmpty() || isEmpty()) {
+        return false;
+    }
+
+    QList<double> latitudes;
+    QList<double> longitudes;
+    latitudes.reserve(coordinates.count());
+    longitudes.reserve(coordinates.count());
+    for (const QGeoCoordinate &coordinate : coordinates) {
+        latitudes.append(coordinate.latitude());
+        longitudes.append(coordinate.longitude());
+    }
+
+    QList<double> elevations(coordinates.count());
+    if (!_elevations(level, latitudes, longitudes, elevations)) {
+        return false;
+    }
+
+    altitudes = elevations;
+    return true;
+}
+
+double TerrainLocalDem::valueSpacingMeters(const QGeoCoordinate &coordinate, int level)
+{
+    const std::shared_ptr<const TerrainTile> tile = _tile(level, tileX(coordinate.longitude(), level), tileY(coordinate.latitude(), level));
+    if (!tile) {
+        return qQNaN();
+    }
+
+    return ((tileSizeDegrees(level) / tile->gridSizeLat()) * kMetersPerDegree);
+}
+
+bool TerrainLocalDem::pathAltitudes(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween, QList<double> &altitudes)
+{
+    altitudes.clear();
+    if (isEmpty()) {
+        return false;
+    }
+
+    const double valueSpacing = valueSpacingMeters(fromCoord);
+    if (qIsNaN(valueSpacing)) {
+        return false;
+    }
+
+    // Long paths are sampled more sparsely than the data so the number of heights stays bounded
+    const double spacing = std::max(valueSpacing, fromCoord.distanceTo(toCoord) / kMaxPathValues);
+    const QList<QGeoCoordinate> coordinates = TerrainTileManager::_pathQueryToCoords(fromCoord, toCoord, distanceBetween, finalDistanceBetween, spacing);
+
+    return this->altitudes(coordinates, altitudes);
+}
+
+bool TerrainLocalDem::carpetAltitudes(const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly, double &minHeight, double &maxHeight, QList<QList<double>> &carpet)
+{
+    carpet.clear();
+    minHeight = qQNaN();
+    maxHeight = qQNaN();
+
+    if (isEmpty() || !swCoord.isValid() || !neCoord.isValid() || (neCoord.latitude() < swCoord.latitude()) || (neCoord.longitude() < swCoord.longitude())) {
+        return false;
+    }
+
+    const double baseSpacing = valueSpacingMeters(swCoord);
+    if (qIsNaN(baseSpacing)) {
+        return false;
+    }
+
+    const double latExtent = neCoord.latitude() - swCoord.latitude();
+    const double lonExtent = neCoord.longitude() - swCoord.longitude();
+    const double baseSpacingDegrees = baseSpacing / kMetersPerDegree;
+    const int maxSize = statsOnly ? kMaxStatsCarpetSize : kMaxCarpetSize;
+
+    // The level whose values are just dense enough for the carpet
+    const double baseValues = (std::max(latExtent, lonExtent) / baseSpacingDegrees) + 1.;
+    int level = (baseValues > maxSize) ? std::min(kMaxLevel, qCeil(std::log2(baseValues / maxSize))) : 0;
+
+    QList<double> latitudes;
+    QList<double> longitudes;
+    QList<double> elevations;
+    int rows = 0;
+    int columns = 0;
+    bool covered = false;
+
+    // Overviews of separate imports may not reach up to the level, finer levels are tried then
+    for (; (level >= 0) && !covered; level--) {
+        const double spacingDegrees = baseSpacingDegrees * (1 << level);
+        rows = std::clamp(qCeil(latExtent / spacingDegrees) + 1, 1, maxSize);
+        columns = std::clamp(qCeil(lonExtent / spacingDegrees) + 1, 1, maxSize);
+
+        const qsizetype count = static_cast<qsizetype>(rows) * columns;
+        latitudes.resize(count);
+        longitudes.resize(count);
+        elevations.resize(count);
+        for (int row = 0; row < rows; row++) {
+            const double lat = swCoord.latitude() + ((rows > 1) ? ((latExtent * row) / (rows - 1)) : 0.);
+            for (int column = 0; column < columns; column++) {
+                latitudes[(row * columns) + column] = lat;
+                longitudes[(row * columns) + column] = swCoord.longitude() + ((columns > 1) ? ((lonExtent * column) / (columns - 1)) : 0.);
+            }
+        }
+
+        covered = _elevations(level, latitudes, longitudes, elevations);
+    }
+
+    if (!covered) {
+        return false;
+    }
+
+    const auto [minIt, maxIt] = std::minmax_element(elevations.cbegin(), elevations.cend());
+    minHeight = *minIt;
+    maxHeight = *maxIt;
+
+    if (!statsOnly) {
+        carpet.reserve(rows);
+        for (int row = 0; row < rows; row++) {
+            carpet.append(elevations.mid(static_cast<qsizetype>(row) * columns, columns));
+        }
+    }
+
+    return true;
+}
+
+bool TerrainLocalDem::importFile(const QString &filePath, QString &errorString)
+{
+    if (_importing) {
+        errorString = tr("Elevation data is already being imported");
+        return false;
+    }
+
+    _importCanceled = false;
+    const ImportResult result = _import(filePath, _database.filePath(), _importFilePath(), nullptr, ProgressHandler());
+    return _finishImport(result, errorString);
+}
+
+bool TerrainLocalDem::startImport(const QString &filePath)
+{
+    if (_importing) {
+        qCWarning(TerrainLocalDemLog) << "import already running, ignoring" << filePath;
+        return false;
+    }
+
+    _importCanceled = false;
+    _importing = true;
+    emit importingChanged();
+
+    // Progress is reported from the worker thread, the signal is emitted on the main thread
+    const ProgressHandler progress = [this](int percent) {
+        (void) QMetaObject::invokeMethod(this, [this, percent]() { emit importProgress(percent); }, Qt::QueuedConnection);
+    };
+
+    const QString databasePath = _database.filePath();
+    const QString importPath = _importFilePath();
+    const std::atomic_bool *const canceled = &_importCanceled;
+    _importWatcher.setFuture(QtConcurrent::run([filePath, databasePath, importPath, canceled, progress]() {
+        return _import(filePath, databasePath, importPath, canceled, progress);
+    }));
+
+    return true;
+}
+
+void TerrainLocalDem::cancelImport()
+{
+    _importCanceled = true;
+}
+
+bool TerrainLocalDem::_finishImport(const ImportResult &result, QString &errorString)
+{
+    if (!result.success || _importCanceled) {
+        errorString = result.success ? tr("Import canceled") : result.errorString;
+        (void) QFile::remove(_importFilePath());
+        return false;
+    }
+
+    if (!_database.replaceWith(_importFilePath())) {
+        errorString = tr("Unable to store the imported elevation data");
+        return false;
+    }
+    _tileCache.clear();
+
+    emit dataChanged();
+
+    return true;
+}
+
+TerrainLocalDem::ImportResult TerrainLocalDem::_import(const QString &filePath, const QString &databasePath, const QString &importPath, const std::atomic_bool *canceled, const ProgressHandler &progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ImportResult result;
+
+    const TerrainDemFile demFile(filePath);
+    if (!demFile.isValid()) {
+        result.errorString = demFile.errorString();
+        return result;
+    }
+
+    // Same resolution as the raster in latitude, the same distance in meters in longitude
+    const double spacingDegrees = demFile.sampleSpacingMeters() / kMetersPerDegree;
+    const double centerLat = (demFile.southLat() + demFile.northLat()) / 2.;
+    const int gridSizeLat = std::clamp(qCeil(kTileSizeDegrees / spacingDegrees), kMinGridSize, kMaxGridSize);
+    const int gridSizeLon = std::clamp(qCeil(gridSizeLat * qCos(qDegreesToRadians(centerLat))), kMinGridSize, kMaxGridSize);
+
+    const int x0 = tileX(demFile.westLon(), 0);
+    const int x1 = tileX(demFile.eastLon(), 0);
+    const int y0 = tileY(demFile.southLat(), 0);
+    const int y1 = tileY(demFile.northLat(), 0);
+    const qint64 baseTileTotal = static_cast<qint64>(x1 - x0 + 1) * (y1 - y0 + 1);
+    if (baseTileTotal > kMaxImportTiles) {
+        result.errorString = tr("Elevation data covers too large an area");
+        return result;
+    }
+
+    // The import goes into a copy, the tile file in use stays untouched until the import is complete
+    (void) QFile::remove(importPath);
+    if (QFile::exists(databasePath) && !QFile::copy(databasePath, importPath)) {
+        result.errorString = tr("Unable to copy the elevation data file");
+        return result;
+    }
+
+    TerrainOfflineDatabase database(importPath);
+    database.setAutoFlush(false);
+    qsizetype unflushedBytes = 0;
+
+    // Overview levels take about a third of the base level tiles
+    const qint64 tileTotal = baseTileTotal + (baseTileTotal / 3) + 1;
+    qint64 tilesDone = 0;
+    int lastPercent = -1;
+    const auto tileDone = [&tilesDone, &lastPercent, tileTotal, &progress, canceled]() {
+        tilesDone++;
+        const int percent = static_cast<int>(std::min<qint64>(99, (tilesDone * 100) / tileTotal));
+        if (progress && (percent != lastPercent)) {
+            lastPercent = percent;
+            progress(percent);
+        }
+        return !(canceled && *canceled);
+    };
+
+    QList<QPoint> changedTiles;
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            const QByteArray tileData = _baseTile(database, demFile, x, y, gridSizeLat, gridSizeLon);
+            if (!tileData.isEmpty()) {
+                _addTile(database, unflushedBytes, tileId(0, x, y), tileData);
+                changedTiles.append(QPoint(x, y));
+            }
+            if (!tileDone()) {
+                result.errorString = tr("Import canceled");
+                return result;
+            }
+        }
+    }
+
+    if (changedTiles.isEmpty()) {
+        result.errorString = tr("File contains no elevation data");
+        return result;
+    }
+
+    const qsizetype baseTileCount = changedTiles.count();
+
+    // Overviews are built up to the level where the import fits into a single tile. Above that they are only rebuilt
+    // where an earlier, larger import built coarser overviews, those would still show the replaced terrain otherwise.
+    int level = 1;
+    for (; level <= kMaxLevel; level++) {
+        if ((changedTiles.count() == 1) && !_hasAncestor(database, level, changedTiles.first().x(), changedTiles.first().y())) {
+            break;
+        }
+
+        QList<QPoint> parents;
+        for (const QPoint &tile : changedTiles) {
+            parents.append(QPoint(tile.x() / 2, tile.y() / 2));
+        }
+        std::sort(parents.begin(), parents.end(), [](const QPoint &a, const QPoint &b) {
+            return ((a.y() < b.y()) || ((a.y() == b.y()) && (a.x() < b.x())));
+        });
+        parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+
+        changedTiles.clear();
+        for (const QPoint &parent : parents) {
+            const QByteArray tileData = _overviewTile(database, level, parent.x(), parent.y(), gridSizeLat, gridSizeLon);
+            if (!tileData.isEmpty()) {
+                _addTile(database, unflushedBytes, tileId(level, parent.x(), parent.y()), tileData);
+                changedTiles.append(parent);
+            }
+            if (!tileDone()) {
+                result.errorString = tr("Import canceled");
+                return result;
+            }
+        }
+
+        if (changedTiles.isEmpty()) {
+            break;
+        }
+    }
+
+    if (!database.flush()) {
+        result.errorString = tr("Unable to write the elevation data file");
+        return result;
+    }
+
+    qCDebug(TerrainLocalDemLog) << "imported" << filePath << "tiles" << baseTileCount << "grid" << gridSizeLat << "x" << gridSizeLon
+                                << "levels" << level << "in" << timer.elapsed() << "ms";
+
+    if (progress) {
+        progress(100);
+    }
+
+    result.success = true;
+    return result;
+}
+
+bool TerrainLocalDem::_hasAncestor(const TerrainOfflineDatabase &database, int level, int x, int y)
+{
+    for (int ancestorLevel = level; ancestorLevel <= kMaxLevel; ancestorLevel++) {
+        const int shift = ancestorLevel - level + 1;
+        if (database.contains(tileId(ancestorLevel, x >> shift, y >> shift))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TerrainLocalDem::clear()
+{
+    // A running import would bring back what is cleared here
+    if (_importing) {
+        cancelImport();
+        _importWatcher.waitForFinished();
+    }
+
+    _database.clear();
+    _tileCache.clear();
+
+    emit dataChanged();
+}
+
+void TerrainLocalDem::_addTile(TerrainOfflineDatabase &database, qsizetype &unflushedBytes, quint64 tileId, const QByteArray &tileData)
+{
+    (void) database.addTile(tileId, tileData);
+
+    // Imported tiles are held in memory until they are written, large imports are written out in between
+    unflushedBytes += tileData.size();
+    if (unflushedBytes > kMaxUnflushedBytes) {
+        (void) database.flush();
+        unflushedBytes = 0;
+    }
+}
+
+QByteArray TerrainLocalDem::_baseTile(const TerrainOfflineDatabase &database, const TerrainDemFile &demFile, int x, int y, int gridSizeLat, int gridSizeLon)
+{
+    const double tileSize = tileSizeDegrees(0);
+    const double swLat = (y * tileSize) - 90.;
+    const double swLon = (x * tileSize) - 180.;
+    const double cellSizeLat = tileSize / gridSizeLat;
+    const double cellSizeLon = tileSize / gridSizeLon;
+
+    // Projecting every value into a UTM raster is slow, across a tile the projection is smooth enough to be
+    // interpolated from a coarse mesh. For geographic rasters the interpolation is exact.
+    double meshColumns[kProjectionMeshSize][kProjectionMeshSize];
+    double meshRows[kProjectionMeshSize][kProjectionMeshSize];
+    for (int i = 0; i < kProjectionMeshSize; i++) {
+        const double lat = swLat + ((0.5 + ((i * (gridSizeLat - 1.)) / (kProjectionMeshSize - 1))) * cellSizeLat);
+        for (int j = 0; j < kProjectionMeshSize; j++) {
+            const double lon = swLon + ((0.5 + ((j * (gridSizeLon - 1.)) / (kProjectionMeshSize - 1))) * cellSizeLon);
+            if (!demFile.rasterPosition(lat, lon, meshColumns[i][j], meshRows[i][j])) {
+                return QByteArray();
+            }
+        }
+    }
+
+    // Values of an earlier import are kept where the new raster has none
+    const std::shared_ptr<const TerrainTile> existingTile = database.tile(tileId(0, x, y));
+
+    QList<double> latitudes(gridSizeLon);
+    QList<double> longitudes(gridSizeLon);
+    QList<double> existingValues(gridSizeLon, qQNaN());
+    for (int column = 0; column < gridSizeLon; column++) {
+        longitudes[column] = swLon + ((column + 0.5) * cellSizeLon);
+    }
+
+    QList<int16_t> grid(static_cast<qsizetype>(gridSizeLat) * gridSizeLon, TerrainTileLocalDem::kNoDataElevation);
+    for (int row = 0; row < gridSizeLat; row++) {
+        if (existingTile) {
+            std::fill(latitudes.begin(), latitudes.end(), swLat + ((row + 0.5) * cellSizeLat));
+            tileElevations(existingTile.get(), latitudes, longitudes, existingValues);
+        }
+
+        const double meshRow = (row * (kProjectionMeshSize - 1.)) / std::max(1, gridSizeLat - 1);
+        const int i0 = std::min(static_cast<int>(meshRow), kProjectionMeshSize - 2);
+        const double rowFraction = meshRow - i0;
+
+        for (int column = 0; column < gridSizeLon; column++) {
+            const double meshColumn = (column * (kProjectionMeshSize - 1.)) / std::max(1, gridSizeLon - 1);
+            const int j0 = std::min(static_cast<int>(meshColumn), kProjectionMeshSize - 2);
+            const double columnFraction = meshColumn - j0;
+
+            const auto interpolate = [i0, j0, rowFraction, columnFraction](const double (&mesh)[kProjectionMeshSize][kProjectionMeshSize]) {
+                const double south = mesh[i0][j0] + ((mesh[i0][j0 + 1] - mesh[i0][j0]) * columnFraction);
+                const double north = mesh[i0 + 1][j0] + ((mesh[i0 + 1][j0 + 1] - mesh[i0 + 1][j0]) * columnFraction);
+                return (south + ((north - south) * rowFraction));
+            };
+
+            double elevation = demFile.elevation(interpolate(meshColumns), interpolate(meshRows));
+            if (qIsNaN(elevation)) {
+                elevation = existingValues[column];
+            }
+            grid[(static_cast<qsizetype>(row) * gridSizeLon) + column] = toGridValue(elevation);
+        }
+    }
+
+    return TerrainTileLocalDem::serializeFromGrid(swLat, swLon, swLat + tileSize, swLon + tileSize, gridSizeLat, gridSizeLon, grid);
+}
+
+QByteArray TerrainLocalDem::_overviewTile(const TerrainOfflineDatabase &database, int level, int x, int y, int gridSizeLat, int gridSizeLon)
+{
+    // children[lon][lat], the four tiles of the level below which make up this one
+    std::shared_ptr<const TerrainTile> children[2][2];
+    bool hasChild = false;
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            children[i][j] = database.tile(tileId(level - 1, (2 * x) + i, (2 * y) + j));
+            hasChild = hasChild || children[i][j];
+        }
+    }
+    if (!hasChild) {
+        return QByteArray();
+    }
+
+    const double tileSize = tileSizeDegrees(level);
+    const double swLat = (y * tileSize) - 90.;
+    const double swLon = (x * tileSize) - 180.;
+    const double midLat = swLat + (tileSize / 2.);
+    const double midLon = swLon + (tileSize / 2.);
+    const double cellSizeLat = tileSize / gridSizeLat;
+    const double cellSizeLon = tileSize / gridSizeLon;
+
+    // Each value averages the four points half way between its center and its corners, which are the centers of the
+    // values below when both levels have the same grid size
+    const qsizetype subColumns = 2 * static_cast<qsizetype>(gridSizeLon);
+    QList<double> subLongitudes(subColumns);
+    for (int column = 0; column < gridSizeLon; column++) {
+        const double lon = swLon + ((column + 0.5) * cellSizeLon);
+        subLongitudes[2 * column] = lon - (cellSizeLon / 4.);
+        subLongitudes[(2 * column) + 1] = lon + (cellSizeLon / 4.);
+    }
+    const size_t split = std::lower_bound(subLongitudes.cbegin(), subLongitudes.cend(), midLon) - subLongitudes.cbegin();
+
+    QList<double> subLatitudes(subColumns);
+    QList<double> subValues[2] = { QList<double>(subColumns), QList<double>(subColumns) };
+    const std::span<const double> lons(subLongitudes);
+
+    QList<int16_t> grid(static_cast<qsizetype>(gridSizeLat) * gridSizeLon, TerrainTileLocalDem::kNoDataElevation);
+    for (int row = 0; row < gridSizeLat; row++) {
+        const double lat = swLat + ((row + 0.5) * cellSizeLat);
+
+        for (int half = 0; half < 2; half++) {
+            const double subLat = lat + ((half == 0) ? -(cellSizeLat / 4.) : (cellSizeLat / 4.));
+            const int j = (subLat < midLat) ? 0 : 1;
+            std::fill(subLatitudes.begin(), subLatitudes.end(), subLat);
+
+            const std::span<const double> lats(subLatitudes);
+            const std::span<double> values(subValues[half]);
+            tileElevations(children[0][j].get(), lats.first(split), lons.first(split), values.first(split));
+            tileElevations(children[1][j].get(), lats.subspan(split), lons.subspan(split), values.subspan(split));
+        }
+
+        for (int column = 0; column < gridSizeLon; column++) {
+            double sum = 0.;
+            int count = 0;
+            for (const QList<double> &halfValues : subValues) {
+                for (int k = 0; k < 2; k++) {
+                    const double value = halfValues[(2 * column) + k];
+                    if (!qIsNaN(value)) {
+                        sum += value;
+                        count++;
+                    }
+                }
+            }
+            if (count > 0) {
+                grid[(static_cast<qsizetype>(row) * gridSizeLon) + column] = toGridValue(sum / count);
+            }
+        }
+    }
+
+    return TerrainTileLocalDem::serializeFromGrid(swLat, swLon, swLat + tileSize, swLon + tileSize, gridSizeLat, gridSizeLon, grid);
+}
@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "TerrainOfflineDatabase.h"
+#include "TerrainTileCache.h"
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtPositioning/QGeoCoordinate>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <span>
+
+class TerrainDemFile;
+class TerrainTile;
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainLocalDemLog)
+
+/// Terrain from elevation rasters imported by the user (SRTM .hgt, GeoTIFF), used in place of the elevation provider
+/// wherever it covers a query.
+///
+/// An import resamples the raster into tiles at its own resolution, up to kMaxGridSize values per tile side, and
+/// builds overview levels from them. Level n tiles are 2^n times the size of level 0 tiles with the same number of
+/// values, each value is the average of the four level n-1 values it covers. Coarse queries read the overviews, so
+/// their cost depends on the number of values returned and not on the area. Tiles are kept in a memory mapped
+/// TerrainOfflineDatabase file of their own, the ones in use in a TerrainTileCache.
+///
+/// Imports work on a copy of the tile file, on a worker thread for startImport(). Queries are answered from the
+/// previous data until the copy is moved into place.
+///
+/// Not thread safe, used from the main thread only.
+class TerrainLocalDem : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param filePath Tile file, empty: Terrain/localdem.qgcterrain in the application data directory
+    explicit TerrainLocalDem(const QString &filePath = QString(), QObject *parent = nullptr);
+    ~TerrainLocalDem();
+
+    static TerrainLocalDem *instance();
+
+    /// Imports an elevation raster. Where it overlaps earlier imports it replaces them. Blocks until it is done.
+    ///     @param[out] errorString Reason the import failed
+    bool importFile(const QString &filePath, QString &errorString);
+
+    /// Imports an elevation raster on a worker thread, reports through importProgress() and importFinished()
+    ///     @return false: an import is already running
+    bool startImport(const QString &filePath);
+    void cancelImport();
+    bool importing() const { return _importing; }
+
+    /// Removes all imported terrain, cancels a running import
+    void clear();
+
+    bool isEmpty() const { return (_database.tileCount() == 0); }
+
+    /// @return false: at least one coordinate is not covered, altitudes is left empty
+    bool altitudes(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, int level = 0);
+
+    /// Heights along a path, spaced by the resolution of the imported data
+    ///     @return false: the path is not covered
+    bool pathAltitudes(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween, QList<double> &altitudes);
+
+    /// Heights of a rectangular area, rows from south to north. Larger areas are answered from coarser levels so the
+    /// carpet has at most kMaxCarpetSize values per side.
+    ///     @param statsOnly true: only min/max, carpet is left empty
+    ///     @return false: the area is not covered
+    bool carpetAltitudes(const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly, double &minHeight, double &maxHeight, QList<QList<double>> &carpet);
+
+    /// Distance between values of a level at a coordinate
+    ///     @return NaN: coordinate is not covered
+    double valueSpacingMeters(const QGeoCoordinate &coordinate, int level = 0);
+
+    static double tileSizeDegrees(int level) { return (kTileSizeDegrees * (1 << level)); }
+    static quint64 tileId(int level, int x, int y) { return TerrainTileCache::tileId(0, x, y, level); }
+    static int tileX(double lon, int level);
+    static int tileY(double lat, int level);
+
+    static constexpr double kTileSizeDegrees = 0.01;
+    static constexpr int kMaxLevel = 10;
+    static constexpr int kMinGridSize = 16;
+    static constexpr int kMaxGridSize = 1024;
+    static constexpr int kMaxCarpetSize = 512;
+    static constexpr int kMaxStatsCarpetSize = 64;
+    static constexpr int kMaxPathValues = 4096;
+    static constexpr int kMaxImportTiles = 250000;
+    static constexpr const char *kFileName = "localdem.qgcterrain";
+
+signals:
+    void dataChanged();
+    void importingChanged();
+    void importProgress(int percent);
+    void importFinished(bool success, const QString &errorString);
+
+private:
+    struct ImportResult {
+        bool success = false;
+        QString errorString;
+    };
+
+    using ProgressHandler = std::function<void(int percent)>;
+
+    std::shared_ptr<const TerrainTile> _tile(int level, int x, int y);
+
+    /// Looks up coordinates in one level
+    ///     @return false: a coordinate is not covered, the lookup stops there
+    bool _elevations(int level, std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations);
+
+    QString _importFilePath() const { return (_database.filePath() + QStringLiteral(".import")); }
+
+    /// Moves a successful import into place, runs on the main thread
+    bool _finishImport(const ImportResult &result, QString &errorString);
+
+    /// Copies the tile file at databasePath to importPath and imports into the copy. Thread safe.
+    ///     @param canceled Checked between tiles, nullptr: Can not be canceled
+    ///     @param progress Called with the percentage done, may be empty
+    static ImportResult _import(const QString &filePath, const QString &databasePath, const QString &importPath, const std::atomic_bool *canceled, const ProgressHandler &progress);
+    static QByteArray _baseTile(const TerrainOfflineDatabase &database, const TerrainDemFile &demFile, int x, int y, int gridSizeLat, int gridSizeLon);
+    static QByteArray _overviewTile(const TerrainOfflineDatabase &database, int level, int x, int y, int gridSizeLat, int gridSizeLon);
+    static void _addTile(TerrainOfflineDatabase &database, qsizetype &unflushedBytes, quint64 tileId, const QByteArray &tileData);
+
+    /// true: the database has a tile at level or above which covers tile (x, y) of level - 1
+    static bool _hasAncestor(const TerrainOfflineDatabase &database, int level, int x, int y);
+
+    TerrainOfflineDatabase _database;
+    TerrainTileCache _tileCache;
+
+    QFutureWatcher<ImportResult> _importWatcher;
+    std::atomic_bool _importCanceled = false;
+    bool _importing = false;
+
+    static constexpr qint64 kTileCacheBudgetBytes = 64 * 1024 * 1024;
+    static constexpr qsizetype kMaxUnflushedBytes = 128 * 1024 * 1024;
+    static constexpr int kProjectionMeshSize = 9;   ///< Raster positions are projected on this mesh per tile and interpolated between
+};
@@ -0,0 +1,514 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainOfflineDatabase.h"
+#include "TerrainTile.h"
+#include "TerrainTileCache.h"
+#include "QGCCacheTile.h"
+#include "QGCMapEngine.h"
+#include "QGCMapTasks.h"
+#include "QGCMapUrlEngine.h"
+#include "QGCTileSet.h"
+#include "QGeoFileTileCacheQGC.h"
+#include "MapProvider.h"
+#include "SettingsManager.h"
+#include "FlightMapSettings.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TerrainOfflineDatabaseLog, "qgc.terrain.terrainofflinedatabase")
+
+Q_GLOBAL_STATIC(TerrainOfflineDatabase, _terrainOfflineDatabase)
+
+TerrainOfflineDatabase *TerrainOfflineDatabase::instance()
+{
+    return _terrainOfflineDatabase();
+}
+
+TerrainOfflineDatabase::TerrainOfflineDatabase(const QString &filePath, QObject *parent)
+    : QObject(parent)
+    , _filePath(filePath)
+{
+    // qCDebug(TerrainOfflineDatabaseLog) << Q_FUNC_INFO << this;
+
+    if (_filePath.isEmpty()) {
+        // Kept apart from the map tile cache so resetting that cache does not throw away terrain downloaded for the field
+        _filePath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/Terrain/") + QString(kFileName);
+    }
+
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(kFlushDelayMSecs);
+    (void) connect(&_flushTimer, &QTimer::timeout, this, [this]() { (void) flush(); });
+
+    (void) _open();
+}
+
+TerrainOfflineDatabase::~TerrainOfflineDatabase()
+{
+    (void) flush();
+    _close();
+
+    // qCDebug(TerrainOfflineDatabaseLog) << Q_FUNC_INFO << this;
+}
+
+bool TerrainOfflineDatabase::_open()
+{
+    _close();
+
+    _file.setFileName(_filePath);
+    if (!_file.exists()) {
+        qCDebug(TerrainOfflineDatabaseLog) << "no database at" << _filePath;
+        return false;
+    }
+
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to open" << _filePath << _file.errorString();
+        return false;
+    }
+
+    const qint64 size = _file.size();
+    if (size < static_cast<qint64>(sizeof(FileHeader))) {
+        qCWarning(TerrainOfflineDatabaseLog) << "database too small" << _filePath;
+        _file.close();
+        return false;
+    }
+
+    const uchar* const mapped = _file.map(0, size);
+    if (!mapped) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to map" << _filePath << _file.errorString();
+        _file.close();
+        return false;
+    }
+
+    FileHeader header;
+    (void) memcpy(&header, mapped, sizeof(header));
+    // Written so that a huge index offset can not wrap around. The entries are read in place, so the index must be aligned.
+    const quint64 indexBytes = static_cast<quint64>(header.tileCount) * sizeof(IndexEntry);
+    const bool indexValid = (header.indexOffset >= sizeof(FileHeader)) && ((header.indexOffset % alignof(IndexEntry)) == 0) &&
+                            (header.indexOffset <= static_cast<quint64>(size)) && (indexBytes <= (static_cast<quint64>(size) - header.indexOffset));
+    if ((memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) || (header.version != kVersion) || !indexValid) {
+        qCWarning(TerrainOfflineDatabaseLog) << "not a terrain database or unsupported version" << _filePath;
+        (void) _file.unmap(const_cast<uchar*>(mapped));
+        _file.close();
+        return false;
+    }
+
+    _mapped = mapped;
+    _mappedSize = size;
+    _index = reinterpret_cast<const IndexEntry*>(_mapped + header.indexOffset);
+    _indexCount = header.tileCount;
+
+    qCDebug(TerrainOfflineDatabaseLog) << "opened" << _filePath << "tiles" << _indexCount;
+
+    return true;
+}
+
+void TerrainOfflineDatabase::_close()
+{
+    if (_mapped) {
+        (void) _file.unmap(const_cast<uchar*>(_mapped));
+    }
+    if (_file.isOpen()) {
+        _file.close();
+    }
+
+    _mapped = nullptr;
+    _mappedSize = 0;
+    _index = nullptr;
+    _indexCount = 0;
+}
+
+quint32 TerrainOfflineDatabase::providerKey(QStringView providerType)
+{
+    return static_cast<quint32>(UrlFactory::hashFromProviderType(providerType));
+}
+
+bool TerrainOfflineDatabase::_entryValid(const IndexEntry &entry) const
+{
+    // Written so that a huge offset can not wrap around
+    const quint64 size = static_cast<quint64>(_mappedSize);
+    return ((entry.offset <= size) && (entry.length <= (size - entry.offset)));
+}
+
+const TerrainOfflineDatabase::IndexEntry *TerrainOfflineDatabase::_findEntry(const TileKey &key) const
+{
+    if (!_index) {
+        return nullptr;
+    }
+
+    const IndexEntry* const end = _index + _indexCount;
+    const IndexEntry* const entry = std::lower_bound(_index, end, key, [](const IndexEntry &entry, const TileKey &key) {
+        return (TileKey(entry.provider, entry.tileId) < key);
+    });
+
+    if ((entry == end) || (entry->provider != key.first) || (entry->tileId != key.second)) {
+        return nullptr;
+    }
+
+    if (!_entryValid(*entry)) {
+        qCWarning(TerrainOfflineDatabaseLog) << "index entry outside of file" << Qt::hex << key.first << key.second;
+        return nullptr;
+    }
+
+    return entry;
+}
+
+QByteArray TerrainOfflineDatabase::_mappedTileData(const IndexEntry &entry) const
+{
+    // Only valid while the file stays mapped
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(_mapped + entry.offset), static_cast<qsizetype>(entry.length));
+}
+
+std::shared_ptr<const TerrainTile> TerrainOfflineDatabase::tile(quint64 tileId, quint32 provider) const
+{
+    const TileKey key(provider, tileId);
+    const auto pending = _pendingTiles.constFind(key);
+    if (pending != _pendingTiles.constEnd()) {
+        return std::make_shared<const TerrainTile>(pending.value());
+    }
+
+    const IndexEntry* const entry = _findEntry(key);
+    if (!entry) {
+        return nullptr;
+    }
+
+    // A deep copy, tiles may outlive the mapping when the file is rewritten
+    const QByteArray tileData(reinterpret_cast<const char*>(_mapped + entry->offset), static_cast<qsizetype>(entry->length));
+    const std::shared_ptr<const TerrainTile> terrainTile = std::make_shared<const TerrainTile>(tileData);
+    if (!terrainTile->isValid()) {
+        qCWarning(TerrainOfflineDatabaseLog) << "invalid tile in database" << Qt::hex << tileId;
+        return nullptr;
+    }
+
+    return terrainTile;
+}
+
+bool TerrainOfflineDatabase::contains(quint64 tileId, quint32 provider) const
+{
+    const TileKey key(provider, tileId);
+    return (_pendingTiles.contains(key) || (_findEntry(key) != nullptr));
+}
+
+qsizetype TerrainOfflineDatabase::tileCount() const
+{
+    qsizetype count = _indexCount;
+    for (auto it = _pendingTiles.constBegin(); it != _pendingTiles.constEnd(); ++it) {
+        if (!_findEntry(it.key())) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+bool TerrainOfflineDatabase::altitudes(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes) const
+{
+    altitudes.clear();
+    if (!_index && _pendingTiles.isEmpty()) {
+        return false;
+    }
+
+    const QString elevationProviderName = SettingsManager::instance()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(elevationProviderName);
+    if (!provider) {
+        qCWarning(TerrainOfflineDatabaseLog) << "unknown elevation provider" << elevationProviderName;
+        return false;
+    }
+    const quint32 providerId = providerKey(elevationProviderName);
+
+    quint64 lastTileId = 0;
+    std::shared_ptr<const TerrainTile> lastTile;
+
+    altitudes.reserve(coordinates.count());
+    for (const QGeoCoordinate &coordinate : coordinates) {
+        const quint64 tileId = TerrainTileCache::tileId(0, provider->long2tileX(coordinate.longitude(), 1), provider->lat2tileY(coordinate.latitude(), 1), 1);
+        if (!lastTile || (tileId != lastTileId)) {
+            lastTile = tile(tileId, providerId);
+            lastTileId = tileId;
+        }
+
+        const double elevation = lastTile ? lastTile->elevation(coordinate) : qQNaN();
+        if (qIsNaN(elevation)) {
+            altitudes.clear();
+            return false;
+        }
+        altitudes.append(elevation);
+    }
+
+    return true;
+}
+
+bool TerrainOfflineDatabase::addTile(quint64 tileId, const QByteArray &tileData, quint32 provider)
+{
+    if (!TerrainTile(tileData).isValid()) {
+        qCWarning(TerrainOfflineDatabaseLog) << "not adding invalid tile" << Qt::hex << provider << tileId;
+        return false;
+    }
+
+    (void) _pendingTiles.insert(TileKey(provider, tileId), tileData);
+    if (_autoFlush && !_flushTimer.isActive()) {
+        _flushTimer.start();
+    }
+
+    emit tileCountChanged();
+
+    return true;
+}
+
+bool TerrainOfflineDatabase::addCachedTile(const QString &hash, const QByteArray &tileData)
+{
+    int x, y, z;
+    if (!UrlFactory::tileHashToTile(hash, x, y, z)) {
+        qCWarning(TerrainOfflineDatabaseLog) << "invalid tile hash" << hash;
+        return false;
+    }
+
+    // The hash starts with the provider hash, so the provider does not have to be registered
+    bool ok = false;
+    const quint32 provider = static_cast<quint32>(QStringView(hash).left(10).toInt(&ok));
+    if (!ok) {
+        qCWarning(TerrainOfflineDatabaseLog) << "invalid tile hash" << hash;
+        return false;
+    }
+
+    return addTile(TerrainTileCache::tileId(0, x, y, z), tileData, provider);
+}
+
+void TerrainOfflineDatabase::importFromTileCache(const QString &type, const QGeoCoordinate &topLeft, const QGeoCoordinate &bottomRight)
+{
+    const quint32 provider = providerKey(type);
+    const QGCTileSet set = UrlFactory::getTileCount(1, topLeft.longitude(), topLeft.latitude(), bottomRight.longitude(), bottomRight.latitude(), type);
+
+    int requested = 0;
+    for (int x = set.tileX0; x <= set.tileX1; x++) {
+        for (int y = set.tileY0; y <= set.tileY1; y++) {
+            if (contains(TerrainTileCache::tileId(0, x, y, 1), provider)) {
+                continue;
+            }
+
+            QGCFetchTileTask* const task = QGeoFileTileCacheQGC::createFetchTileTask(type, x, y, 1);
+            (void) connect(task, &QGCFetchTileTask::tileFetched, this, [this](QGCCacheTile *cacheTile) {
+                (void) addCachedTile(cacheTile->hash(), cacheTile->img());
+                delete cacheTile;
+            });
+            (void) getQGCMapEngine()->addTask(task);
+            requested++;
+        }
+    }
+
+    qCDebug(TerrainOfflineDatabaseLog) << "importing up to" << requested << "tiles from the map tile cache";
+}
+
+bool TerrainOfflineDatabase::flush()
+{
+    _flushTimer.stop();
+
+    if (_pendingTiles.isEmpty()) {
+        return true;
+    }
+
+    if (!QDir().mkpath(QFileInfo(_filePath).absolutePath())) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to create directory for" << _filePath;
+        return false;
+    }
+
+    // The entries which stay, copied since the file is unmapped while it is written
+    QList<IndexEntry> entries;
+    entries.reserve(_indexCount + _pendingTiles.count());
+    quint64 tileBytes = 0;
+    for (quint32 i = 0; i < _indexCount; i++) {
+        const IndexEntry &entry = _index[i];
+        const TileKey key(entry.provider, entry.tileId);
+        if (_pendingTiles.contains(key)) {
+            continue;
+        }
+        // Entries of a damaged file are left out instead of taken over
+        if (!_entryValid(entry)) {
+            qCWarning(TerrainOfflineDatabaseLog) << "dropping index entry outside of file" << Qt::hex << key.first << key.second;
+            continue;
+        }
+        entries.append(entry);
+        tileBytes += entry.length;
+    }
+
+    quint64 pendingBytes = 0;
+    for (auto it = _pendingTiles.constBegin(); it != _pendingTiles.constEnd(); ++it) {
+        pendingBytes += static_cast<quint64>(it.value().size());
+    }
+
+    // A flush only writes the new tiles and the index, which is small next to the tiles. That leaves replaced tiles
+    // and the old index behind as dead space, the file is compacted once it would take up more than twice the space
+    // in use.
+    const quint64 indexBytes = static_cast<quint64>(entries.count() + _pendingTiles.count()) * sizeof(IndexEntry);
+    const quint64 usedBytes = sizeof(FileHeader) + tileBytes + pendingBytes + indexBytes;
+    const quint64 appendedBytes = static_cast<quint64>(_mappedSize) + pendingBytes + alignof(IndexEntry) + indexBytes;
+    const bool rewrite = !_mapped || (appendedBytes > (2 * usedBytes));
+
+    const bool written = rewrite ? _rewrite(entries) : _append(entries);
+    if (written) {
+        _pendingTiles.clear();
+    }
+    (void) _open();
+
+    if (written) {
+        qCDebug(TerrainOfflineDatabaseLog) << (rewrite ? "rewrote" : "appended to") << _filePath << "tiles" << _indexCount << "size" << _mappedSize;
+    }
+
+    return written;
+}
+
+bool TerrainOfflineDatabase::_writePendingTiles(QFileDevice &file, quint64 offset, QList<IndexEntry> &entries, FileHeader &header) const
+{
+    for (auto it = _pendingTiles.constBegin(); it != _pendingTiles.constEnd(); ++it) {
+        const QByteArray &tileData = it.value();
+        if (file.write(tileData) != tileData.size()) {
+            return false;
+        }
+        entries.append({ it.key().second, offset, static_cast<quint32>(tileData.size()), it.key().first });
+        offset += static_cast<quint64>(tileData.size());
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const IndexEntry &entry1, const IndexEntry &entry2) {
+        return (TileKey(entry1.provider, entry1.tileId) < TileKey(entry2.provider, entry2.tileId));
+    });
+
+    const qint64 padding = static_cast<qint64>((alignof(IndexEntry) - (offset % alignof(IndexEntry))) % alignof(IndexEntry));
+    if (file.write(QByteArray(padding, '\0')) != padding) {
+        return false;
+    }
+
+    (void) memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.tileCount = static_cast<quint32>(entries.count());
+    header.indexOffset = offset + static_cast<quint64>(padding);
+
+    const qint64 indexBytes = static_cast<qint64>(entries.count() * sizeof(IndexEntry));
+    return (file.write(reinterpret_cast<const char*>(entries.constData()), indexBytes) == indexBytes);
+}
+
+bool TerrainOfflineDatabase::_rewrite(QList<IndexEntry> entries)
+{
+    QSaveFile file(_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to write" << _filePath << file.errorString();
+        _close();
+        return false;
+    }
+
+    // Written again once the position of the index is known
+    FileHeader header{};
+    bool ok = (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == static_cast<qint64>(sizeof(header)));
+
+    quint64 offset = sizeof(FileHeader);
+    for (IndexEntry &entry : entries) {
+        if (!ok) {
+            break;
+        }
+        ok = (file.write(_mappedTileData(entry)) == static_cast<qint64>(entry.length));
+        entry.offset = offset;
+        offset += entry.length;
+    }
+
+    ok = ok && _writePendingTiles(file, offset, entries, header) && file.seek(0) &&
+         (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == static_cast<qint64>(sizeof(header)));
+
+    // The old file must not be mapped while it is replaced, and the mapped tile data is not used past this point
+    _close();
+
+    if (!ok) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to write" << _filePath << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to write" << _filePath << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool TerrainOfflineDatabase::_append(QList<IndexEntry> entries)
+{
+    const quint64 fileSize = static_cast<quint64>(_mappedSize);
+
+    // Some platforms do not allow writing to a mapped file
+    _close();
+
+    QFile file(_filePath);
+    if (!file.open(QIODevice::ReadWrite) || !file.seek(static_cast<qint64>(fileSize))) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to open" << _filePath << file.errorString();
+        return false;
+    }
+
+    // The header goes last, until then it points to the old index which is left untouched
+    FileHeader header{};
+    const bool ok = _writePendingTiles(file, fileSize, entries, header) && file.flush() && file.seek(0) &&
+                    (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == static_cast<qint64>(sizeof(header)));
+    if (!ok) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to write" << _filePath << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void TerrainOfflineDatabase::clear()
+{
+    _flushTimer.stop();
+    _pendingTiles.clear();
+    _close();
+
+    if (QFile::exists(_filePath) && !QFile::remove(_filePath)) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to remove" << _filePath;
+    }
+
+    emit tileCountChanged();
+}
+
+void TerrainOfflineDatabase::setAutoFlush(bool autoFlush)
+{
+    _autoFlush = autoFlush;
+    if (!_autoFlush) {
+        _flushTimer.stop();
+    }
+}
+
+bool TerrainOfflineDatabase::replaceWith(const QString &filePath)
+{
+    _flushTimer.stop();
+    _pendingTiles.clear();
+
+    // The file must not be mapped while it is replaced
+    _close();
+
+    if (QFile::exists(_filePath) && !QFile::remove(_filePath)) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to remove" << _filePath;
+        (void) _open();
+        return false;
+    }
+
+    const bool replaced = QFile::rename(filePath, _filePath);
+    if (!replaced) {
+        qCWarning(TerrainOfflineDatabaseLog) << "failed to move" << filePath << "to" << _filePath;
+    }
+
+    (void) _open();
+    emit tileCountChanged();
+
+    return replaced;
+}
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtPositioning/QGeoCoordinate>
+
+#include <memory>
+#include <utility>
+
+class TerrainTile;
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainOfflineDatabaseLog)
+
+/// Terrain tiles stored for use without a network connection.
+///
+/// The tiles live in a single file which is memory mapped: a header, the serialized tiles and an index sorted by tile
+/// id. A lookup is a binary search in the mapped index. Added tiles are kept in memory and written out together: they
+/// are appended with a new index, and the header is switched over to that index last, so an interrupted write leaves
+/// the previous state. Replaced tiles and old indexes are dead space, the file is rewritten once they outweigh the
+/// tiles in use.
+///
+/// Tiles are keyed by provider and tile id. The provider is UrlFactory::hashFromProviderType() of the elevation
+/// provider name, 0 for tiles which do not come from a provider. It is stable across releases, unlike the map ids
+/// which are assigned at runtime, so tile ids are TerrainTileCache::tileId() values with a map id of 0.
+/// Tiles are in the serialized TerrainTile format.
+/// Not thread safe, used from the main thread only.
+class TerrainOfflineDatabase : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param filePath Database file, empty: Terrain/terrain.qgcterrain in the application data directory
+    explicit TerrainOfflineDatabase(const QString &filePath = QString(), QObject *parent = nullptr);
+    ~TerrainOfflineDatabase();
+
+    static TerrainOfflineDatabase *instance();
+
+    QString filePath() const { return _filePath; }
+
+    /// @return nullptr: tile is not in the database
+    std::shared_ptr<const TerrainTile> tile(quint64 tileId, quint32 provider = 0) const;
+    bool contains(quint64 tileId, quint32 provider = 0) const;
+    qsizetype tileCount() const;
+
+    /// Key of an elevation provider in the database
+    static quint32 providerKey(QStringView providerType);
+
+    /// Looks the coordinates up in the tiles of the current elevation provider
+    ///     @return false: at least one coordinate is not covered, altitudes is left empty
+    bool altitudes(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes) const;
+
+    /// Adds or replaces a tile, it is written to disk shortly after
+    ///     @return false: data is not a valid tile
+    bool addTile(quint64 tileId, const QByteArray &tileData, quint32 provider = 0);
+
+    /// Adds a tile stored in the map tile cache under its cache hash
+    bool addCachedTile(const QString &hash, const QByteArray &tileData);
+
+    /// Copies the tiles of an area which are already in the map tile cache
+    ///     @param type Elevation provider type
+    void importFromTileCache(const QString &type, const QGeoCoordinate &topLeft, const QGeoCoordinate &bottomRight);
+
+    /// Writes added tiles to disk
+    bool flush();
+
+    /// Removes all tiles and the file
+    void clear();
+
+    /// false: added tiles are only written by flush(). Needed off the main thread, where there is no event loop for
+    /// the flush timer.
+    void setAutoFlush(bool autoFlush);
+
+    /// Replaces the database by another database file, which is moved into place. Tiles not yet written are dropped.
+    bool replaceWith(const QString &filePath);
+
+    static constexpr const char *kFileName = "terrain.qgcterrain";
+
+signals:
+    void tileCountChanged();
+
+private:
+    struct FileHeader {
+        char magic[8];
+        quint32 version;
+        quint32 tileCount;
+        quint64 indexOffset;    ///< From the start of the file
+    };
+
+    struct IndexEntry {
+        quint64 tileId;
+        quint64 offset;         ///< From the start of the file
+        quint32 length;
+        quint32 provider;
+    };
+
+    /// Index order: by provider, then tile id
+    using TileKey = std::pair<quint32, quint64>;
+
+    bool _open();
+    void _close();
+    const IndexEntry *_findEntry(const TileKey &key) const;
+    /// false: entry points outside of the file
+    bool _entryValid(const IndexEntry &entry) const;
+    QByteArray _mappedTileData(const IndexEntry &entry) const;
+    /// Writes the tiles in the file and the existing entries to a new file, unmaps the file
+    bool _rewrite(QList<IndexEntry> entries);
+    /// Writes the pending tiles and a new index at the end of the file, unmaps the file
+    bool _append(QList<IndexEntry> entries);
+    /// Writes the pending tiles starting at offset in the file, then the index of entries and them
+    ///     @param header Set to the new index
+    bool _writePendingTiles(QFileDevice &file, quint64 offset, QList<IndexEntry> &entries, FileHeader &header) const;
+
+    QString _filePath;
+    QFile _file;
+    const uchar *_mapped = nullptr;
+    qint64 _mappedSize = 0;
+    const IndexEntry *_index = nullptr;
+    quint32 _indexCount = 0;
+
+    QHash<TileKey, QByteArray> _pendingTiles;   ///< Added, not yet written
+    QTimer _flushTimer;
+    bool _autoFlush = true;
+
+    static constexpr char kMagic[8] = { 'Q', 'G', 'C', 'T', 'E', 'R', 'R', '\0' };
+    static constexpr quint32 kVersion = 3;
+    static constexpr int kFlushDelayMSecs = 2000;
+};
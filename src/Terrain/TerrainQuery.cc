@@ -9,6 +9,7 @@
 
 #include "TerrainQuery.h"
 #include "TerrainQueryInterface.h"
+#include "TerrainLocalDem.h"
 #include "TerrainTileManager.h"
 #include "QGCLoggingCategory.h"
 
@@ -180,6 +181,11 @@ void TerrainAtCoordinateQuery::requestData(const QList<QGeoCoordinate> &coordina
 
 bool TerrainAtCoordinateQuery::getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error)
 {
+    if (TerrainLocalDem::instance()->altitudes(coordinates, altitudes)) {
+        error = false;
+        return true;
+    }
+
     return TerrainTileManager::instance()->getAltitudesForCoordinates(coordinates, altitudes, error);
 }
 
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "TerrainQueryInterface.h"
+#include "TerrainLocalDem.h"
 #include "TerrainTileManager.h"
 #include "QGCLoggingCategory.h"
 
@@ -102,15 +103,46 @@ void TerrainOfflineQuery::requestCoordinateHeights(const QList<QGeoCoordinate> &
     }
 
     _queryMode = TerrainQuery::QueryModeCoordinates;
+
+    QList<double> heights;
+    if (TerrainLocalDem::instance()->altitudes(coordinates, heights)) {
+        signalCoordinateHeights(true, heights);
+        return;
+    }
+
     TerrainTileManager::instance()->addCoordinateQuery(this, coordinates);
 }
 
 void TerrainOfflineQuery::requestPathHeights(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord)
 {
     _queryMode = TerrainQuery::QueryModePath;
+
+    double distanceBetween, finalDistanceBetween;
+    QList<double> heights;
+    if (TerrainLocalDem::instance()->pathAltitudes(fromCoord, toCoord, distanceBetween, finalDistanceBetween, heights)) {
+        signalPathHeights(true, distanceBetween, finalDistanceBetween, heights);
+        return;
+    }
+
     TerrainTileManager::instance()->addPathQuery(this, fromCoord, toCoord);
 }
 
+void TerrainOfflineQuery::requestCarpetHeights(const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly)
+{
+    _queryMode = TerrainQuery::QueryModeCarpet;
+
+    // Only imported terrain can answer carpet queries offline
+    double minHeight, maxHeight;
+    QList<QList<double>> carpet;
+    if (!TerrainLocalDem::instance()->carpetAltitudes(swCoord, neCoord, statsOnly, minHeight, maxHeight, carpet)) {
+        qCDebug(TerrainQueryInterfaceLog) << Q_FUNC_INFO << "area not covered by imported terrain";
+        _requestFailed();
+        return;
+    }
+
+    signalCarpetHeights(true, minHeight, maxHeight, carpet);
+}
+
 /*===========================================================================*/
 
 TerrainOnlineQuery::TerrainOnlineQuery(QObject *parent)
@@ -77,6 +77,7 @@ class TerrainQueryInterface : public QObject
 
 /*===========================================================================*/
 
+/// Answers from imported terrain (TerrainLocalDem) where it covers the query, otherwise from elevation tiles
 class TerrainOfflineQuery : public TerrainQueryInterface
 {
     Q_OBJECT
@@ -87,6 +88,7 @@ class TerrainOfflineQuery : public TerrainQueryInterface
 
     void requestCoordinateHeights(const QList<QGeoCoordinate> &coordinates) override;
     void requestPathHeights(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord) override;
+    void requestCarpetHeights(const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly) override;
 };
 
 /*===========================================================================*/
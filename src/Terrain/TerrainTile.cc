@@ -10,13 +10,33 @@
 #include "TerrainTile.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QtMath>
 #include <QtCore/QtNumeric>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 QGC_LOGGING_CATEGORY(TerrainTileLog, "qgc.terrain.terraintile");
 
+namespace
+{
+
+/// Coordinates are unpacked into lat/lon arrays of this size on the stack
+constexpr size_t kCoordinateChunkSize = 256;
+
+/// Clamps a fractional grid position into [0, max]. Unlike std::clamp a NaN position ends up as 0, so the result
+/// can always be converted to an index. Compiles to plain min/max instructions.
+inline double clampPosition(double position, double max)
+{
+    const double lower = (position > 0.0) ? position : 0.0;
+    return (lower < max) ? lower : max;
+}
+
+} // namespace
+
 TerrainTile::TerrainTile(const QByteArray &byteArray)
-    : _tileInfo(*reinterpret_cast<const TileInfo_t*>(byteArray.constData()))
 {
     // qCDebug(TerrainTileLog) << Q_FUNC_INFO << this;
 
@@ -28,6 +48,13 @@ TerrainTile::TerrainTile(const QByteArray &byteArray)
         return;
     }
 
+    (void) memcpy(&_tileInfo, byteArray.constData(), sizeof(TileInfo_t));
+
+    if ((_tileInfo.gridSizeLat <= 0) || (_tileInfo.gridSizeLon <= 0)) {
+        qCWarning(TerrainTileLog) << "Terrain tile grid is empty";
+        return;
+    }
+
     const int cTileDataBytes = static_cast<int>(sizeof(int16_t)) * _tileInfo.gridSizeLat * _tileInfo.gridSizeLon;
     if (cTileBytesAvailable < cTileHeaderBytes + cTileDataBytes) {
         qCWarning(TerrainTileLog) << "Terrain tile binary data too small for tile data";
@@ -45,21 +72,19 @@ TerrainTile::TerrainTile(const QByteArray &byteArray)
 
     qCDebug(TerrainTileLog) << this << "TileInfo: south west:" << _tileInfo.swLat << _tileInfo.swLon;
     qCDebug(TerrainTileLog) << this << "TileInfo: north east:" << _tileInfo.neLat << _tileInfo.neLon;
-    qCDebug(TerrainTileLog) << this << "TileInfo: dimensions:" << _tileInfo.gridSizeLat << "by" << _tileInfo.gridSizeLat;
+    qCDebug(TerrainTileLog) << this << "TileInfo: dimensions:" << _tileInfo.gridSizeLat << "by" << _tileInfo.gridSizeLon;
     qCDebug(TerrainTileLog) << this << "TileInfo: min, max, avg:" << _tileInfo.minElevation << _tileInfo.maxElevation << _tileInfo.avgElevation;
     qCDebug(TerrainTileLog) << this << "TileInfo: cell size:" << _cellSizeLat << _cellSizeLon;
 
-    _elevationData.resize(_tileInfo.gridSizeLat);
-    for (int k = 0; k < _tileInfo.gridSizeLat; k++) {
-        _elevationData[k].resize(_tileInfo.gridSizeLon);
-    }
-
-    int valueIndex = 0;
-    const int16_t* const pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _tileInfo.gridSizeLat; i++) {
-        for (int j = 0; j < _tileInfo.gridSizeLon; j++) {
-            _elevationData[i][j] = pTileData[valueIndex++];
-        }
+    // The grid is used in place, sharing the buffer of the downloaded data. Only if it is not aligned for int16_t
+    // it has to be copied into a buffer of its own.
+    const char* const pTileData = byteArray.constData() + cTileHeaderBytes;
+    if ((reinterpret_cast<quintptr>(pTileData) % alignof(int16_t)) == 0) {
+        _elevationBytes = byteArray;
+        _elevationData = reinterpret_cast<const int16_t*>(_elevationBytes.constData() + cTileHeaderBytes);
+    } else {
+        _elevationBytes = QByteArray(pTileData, cTileDataBytes);
+        _elevationData = reinterpret_cast<const int16_t*>(_elevationBytes.constData());
     }
 
     _isValid = true;
@@ -77,35 +102,98 @@ double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
         return qQNaN();
     }
 
-    const double latDeltaSw = coordinate.latitude() - _tileInfo.swLat;
-    const double lonDeltaSw = coordinate.longitude() - _tileInfo.swLon;
-
-    const int16_t latIndex = qFloor(latDeltaSw / _cellSizeLat);
-    const int16_t lonIndex = qFloor(lonDeltaSw / _cellSizeLon);
-
-    const bool latIndexInvalid = (latIndex < 0) || (latIndex > (_tileInfo.gridSizeLat - 1));
-    const bool lonIndexInvalid = (lonIndex < 0) || (lonIndex > (_tileInfo.gridSizeLon - 1));
+    const int latIndex = qFloor((coordinate.latitude() - _tileInfo.swLat) / _cellSizeLat);
+    const int lonIndex = qFloor((coordinate.longitude() - _tileInfo.swLon) / _cellSizeLon);
 
-    if (latIndexInvalid || lonIndexInvalid) {
+    if ((latIndex < 0) || (latIndex >= _tileInfo.gridSizeLat) || (lonIndex < 0) || (lonIndex >= _tileInfo.gridSizeLon)) {
         qCWarning(TerrainTileLog) << this << "Internal error: coordinate" << coordinate << "outside tile bounds";
         return qQNaN();
     }
 
-    if ((latIndex >= _elevationData.size()) || (lonIndex >= _elevationData[latIndex].size())) {
-        qCWarning(TerrainTileLog).noquote() << this << "Internal error: _elevationData size inconsistent _tileInfo << coordinate" << coordinate
-            << "\n\t_tillIndo.gridSizeLat:" << _tileInfo.gridSizeLat << "_tileInfo.gridSizeLon:" << _tileInfo.gridSizeLon
-            << "\n\t_data.size():" << _elevationData.size() << "_elevationData[latIndex].size():" << _elevationData[latIndex].size();
-        return qQNaN();
+    return static_cast<double>(gridValue(latIndex, lonIndex));
+}
+
+void TerrainTile::elevations(std::span<const QGeoCoordinate> coordinates, std::span<double> elevations, bool interpolate) const
+{
+    Q_ASSERT(coordinates.size() == elevations.size());
+
+    double latitudes[kCoordinateChunkSize];
+    double longitudes[kCoordinateChunkSize];
+
+    for (size_t start = 0; start < coordinates.size(); start += kCoordinateChunkSize) {
+        const size_t count = std::min(kCoordinateChunkSize, coordinates.size() - start);
+        for (size_t i = 0; i < count; i++) {
+            latitudes[i] = coordinates[start + i].latitude();
+            longitudes[i] = coordinates[start + i].longitude();
+        }
+
+        this->elevations(std::span<const double>(latitudes, count), std::span<const double>(longitudes, count), elevations.subspan(start, count), interpolate);
     }
+}
 
-    const int16_t elevation = _elevationData[latIndex][lonIndex];
-    if (elevation < _tileInfo.minElevation) {
-        qCWarning(TerrainTileLog) << this << "Warning: elevation read is below min elevation in tile:" << elevation << "<" << _tileInfo.minElevation;
-    } else if (elevation > _tileInfo.maxElevation) {
-        qCWarning(TerrainTileLog) << this << "Warning: elevation read is above max elevation in tile:" << elevation << ">" << _tileInfo.maxElevation;
+void TerrainTile::elevations(std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations, bool interpolate) const
+{
+    Q_ASSERT((latitudes.size() == longitudes.size()) && (latitudes.size() == elevations.size()));
+
+    if (!_isValid) {
+        qCWarning(TerrainTileLog) << this << "Request for elevations, but tile is invalid.";
+        std::fill(elevations.begin(), elevations.end(), qQNaN());
+        return;
     }
 
-    qCDebug(TerrainTileLog) << this << "latIndex, lonIndex:" << latIndex << lonIndex << "elevation:" << elevation;
+    const double swLat = _tileInfo.swLat;
+    const double swLon = _tileInfo.swLon;
+    const double latScale = 1.0 / _cellSizeLat;
+    const double lonScale = 1.0 / _cellSizeLon;
+    const int rows = _tileInfo.gridSizeLat;
+    const int columns = _tileInfo.gridSizeLon;
+    const double rowLimit = rows;
+    const double columnLimit = columns;
+    const int16_t* const data = _elevationData;
+    const size_t count = elevations.size();
+
+    // Indices are clamped so that the loads stay inside the grid, coordinates outside are masked to NaN afterwards.
+    // NaN coordinates fail all comparisons and end up as NaN as well.
+    if (!interpolate) {
+        for (size_t i = 0; i < count; i++) {
+            const double latPosition = (latitudes[i] - swLat) * latScale;
+            const double lonPosition = (longitudes[i] - swLon) * lonScale;
+            const bool inside = (latPosition >= 0.0) && (latPosition < rowLimit) && (lonPosition >= 0.0) && (lonPosition < columnLimit);
+
+            const int row = static_cast<int>(clampPosition(latPosition, rowLimit - 1.0));
+            const int column = static_cast<int>(clampPosition(lonPosition, columnLimit - 1.0));
+            const double value = data[(row * columns) + column];
+
+            elevations[i] = inside ? value : qQNaN();
+        }
+        return;
+    }
 
-    return static_cast<double>(elevation);
+    // Each value sits at the center of its cell. Between the outermost centers and the tile edge the grid is
+    // extended flat, which the clamping takes care of.
+    for (size_t i = 0; i < count; i++) {
+        const double latPosition = (latitudes[i] - swLat) * latScale;
+        const double lonPosition = (longitudes[i] - swLon) * lonScale;
+        const bool inside = (latPosition >= 0.0) && (latPosition < rowLimit) && (lonPosition >= 0.0) && (lonPosition < columnLimit);
+
+        const double latCenter = clampPosition(latPosition - 0.5, rowLimit - 1.0);
+        const double lonCenter = clampPosition(lonPosition - 0.5, columnLimit - 1.0);
+        const int row0 = static_cast<int>(latCenter);
+        const int column0 = static_cast<int>(lonCenter);
+        const int row1 = std::min(row0 + 1, rows - 1);
+        const int column1 = std::min(column0 + 1, columns - 1);
+        const double latFraction = latCenter - row0;
+        const double lonFraction = lonCenter - column0;
+
+        const double southWest = data[(row0 * columns) + column0];
+        const double southEast = data[(row0 * columns) + column1];
+        const double northWest = data[(row1 * columns) + column0];
+        const double northEast = data[(row1 * columns) + column1];
+
+        const double south = southWest + ((southEast - southWest) * lonFraction);
+        const double north = northWest + ((northEast - northWest) * lonFraction);
+        const double value = south + ((north - south) * latFraction);
+
+        elevations[i] = inside ? value : qQNaN();
+    }
 }
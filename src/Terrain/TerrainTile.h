@@ -9,9 +9,11 @@
 
 #pragma once
 
-#include <QtCore/QList>
+#include <QtCore/QByteArray>
 #include <QtCore/QLoggingCategory>
 
+#include <span>
+
 class QGeoCoordinate;
 class TerrainTileTest;
 
@@ -33,9 +35,20 @@ class TerrainTile
 
     /// Evaluates the elevation at the given coordinate
     ///    @param coordinate
-    ///    @return elevation
+    ///    @return elevation of the grid cell the coordinate falls in, NaN if it is outside the tile
     double elevation(const QGeoCoordinate &coordinate) const;
 
+    /// Evaluates the elevations of many coordinates at once, coordinates outside the tile get NaN
+    ///    @param coordinates
+    ///    @param[out] elevations Must be the same size as coordinates
+    ///    @param interpolate true: bilinear interpolation between the centers of the surrounding cells,
+    ///                       false: same value elevation() returns
+    void elevations(std::span<const QGeoCoordinate> coordinates, std::span<double> elevations, bool interpolate = false) const;
+
+    /// Same as above for coordinates which are already split in latitudes and longitudes. The loop has no calls
+    /// and no data dependent branches, so the compiler can vectorize it.
+    void elevations(std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations, bool interpolate = false) const;
+
     /// Accessor for the minimum elevation of the tile
     ///    @return minimum elevation
     double minElevation() const { return (_isValid ? static_cast<double>(_tileInfo.minElevation) : qQNaN()); }
@@ -48,6 +61,16 @@ class TerrainTile
     ///    @return average elevation
     double avgElevation() const { return (_isValid ? _tileInfo.avgElevation : qQNaN()); }
 
+    /// Number of grid cells in latitude and longitude direction
+    int gridSizeLat() const { return _tileInfo.gridSizeLat; }
+    int gridSizeLon() const { return _tileInfo.gridSizeLon; }
+
+    /// Memory held by the tile, including the shared data buffer
+    qsizetype byteSize() const { return static_cast<qsizetype>(sizeof(*this)) + _elevationBytes.size(); }
+
+    /// Raw grid value, row 0 is the southern most row. Indices are not checked.
+    int16_t gridValue(int latIndex, int lonIndex) const { return _elevationData[(latIndex * _tileInfo.gridSizeLon) + lonIndex]; }
+
 protected:
     struct TileInfo_t {
         double  swLat, swLon, neLat, neLon;
@@ -58,8 +81,9 @@ class TerrainTile
 
 private:
     TileInfo_t _tileInfo{};
-    QList<QList<int16_t>> _elevationData;   ///< 2D elevation data array
-    double _cellSizeLat = 0.0;              ///< data grid size in latitude direction
-    double _cellSizeLon = 0.0;              ///< data grid size in longitude direction
-    bool _isValid = false;                  ///< data loaded is valid
+    QByteArray _elevationBytes;                 ///< Keeps the buffer _elevationData points into alive
+    const int16_t *_elevationData = nullptr;    ///< Row major elevation grid, gridSizeLat rows of gridSizeLon values
+    double _cellSizeLat = 0.0;                  ///< data grid size in latitude direction
+    double _cellSizeLon = 0.0;                  ///< data grid size in longitude direction
+    bool _isValid = false;                      ///< data loaded is valid
 };
@@ -0,0 +1,153 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileCache.h"
+#include "TerrainTile.h"
+#include "QGCLoggingCategory.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+QGC_LOGGING_CATEGORY(TerrainTileCacheLog, "qgc.terrain.terraintilecache")
+
+TerrainTileCache::TerrainTileCache(qint64 budgetBytes)
+    : _budgetBytes(std::max<qint64>(0, budgetBytes))
+{
+    // qCDebug(TerrainTileCacheLog) << Q_FUNC_INFO << this;
+}
+
+TerrainTileCache::~TerrainTileCache()
+{
+    // qCDebug(TerrainTileCacheLog) << Q_FUNC_INFO << this;
+}
+
+quint64 TerrainTileCache::tileId(int mapId, int x, int y, int zoom)
+{
+    // 16 bit map id, 8 bit zoom, 20 bit x and y: enough for zoom levels up to 20
+    return ((static_cast<quint64>(mapId) & 0xFFFF) << 48)
+         | ((static_cast<quint64>(zoom) & 0xFF) << 40)
+         | ((static_cast<quint64>(x) & 0xFFFFF) << 20)
+         | (static_cast<quint64>(y) & 0xFFFFF);
+}
+
+std::shared_ptr<const TerrainTile> TerrainTileCache::tile(quint64 id) const
+{
+    QReadLocker locker(&_lock);
+
+    const auto it = _entries.find(id);
+    if (it == _entries.end()) {
+        (void) _misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    it->second.lastUsed.store(_useClock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    (void) _hits.fetch_add(1, std::memory_order_relaxed);
+    return it->second.tile;
+}
+
+bool TerrainTileCache::contains(quint64 id) const
+{
+    QReadLocker locker(&_lock);
+    return _entries.contains(id);
+}
+
+void TerrainTileCache::insert(quint64 id, const std::shared_ptr<const TerrainTile> &tile)
+{
+    if (!tile) {
+        return;
+    }
+
+    QWriteLocker locker(&_lock);
+
+    const auto [it, inserted] = _entries.try_emplace(id);
+    if (!inserted) {
+        return;
+    }
+
+    it->second.tile = tile;
+    it->second.bytes = tile->byteSize();
+    it->second.lastUsed.store(_useClock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _bytes += it->second.bytes;
+    _insertions++;
+
+    if (_bytes > _budgetBytes) {
+        _evict(id);
+    }
+}
+
+void TerrainTileCache::_evict(quint64 keepId)
+{
+    const qint64 targetBytes = (_budgetBytes * kEvictionTargetPercent) / 100;
+
+    std::vector<std::pair<quint64, quint64>> byAge;
+    byAge.reserve(_entries.size());
+    for (const auto &[id, entry] : _entries) {
+        if (id != keepId) {
+            byAge.emplace_back(entry.lastUsed.load(std::memory_order_relaxed), id);
+        }
+    }
+    std::sort(byAge.begin(), byAge.end());
+
+    quint64 evicted = 0;
+    for (const auto &[lastUsed, id] : byAge) {
+        if (_bytes <= targetBytes) {
+            break;
+        }
+
+        const auto it = _entries.find(id);
+        _bytes -= it->second.bytes;
+        (void) _entries.erase(it);
+        evicted++;
+    }
+    _evictions += evicted;
+
+    qCDebug(TerrainTileCacheLog) << "evicted" << evicted << "tiles, cache now" << _bytes << "of" << _budgetBytes << "bytes";
+}
+
+qint64 TerrainTileCache::budgetBytes() const
+{
+    QReadLocker locker(&_lock);
+    return _budgetBytes;
+}
+
+void TerrainTileCache::setBudgetBytes(qint64 budgetBytes)
+{
+    QWriteLocker locker(&_lock);
+
+    _budgetBytes = std::max<qint64>(0, budgetBytes);
+    if (_bytes > _budgetBytes) {
+        // Nothing is exempt, the most recently used tile is evicted last anyway
+        _evict(std::numeric_limits<quint64>::max());
+    }
+}
+
+void TerrainTileCache::clear()
+{
+    QWriteLocker locker(&_lock);
+
+    _entries.clear();
+    _bytes = 0;
+}
+
+TerrainTileCache::Statistics TerrainTileCache::statistics() const
+{
+    QReadLocker locker(&_lock);
+
+    Statistics statistics;
+    statistics.hits = _hits.load(std::memory_order_relaxed);
+    statistics.misses = _misses.load(std::memory_order_relaxed);
+    statistics.insertions = _insertions;
+    statistics.evictions = _evictions;
+    statistics.tileCount = static_cast<qsizetype>(_entries.size());
+    statistics.bytes = _bytes;
+    statistics.budgetBytes = _budgetBytes;
+    return statistics;
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QReadWriteLock>
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+class TerrainTile;
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainTileCacheLog)
+
+/// Memory bounded least recently used cache of terrain tiles, keyed by a packed tile id.
+///
+/// Thread safe. Lookups only take a shared lock, so any number of threads can query in parallel. Recency is
+/// tracked with a per tile atomic use stamp instead of a list which would need an exclusive lock to reorder.
+/// Once an insert takes the cache over budget, the least recently used tiles are evicted in one go until the
+/// cache is down to kEvictionTargetPercent of the budget.
+class TerrainTileCache
+{
+public:
+    struct Statistics {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 insertions = 0;
+        quint64 evictions = 0;
+        qsizetype tileCount = 0;
+        qint64 bytes = 0;
+        qint64 budgetBytes = 0;
+    };
+
+    explicit TerrainTileCache(qint64 budgetBytes = kDefaultBudgetBytes);
+    ~TerrainTileCache();
+
+    /// Packs a tile address into a cache key
+    static quint64 tileId(int mapId, int x, int y, int zoom);
+
+    /// @return nullptr if the tile is not cached. The tile stays valid while the pointer is held, even if it is evicted.
+    std::shared_ptr<const TerrainTile> tile(quint64 id) const;
+    bool contains(quint64 id) const;
+
+    /// Adds a tile unless one with the same id is cached already, may evict others
+    void insert(quint64 id, const std::shared_ptr<const TerrainTile> &tile);
+
+    qint64 budgetBytes() const;
+    void setBudgetBytes(qint64 budgetBytes);
+
+    void clear();
+    Statistics statistics() const;
+
+    static constexpr qint64 kDefaultBudgetBytes = 32 * 1024 * 1024;
+    static constexpr int kEvictionTargetPercent = 90;
+
+private:
+    struct Entry {
+        std::shared_ptr<const TerrainTile> tile;
+        qint64 bytes = 0;
+        mutable std::atomic<quint64> lastUsed = 0;
+    };
+
+    /// Must be called with the exclusive lock held
+    void _evict(quint64 keepId);
+
+    mutable QReadWriteLock _lock;
+    std::unordered_map<quint64, Entry> _entries;
+    qint64 _bytes = 0;
+    qint64 _budgetBytes = 0;
+
+    mutable std::atomic<quint64> _useClock = 0;
+    mutable std::atomic<quint64> _hits = 0;
+    mutable std::atomic<quint64> _misses = 0;
+    quint64 _insertions = 0;
+    quint64 _evictions = 0;
+};
@@ -10,15 +10,16 @@
 #include "TerrainTileManager.h"
 #include "TerrainTile.h"
 #include "TerrainTileCopernicus.h"
+#include "TerrainOfflineDatabase.h"
 #include "QGeoTileFetcherQGC.h"
 #include "QGeoMapReplyQGC.h"
 #include "QGCMapUrlEngine.h"
 #include "ElevationMapProvider.h"
 #include "SettingsManager.h"
 #include "FlightMapSettings.h"
+#include "MapsSettings.h"
 #include "QGCLoggingCategory.h"
 
-#include <QtLocation/private/qgeotilespec_p.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QNetworkRequest>
@@ -43,60 +44,149 @@ TerrainTileManager::TerrainTileManager(QObject *parent)
     proxy.setType(QNetworkProxy::DefaultProxy);
     _networkManager->setProxy(proxy);
 #endif
+
+    Fact* const cacheSizeFact = SettingsManager::instance()->mapsSettings()->maxTerrainCacheMemorySize();
+    _tileCache.setBudgetBytes(cacheSizeFact->rawValue().toLongLong() * 1024 * 1024);
+    (void) connect(cacheSizeFact, &Fact::rawValueChanged, this, [this](const QVariant &value) {
+        _tileCache.setBudgetBytes(value.toLongLong() * 1024 * 1024);
+    });
 }
 
 TerrainTileManager::~TerrainTileManager()
 {
-    qDeleteAll(_tiles);
+    for (QGeoTiledMapReplyQGC *reply : _downloads.keys()) {
+        reply->disconnect(this);
+        reply->abort();
+    }
 
     // qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << this;
 }
 
 bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error)
+{
+    QHash<quint64, QGeoTileSpec> missingTiles;
+    if (_cachedAltitudes(coordinates, altitudes, error, missingTiles)) {
+        return true;
+    }
+
+    _fetchTiles(missingTiles);
+    return false;
+}
+
+bool TerrainTileManager::_cachedAltitudes(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error, QHash<quint64, QGeoTileSpec> &missingTiles, const TileMap &receivedTiles)
 {
     error = false;
 
     const QString elevationProviderName = SettingsManager::instance()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
     const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(elevationProviderName);
+    if (!provider) {
+        // Nothing to download from either, so the query is answered with an error instead of being queued
+        qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "unknown elevation provider" << elevationProviderName;
+        altitudes.clear();
+        error = true;
+        return true;
+    }
+    const int mapId = provider->getMapId();
+    const quint32 offlineProvider = TerrainOfflineDatabase::providerKey(elevationProviderName);
+
+    // Neighbouring coordinates mostly fall into the same tile, which saves the cache lookup
+    quint64 lastTileId = 0;
+    std::shared_ptr<const TerrainTile> lastTile;
+
     for (const QGeoCoordinate &coordinate: coordinates) {
-        const QString tileHash = UrlFactory::getTileHash(
-            provider->getMapName(),
-            provider->long2tileX(coordinate.longitude(), 1),
-            provider->lat2tileY(coordinate.latitude(), 1),
-            1
-        );
-        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "hash:coordinate" << tileHash << coordinate;
-
-        TerrainTile* const tile = _getCachedTile(tileHash);
-        if (tile) {
-            const double elevation = tile->elevation(coordinate);
-            if (qIsNaN(elevation)) {
-                error = true;
-                qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "Internal Error: missing elevation in tile cache";
-            } else {
-                qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "returning elevation from tile cache" << elevation;
+        const int x = provider->long2tileX(coordinate.longitude(), 1);
+        const int y = provider->lat2tileY(coordinate.latitude(), 1);
+        const quint64 tileId = TerrainTileCache::tileId(mapId, x, y, 1);
+        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "tile:coordinate" << Qt::hex << tileId << Qt::dec << coordinate;
+
+        if (!lastTile || (tileId != lastTileId)) {
+            if (missingTiles.contains(tileId)) {
+                continue;
+            }
+
+            lastTile = receivedTiles.value(tileId);
+            if (!lastTile) {
+                lastTile = _tileCache.tile(tileId);
             }
-            altitudes.push_back(elevation);
-        } else if (_state != TerrainQuery::State::Downloading) {
-            QGeoTileSpec spec;
-            spec.setX(provider->long2tileX(coordinate.longitude(), 1));
-            spec.setY(provider->lat2tileY(coordinate.latitude(), 1));
-            spec.setZoom(1);
-            spec.setMapId(provider->getMapId());
-            const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
-            QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
-            (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
-            _state = TerrainQuery::State::Downloading;
-            // TODO: Batch Downloading?
-            return false;
+            if (!lastTile) {
+                // Map ids are assigned at runtime, the database keys its tiles by provider name
+                lastTile = TerrainOfflineDatabase::instance()->tile(TerrainTileCache::tileId(0, x, y, 1), offlineProvider);
+                if (lastTile) {
+                    _tileCache.insert(tileId, lastTile);
+                }
+            }
+            lastTileId = tileId;
+
+            if (!lastTile) {
+                QGeoTileSpec spec;
+                spec.setX(x);
+                spec.setY(y);
+                spec.setZoom(1);
+                spec.setMapId(mapId);
+                (void) missingTiles.insert(tileId, spec);
+                continue;
+            }
+        }
+
+        if (!missingTiles.isEmpty()) {
+            // Altitudes are only returned if all of them are available
+            continue;
+        }
+
+        const double elevation = lastTile->elevation(coordinate);
+        if (qIsNaN(elevation)) {
+            error = true;
+            qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "Internal Error: missing elevation in tile cache";
         } else {
-            return false;
+            qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "returning elevation from tile cache" << elevation;
         }
+        altitudes.push_back(elevation);
+    }
+
+    if (!missingTiles.isEmpty()) {
+        altitudes.clear();
+        error = false;
+        return false;
     }
 
     return true;
 }
 
+void TerrainTileManager::_fetchTiles(const QHash<quint64, QGeoTileSpec> &tiles)
+{
+    for (auto it = tiles.constBegin(); it != tiles.constEnd(); ++it) {
+        if (_tilesToDownload.contains(it.key())) {
+            continue;
+        }
+
+        (void) _tilesToDownload.insert(it.key(), it.value());
+        _downloadQueue.enqueue(it.key());
+    }
+
+    _startDownloads();
+}
+
+void TerrainTileManager::_startDownloads()
+{
+    while ((_downloadsInFlight < kMaxConcurrentDownloads) && !_downloadQueue.isEmpty()) {
+        const quint64 tileId = _downloadQueue.dequeue();
+        const QGeoTileSpec spec = _tilesToDownload.value(tileId);
+
+        qCDebug(TerrainTileManagerLog) << "downloading tile" << spec.x() << spec.y() << "in flight" << _downloadsInFlight << "waiting" << _downloadQueue.count();
+
+        _downloadsInFlight++;
+        _downloadTile(tileId, spec);
+    }
+}
+
+void TerrainTileManager::_downloadTile(quint64 tileId, const QGeoTileSpec &spec)
+{
+    const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
+    QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
+    (void) _downloads.insert(reply, tileId);
+    (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
+}
+
 void TerrainTileManager::addCoordinateQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &coordinates)
 {
     qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "count" << coordinates.count();
@@ -105,69 +195,89 @@ void TerrainTileManager::addCoordinateQuery(TerrainQueryInterface *terrainQueryI
         return;
     }
 
+    const QueuedRequestInfo_t requestInfo = {
+        terrainQueryInterface,
+        TerrainQuery::QueryMode::QueryModeCoordinates,
+        0,
+        0,
+        coordinates,
+        {}
+    };
+
     bool error;
     QList<double> altitudes;
-    if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
-        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "queue count" << _requestQueue.count();
-        const QueuedRequestInfo_t queuedRequestInfo = {
-            terrainQueryInterface,
-            TerrainQuery::QueryMode::QueryModeCoordinates,
-            0,
-            0,
-            coordinates
-        };
-        _requestQueue.enqueue(queuedRequestInfo);
-        return;
-    }
-
-    if (error) {
-        QList<double> noAltitudes;
-        qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "signalling failure due to internal error";
-        terrainQueryInterface->signalCoordinateHeights(false, noAltitudes);
+    QHash<quint64, QGeoTileSpec> missingTiles;
+    if (!_cachedAltitudes(coordinates, altitudes, error, missingTiles)) {
+        _queueRequest(requestInfo, missingTiles);
         return;
     }
 
     qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "all altitudes taken from cached data";
-    terrainQueryInterface->signalCoordinateHeights((coordinates.count() == altitudes.count()), altitudes);
+    _signalResult(requestInfo, error, altitudes);
 }
 
 void TerrainTileManager::addPathQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint)
 {
-    double distanceBetween;
-    double finalDistanceBetween;
-    const QList<QGeoCoordinate> coordinates = _pathQueryToCoords(startPoint, endPoint, distanceBetween, finalDistanceBetween);
+    QueuedRequestInfo_t requestInfo = {
+        terrainQueryInterface,
+        TerrainQuery::QueryMode::QueryModePath,
+        0,
+        0,
+        {},
+        {}
+    };
+    requestInfo.coordinates = _pathQueryToCoords(startPoint, endPoint, requestInfo.distanceBetween, requestInfo.finalDistanceBetween);
 
     bool error;
     QList<double> altitudes;
-    if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
-        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "queue count" << _requestQueue.count();
-        const QueuedRequestInfo_t queuedRequestInfo = {
-            terrainQueryInterface,
-            TerrainQuery::QueryMode::QueryModePath,
-            distanceBetween,
-            finalDistanceBetween,
-            coordinates
-        };
-        _requestQueue.enqueue(queuedRequestInfo);
+    QHash<quint64, QGeoTileSpec> missingTiles;
+    if (!_cachedAltitudes(requestInfo.coordinates, altitudes, error, missingTiles)) {
+        _queueRequest(requestInfo, missingTiles);
         return;
     }
 
+    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "all altitudes taken from cached data";
+    _signalResult(requestInfo, error, altitudes);
+}
+
+void TerrainTileManager::_queueRequest(const QueuedRequestInfo_t &requestInfo, const QHash<quint64, QGeoTileSpec> &missingTiles)
+{
+    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "queue count" << _requestQueue.count() << "missing tiles" << missingTiles.count();
+
+    QueuedRequestInfo_t queuedRequestInfo = requestInfo;
+    for (auto it = missingTiles.constBegin(); it != missingTiles.constEnd(); ++it) {
+        (void) queuedRequestInfo.missingTiles.insert(it.key());
+    }
+    _requestQueue.append(queuedRequestInfo);
+
+    _fetchTiles(missingTiles);
+}
+
+void TerrainTileManager::_signalResult(const QueuedRequestInfo_t &requestInfo, bool error, const QList<double> &altitudes)
+{
     if (error) {
-        QList<double> noAltitudes;
-        qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "signalling failure due to internal error";
-        terrainQueryInterface->signalPathHeights(false, distanceBetween, finalDistanceBetween, noAltitudes);
-        return;
+        qCWarning(TerrainTileManagerLog) << "signalling failure due to internal error";
     }
 
-    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "all altitudes taken from cached data";
-    terrainQueryInterface->signalPathHeights((coordinates.count() == altitudes.count()), distanceBetween, finalDistanceBetween, altitudes);
+    const QList<double> noAltitudes;
+    const bool success = !error && (requestInfo.coordinates.count() == altitudes.count());
+    switch (requestInfo.queryMode) {
+    case TerrainQuery::QueryMode::QueryModeCoordinates:
+        requestInfo.terrainQueryInterface->signalCoordinateHeights(success, error ? noAltitudes : altitudes);
+        break;
+    case TerrainQuery::QueryMode::QueryModePath:
+        requestInfo.terrainQueryInterface->signalPathHeights(success, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, error ? noAltitudes : altitudes);
+        break;
+    default:
+        break;
+    }
 }
 
-QList<QGeoCoordinate> TerrainTileManager::_pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween)
+QList<QGeoCoordinate> TerrainTileManager::_pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween, double spacingMeters)
 {
     const double lat = fromCoord.latitude();
     const double lon = fromCoord.longitude();
-    const int steps = qCeil(toCoord.distanceTo(fromCoord) / TerrainTileCopernicus::kTileValueSpacingMeters); // TODO: get spacing from terrainQueryInterface
+    const int steps = qCeil(toCoord.distanceTo(fromCoord) / spacingMeters);
     const double latDiff = toCoord.latitude() - lat;
     const double lonDiff = toCoord.longitude() - lon;
 
@@ -194,11 +304,20 @@ QList<QGeoCoordinate> TerrainTileManager::_pathQueryToCoords(const QGeoCoordinat
     return coordinates;
 }
 
-void TerrainTileManager::_tileFailed()
+void TerrainTileManager::_tileFailed(quint64 tileId)
 {
-    QList<double> noAltitudes;
+    QList<QueuedRequestInfo_t> failedRequests;
+    for (qsizetype i = 0; i < _requestQueue.count();) {
+        if (_requestQueue[i].missingTiles.contains(tileId)) {
+            failedRequests.append(_requestQueue.takeAt(i));
+        } else {
+            i++;
+        }
+    }
 
-    for (const QueuedRequestInfo_t &requestInfo: _requestQueue) {
+    // Signalled after the queue is updated, receivers may queue new requests
+    QList<double> noAltitudes;
+    for (const QueuedRequestInfo_t &requestInfo: failedRequests) {
         switch (requestInfo.queryMode) {
         case TerrainQuery::QueryMode::QueryModeCoordinates:
             requestInfo.terrainQueryInterface->signalCoordinateHeights(false, noAltitudes);
@@ -210,14 +329,41 @@ void TerrainTileManager::_tileFailed()
             continue;
         }
     }
+}
+
+void TerrainTileManager::_tileReceived(quint64 tileId, const std::shared_ptr<const TerrainTile> &tile)
+{
+    QList<QueuedRequestInfo_t> readyRequests;
+    for (qsizetype i = 0; i < _requestQueue.count();) {
+        QueuedRequestInfo_t &requestInfo = _requestQueue[i];
+        if (requestInfo.missingTiles.remove(tileId)) {
+            // Held by the request, so the cache may evict it before the request's other tiles arrive
+            (void) requestInfo.receivedTiles.insert(tileId, tile);
+            if (requestInfo.missingTiles.isEmpty()) {
+                readyRequests.append(_requestQueue.takeAt(i));
+                continue;
+            }
+        }
+        i++;
+    }
 
-    _requestQueue.clear();
+    for (const QueuedRequestInfo_t &requestInfo: readyRequests) {
+        bool error;
+        QList<double> altitudes;
+        QHash<quint64, QGeoTileSpec> missingTiles;
+        if (!_cachedAltitudes(requestInfo.coordinates, altitudes, error, missingTiles, requestInfo.receivedTiles)) {
+            // A tile which was cached when the request was queued has been evicted in the meantime
+            _queueRequest(requestInfo, missingTiles);
+            continue;
+        }
+
+        qCDebug(TerrainTileManagerLog) << "All altitudes taken from cached data";
+        _signalResult(requestInfo, error, altitudes);
+    }
 }
 
 void TerrainTileManager::_terrainDone()
 {
-    _state = TerrainQuery::State::Idle;
-
     QGeoTiledMapReplyQGC* const reply = qobject_cast<QGeoTiledMapReplyQGC*>(QObject::sender());
     if (!reply) {
         qCWarning(TerrainTileManagerLog) << "Elevation tile fetched but invalid reply data type.";
@@ -225,97 +371,58 @@ void TerrainTileManager::_terrainDone()
     }
     reply->deleteLater();
 
-    const QByteArray responseBytes = reply->mapImageData();
-    const QGeoTileSpec spec = reply->tileSpec();
+    const quint64 tileId = _downloads.take(reply);
 
+    QByteArray responseBytes;
     if (reply->error() != QGeoTiledMapReplyQGC::NoError) {
         qCWarning(TerrainTileManagerLog) << "Elevation tile fetching returned error:" << reply->errorString();
-        _tileFailed();
-        return;
-    }
-
-    if (responseBytes.isEmpty()) {
-        qCWarning(TerrainTileManagerLog) << "Error in fetching elevation tile. Empty response.";
-        _tileFailed();
-        return;
-    }
-
-    qCDebug(TerrainTileManagerLog) << "Received some bytes of terrain data:" << responseBytes.size();
-
-    const QString hash = UrlFactory::getTileHash(UrlFactory::getProviderTypeFromQtMapId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
-    _cacheTile(responseBytes, hash);
-
-    for (qsizetype i = _requestQueue.count() - 1; i >= 0; i--) {
-        bool error;
-        QList<double> altitudes;
-        QueuedRequestInfo_t &requestInfo = _requestQueue[i];
-
-        if (!getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
-            continue;
-        }
-
-        switch (requestInfo.queryMode) {
-        case TerrainQuery::QueryMode::QueryModeCoordinates:
-            if (error) {
-                qCWarning(TerrainTileManagerLog) << "signalling failure due to internal error";
-                QList<double> noAltitudes;
-                requestInfo.terrainQueryInterface->signalCoordinateHeights(false, noAltitudes);
-            } else {
-                qCDebug(TerrainTileManagerLog) << "All altitudes taken from cached data";
-                requestInfo.terrainQueryInterface->signalCoordinateHeights(requestInfo.coordinates.count() == altitudes.count(), altitudes);
-            }
-            break;
-        case TerrainQuery::QueryMode::QueryModePath:
-            if (error) {
-                qCWarning(TerrainTileManagerLog) << "signalling failure due to internal error";
-                QList<double> noAltitudes;
-                requestInfo.terrainQueryInterface->signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
-            } else {
-                qCDebug(TerrainTileManagerLog) << "All altitudes taken from cached data";
-                requestInfo.terrainQueryInterface->signalPathHeights(requestInfo.coordinates.count() == altitudes.count(), requestInfo.distanceBetween, requestInfo.finalDistanceBetween, altitudes);
-            }
-            break;
-        default:
-            break;
+    } else {
+        responseBytes = reply->mapImageData();
+        if (responseBytes.isEmpty()) {
+            qCWarning(TerrainTileManagerLog) << "Error in fetching elevation tile. Empty response.";
         }
-
-        _requestQueue.removeAt(i);
     }
+
+    _downloadFinished(tileId, responseBytes);
 }
 
-void TerrainTileManager::_cacheTile(const QByteArray &data, const QString &hash)
+void TerrainTileManager::_downloadFinished(quint64 tileId, const QByteArray &responseBytes)
 {
-    TerrainTile* const terrainTile = new TerrainTile(data);
-    if (terrainTile->isValid()) {
-        _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            (void) _tiles.insert(hash, terrainTile);
-        } else {
-            delete terrainTile;
-        }
-        _tilesMutex.unlock();
-    } else {
-        delete terrainTile;
-        qCWarning(TerrainTileManagerLog) << "Received invalid tile";
+    _downloadsInFlight--;
+    (void) _tilesToDownload.remove(tileId);
+
+    // Keep the pipe full before the queued requests are processed
+    _startDownloads();
+
+    if ((_downloadsInFlight == 0) && TerrainTileManagerLog().isDebugEnabled()) {
+        _logTileCacheStatistics();
     }
-}
 
-TerrainTile *TerrainTileManager::_getCachedTile(const QString &hash)
-{
-    _tilesMutex.lock();
-    if (!_tiles.contains(hash)) {
-        _tilesMutex.unlock();
-        return nullptr;
+    if (responseBytes.isEmpty()) {
+        _tileFailed(tileId);
+        return;
     }
 
-    TerrainTile* const tile = _tiles[hash];
+    qCDebug(TerrainTileManagerLog) << "Received some bytes of terrain data:" << responseBytes.size();
 
+    const std::shared_ptr<const TerrainTile> tile = std::make_shared<const TerrainTile>(responseBytes);
     if (!tile->isValid()) {
-        _tilesMutex.unlock();
-        return nullptr;
+        qCWarning(TerrainTileManagerLog) << "Received invalid tile";
+        _tileFailed(tileId);
+        return;
     }
 
-    _tilesMutex.unlock();
+    _tileCache.insert(tileId, tile);
+    _tileReceived(tileId, tile);
+}
+
+void TerrainTileManager::_logTileCacheStatistics() const
+{
+    const TerrainTileCache::Statistics statistics = tileCacheStatistics();
+    const quint64 lookups = statistics.hits + statistics.misses;
+    const double hitRate = (lookups > 0) ? ((100. * statistics.hits) / lookups) : 0.;
 
-    return tile;
+    qCDebug(TerrainTileManagerLog) << "tile cache:" << statistics.tileCount << "tiles" << statistics.bytes << "of" << statistics.budgetBytes << "bytes,"
+                                   << "hits" << statistics.hits << "misses" << statistics.misses << "hit rate" << qRound(hitRate) << "%,"
+                                   << "insertions" << statistics.insertions << "evictions" << statistics.evictions;
 }
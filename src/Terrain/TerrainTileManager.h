@@ -10,47 +10,58 @@
 #pragma once
 
 #include "TerrainQueryInterface.h"
+#include "TerrainTileCache.h"
+#include "TerrainTileCopernicus.h"
 
 #include <QtCore/QLoggingCategory>
-#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
+#include <QtCore/QSet>
+#include <QtLocation/private/qgeotilespec_p.h>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <memory>
+
 class TerrainTile;
+class QGeoTiledMapReplyQGC;
 class QNetworkAccessManager;
 class UnitTestTerrainQuery;
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainTileManagerLog)
 
+/// Serves terrain heights from downloaded elevation tiles. All tiles a query is missing are fetched together, with
+/// at most kMaxConcurrentDownloads in flight. Queued queries are answered as soon as the last tile they need arrives.
 class TerrainTileManager : public QObject
 {
     Q_OBJECT
 
     friend class UnitTestTerrainQuery;
+    friend class TerrainQueryTest;
+    friend class TerrainLocalDem;
 public:
     explicit TerrainTileManager(QObject *parent = nullptr);
     ~TerrainTileManager();
 
     static TerrainTileManager *instance();
 
-    /// Either returns altitudes from cache or queues database request
+    /// Either returns altitudes from cache or starts downloading all tiles which are missing
     ///     @param[out] error true: altitude not returned due to error, false: altitudes returned
-    ///     @return true: altitude returned (check error as well), false: database query queued (altitudes not returned)
+    ///     @return true: altitude returned (check error as well), false: tiles are being downloaded (altitudes not returned)
     bool getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error);
 
     void addCoordinateQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &coordinates);
     void addPathQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint);
 
+    TerrainTileCache::Statistics tileCacheStatistics() const { return _tileCache.statistics(); }
+
+    /// Same limit QNetworkAccessManager applies per host
+    static constexpr int kMaxConcurrentDownloads = 6;
+
 private slots:
     void _terrainDone();
 
 private:
-    /// Returns a list of individual coordinates along the requested path spaced according to the terrain tile value spacing
-    static QList<QGeoCoordinate> _pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween);
-    void _tileFailed();
-    void _cacheTile(const QByteArray &data, const QString &hash);
-    TerrainTile *_getCachedTile(const QString &hash);
+    using TileMap = QHash<quint64, std::shared_ptr<const TerrainTile>>;
 
     struct QueuedRequestInfo_t {
         TerrainQueryInterface *terrainQueryInterface;
@@ -58,13 +69,40 @@ private slots:
         double distanceBetween;                         ///< Distance between each returned height
         double finalDistanceBetween;                    ///< Distance between for final height
         QList<QGeoCoordinate> coordinates;
+        QSet<quint64> missingTiles;                     ///< Ids of the tiles still being downloaded
+        TileMap receivedTiles;                          ///< Downloaded tiles, held until the request is answered
     };
 
-    QQueue<QueuedRequestInfo_t> _requestQueue;
-    TerrainQuery::State _state = TerrainQuery::State::Idle;
-
-    QMutex _tilesMutex;
-    QHash<QString, TerrainTile*> _tiles;
+    /// Returns a list of individual coordinates along the requested path spaced according to the terrain tile value spacing
+    ///     @param spacingMeters Spacing of the terrain values, default is the one of the downloaded tiles
+    static QList<QGeoCoordinate> _pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween, double spacingMeters = TerrainTileCopernicus::kTileValueSpacingMeters);
+
+    /// Looks the coordinates up in the cached tiles only
+    ///     @param[out] missingTiles Tiles which are not cached, by id
+    ///     @param receivedTiles Tiles to use before looking in the cache
+    ///     @return true: all tiles were available
+    bool _cachedAltitudes(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error, QHash<quint64, QGeoTileSpec> &missingTiles, const TileMap &receivedTiles = TileMap());
+    void _queueRequest(const QueuedRequestInfo_t &requestInfo, const QHash<quint64, QGeoTileSpec> &missingTiles);
+    void _fetchTiles(const QHash<quint64, QGeoTileSpec> &tiles);
+    void _startDownloads();
+    /// Starts the download of a tile, which has to end in _downloadFinished
+    virtual void _downloadTile(quint64 tileId, const QGeoTileSpec &spec);
+    /// @param responseBytes Serialized tile, empty: download failed
+    void _downloadFinished(quint64 tileId, const QByteArray &responseBytes);
+    void _tileFailed(quint64 tileId);
+    void _tileReceived(quint64 tileId, const std::shared_ptr<const TerrainTile> &tile);
+    void _signalResult(const QueuedRequestInfo_t &requestInfo, bool error, const QList<double> &altitudes);
+    /// Logged when a batch of downloads is done
+    void _logTileCacheStatistics() const;
+
+    QList<QueuedRequestInfo_t> _requestQueue;
+
+    QQueue<quint64> _downloadQueue;                     ///< Tiles waiting for a free download slot
+    QHash<quint64, QGeoTileSpec> _tilesToDownload;      ///< Tiles in _downloadQueue or in flight
+    QHash<QGeoTiledMapReplyQGC*, quint64> _downloads;   ///< In flight replies and the id of their tile
+    int _downloadsInFlight = 0;
+
+    TerrainTileCache _tileCache;
 
     QNetworkAccessManager *_networkManager = nullptr;
 };
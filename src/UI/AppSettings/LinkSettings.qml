@@ -253,6 +253,19 @@ SettingsPage {
                     onCheckedChanged:   editingConfig.highLatency = checked
                 }
 
+                RowLayout {
+                    Layout.fillWidth:   true
+                    spacing:            ScreenTools.defaultFontPixelWidth
+
+                    QGCLabel { text: qsTr("Outbound Limit (bytes/s, 0 = none)") }
+                    QGCTextField {
+                        Layout.fillWidth:   true
+                        text:               editingConfig.outboundByteRate
+                        numericValuesOnly:  true
+                        onEditingFinished:  editingConfig.outboundByteRate = parseInt(text) || 0
+                    }
+                }
+
                 LabelledComboBox {
                     label:                  qsTr("Type")
                     enabled:                originalConfig == null
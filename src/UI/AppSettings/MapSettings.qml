@@ -160,6 +160,47 @@ Item {
             }
         }
 
+        SettingsGroupLayout {
+            Layout.fillWidth:   true
+            heading:            qsTr("Imported Elevation Data")
+            headingDescription: qsTr("Used for terrain wherever it covers the area, in place of the elevation provider")
+
+            LabelledButton {
+                label:      qsTr("Import SRTM (.hgt) or GeoTIFF File")
+                buttonText: qsTr("Import")
+                enabled:    !_currentlyImportOrExporting
+                onClicked:  elevationFileDialog.openForLoad()
+            }
+
+            RowLayout {
+                spacing: ScreenTools.defaultFontPixelWidth
+                visible: _mapEngineManager.elevationDataImporting
+
+                QGCLabel {
+                    Layout.fillWidth:   true
+                    text:               qsTr("Importing")
+                    font.bold:          true
+                }
+                ProgressBar {
+                    width:          ScreenTools.defaultFontPixelWidth * 25
+                    from:           0
+                    to:             100
+                    value:          _mapEngineManager.actionProgress
+                }
+                QGCButton {
+                    text:       qsTr("Cancel")
+                    onClicked:  _mapEngineManager.cancelElevationDataImport()
+                }
+            }
+
+            LabelledButton {
+                label:      qsTr("Remove Imported Elevation Data")
+                buttonText: qsTr("Clear")
+                enabled:    _mapEngineManager.elevationDataImported
+                onClicked:  _mapEngineManager.clearElevationData()
+            }
+        }
+
         SettingsGroupLayout {
             Layout.fillWidth:   true
             heading:            qsTr("Tokens")
@@ -223,6 +264,10 @@ Item {
 
             LabelledFactTextField {
                 fact: _mapsSettings.maxCacheMemorySize
+            }
+
+            LabelledFactTextField {
+                fact: _mapsSettings.maxTerrainCacheMemorySize
             }    
         }
 
@@ -243,6 +288,17 @@ Item {
             }
         }
 
+        QGCFileDialog {
+            id:             elevationFileDialog
+            title:          qsTr("Import Elevation Data")
+            nameFilters:    [ qsTr("Elevation Data (*.hgt *.tif *.tiff)") ]
+
+            onAcceptedForLoad: (file) => {
+                close()
+                _mapEngineManager.importElevationData(file)
+            }
+        }
+
         Component {
             id: exportDialogComponent
 
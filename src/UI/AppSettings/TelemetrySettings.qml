@@ -47,6 +47,20 @@ SettingsPage {
             text:               qsTr("Emit heartbeat")
             fact:               _mavlinkSettings.sendGCSHeartbeat
         }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Decode MAVLink on link threads")
+            fact:               _mavlinkSettings.decodeOnLinkThreads
+            visible:            fact.visible
+        }
+
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("Max high rate telemetry rate")
+            fact:               _mavlinkSettings.telemetryDecimationRate
+            visible:            fact.visible
+        }
     }
 
     SettingsGroupLayout {
@@ -135,6 +149,14 @@ SettingsPage {
             property Fact _telemetrySaveNotArmed: _mavlinkSettings.telemetrySaveNotArmed
         }
 
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("Sync log to storage every")
+            fact:               _mavlinkSettings.telemetryLogSyncInterval
+            visible:            fact.visible
+            enabled:            _mavlinkSettings.telemetrySave.rawValue
+        }
+
         FactCheckBoxSlider {
             Layout.fillWidth:   true
             text:               qsTr("Save CSV log of telemetry data")
@@ -99,6 +99,23 @@ int convertGeoToUTM(const QGeoCoordinate& coord, double &easting, double &northi
     }
 }
 
+bool convertGeoToUTM(const QGeoCoordinate& coord, int zone, bool southhemi, double &easting, double &northing)
+{
+    try {
+        int usedZone;
+        bool northp;
+        GeographicLib::UTMUPS::Forward(coord.latitude(), coord.longitude(), usedZone, northp, easting, northing, zone);
+        if (northp == southhemi) {
+            // Moves the northing over to the false northing of the requested hemisphere
+            northing += southhemi ? GeographicLib::UTMUPS::UTMShift() : -GeographicLib::UTMUPS::UTMShift();
+        }
+        return true;
+    } catch(const GeographicLib::GeographicErr& e) {
+        qCDebug(QGCGeoLog) << Q_FUNC_INFO << e.what();
+        return false;
+    }
+}
+
 bool convertUTMToGeo(double easting, double northing, int zone, bool southhemi, QGeoCoordinate &coord)
 {
     double lat, lon;
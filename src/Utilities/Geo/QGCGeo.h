@@ -65,6 +65,13 @@ void convertNedToGeo(double x, double y, double z, const QGeoCoordinate &origin,
 //   If conversion failed the function returns 0
 int convertGeoToUTM(const QGeoCoordinate& coord, double &easting, double &northing);
 
+// Same as above, but always uses the given zone and hemisphere. Needed to work in the
+// grid of existing UTM data, coordinates are allowed to lie outside of the zone.
+//
+// Returns:
+// The function returns true if conversion succeeded.
+bool convertGeoToUTM(const QGeoCoordinate& coord, int zone, bool southhemi, double &easting, double &northing);
+
 // UTMXYToLatLon
 //
 // Converts x and y coordinates in the Universal Transverse Mercator//   The UTM zone parameter should be in the range [1,60].
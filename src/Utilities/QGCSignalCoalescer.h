@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// Coalescing connections: the slot runs once per event loop pass in the receiver's thread with the arguments of the
+/// latest emission. Emitting again while a call is pending only replaces the pending arguments, which is O(1) and adds
+/// nothing to the event queue. The signal can be emitted from any thread.
+///
+/// Use it for state updates where only the latest value matters (recalculations, progress, images for display). Never
+/// use it for data streams, every emission but the last one before the slot runs is dropped.
+namespace QGCSignalCoalescer
+{
+
+namespace Private
+{
+
+/// Pending arguments of one coalescing connection, shared by the emitting side and the queued call
+template<typename... Args>
+class PendingCall
+{
+public:
+    /// Stores the arguments of an emission
+    ///     @return true: no call is pending yet, the caller has to post one
+    bool store(Args... args)
+    {
+        if constexpr (sizeof...(Args) == 0) {
+            return !_scheduled.exchange(true, std::memory_order_acq_rel);
+        } else {
+            QMutexLocker locker(&_mutex);
+            _args.emplace(std::move(args)...);
+            return !_scheduled.exchange(true, std::memory_order_acq_rel);
+        }
+    }
+
+    /// Takes the latest arguments. Returns nothing if an earlier pass already took them.
+    std::optional<std::tuple<Args...>> take()
+    {
+        if constexpr (sizeof...(Args) == 0) {
+            if (!_scheduled.exchange(false, std::memory_order_acq_rel)) {
+                return std::nullopt;
+            }
+            return std::tuple<>();
+        } else {
+            QMutexLocker locker(&_mutex);
+            (void) _scheduled.exchange(false, std::memory_order_acq_rel);
+            return std::exchange(_args, std::nullopt);
+        }
+    }
+
+private:
+    std::atomic<bool> _scheduled = false;
+    QMutex _mutex;
+    std::optional<std::tuple<Args...>> _args;
+};
+
+/// Calls the slot with all signal arguments if it takes them, otherwise without any
+template<typename Receiver, typename Slot, typename... Args>
+void invoke(Receiver *receiver, Slot &slot, std::tuple<Args...> &args)
+{
+    if constexpr (std::is_member_function_pointer_v<Slot>) {
+        if constexpr (std::is_invocable_v<Slot&, Receiver*, Args...>) {
+            std::apply([receiver, &slot](Args&... values) { std::invoke(slot, receiver, std::move(values)...); }, args);
+        } else {
+            std::invoke(slot, receiver);
+        }
+    } else {
+        if constexpr (std::is_invocable_v<Slot&, Args...>) {
+            std::apply([&slot](Args&... values) { std::invoke(slot, std::move(values)...); }, args);
+        } else {
+            std::invoke(slot);
+        }
+    }
+}
+
+template<typename List>
+struct Connector;
+
+template<typename... SignalArgs>
+struct Connector<QtPrivate::List<SignalArgs...>>
+{
+    using Pending = PendingCall<std::decay_t<SignalArgs>...>;
+
+    /// Functor connected to the signal, runs in the emitting thread
+    template<typename Receiver, typename Slot>
+    static auto emitter(Receiver *receiver, Slot slot)
+    {
+        const auto pending = std::make_shared<Pending>();
+        return [pending, receiver, slot](SignalArgs... args) {
+            if (!pending->store(args...)) {
+                return;
+            }
+
+            (void) QMetaObject::invokeMethod(receiver, [pending, receiver, slot]() mutable {
+                auto pendingArgs = pending->take();
+                if (pendingArgs) {
+                    invoke(receiver, slot, *pendingArgs);
+                }
+            }, Qt::QueuedConnection);
+        };
+    }
+};
+
+} // namespace Private
+
+/// Connects signal to slot through a coalescing queue. The slot is never called synchronously, not even if sender
+/// and receiver live in the same thread. The connection goes away with either object and can be removed with
+/// QObject::disconnect. A call which is already pending still runs once.
+///     @param slot Member function of receiver, or a functor for which receiver is the context object
+template<typename Sender, typename Signal, typename Receiver, typename Slot>
+QMetaObject::Connection connect(const Sender *sender, Signal signal, Receiver *receiver, Slot slot)
+{
+    using SignalArguments = typename QtPrivate::FunctionPointer<Signal>::Arguments;
+
+    // The receiver is only the context of the emitting functor, the slot itself runs queued in its thread
+    return QObject::connect(sender, signal, receiver, Private::Connector<SignalArguments>::emitter(receiver, std::move(slot)), Qt::DirectConnection);
+}
+
+} // namespace QGCSignalCoalescer
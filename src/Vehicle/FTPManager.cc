@@ -24,7 +24,7 @@ FTPManager::FTPManager(Vehicle* vehicle)
 {
     _ackOrNakTimeoutTimer.setSingleShot(true);
     // Mock link responds immediately if at all, speed up unit tests with faster timoue
-    _ackOrNakTimeoutTimer.setInterval(qgcApp()->runningUnitTests() ? 10 : _ackOrNakTimeoutMsecs);
+    _ackOrNakTimeoutTimer.setInterval(_ackOrNakTimeoutBaseMSecs());
     connect(&_ackOrNakTimeoutTimer, &QTimer::timeout, this, &FTPManager::_ackOrNakTimeout);
     
     // Make sure we don't have bad structure packing
@@ -728,9 +728,12 @@ void FTPManager::_resetSessionsTimeout(void)
 
 void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
 {
-    _ackOrNakTimeoutTimer.start();
-    
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+
+    // Allow for the time the request waits in the outbound queue of a link which is paced to a byte budget
+    const int queueDelayMSecs = sharedLink ? sharedLink->outboundDelayMSecs(LinkOutboundQueue::PriorityBulk) : 0;
+    _ackOrNakTimeoutTimer.start(_ackOrNakTimeoutBaseMSecs() + queueDelayMSecs);
+
     if (sharedLink) {
         request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
         _expectedIncomingSeqNumber += 2;
@@ -752,6 +755,11 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
     }
 }
 
+int FTPManager::_ackOrNakTimeoutBaseMSecs(void)
+{
+    return (qgcApp()->runningUnitTests() ? 10 : _ackOrNakTimeoutMsecs);
+}
+
 bool FTPManager::_parseURI(uint8_t fromCompId, const QString& uri, QString& parsedURI, uint8_t& compId)
 {
     parsedURI   = uri;
@@ -151,6 +151,7 @@ private slots:
     void    _resetSessionsTimeout       (void);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
     void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
+    static int _ackOrNakTimeoutBaseMSecs(void);
     void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
     void    _downloadComplete           (const QString& errorMsg);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
@@ -42,6 +42,15 @@ VehicleBatteryFactGroup::VehicleBatteryFactGroup(uint8_t batteryId, QObject *par
     (void) connect(&_timeRemainingFact, &Fact::rawValueChanged, this, &VehicleBatteryFactGroup::_timeRemainingChanged);
 }
 
+QList<uint32_t> VehicleBatteryFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2,
+        MAVLINK_MSG_ID_BATTERY_STATUS
+    };
+}
+
 void VehicleBatteryFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     switch (message.msgid) {
@@ -65,7 +74,7 @@ void VehicleBatteryFactGroup::_handleHighLatency(Vehicle *vehicle, const mavlink
     mavlink_msg_high_latency_decode(&message, &highLatency);
 
     VehicleBatteryFactGroup *const group = _findOrAddBatteryGroupById(vehicle, 0);
-    group->percentRemaining()->setRawValue((highLatency.battery_remaining == UINT8_MAX) ? qQNaN() : highLatency.battery_remaining);
+    group->percentRemaining()->setTelemetryValue((highLatency.battery_remaining == UINT8_MAX) ? qQNaN() : highLatency.battery_remaining);
 
     group->_setTelemetryAvailable(true);
 }
@@ -76,7 +85,7 @@ void VehicleBatteryFactGroup::_handleHighLatency2(Vehicle *vehicle, const mavlin
     mavlink_msg_high_latency2_decode(&message, &highLatency2);
 
     VehicleBatteryFactGroup *const group = _findOrAddBatteryGroupById(vehicle, 0);
-    group->percentRemaining()->setRawValue((highLatency2.battery == -1) ? qQNaN() : highLatency2.battery);
+    group->percentRemaining()->setTelemetryValue((highLatency2.battery == -1) ? qQNaN() : highLatency2.battery);
 
     group->_setTelemetryAvailable(true);
 }
@@ -109,16 +118,16 @@ void VehicleBatteryFactGroup::_handleBatteryStatus(Vehicle *vehicle, const mavli
         totalVoltage += cellVoltage;
     }
 
-    group->function()->setRawValue(batteryStatus.battery_function);
-    group->type()->setRawValue(batteryStatus.type);
-    group->temperature()->setRawValue((batteryStatus.temperature == INT16_MAX) ? qQNaN() : (static_cast<double>(batteryStatus.temperature) / 100.0));
-    group->voltage()->setRawValue(totalVoltage);
-    group->current()->setRawValue((batteryStatus.current_battery == -1) ? qQNaN() : (static_cast<double>(batteryStatus.current_battery) / 100.0));
-    group->mahConsumed()->setRawValue((batteryStatus.current_consumed == -1) ? qQNaN() : batteryStatus.current_consumed);
-    group->percentRemaining()->setRawValue((batteryStatus.battery_remaining == -1) ? qQNaN() : batteryStatus.battery_remaining);
-    group->timeRemaining()->setRawValue((batteryStatus.time_remaining == 0) ? qQNaN() : batteryStatus.time_remaining);
-    group->chargeState()->setRawValue(batteryStatus.charge_state);
-    group->instantPower()->setRawValue(totalVoltage * group->current()->rawValue().toDouble());
+    group->function()->setTelemetryValue(batteryStatus.battery_function);
+    group->type()->setTelemetryValue(batteryStatus.type);
+    group->temperature()->setTelemetryValue((batteryStatus.temperature == INT16_MAX) ? qQNaN() : (static_cast<double>(batteryStatus.temperature) / 100.0));
+    group->voltage()->setTelemetryValue(totalVoltage);
+    group->current()->setTelemetryValue((batteryStatus.current_battery == -1) ? qQNaN() : (static_cast<double>(batteryStatus.current_battery) / 100.0));
+    group->mahConsumed()->setTelemetryValue((batteryStatus.current_consumed == -1) ? qQNaN() : batteryStatus.current_consumed);
+    group->percentRemaining()->setTelemetryValue((batteryStatus.battery_remaining == -1) ? qQNaN() : batteryStatus.battery_remaining);
+    group->timeRemaining()->setTelemetryValue((batteryStatus.time_remaining == 0) ? qQNaN() : batteryStatus.time_remaining);
+    group->chargeState()->setTelemetryValue(batteryStatus.charge_state);
+    group->instantPower()->setTelemetryValue(totalVoltage * group->current()->rawValue().toDouble());
 
     group->_setTelemetryAvailable(true);
 }
@@ -48,6 +48,7 @@ class VehicleBatteryFactGroup : public FactGroup
 
     // Overrides from FactGroup
     void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) final;
+    QList<uint32_t> handledMessageIds() const final;
 
 private slots:
     void _timeRemainingChanged(const QVariant &value);
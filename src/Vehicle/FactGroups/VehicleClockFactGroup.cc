@@ -20,15 +20,17 @@ VehicleClockFactGroup::VehicleClockFactGroup(QObject *parent)
     _currentTimeFact.setRawValue(QTime().toString());
     _currentUTCTimeFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _currentDateFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
+
+    _clockTimer.setInterval(_updateRateMSecs);
+    (void) connect(&_clockTimer, &QTimer::timeout, this, &VehicleClockFactGroup::_updateClock);
+    _clockTimer.start();
 }
 
-void VehicleClockFactGroup::_updateAllValues()
+void VehicleClockFactGroup::_updateClock()
 {
     currentTime()->setRawValue(QTime::currentTime().toString());
     currentUTCTime()->setRawValue(QDateTime::currentDateTimeUtc().time().toString());
     currentDate()->setRawValue(QDateTime::currentDateTime().toString(qgcApp()->getCurrentLanguage().dateFormat(QLocale::ShortFormat)));
 
     _setTelemetryAvailable(true);
-
-    FactGroup::_updateAllValues();
 }
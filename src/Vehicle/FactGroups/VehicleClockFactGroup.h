@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <QtCore/QTimer>
+
 #include "FactGroup.h"
 
 class VehicleClockFactGroup : public FactGroup
@@ -26,10 +28,12 @@ class VehicleClockFactGroup : public FactGroup
     Fact *currentDate() { return &_currentDateFact; }
 
 private slots:
-    void _updateAllValues() final;
+    void _updateClock();
 
 private:
     Fact _currentTimeFact = Fact(0, QStringLiteral("currentTime"), FactMetaData::valueTypeString);
     Fact _currentUTCTimeFact = Fact(0, QStringLiteral("currentUTCTime"), FactMetaData::valueTypeString);
     Fact _currentDateFact = Fact(0, QStringLiteral("currentDate"), FactMetaData::valueTypeString);
+
+    QTimer _clockTimer;
 };
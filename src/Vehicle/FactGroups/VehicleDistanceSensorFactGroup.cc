@@ -27,6 +27,11 @@ VehicleDistanceSensorFactGroup::VehicleDistanceSensorFactGroup(QObject *parent)
     _addFact(&_maxDistanceFact);
 }
 
+QList<uint32_t> VehicleDistanceSensorFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_DISTANCE_SENSOR };
+}
+
 void VehicleDistanceSensorFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -58,12 +63,12 @@ void VehicleDistanceSensorFactGroup::handleMessage(Vehicle *vehicle, const mavli
 
     for (const orientation2Fact_s &orientation2Fact : rgOrientation2Fact) {
         if (orientation2Fact.orientation == distanceSensor.orientation) {
-            orientation2Fact.fact->setRawValue(distanceSensor.current_distance / 100.0); // cm to meters
+            orientation2Fact.fact->setTelemetryValue(distanceSensor.current_distance / 100.0); // cm to meters
             break;
         }
     }
 
-    maxDistance()->setRawValue(distanceSensor.max_distance / 100.0);
+    maxDistance()->setTelemetryValue(distanceSensor.max_distance / 100.0);
 
     _setTelemetryAvailable(true);
 }
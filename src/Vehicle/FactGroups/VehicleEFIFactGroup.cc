@@ -50,6 +50,11 @@ VehicleEFIFactGroup::VehicleEFIFactGroup(QObject *parent)
     _ptCompFact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleEFIFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_EFI_STATUS };
+}
+
 void VehicleEFIFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -68,23 +73,23 @@ void VehicleEFIFactGroup::_handleEFIStatus(const mavlink_message_t &message)
     mavlink_efi_status_t efi{};
     mavlink_msg_efi_status_decode(&message, &efi);
 
-    health()->setRawValue((efi.health == INT8_MAX) ? qQNaN() : efi.health);
-    ecuIndex()->setRawValue(efi.ecu_index);
-    rpm()->setRawValue(efi.rpm);
-    fuelConsumed()->setRawValue(efi.fuel_consumed);
-    fuelFlow()->setRawValue(efi.fuel_flow);
-    engineLoad()->setRawValue(efi.engine_load);
-    throttlePos()->setRawValue(efi.throttle_position);
-    sparkTime()->setRawValue(efi.spark_dwell_time);
-    baroPress()->setRawValue(efi.barometric_pressure);
-    intakePress()->setRawValue(efi.intake_manifold_pressure);
-    intakeTemp()->setRawValue(efi.intake_manifold_temperature);
-    cylinderTemp()->setRawValue(efi.cylinder_head_temperature);
-    ignTime()->setRawValue(efi.ignition_timing);
-    injTime()->setRawValue(efi.injection_time);
-    exGasTemp()->setRawValue(efi.exhaust_gas_temperature);
-    throttleOut()->setRawValue(efi.throttle_out);
-    ptComp()->setRawValue(efi.pt_compensation);
+    health()->setTelemetryValue((efi.health == INT8_MAX) ? qQNaN() : efi.health);
+    ecuIndex()->setTelemetryValue(efi.ecu_index);
+    rpm()->setTelemetryValue(efi.rpm);
+    fuelConsumed()->setTelemetryValue(efi.fuel_consumed);
+    fuelFlow()->setTelemetryValue(efi.fuel_flow);
+    engineLoad()->setTelemetryValue(efi.engine_load);
+    throttlePos()->setTelemetryValue(efi.throttle_position);
+    sparkTime()->setTelemetryValue(efi.spark_dwell_time);
+    baroPress()->setTelemetryValue(efi.barometric_pressure);
+    intakePress()->setTelemetryValue(efi.intake_manifold_pressure);
+    intakeTemp()->setTelemetryValue(efi.intake_manifold_temperature);
+    cylinderTemp()->setTelemetryValue(efi.cylinder_head_temperature);
+    ignTime()->setTelemetryValue(efi.ignition_timing);
+    injTime()->setTelemetryValue(efi.injection_time);
+    exGasTemp()->setTelemetryValue(efi.exhaust_gas_temperature);
+    throttleOut()->setTelemetryValue(efi.throttle_out);
+    ptComp()->setTelemetryValue(efi.pt_compensation);
 
     _setTelemetryAvailable(true);
 }
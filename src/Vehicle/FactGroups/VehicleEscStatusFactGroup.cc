@@ -31,6 +31,11 @@ VehicleEscStatusFactGroup::VehicleEscStatusFactGroup(QObject *parent)
     _addFact(&_voltageFourthFact);
 }
 
+QList<uint32_t> VehicleEscStatusFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_ESC_STATUS };
+}
+
 void VehicleEscStatusFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -42,22 +47,22 @@ void VehicleEscStatusFactGroup::handleMessage(Vehicle *vehicle, const mavlink_me
     mavlink_esc_status_t content{};
     mavlink_msg_esc_status_decode(&message, &content);
 
-    index()->setRawValue(content.index);
+    index()->setTelemetryValue(content.index);
 
-    rpmFirst()->setRawValue(content.rpm[0]);
-    rpmSecond()->setRawValue(content.rpm[1]);
-    rpmThird()->setRawValue(content.rpm[2]);
-    rpmFourth()->setRawValue(content.rpm[3]);
+    rpmFirst()->setTelemetryValue(content.rpm[0]);
+    rpmSecond()->setTelemetryValue(content.rpm[1]);
+    rpmThird()->setTelemetryValue(content.rpm[2]);
+    rpmFourth()->setTelemetryValue(content.rpm[3]);
 
-    currentFirst()->setRawValue(content.current[0]);
-    currentSecond()->setRawValue(content.current[1]);
-    currentThird()->setRawValue(content.current[2]);
-    currentFourth()->setRawValue(content.current[3]);
+    currentFirst()->setTelemetryValue(content.current[0]);
+    currentSecond()->setTelemetryValue(content.current[1]);
+    currentThird()->setTelemetryValue(content.current[2]);
+    currentFourth()->setTelemetryValue(content.current[3]);
 
-    voltageFirst()->setRawValue(content.voltage[0]);
-    voltageSecond()->setRawValue(content.voltage[1]);
-    voltageThird()->setRawValue(content.voltage[2]);
-    voltageFourth()->setRawValue(content.voltage[3]);
+    voltageFirst()->setTelemetryValue(content.voltage[0]);
+    voltageSecond()->setTelemetryValue(content.voltage[1]);
+    voltageThird()->setTelemetryValue(content.voltage[2]);
+    voltageFourth()->setTelemetryValue(content.voltage[3]);
 
     _setTelemetryAvailable(true);
 }
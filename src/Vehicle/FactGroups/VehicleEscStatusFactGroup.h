@@ -49,6 +49,7 @@ class VehicleEscStatusFactGroup : public FactGroup
 
     // Overrides from FactGroup
     void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) final;
+    QList<uint32_t> handledMessageIds() const final;
 
 private:
     Fact _indexFact = Fact(0, QStringLiteral("index"), FactMetaData::valueTypeUint8);
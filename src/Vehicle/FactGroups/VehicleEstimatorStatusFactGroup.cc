@@ -35,6 +35,11 @@ VehicleEstimatorStatusFactGroup::VehicleEstimatorStatusFactGroup(QObject *parent
     _addFact(&_vertPosAccuracyFact);
 }
 
+QList<uint32_t> VehicleEstimatorStatusFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_ESTIMATOR_STATUS };
+}
+
 void VehicleEstimatorStatusFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -46,26 +51,26 @@ void VehicleEstimatorStatusFactGroup::handleMessage(Vehicle *vehicle, const mavl
     mavlink_estimator_status_t estimatorStatus{};
     mavlink_msg_estimator_status_decode(&message, &estimatorStatus);
 
-    goodAttitudeEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_ATTITUDE));
-    goodHorizVelEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_VELOCITY_HORIZ));
-    goodVertVelEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_VELOCITY_VERT));
-    goodHorizPosRelEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_POS_HORIZ_REL));
-    goodHorizPosAbsEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_POS_HORIZ_ABS));
-    goodVertPosAbsEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_POS_VERT_ABS));
-    goodVertPosAGLEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_POS_VERT_AGL));
-    goodConstPosModeEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_CONST_POS_MODE));
-    goodPredHorizPosRelEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_PRED_POS_HORIZ_REL));
-    goodPredHorizPosAbsEstimate()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_PRED_POS_HORIZ_ABS));
-    gpsGlitch()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_GPS_GLITCH));
-    accelError()->setRawValue(!!(estimatorStatus.flags & ESTIMATOR_ACCEL_ERROR));
-    velRatio()->setRawValue(estimatorStatus.vel_ratio);
-    horizPosRatio()->setRawValue(estimatorStatus.pos_horiz_ratio);
-    vertPosRatio()->setRawValue(estimatorStatus.pos_vert_ratio);
-    magRatio()->setRawValue(estimatorStatus.mag_ratio);
-    haglRatio()->setRawValue(estimatorStatus.hagl_ratio);
-    tasRatio()->setRawValue(estimatorStatus.tas_ratio);
-    horizPosAccuracy()->setRawValue(estimatorStatus.pos_horiz_accuracy);
-    vertPosAccuracy()->setRawValue(estimatorStatus.pos_vert_accuracy);
+    goodAttitudeEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_ATTITUDE));
+    goodHorizVelEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_VELOCITY_HORIZ));
+    goodVertVelEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_VELOCITY_VERT));
+    goodHorizPosRelEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_POS_HORIZ_REL));
+    goodHorizPosAbsEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_POS_HORIZ_ABS));
+    goodVertPosAbsEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_POS_VERT_ABS));
+    goodVertPosAGLEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_POS_VERT_AGL));
+    goodConstPosModeEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_CONST_POS_MODE));
+    goodPredHorizPosRelEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_PRED_POS_HORIZ_REL));
+    goodPredHorizPosAbsEstimate()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_PRED_POS_HORIZ_ABS));
+    gpsGlitch()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_GPS_GLITCH));
+    accelError()->setTelemetryValue(!!(estimatorStatus.flags & ESTIMATOR_ACCEL_ERROR));
+    velRatio()->setTelemetryValue(estimatorStatus.vel_ratio);
+    horizPosRatio()->setTelemetryValue(estimatorStatus.pos_horiz_ratio);
+    vertPosRatio()->setTelemetryValue(estimatorStatus.pos_vert_ratio);
+    magRatio()->setTelemetryValue(estimatorStatus.mag_ratio);
+    haglRatio()->setTelemetryValue(estimatorStatus.hagl_ratio);
+    tasRatio()->setTelemetryValue(estimatorStatus.tas_ratio);
+    horizPosAccuracy()->setTelemetryValue(estimatorStatus.pos_horiz_accuracy);
+    vertPosAccuracy()->setTelemetryValue(estimatorStatus.pos_vert_accuracy);
 
     _setTelemetryAvailable(true);
 }
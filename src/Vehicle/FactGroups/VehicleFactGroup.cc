@@ -50,6 +50,21 @@ VehicleFactGroup::VehicleFactGroup(QObject *parent)
     _hobbsFact.setRawValue(QStringLiteral("0000:00:00"));
 }
 
+QList<uint32_t> VehicleFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_ATTITUDE,
+        MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+        MAVLINK_MSG_ID_ALTITUDE,
+        MAVLINK_MSG_ID_VFR_HUD,
+        MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT,
+        MAVLINK_MSG_ID_RAW_IMU,
+#ifndef QGC_NO_ARDUPILOT_DIALECT
+        MAVLINK_MSG_ID_RANGEFINDER,
+#endif
+    };
+}
+
 void VehicleFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     switch (message.msgid) {
@@ -97,14 +112,14 @@ void VehicleFactGroup::_handleAttitudeWorker(double rollRadians, double pitchRad
     // truncate to integer so widget never displays 360
     yawDegrees = trunc(yawDegrees);
 
-    roll()->setRawValue(rollDegrees);
-    pitch()->setRawValue(pitchDegrees);
-    heading()->setRawValue(yawDegrees);
+    roll()->setTelemetryValue(rollDegrees);
+    pitch()->setTelemetryValue(pitchDegrees);
+    heading()->setTelemetryValue(yawDegrees);
 }
 
 void VehicleFactGroup::_handleAttitude(Vehicle *vehicle, const mavlink_message_t &message)
 {
-    if ((message.sysid != vehicle->id()) || (message.compid != vehicle->compId())) {
+    if (vehicle && ((message.sysid != vehicle->id()) || (message.compid != vehicle->compId()))) {
         return;
     }
 
@@ -127,8 +142,8 @@ void VehicleFactGroup::_handleAltitude(const mavlink_message_t &message)
 
     // Data from ALTITUDE message takes precedence over gps messages
     _altitudeMessageAvailable = true;
-    altitudeRelative()->setRawValue(altitude.altitude_relative);
-    altitudeAMSL()->setRawValue(altitude.altitude_amsl);
+    altitudeRelative()->setTelemetryValue(altitude.altitude_relative);
+    altitudeAMSL()->setTelemetryValue(altitude.altitude_amsl);
 
     _setTelemetryAvailable(true);
 }
@@ -136,7 +151,7 @@ void VehicleFactGroup::_handleAltitude(const mavlink_message_t &message)
 void VehicleFactGroup::_handleAttitudeQuaternion(Vehicle *vehicle, const mavlink_message_t &message)
 {
     // only accept the attitude message from the vehicle's flight controller
-    if ((message.sysid != vehicle->id()) || (message.compid != vehicle->compId())) {
+    if (vehicle && ((message.sysid != vehicle->id()) || (message.compid != vehicle->compId()))) {
         return;
     }
 
@@ -161,9 +176,9 @@ void VehicleFactGroup::_handleAttitudeQuaternion(Vehicle *vehicle, const mavlink
 
     _handleAttitudeWorker(attRoll, attPitch, attYaw);
 
-    rollRate()->setRawValue(qRadiansToDegrees(rates[0]));
-    pitchRate()->setRawValue(qRadiansToDegrees(rates[1]));
-    yawRate()->setRawValue(qRadiansToDegrees(rates[2]));
+    rollRate()->setTelemetryValue(qRadiansToDegrees(rates[0]));
+    pitchRate()->setTelemetryValue(qRadiansToDegrees(rates[1]));
+    yawRate()->setTelemetryValue(qRadiansToDegrees(rates[2]));
 
     _setTelemetryAvailable(true);
 }
@@ -173,10 +188,10 @@ void VehicleFactGroup::_handleNavControllerOutput(const mavlink_message_t &messa
     mavlink_nav_controller_output_t navControllerOutput{};
     mavlink_msg_nav_controller_output_decode(&message, &navControllerOutput);
 
-    altitudeTuningSetpoint()->setRawValue(_altitudeTuningFact.rawValue().toDouble() - navControllerOutput.alt_error);
-    xTrackError()->setRawValue(navControllerOutput.xtrack_error);
-    airSpeedSetpoint()->setRawValue(_airSpeedFact.rawValue().toDouble() - navControllerOutput.aspd_error);
-    distanceToNextWP()->setRawValue(navControllerOutput.wp_dist);
+    altitudeTuningSetpoint()->setTelemetryValue(_altitudeTuningFact.rawValue().toDouble() - navControllerOutput.alt_error);
+    xTrackError()->setTelemetryValue(navControllerOutput.xtrack_error);
+    airSpeedSetpoint()->setTelemetryValue(_airSpeedFact.rawValue().toDouble() - navControllerOutput.aspd_error);
+    distanceToNextWP()->setTelemetryValue(navControllerOutput.wp_dist);
 
     _setTelemetryAvailable(true);
 }
@@ -186,16 +201,16 @@ void VehicleFactGroup::_handleVfrHud(const mavlink_message_t &message)
     mavlink_vfr_hud_t vfrHud{};
     mavlink_msg_vfr_hud_decode(&message, &vfrHud);
 
-    airSpeed()->setRawValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
-    groundSpeed()->setRawValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
-    climbRate()->setRawValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
-    throttlePct()->setRawValue(static_cast<int16_t>(vfrHud.throttle));
+    airSpeed()->setTelemetryValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
+    groundSpeed()->setTelemetryValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
+    climbRate()->setTelemetryValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
+    throttlePct()->setTelemetryValue(static_cast<int16_t>(vfrHud.throttle));
     if (qIsNaN(_altitudeTuningOffset)) {
         _altitudeTuningOffset = vfrHud.alt;
     }
-    altitudeTuning()->setRawValue(vfrHud.alt - _altitudeTuningOffset);
+    altitudeTuning()->setTelemetryValue(vfrHud.alt - _altitudeTuningOffset);
     if (!qIsNaN(vfrHud.groundspeed) && !qIsNaN(_distanceToHomeFact.cookedValue().toDouble())) {
-      timeToHome()->setRawValue(_distanceToHomeFact.cookedValue().toDouble() / vfrHud.groundspeed);
+      timeToHome()->setTelemetryValue(_distanceToHomeFact.cookedValue().toDouble() / vfrHud.groundspeed);
     }
 
     _setTelemetryAvailable(true);
@@ -206,7 +221,7 @@ void VehicleFactGroup::_handleRawImuTemp(const mavlink_message_t &message)
     mavlink_raw_imu_t imuRaw{};
     mavlink_msg_raw_imu_decode(&message, &imuRaw);
 
-    imuTemp()->setRawValue((imuRaw.temperature == 0) ? 0 : (imuRaw.temperature * 0.01));
+    imuTemp()->setTelemetryValue((imuRaw.temperature == 0) ? 0 : (imuRaw.temperature * 0.01));
 
     _setTelemetryAvailable(true);
 }
@@ -217,7 +232,7 @@ void VehicleFactGroup::_handleRangefinder(const mavlink_message_t &message)
     mavlink_rangefinder_t rangefinder{};
     mavlink_msg_rangefinder_decode(&message, &rangefinder);
 
-    rangeFinderDist()->setRawValue(qIsNaN(rangefinder.distance) ? 0 : rangefinder.distance);
+    rangeFinderDist()->setTelemetryValue(qIsNaN(rangefinder.distance) ? 0 : rangefinder.distance);
 
     _setTelemetryAvailable(true);
 }
@@ -13,6 +13,11 @@
 
 #include <QtPositioning/QGeoCoordinate>
 
+QList<uint32_t> VehicleGPS2FactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_GPS2_RAW };
+}
+
 void VehicleGPS2FactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -31,14 +36,14 @@ void VehicleGPS2FactGroup::_handleGps2Raw(const mavlink_message_t &message)
     mavlink_gps2_raw_t gps2Raw{};
     mavlink_msg_gps2_raw_decode(&message, &gps2Raw);
 
-    lat()->setRawValue(gps2Raw.lat * 1e-7);
-    lon()->setRawValue(gps2Raw.lon * 1e-7);
+    lat()->setTelemetryValue(gps2Raw.lat * 1e-7);
+    lon()->setTelemetryValue(gps2Raw.lon * 1e-7);
     mgrs()->setRawValue(QGCGeo::convertGeoToMGRS(QGeoCoordinate(gps2Raw.lat * 1e-7, gps2Raw.lon * 1e-7)));
-    count()->setRawValue((gps2Raw.satellites_visible == 255) ? 0 : gps2Raw.satellites_visible);
-    hdop()->setRawValue((gps2Raw.eph == UINT16_MAX) ? qQNaN() : (gps2Raw.eph / 100.0));
-    vdop()->setRawValue((gps2Raw.epv == UINT16_MAX) ? qQNaN() : (gps2Raw.epv / 100.0));
-    courseOverGround()->setRawValue((gps2Raw.cog == UINT16_MAX) ? qQNaN() : (gps2Raw.cog / 100.0));
-    lock()->setRawValue(gps2Raw.fix_type);
+    count()->setTelemetryValue((gps2Raw.satellites_visible == 255) ? 0 : gps2Raw.satellites_visible);
+    hdop()->setTelemetryValue((gps2Raw.eph == UINT16_MAX) ? qQNaN() : (gps2Raw.eph / 100.0));
+    vdop()->setTelemetryValue((gps2Raw.epv == UINT16_MAX) ? qQNaN() : (gps2Raw.epv / 100.0));
+    courseOverGround()->setTelemetryValue((gps2Raw.cog == UINT16_MAX) ? qQNaN() : (gps2Raw.cog / 100.0));
+    lock()->setTelemetryValue(gps2Raw.fix_type);
 
     _setTelemetryAvailable(true);
 }
@@ -33,6 +33,15 @@ VehicleGPSFactGroup::VehicleGPSFactGroup(QObject *parent)
     _courseOverGroundFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
 }
 
+QList<uint32_t> VehicleGPSFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_GPS_RAW_INT,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2
+    };
+}
+
 void VehicleGPSFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -57,14 +66,14 @@ void VehicleGPSFactGroup::_handleGpsRawInt(const mavlink_message_t &message)
     mavlink_gps_raw_int_t gpsRawInt{};
     mavlink_msg_gps_raw_int_decode(&message, &gpsRawInt);
 
-    lat()->setRawValue(gpsRawInt.lat * 1e-7);
-    lon()->setRawValue(gpsRawInt.lon * 1e-7);
+    lat()->setTelemetryValue(gpsRawInt.lat * 1e-7);
+    lon()->setTelemetryValue(gpsRawInt.lon * 1e-7);
     mgrs()->setRawValue(QGCGeo::convertGeoToMGRS(QGeoCoordinate(gpsRawInt.lat * 1e-7, gpsRawInt.lon * 1e-7)));
-    count()->setRawValue((gpsRawInt.satellites_visible == 255) ? 0 : gpsRawInt.satellites_visible);
-    hdop()->setRawValue((gpsRawInt.eph == UINT16_MAX) ? qQNaN() : (gpsRawInt.eph / 100.0));
-    vdop()->setRawValue((gpsRawInt.epv == UINT16_MAX) ? qQNaN() : (gpsRawInt.epv / 100.0));
-    courseOverGround()->setRawValue((gpsRawInt.cog == UINT16_MAX) ? qQNaN() : (gpsRawInt.cog / 100.0));
-    lock()->setRawValue(gpsRawInt.fix_type);
+    count()->setTelemetryValue((gpsRawInt.satellites_visible == 255) ? 0 : gpsRawInt.satellites_visible);
+    hdop()->setTelemetryValue((gpsRawInt.eph == UINT16_MAX) ? qQNaN() : (gpsRawInt.eph / 100.0));
+    vdop()->setTelemetryValue((gpsRawInt.epv == UINT16_MAX) ? qQNaN() : (gpsRawInt.epv / 100.0));
+    courseOverGround()->setTelemetryValue((gpsRawInt.cog == UINT16_MAX) ? qQNaN() : (gpsRawInt.cog / 100.0));
+    lock()->setTelemetryValue(gpsRawInt.fix_type);
 
     _setTelemetryAvailable(true);
 }
@@ -74,10 +83,10 @@ void VehicleGPSFactGroup::_handleHighLatency(const mavlink_message_t &message)
     mavlink_high_latency_t highLatency{};
     mavlink_msg_high_latency_decode(&message, &highLatency);
 
-    lat()->setRawValue(highLatency.latitude * 1e-7);
-    lon()->setRawValue(highLatency.longitude * 1e-7);
+    lat()->setTelemetryValue(highLatency.latitude * 1e-7);
+    lon()->setTelemetryValue(highLatency.longitude * 1e-7);
     mgrs()->setRawValue(QGCGeo::convertGeoToMGRS(QGeoCoordinate(highLatency.latitude * 1e-7, highLatency.longitude * 1e-7, highLatency.altitude_amsl)));
-    count()->setRawValue(0);
+    count()->setTelemetryValue(0);
 
     _setTelemetryAvailable(true);
 }
@@ -87,12 +96,12 @@ void VehicleGPSFactGroup::_handleHighLatency2(const mavlink_message_t &message)
     mavlink_high_latency2_t highLatency2{};
     mavlink_msg_high_latency2_decode(&message, &highLatency2);
 
-    lat()->setRawValue(highLatency2.latitude * 1e-7);
-    lon()->setRawValue(highLatency2.longitude * 1e-7);
+    lat()->setTelemetryValue(highLatency2.latitude * 1e-7);
+    lon()->setTelemetryValue(highLatency2.longitude * 1e-7);
     mgrs()->setRawValue(QGCGeo::convertGeoToMGRS(QGeoCoordinate(highLatency2.latitude * 1e-7, highLatency2.longitude * 1e-7, highLatency2.altitude)));
-    count()->setRawValue(0);
-    hdop()->setRawValue((highLatency2.eph == UINT8_MAX) ? qQNaN() : (highLatency2.eph / 10.0));
-    vdop()->setRawValue((highLatency2.epv == UINT8_MAX) ? qQNaN() : (highLatency2.epv / 10.0));
+    count()->setTelemetryValue(0);
+    hdop()->setTelemetryValue((highLatency2.eph == UINT8_MAX) ? qQNaN() : (highLatency2.eph / 10.0));
+    vdop()->setTelemetryValue((highLatency2.epv == UINT8_MAX) ? qQNaN() : (highLatency2.epv / 10.0));
 
     _setTelemetryAvailable(true);
 }
@@ -40,6 +40,11 @@ VehicleGeneratorFactGroup::VehicleGeneratorFactGroup(QObject *parent)
     (void) connect(status(), &Fact::rawValueChanged, this,& VehicleGeneratorFactGroup::_updateGeneratorFlags);
 }
 
+QList<uint32_t> VehicleGeneratorFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_GENERATOR_STATUS };
+}
+
 void VehicleGeneratorFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -58,17 +63,17 @@ void VehicleGeneratorFactGroup::_handleGeneratorStatus(const mavlink_message_t &
     mavlink_generator_status_t generator{};
     mavlink_msg_generator_status_decode(&message, &generator);
 
-    status()->setRawValue((generator.status == UINT16_MAX) ? qQNaN() : generator.status);
-    genSpeed()->setRawValue((generator.generator_speed == UINT16_MAX) ? qQNaN() : generator.generator_speed);
-    batteryCurrent()->setRawValue(generator.battery_current);
-    loadCurrent()->setRawValue(generator.load_current);
-    powerGenerated()->setRawValue(generator.power_generated);
-    busVoltage()->setRawValue(generator.bus_voltage);
-    rectifierTemp()->setRawValue((generator.rectifier_temperature == INT16_MAX) ? qQNaN() : generator.rectifier_temperature);
-    batCurrentSetpoint()->setRawValue(generator.bat_current_setpoint);
-    genTemp()->setRawValue((generator.generator_temperature == INT16_MAX) ? qQNaN() : generator.generator_temperature);
-    runtime()->setRawValue((generator.runtime == UINT32_MAX) ? qQNaN() : generator.runtime);
-    timeMaintenance()->setRawValue((generator.time_until_maintenance == INT32_MAX) ? qQNaN() : generator.time_until_maintenance);
+    status()->setTelemetryValue((generator.status == UINT16_MAX) ? qQNaN() : generator.status);
+    genSpeed()->setTelemetryValue((generator.generator_speed == UINT16_MAX) ? qQNaN() : generator.generator_speed);
+    batteryCurrent()->setTelemetryValue(generator.battery_current);
+    loadCurrent()->setTelemetryValue(generator.load_current);
+    powerGenerated()->setTelemetryValue(generator.power_generated);
+    busVoltage()->setTelemetryValue(generator.bus_voltage);
+    rectifierTemp()->setTelemetryValue((generator.rectifier_temperature == INT16_MAX) ? qQNaN() : generator.rectifier_temperature);
+    batCurrentSetpoint()->setTelemetryValue(generator.bat_current_setpoint);
+    genTemp()->setTelemetryValue((generator.generator_temperature == INT16_MAX) ? qQNaN() : generator.generator_temperature);
+    runtime()->setTelemetryValue((generator.runtime == UINT32_MAX) ? qQNaN() : generator.runtime);
+    timeMaintenance()->setTelemetryValue((generator.time_until_maintenance == INT32_MAX) ? qQNaN() : generator.time_until_maintenance);
 
     _setTelemetryAvailable(true);
 }
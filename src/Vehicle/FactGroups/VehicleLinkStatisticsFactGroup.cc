@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleLinkStatisticsFactGroup.h"
+
+VehicleLinkStatisticsFactGroup::VehicleLinkStatisticsFactGroup(QObject *parent)
+    : FactGroup(1000, QStringLiteral(":/json/Vehicle/LinkStatisticsFact.json"), parent)
+{
+    _addFact(&_receivedFact);
+    _addFact(&_lostFact);
+    _addFact(&_lossPercentFact);
+    _addFact(&_windowLossPercentFact);
+    _addFact(&_jitterFact);
+    _addFact(&_messageRateFact);
+    _addFact(&_burstLoss1Fact);
+    _addFact(&_burstLoss2Fact);
+    _addFact(&_burstLoss3To4Fact);
+    _addFact(&_burstLoss5To8Fact);
+    _addFact(&_burstLoss9To16Fact);
+    _addFact(&_burstLoss17To32Fact);
+    _addFact(&_burstLoss33To64Fact);
+    _addFact(&_burstLoss65PlusFact);
+
+    reset();
+}
+
+void VehicleLinkStatisticsFactGroup::reset()
+{
+    _lastSnapshot = MAVLinkStatistics::Snapshot();
+    _messageIdRates.clear();
+    emit messageRatesChanged();
+
+    for (Fact *const fact : std::as_const(_nameToFactMap)) {
+        fact->setRawValue(0);
+    }
+    _setTelemetryAvailable(false);
+}
+
+void VehicleLinkStatisticsFactGroup::update(const MAVLinkStatistics::Snapshot &snapshot)
+{
+    received()->setTelemetryValue(snapshot.received);
+    lost()->setTelemetryValue(snapshot.lost);
+    lossPercent()->setTelemetryValue(snapshot.lossPercent());
+    windowLossPercent()->setTelemetryValue(snapshot.windowLossPercent());
+    jitter()->setTelemetryValue(snapshot.jitterMSecs);
+
+    Fact *const burstLossFacts[MAVLinkStatistics::kBurstBinCount] = {
+        burstLoss1(), burstLoss2(), burstLoss3To4(), burstLoss5To8(), burstLoss9To16(), burstLoss17To32(), burstLoss33To64(), burstLoss65Plus()
+    };
+    for (int i = 0; i < MAVLinkStatistics::kBurstBinCount; i++) {
+        burstLossFacts[i]->setTelemetryValue(snapshot.burstLoss[i]);
+    }
+
+    // Counts restart when the link metadata is reset, the first snapshot after that has no rates
+    const double elapsedSecs = (snapshot.timeUSecs - _lastSnapshot.timeUSecs) / 1e6;
+    const bool ratesValid = (_lastSnapshot.timeUSecs > 0) && (elapsedSecs > 0) && (snapshot.received >= _lastSnapshot.received);
+
+    _messageIdRates.clear();
+    if (ratesValid) {
+        for (auto it = snapshot.messageCounts.cbegin(); it != snapshot.messageCounts.cend(); ++it) {
+            const quint64 lastCount = _lastSnapshot.messageCounts.value(it.key());
+            if (it.value() > lastCount) {
+                (void) _messageIdRates.insert(it.key(), (it.value() - lastCount) / elapsedSecs);
+            }
+        }
+        messageRate()->setTelemetryValue((snapshot.received - _lastSnapshot.received) / elapsedSecs);
+    }
+    emit messageRatesChanged();
+
+    _lastSnapshot = snapshot;
+
+    if (snapshot.received > 0) {
+        _setTelemetryAvailable(true);
+    }
+}
+
+QVariantMap VehicleLinkStatisticsFactGroup::messageRates() const
+{
+    QVariantMap rates;
+    for (auto it = _messageIdRates.cbegin(); it != _messageIdRates.cend(); ++it) {
+        const mavlink_message_info_t *const info = mavlink_get_message_info_by_id(it.key());
+        const QString name = info ? QString::fromLatin1(info->name) : QString::number(it.key());
+        rates[name] = it.value();
+    }
+
+    return rates;
+}
@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QVariantMap>
+
+#include "FactGroup.h"
+#include "MAVLinkStatistics.h"
+
+/// Receive statistics of the vehicle on its primary link, updated from MAVLinkStatistics snapshots
+class VehicleLinkStatisticsFactGroup : public FactGroup
+{
+    Q_OBJECT
+    Q_PROPERTY(Fact         *received           READ received           CONSTANT)
+    Q_PROPERTY(Fact         *lost               READ lost               CONSTANT)
+    Q_PROPERTY(Fact         *lossPercent        READ lossPercent        CONSTANT)
+    Q_PROPERTY(Fact         *windowLossPercent  READ windowLossPercent  CONSTANT)
+    Q_PROPERTY(Fact         *jitter             READ jitter             CONSTANT)
+    Q_PROPERTY(Fact         *messageRate        READ messageRate        CONSTANT)
+    Q_PROPERTY(Fact         *burstLoss1         READ burstLoss1         CONSTANT)
+    Q_PROPERTY(Fact         *burstLoss2         READ burstLoss2         CONSTANT)
+    Q_PROPERTY(Fact         *burstLoss3To4      READ burstLoss3To4      CONSTANT)
+    Q_PROPERTY(Fact         *burstLoss5To8      READ burstLoss5To8      CONSTANT)
+    Q_PROPERTY(Fact         *burstLoss9To16     READ burstLoss9To16     CONSTANT)
+    Q_PROPERTY(Fact         *burstLoss17To32    READ burstLoss17To32    CONSTANT)
+    Q_PROPERTY(Fact         *burstLoss33To64    READ burstLoss33To64    CONSTANT)
+    Q_PROPERTY(Fact         *burstLoss65Plus    READ burstLoss65Plus    CONSTANT)
+    Q_PROPERTY(QVariantMap  messageRates        READ messageRates       NOTIFY messageRatesChanged)
+
+public:
+    explicit VehicleLinkStatisticsFactGroup(QObject *parent = nullptr);
+
+    Fact *received() { return &_receivedFact; }
+    Fact *lost() { return &_lostFact; }
+    Fact *lossPercent() { return &_lossPercentFact; }
+    Fact *windowLossPercent() { return &_windowLossPercentFact; }
+    Fact *jitter() { return &_jitterFact; }
+    Fact *messageRate() { return &_messageRateFact; }
+    Fact *burstLoss1() { return &_burstLoss1Fact; }
+    Fact *burstLoss2() { return &_burstLoss2Fact; }
+    Fact *burstLoss3To4() { return &_burstLoss3To4Fact; }
+    Fact *burstLoss5To8() { return &_burstLoss5To8Fact; }
+    Fact *burstLoss9To16() { return &_burstLoss9To16Fact; }
+    Fact *burstLoss17To32() { return &_burstLoss17To32Fact; }
+    Fact *burstLoss33To64() { return &_burstLoss33To64Fact; }
+    Fact *burstLoss65Plus() { return &_burstLoss65PlusFact; }
+
+    /// Messages per second for each message name
+    QVariantMap messageRates() const;
+
+    /// Messages per second for each message id, calculated between the last two snapshots
+    const QHash<uint32_t, double> &messageIdRates() const { return _messageIdRates; }
+
+    /// Sets the values from a new snapshot, rates are calculated against the previous snapshot
+    void update(const MAVLinkStatistics::Snapshot &snapshot);
+
+    /// Clears the values, the next snapshot starts new rates
+    void reset();
+
+signals:
+    void messageRatesChanged();
+
+private:
+    MAVLinkStatistics::Snapshot _lastSnapshot;
+    QHash<uint32_t, double> _messageIdRates;
+
+    Fact _receivedFact = Fact(0, QStringLiteral("received"), FactMetaData::valueTypeUint64);
+    Fact _lostFact = Fact(0, QStringLiteral("lost"), FactMetaData::valueTypeUint64);
+    Fact _lossPercentFact = Fact(0, QStringLiteral("lossPercent"), FactMetaData::valueTypeDouble);
+    Fact _windowLossPercentFact = Fact(0, QStringLiteral("windowLossPercent"), FactMetaData::valueTypeDouble);
+    Fact _jitterFact = Fact(0, QStringLiteral("jitter"), FactMetaData::valueTypeDouble);
+    Fact _messageRateFact = Fact(0, QStringLiteral("messageRate"), FactMetaData::valueTypeDouble);
+    Fact _burstLoss1Fact = Fact(0, QStringLiteral("burstLoss1"), FactMetaData::valueTypeUint64);
+    Fact _burstLoss2Fact = Fact(0, QStringLiteral("burstLoss2"), FactMetaData::valueTypeUint64);
+    Fact _burstLoss3To4Fact = Fact(0, QStringLiteral("burstLoss3To4"), FactMetaData::valueTypeUint64);
+    Fact _burstLoss5To8Fact = Fact(0, QStringLiteral("burstLoss5To8"), FactMetaData::valueTypeUint64);
+    Fact _burstLoss9To16Fact = Fact(0, QStringLiteral("burstLoss9To16"), FactMetaData::valueTypeUint64);
+    Fact _burstLoss17To32Fact = Fact(0, QStringLiteral("burstLoss17To32"), FactMetaData::valueTypeUint64);
+    Fact _burstLoss33To64Fact = Fact(0, QStringLiteral("burstLoss33To64"), FactMetaData::valueTypeUint64);
+    Fact _burstLoss65PlusFact = Fact(0, QStringLiteral("burstLoss65Plus"), FactMetaData::valueTypeUint64);
+};
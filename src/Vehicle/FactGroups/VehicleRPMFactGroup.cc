@@ -24,6 +24,11 @@ VehicleRPMFactGroup::VehicleRPMFactGroup(QObject *parent)
     _rpm4Fact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleRPMFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_RAW_RPM };
+}
+
 void VehicleRPMFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -36,16 +41,16 @@ void VehicleRPMFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_
     mavlink_msg_raw_rpm_decode(&message, &raw_rpm);
     switch (raw_rpm.index) {
         case 0:
-            rpm1()->setRawValue(raw_rpm.frequency);
+            rpm1()->setTelemetryValue(raw_rpm.frequency);
             break;
         case 1:
-            rpm2()->setRawValue(raw_rpm.frequency);
+            rpm2()->setTelemetryValue(raw_rpm.frequency);
             break;
         case 2:
-            rpm3()->setRawValue(raw_rpm.frequency);
+            rpm3()->setTelemetryValue(raw_rpm.frequency);
             break;
         case 3:
-            rpm4()->setRawValue(raw_rpm.frequency);
+            rpm4()->setTelemetryValue(raw_rpm.frequency);
             break;
         default:
             break;
@@ -29,6 +29,7 @@ class VehicleRPMFactGroup : public FactGroup
 
     // Overrides from FactGroup
     void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) final;
+    QList<uint32_t> handledMessageIds() const final;
 
 private:
     Fact _rpm1Fact = Fact(0, QStringLiteral("rpm1"), FactMetaData::valueTypeDouble);
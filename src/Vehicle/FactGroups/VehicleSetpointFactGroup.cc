@@ -30,6 +30,11 @@ VehicleSetpointFactGroup::VehicleSetpointFactGroup(QObject *parent)
     _yawRateFact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleSetpointFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_ATTITUDE_TARGET };
+}
+
 void VehicleSetpointFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -44,16 +49,16 @@ void VehicleSetpointFactGroup::handleMessage(Vehicle *vehicle, const mavlink_mes
     float targetRoll, targetPitch, targetYaw;
     mavlink_quaternion_to_euler(attitudeTarget.q, &targetRoll, &targetPitch, &targetYaw);
 
-    roll()->setRawValue(qRadiansToDegrees(targetRoll));
-    pitch()->setRawValue(qRadiansToDegrees(targetPitch));
+    roll()->setTelemetryValue(qRadiansToDegrees(targetRoll));
+    pitch()->setTelemetryValue(qRadiansToDegrees(targetPitch));
     if (targetYaw < 0.f) {
         targetYaw += 2.f * static_cast<float>(M_PI); // bring to range [0, 2pi] to match the heading angle
     }
-    yaw()->setRawValue(qRadiansToDegrees(targetYaw));
+    yaw()->setTelemetryValue(qRadiansToDegrees(targetYaw));
 
-    rollRate()->setRawValue(qRadiansToDegrees(attitudeTarget.body_roll_rate));
-    pitchRate()->setRawValue(qRadiansToDegrees(attitudeTarget.body_pitch_rate));
-    yawRate()->setRawValue(qRadiansToDegrees(attitudeTarget.body_yaw_rate));
+    rollRate()->setTelemetryValue(qRadiansToDegrees(attitudeTarget.body_roll_rate));
+    pitchRate()->setTelemetryValue(qRadiansToDegrees(attitudeTarget.body_pitch_rate));
+    yawRate()->setTelemetryValue(qRadiansToDegrees(attitudeTarget.body_yaw_rate));
 
     _setTelemetryAvailable(true);
 }
@@ -22,6 +22,17 @@ VehicleTemperatureFactGroup::VehicleTemperatureFactGroup(QObject *parent)
     _temperature3Fact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleTemperatureFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_SCALED_PRESSURE,
+        MAVLINK_MSG_ID_SCALED_PRESSURE2,
+        MAVLINK_MSG_ID_SCALED_PRESSURE3,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2
+    };
+}
+
 void VehicleTemperatureFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -52,7 +63,7 @@ void VehicleTemperatureFactGroup::_handleHighLatency(const mavlink_message_t &me
     mavlink_high_latency_t highLatency{};
     mavlink_msg_high_latency_decode(&message, &highLatency);
 
-    temperature1()->setRawValue(highLatency.temperature_air);
+    temperature1()->setTelemetryValue(highLatency.temperature_air);
 
     _setTelemetryAvailable(true);
 }
@@ -62,7 +73,7 @@ void VehicleTemperatureFactGroup::_handleHighLatency2(const mavlink_message_t &m
     mavlink_high_latency2_t highLatency2{};
     mavlink_msg_high_latency2_decode(&message, &highLatency2);
 
-    temperature1()->setRawValue(highLatency2.temperature_air);
+    temperature1()->setTelemetryValue(highLatency2.temperature_air);
 
     _setTelemetryAvailable(true);
 }
@@ -72,7 +83,7 @@ void VehicleTemperatureFactGroup::_handleScaledPressure(const mavlink_message_t
     mavlink_scaled_pressure_t pressure{};
     mavlink_msg_scaled_pressure_decode(&message, &pressure);
 
-    temperature1()->setRawValue(pressure.temperature / 100.0);
+    temperature1()->setTelemetryValue(pressure.temperature / 100.0);
 
     _setTelemetryAvailable(true);
 }
@@ -82,7 +93,7 @@ void VehicleTemperatureFactGroup::_handleScaledPressure2(const mavlink_message_t
     mavlink_scaled_pressure2_t pressure{};
     mavlink_msg_scaled_pressure2_decode(&message, &pressure);
 
-    temperature2()->setRawValue(pressure.temperature / 100.0);
+    temperature2()->setTelemetryValue(pressure.temperature / 100.0);
 
     _setTelemetryAvailable(true);
 }
@@ -92,7 +103,7 @@ void VehicleTemperatureFactGroup::_handleScaledPressure3(const mavlink_message_t
     mavlink_scaled_pressure3_t pressure{};
     mavlink_msg_scaled_pressure3_decode(&message, &pressure);
 
-    temperature3()->setRawValue(pressure.temperature / 100.0);
+    temperature3()->setTelemetryValue(pressure.temperature / 100.0);
 
     _setTelemetryAvailable(true);
 }
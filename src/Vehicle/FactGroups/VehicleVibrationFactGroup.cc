@@ -25,6 +25,11 @@ VehicleVibrationFactGroup::VehicleVibrationFactGroup(QObject *parent)
     _zAxisFact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleVibrationFactGroup::handledMessageIds() const
+{
+    return { MAVLINK_MSG_ID_VIBRATION };
+}
+
 void VehicleVibrationFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
 {
     Q_UNUSED(vehicle);
@@ -36,12 +41,12 @@ void VehicleVibrationFactGroup::handleMessage(Vehicle *vehicle, const mavlink_me
     mavlink_vibration_t vibration{};
     mavlink_msg_vibration_decode(&message, &vibration);
 
-    xAxis()->setRawValue(vibration.vibration_x);
-    yAxis()->setRawValue(vibration.vibration_y);
-    zAxis()->setRawValue(vibration.vibration_z);
-    clipCount1()->setRawValue(vibration.clipping_0);
-    clipCount2()->setRawValue(vibration.clipping_1);
-    clipCount3()->setRawValue(vibration.clipping_2);
+    xAxis()->setTelemetryValue(vibration.vibration_x);
+    yAxis()->setTelemetryValue(vibration.vibration_y);
+    zAxis()->setTelemetryValue(vibration.vibration_z);
+    clipCount1()->setTelemetryValue(vibration.clipping_0);
+    clipCount2()->setTelemetryValue(vibration.clipping_1);
+    clipCount3()->setTelemetryValue(vibration.clipping_2);
 
     _setTelemetryAvailable(true);
 }
@@ -17,8 +17,13 @@ TrajectoryPoints::TrajectoryPoints(Vehicle* vehicle, QObject* parent)
 {
 }
 
-void TrajectoryPoints::_vehicleCoordinateChanged(QGeoCoordinate coordinate)
+void TrajectoryPoints::_vehicleStateSnapshotChanged(const VehicleStateSnapshot& snapshot)
 {
+    const QGeoCoordinate coordinate = snapshot.coordinate;
+    if (!coordinate.isValid()) {
+        return;
+    }
+
     // The goal of this algorithm is to limit the number of trajectory points whic represent the vehicle path.
     // Fewer points means higher performance of map display.
 
@@ -54,12 +59,12 @@ void TrajectoryPoints::_vehicleCoordinateChanged(QGeoCoordinate coordinate)
 void TrajectoryPoints::start(void)
 {
     clear();
-    connect(_vehicle, &Vehicle::coordinateChanged, this, &TrajectoryPoints::_vehicleCoordinateChanged);
+    connect(_vehicle, &Vehicle::stateSnapshotChanged, this, &TrajectoryPoints::_vehicleStateSnapshotChanged);
 }
 
 void TrajectoryPoints::stop(void)
 {
-    disconnect(_vehicle, &Vehicle::coordinateChanged, this, &TrajectoryPoints::_vehicleCoordinateChanged);
+    disconnect(_vehicle, &Vehicle::stateSnapshotChanged, this, &TrajectoryPoints::_vehicleStateSnapshotChanged);
 }
 
 void TrajectoryPoints::clear(void)
@@ -14,6 +14,7 @@
 #include <QtCore/QVariantList>
 
 class Vehicle;
+struct VehicleStateSnapshot;
 
 class TrajectoryPoints : public QObject
 {
@@ -36,7 +37,7 @@ public slots:
     void pointsCleared  (void);
 
 private slots:
-    void _vehicleCoordinateChanged(QGeoCoordinate coordinate);
+    void _vehicleStateSnapshotChanged(const VehicleStateSnapshot& snapshot);
 
 private:
     Vehicle*        _vehicle;
@@ -14,6 +14,7 @@
 #include "AutoPilotPlugin.h"
 #include "ComponentInformationManager.h"
 #include "EventHandler.h"
+#include "FactGroupUpdateScheduler.h"
 #include "FirmwarePlugin.h"
 #include "FirmwarePluginManager.h"
 #include "FTPManager.h"
@@ -38,6 +39,7 @@
 #include "QGCImageProvider.h"
 #include "QGCLoggingCategory.h"
 #include "QGCQGeoCoordinate.h"
+#include "QGCSignalCoalescer.h"
 #include "RallyPointManager.h"
 #include "RemoteIDManager.h"
 #include "SettingsManager.h"
@@ -46,9 +48,11 @@
 #include "StandardModes.h"
 #include "TerrainProtocolHandler.h"
 #include "TerrainQuery.h"
+#include "TelemetryHistory.h"
 #include "TrajectoryPoints.h"
 #include "VehicleBatteryFactGroup.h"
 #include "VehicleLinkManager.h"
+#include "VehicleMessageDecimator.h"
 #include "VehicleObjectAvoidance.h"
 #include "VideoManager.h"
 #include "VideoSettings.h"
@@ -98,24 +102,15 @@ Vehicle::Vehicle(LinkInterface*             link,
     , _defaultCruiseSpeed           (SettingsManager::instance()->appSettings()->offlineEditingCruiseSpeed()->rawValue().toDouble())
     , _defaultHoverSpeed            (SettingsManager::instance()->appSettings()->offlineEditingHoverSpeed()->rawValue().toDouble())
     , _trajectoryPoints             (new TrajectoryPoints(this, this))
+    , _telemetryHistory             (new TelemetryHistory(TelemetryHistory::kDefaultHistorySeconds, this))
     , _mavlinkStreamConfig          (std::bind(&Vehicle::_setMessageInterval, this, std::placeholders::_1, std::placeholders::_2))
     , _vehicleFactGroup             (this)
     , _gpsFactGroup                 (this)
-    , _gps2FactGroup                (this)
-    , _windFactGroup                (this)
-    , _vibrationFactGroup           (this)
-    , _temperatureFactGroup         (this)
     , _clockFactGroup               (this)
+    , _linkStatisticsFactGroup      (this)
     , _setpointFactGroup            (this)
-    , _distanceSensorFactGroup      (this)
     , _localPositionFactGroup       (this)
     , _localPositionSetpointFactGroup(this)
-    , _escStatusFactGroup           (this)
-    , _estimatorStatusFactGroup     (this)
-    , _hygrometerFactGroup          (this)
-    , _generatorFactGroup           (this)
-    , _efiFactGroup                 (this)
-    , _rpmFactGroup                 (this)
     , _terrainFactGroup             (this)
     , _terrainProtocolHandler       (new TerrainProtocolHandler(this, &_terrainFactGroup, this))
 {
@@ -124,8 +119,28 @@ Vehicle::Vehicle(LinkInterface*             link,
 
     qCDebug(VehicleLog) << "Link started with Mavlink " << (MAVLinkProtocol::instance()->getCurrentVersion() >= 200 ? "V2" : "V1");
 
-    connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
-    connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
+    // Messages from this vehicle go through the decimator, tlogs and forwarding are fed by MAVLinkProtocol and still see every message
+    _messageDecimator = new VehicleMessageDecimator([this](LinkInterface *link, const mavlink_message_t &message) {
+        _mavlinkMessageReceived(link, message);
+    }, this);
+    Fact *const decimationRateFact = SettingsManager::instance()->mavlinkSettings()->telemetryDecimationRate();
+    _messageDecimator->setDefaultMaxRate(decimationRateFact->rawValue().toDouble());
+    connect(decimationRateFact, &Fact::rawValueChanged, this, [this](const QVariant &value) {
+        _messageDecimator->setDefaultMaxRate(value.toDouble());
+    });
+    connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::messageReceived, this, [this](LinkInterface *link, const mavlink_message_t &message) {
+        if (message.sysid == _id) {
+            _messageDecimator->messageReceived(link, message);
+        } else {
+            _mavlinkMessageReceived(link, message);
+        }
+    });
+
+    // Receive statistics are sampled, they are kept by MAVLinkProtocol for every link/system/component
+    _linkStatisticsTimer.setInterval(1000);
+    _linkStatisticsTimer.setSingleShot(false);
+    connect(&_linkStatisticsTimer, &QTimer::timeout, this, &Vehicle::_updateLinkStatistics);
+    _linkStatisticsTimer.start();
 
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
     connect(this, &Vehicle::armedChanged,               this, &Vehicle::_announceArmedChanged);
@@ -209,14 +224,12 @@ Vehicle::Vehicle(MAV_AUTOPILOT              firmwareType,
     , _capabilityBitsKnown              (true)
     , _capabilityBits                   (MAV_PROTOCOL_CAPABILITY_MISSION_FENCE | MAV_PROTOCOL_CAPABILITY_MISSION_RALLY)
     , _trajectoryPoints                 (new TrajectoryPoints(this, this))
+    , _telemetryHistory                 (new TelemetryHistory(TelemetryHistory::kDefaultHistorySeconds, this))
     , _mavlinkStreamConfig              (std::bind(&Vehicle::_setMessageInterval, this, std::placeholders::_1, std::placeholders::_2))
     , _vehicleFactGroup                 (this)
     , _gpsFactGroup                     (this)
-    , _gps2FactGroup                    (this)
-    , _windFactGroup                    (this)
-    , _vibrationFactGroup               (this)
     , _clockFactGroup                   (this)
-    , _distanceSensorFactGroup          (this)
+    , _linkStatisticsFactGroup          (this)
     , _localPositionFactGroup           (this)
     , _localPositionSetpointFactGroup   (this)
 {
@@ -256,11 +269,16 @@ void Vehicle::_commonInit()
     connect(_firmwarePlugin, &FirmwarePlugin::toolIndicatorsChanged, this, &Vehicle::toolIndicatorsChanged);
     connect(_firmwarePlugin, &FirmwarePlugin::modeIndicatorsChanged, this, &Vehicle::modeIndicatorsChanged);
 
-    connect(this, &Vehicle::coordinateChanged,      this, &Vehicle::_updateDistanceHeadingToHome);
-    connect(this, &Vehicle::coordinateChanged,      this, &Vehicle::_updateDistanceToGCS);
+    // Position updates are coalesced to one stateSnapshotChanged per UI frame
+    _stateSnapshotTimer.setSingleShot(true);
+    connect(&_stateSnapshotTimer, &QTimer::timeout, this, &Vehicle::_publishStateSnapshot);
+    connect(this, &Vehicle::coordinateChanged,      this, &Vehicle::_scheduleStateSnapshot);
+
+    connect(this, &Vehicle::stateSnapshotChanged,   this, &Vehicle::_updateDistanceHeadingToHome);
+    connect(this, &Vehicle::stateSnapshotChanged,   this, &Vehicle::_updateDistanceToGCS);
     connect(this, &Vehicle::homePositionChanged,    this, &Vehicle::_updateDistanceHeadingToHome);
     connect(this, &Vehicle::hobbsMeterChanged,      this, &Vehicle::_updateHobbsMeter);
-    connect(this, &Vehicle::coordinateChanged,      this, &Vehicle::_updateAltAboveTerrain);
+    connect(this, &Vehicle::stateSnapshotChanged,   this, &Vehicle::_updateAltAboveTerrain);
     // Initialize alt above terrain to Nan so frontend can display it correctly in case the terrain query had no response
     _altitudeAboveTerrFact.setRawValue(qQNaN());
 
@@ -320,23 +338,27 @@ void Vehicle::_commonInit()
     _createStatusTextHandler();
     _createMAVLinkLogManager();
 
+    // Fact groups are added at runtime as well (batteries), so handlers are registered again on the next message
+    connect(this, &FactGroup::factGroupNamesChanged, this, [this]() { _messageDispatcherDirty = true; });
+
     // _addFactGroup(_vehicleFactGroup,            _vehicleFactGroupName);
     _addFactGroup(&_gpsFactGroup,               _gpsFactGroupName);
-    _addFactGroup(&_gps2FactGroup,              _gps2FactGroupName);
-    _addFactGroup(&_windFactGroup,              _windFactGroupName);
-    _addFactGroup(&_vibrationFactGroup,         _vibrationFactGroupName);
-    _addFactGroup(&_temperatureFactGroup,       _temperatureFactGroupName);
+    _addLazyFactGroup<VehicleGPS2FactGroup>(_gps2FactGroupName);
+    _addLazyFactGroup<VehicleWindFactGroup>(_windFactGroupName);
+    _addLazyFactGroup<VehicleVibrationFactGroup>(_vibrationFactGroupName);
+    _addLazyFactGroup<VehicleTemperatureFactGroup>(_temperatureFactGroupName);
     _addFactGroup(&_clockFactGroup,             _clockFactGroupName);
+    _addFactGroup(&_linkStatisticsFactGroup,    _linkStatisticsFactGroupName);
     _addFactGroup(&_setpointFactGroup,          _setpointFactGroupName);
-    _addFactGroup(&_distanceSensorFactGroup,    _distanceSensorFactGroupName);
+    _addLazyFactGroup<VehicleDistanceSensorFactGroup>(_distanceSensorFactGroupName);
     _addFactGroup(&_localPositionFactGroup,     _localPositionFactGroupName);
     _addFactGroup(&_localPositionSetpointFactGroup,_localPositionSetpointFactGroupName);
-    _addFactGroup(&_escStatusFactGroup,         _escStatusFactGroupName);
-    _addFactGroup(&_estimatorStatusFactGroup,   _estimatorStatusFactGroupName);
-    _addFactGroup(&_hygrometerFactGroup,        _hygrometerFactGroupName);
-    _addFactGroup(&_generatorFactGroup,         _generatorFactGroupName);
-    _addFactGroup(&_efiFactGroup,               _efiFactGroupName);
-    _addFactGroup(&_rpmFactGroup,               _rpmFactGroupName);
+    _addLazyFactGroup<VehicleEscStatusFactGroup>(_escStatusFactGroupName);
+    _addLazyFactGroup<VehicleEstimatorStatusFactGroup>(_estimatorStatusFactGroupName);
+    _addLazyFactGroup<VehicleHygrometerFactGroup>(_hygrometerFactGroupName);
+    _addLazyFactGroup<VehicleGeneratorFactGroup>(_generatorFactGroupName);
+    _addLazyFactGroup<VehicleEFIFactGroup>(_efiFactGroupName);
+    _addLazyFactGroup<VehicleRPMFactGroup>(_rpmFactGroupName);
     _addFactGroup(&_terrainFactGroup,           _terrainFactGroupName);
 
     // Add firmware-specific fact groups, if provided
@@ -347,6 +369,9 @@ void Vehicle::_commonInit()
         }
     }
 
+    // Fact groups added later on are recorded as well
+    setTelemetryHistory(_telemetryHistory);
+
     _flightDistanceFact.setRawValue(0);
     _flightTimeFact.setRawValue(0);
     _flightTimeUpdater.setInterval(1000);
@@ -453,7 +478,7 @@ void Vehicle::resetCounters()
     _messagesReceived   = 0;
     _messagesSent       = 0;
     _messagesLost       = 0;
-    _messageSeq         = 0;
+    _messagesLostAtReset = _mavlinkLossCount;
     _heardFrom          = false;
 }
 
@@ -476,30 +501,12 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     // We give the link manager first whack since it it reponsible for adding new links
     _vehicleLinkManager->mavlinkMessageReceived(link, message);
 
-    //-- Check link status
+    //-- Check link status, losses are counted by MAVLinkProtocol, see _updateLinkStatistics
     _messagesReceived++;
     emit messagesReceivedChanged();
-    if(!_heardFrom) {
-        if(message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-            _heardFrom  = true;
-            _compID     = message.compid;
-            _messageSeq = message.seq + 1;
-        }
-    } else {
-        if(_compID == message.compid) {
-            uint16_t seq_received = static_cast<uint16_t>(message.seq);
-            uint16_t packet_lost_count = 0;
-            //-- Account for overflow during packet loss
-            if(seq_received < _messageSeq) {
-                packet_lost_count = (seq_received + 255) - _messageSeq;
-            } else {
-                packet_lost_count = seq_received - _messageSeq;
-            }
-            _messageSeq = message.seq + 1;
-            _messagesLost += packet_lost_count;
-            if(packet_lost_count)
-                emit messagesLostChanged();
-        }
+    if(!_heardFrom && message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        _heardFrom  = true;
+        _compID     = message.compid;
     }
 
     // Give the plugin a change to adjust the message contents
@@ -515,22 +522,20 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     if (!_terrainProtocolHandler->mavlinkMessageReceived(message)) {
         return;
     }
-    _ftpManager->_mavlinkMessageReceived(message);
-    _parameterManager->mavlinkMessageReceived(message);
-    (void) QMetaObject::invokeMethod(_imageProtocolManager, "mavlinkMessageReceived", Qt::AutoConnection, message);
-    _remoteIDManager->mavlinkMessageReceived(message);
-
-    _waitForMavlinkMessageMessageReceivedHandler(message);
 
-    // Battery fact groups are created dynamically as new batteries are discovered
+    // Battery fact groups are created dynamically as new batteries are discovered. This must happen ahead of
+    // dispatching so a new battery fact group sees the message which created it.
     VehicleBatteryFactGroup::handleMessageForFactGroupCreation(this, message);
 
-    // Let the fact groups take a whack at the mavlink traffic
-    for (FactGroup* factGroup : factGroups()) {
-        factGroup->handleMessage(this, message);
+    if (_messageDispatcherDirty) {
+        _buildMessageDispatcher();
     }
 
-    this->handleMessage(this, message);
+    QElapsedTimer handlerTimer;
+    handlerTimer.start();
+
+    // Managers and fact groups only see the message ids they registered for
+    _messageDispatcher.dispatch(message);
 
     switch (message.msgid) {
     case MAVLINK_MSG_ID_HOME_POSITION:
@@ -662,11 +667,75 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         break;
     }
 
+    _messageDispatcher.addHandlerTime(message.msgid, handlerTimer.nsecsElapsed());
+
     // This must be emitted after the vehicle processes the message. This way the vehicle state is up to date when anyone else
     // does processing.
     emit mavlinkMessageReceived(message);
 }
 
+void Vehicle::_buildMessageDispatcher()
+{
+    _messageDispatcherDirty = false;
+    _messageDispatcher.clearHandlers();
+
+    _messageDispatcher.addHandler(MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL, [this](const mavlink_message_t &message) {
+        _ftpManager->_mavlinkMessageReceived(message);
+    });
+    _messageDispatcher.addHandler(MAVLINK_MSG_ID_PARAM_VALUE, [this](const mavlink_message_t &message) {
+        _parameterManager->mavlinkMessageReceived(message);
+    });
+    _messageDispatcher.addHandler({ MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE, MAVLINK_MSG_ID_ENCAPSULATED_DATA }, [this](const mavlink_message_t &message) {
+        _imageProtocolManager->mavlinkMessageReceived(message);
+    });
+    _messageDispatcher.addHandler(MAVLINK_MSG_ID_OPEN_DRONE_ID_ARM_STATUS, [this](const mavlink_message_t &message) {
+        mavlink_message_t remoteIDMessage = message;
+        _remoteIDManager->mavlinkMessageReceived(remoteIDMessage);
+    });
+
+    // Anyone can wait for any message
+    _messageDispatcher.addHandlerForAllMessages([this](const mavlink_message_t &message) {
+        _waitForMavlinkMessageMessageReceivedHandler(message);
+    });
+
+    // Attitude, speed and altitude only show up in the state snapshot, position changes come through coordinateChanged
+    _messageDispatcher.addHandler({ MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_ATTITUDE_QUATERNION, MAVLINK_MSG_ID_ALTITUDE, MAVLINK_MSG_ID_VFR_HUD, MAVLINK_MSG_ID_GLOBAL_POSITION_INT }, [this](const mavlink_message_t &message) {
+        Q_UNUSED(message);
+        _scheduleStateSnapshot();
+    });
+
+    const auto addFactGroupHandler = [this](FactGroup *factGroup) {
+        const QList<uint32_t> msgids = factGroup->handledMessageIds();
+        const auto handler = [this, factGroup](const mavlink_message_t &message) {
+            factGroup->handleMessage(this, message);
+        };
+        if (msgids.isEmpty()) {
+            _messageDispatcher.addHandlerForAllMessages(handler);
+        } else {
+            _messageDispatcher.addHandler(msgids, handler);
+        }
+    };
+
+    for (FactGroup *factGroup : factGroups()) {
+        addFactGroupHandler(factGroup);
+    }
+    addFactGroupHandler(this);
+
+    // Fact groups not used so far are created by their first message. Creating one marks the dispatcher dirty, so
+    // from the next message on it is dispatched to like the others.
+    for (auto it = lazyFactGroups().cbegin(); it != lazyFactGroups().cend(); ++it) {
+        const QString name = it.key();
+        const auto handler = [this, name](const mavlink_message_t &message) {
+            getFactGroup(name)->handleMessage(this, message);
+        };
+        if (it.value().handledMessageIds.isEmpty()) {
+            _messageDispatcher.addHandlerForAllMessages(handler);
+        } else {
+            _messageDispatcher.addHandler(it.value().handledMessageIds, handler);
+        }
+    }
+}
+
 #if !defined(QGC_NO_ARDUPILOT_DIALECT)
 void Vehicle::_handleCameraFeedback(const mavlink_message_t& message)
 {
@@ -776,6 +845,30 @@ void Vehicle::_handleGlobalPositionInt(mavlink_message_t& message)
     }
 }
 
+void Vehicle::_scheduleStateSnapshot()
+{
+    // Latest values win, the snapshot is taken when the timer fires
+    if (!_stateSnapshotTimer.isActive()) {
+        _stateSnapshotTimer.start(FactGroupUpdateScheduler::instance()->tickIntervalMSecs());
+    }
+}
+
+void Vehicle::_publishStateSnapshot()
+{
+    _stateSnapshot.coordinate       = _coordinate;
+    _stateSnapshot.roll             = _rollFact.rawValue().toDouble();
+    _stateSnapshot.pitch            = _pitchFact.rawValue().toDouble();
+    _stateSnapshot.heading          = _headingFact.rawValue().toDouble();
+    _stateSnapshot.groundSpeed      = _groundSpeedFact.rawValue().toDouble();
+    _stateSnapshot.airSpeed         = _airSpeedFact.rawValue().toDouble();
+    _stateSnapshot.climbRate        = _climbRateFact.rawValue().toDouble();
+    _stateSnapshot.altitudeRelative = _altitudeRelativeFact.rawValue().toDouble();
+    _stateSnapshot.altitudeAMSL     = _altitudeAMSLFact.rawValue().toDouble();
+    _stateSnapshot.timestampMSecs   = QDateTime::currentMSecsSinceEpoch();
+
+    emit stateSnapshotChanged(_stateSnapshot);
+}
+
 // TODO: VehicleFactGroup
 void Vehicle::_handleHighLatency(mavlink_message_t& message)
 {
@@ -1498,7 +1591,7 @@ bool Vehicle::sendMessageOnLinkThreadSafe(LinkInterface* link, mavlink_message_t
     uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
     int len = mavlink_msg_to_send_buffer(buffer, &message);
 
-    link->writeBytesThreadSafe((const char*)buffer, len);
+    link->writeBytesThreadSafe((const char*)buffer, len, LinkOutboundQueue::priorityForMessage(message.msgid));
     _messagesSent++;
     emit messagesSentChanged();
 
@@ -3538,14 +3631,27 @@ void Vehicle::_vehicleParamLoaded(bool ready)
     }
 }
 
-void Vehicle::_mavlinkMessageStatus(int uasId, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent)
+void Vehicle::_updateLinkStatistics()
 {
-    if(uasId == _id) {
-        _mavlinkSentCount       = totalSent;
-        _mavlinkReceivedCount   = totalReceived;
-        _mavlinkLossCount       = totalLoss;
-        _mavlinkLossPercent     = lossPercent;
-        emit mavlinkStatusChanged();
+    const SharedLinkInterfacePtr sharedLink = vehicleLinkManager()->primaryLink().lock();
+    if (!sharedLink || !_heardFrom) {
+        return;
+    }
+
+    const MAVLinkStatistics::Snapshot snapshot = MAVLinkProtocol::instance()->statistics(sharedLink->mavlinkChannel(), static_cast<uint8_t>(_id), _compID);
+    _linkStatisticsFactGroup.update(snapshot);
+
+    _mavlinkSentCount       = snapshot.received + snapshot.lost;
+    _mavlinkReceivedCount   = snapshot.received;
+    _mavlinkLossCount       = snapshot.lost;
+    _mavlinkLossPercent     = static_cast<float>(snapshot.windowLossPercent());
+    emit mavlinkStatusChanged();
+
+    // The statistics keep counting across resetCounters
+    const quint64 messagesLost = (snapshot.lost >= _messagesLostAtReset) ? (snapshot.lost - _messagesLostAtReset) : snapshot.lost;
+    if (_messagesLost != messagesLost) {
+        _messagesLost = static_cast<uint>(messagesLost);
+        emit messagesLostChanged();
     }
 }
 
@@ -4376,10 +4482,12 @@ void Vehicle::sendSetupSigning()
 void Vehicle::_createImageProtocolManager()
 {
     _imageProtocolManager = new ImageProtocolManager(this);
-    (void) connect(_imageProtocolManager, &ImageProtocolManager::flowImageIndexChanged, this, &Vehicle::flowImageIndexChanged);
-    (void) connect(_imageProtocolManager, &ImageProtocolManager::imageReady, this, [this](const QImage &image) {
+    // Only the latest image is shown. Both go through coalescing connections so the image is set before the index
+    // change makes the UI reload it.
+    (void) QGCSignalCoalescer::connect(_imageProtocolManager, &ImageProtocolManager::imageReady, this, [this](const QImage &image) {
         qgcApp()->qgcImageProvider()->setImage(image, _id);
     });
+    (void) QGCSignalCoalescer::connect(_imageProtocolManager, &ImageProtocolManager::flowImageIndexChanged, this, &Vehicle::flowImageIndexChanged);
 }
 
 uint32_t Vehicle::flowImageIndex() const
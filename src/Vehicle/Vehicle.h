@@ -25,10 +25,13 @@
 #include "QmlObjectListModel.h"
 #include "SysStatusSensorInfo.h"
 #include "VehicleLinkManager.h"
+#include "VehicleMessageDispatcher.h"
+#include "VehicleStateSnapshot.h"
 
 #include "TerrainFactGroup.h"
 #include "VehicleFactGroup.h"
 #include "VehicleClockFactGroup.h"
+#include "VehicleLinkStatisticsFactGroup.h"
 #include "VehicleDistanceSensorFactGroup.h"
 #include "VehicleEFIFactGroup.h"
 #include "VehicleEscStatusFactGroup.h"
@@ -71,8 +74,10 @@ class SendMavCommandWithSignallingTest;
 class StandardModes;
 class TerrainAtCoordinateQuery;
 class TerrainProtocolHandler;
+class TelemetryHistory;
 class TrajectoryPoints;
 class VehicleBatteryFactGroup;
+class VehicleMessageDecimator;
 class VehicleObjectAvoidance;
 class GimbalController;
 #ifdef QGC_UTM_ADAPTER
@@ -91,6 +96,7 @@ class Vehicle : public VehicleFactGroup
 {
     Q_OBJECT
     Q_MOC_INCLUDE("AutoPilotPlugin.h")
+    Q_MOC_INCLUDE("TelemetryHistory.h")
     Q_MOC_INCLUDE("TrajectoryPoints.h")
     Q_MOC_INCLUDE("ParameterManager.h")
     Q_MOC_INCLUDE("VehicleObjectAvoidance.h")
@@ -144,6 +150,8 @@ class Vehicle : public VehicleFactGroup
     Q_PROPERTY(QStringList          flightModes                 READ flightModes                                                    NOTIFY flightModesChanged)
     Q_PROPERTY(QString              flightMode                  READ flightMode                 WRITE setFlightMode                 NOTIFY flightModeChanged)
     Q_PROPERTY(TrajectoryPoints*    trajectoryPoints            MEMBER _trajectoryPoints                                            CONSTANT)
+    Q_PROPERTY(TelemetryHistory*    telemetryHistory            READ telemetryHistory                                               CONSTANT)
+    Q_PROPERTY(VehicleStateSnapshot stateSnapshot               READ stateSnapshot                                                  NOTIFY stateSnapshotChanged)
     Q_PROPERTY(QmlObjectListModel*  cameraTriggerPoints         READ cameraTriggerPoints                                            CONSTANT)
     Q_PROPERTY(float                latitude                    READ latitude                                                       NOTIFY coordinateChanged)
     Q_PROPERTY(float                longitude                   READ longitude                                                      NOTIFY coordinateChanged)
@@ -259,6 +267,7 @@ class Vehicle : public VehicleFactGroup
     Q_PROPERTY(FactGroup*           vibration       READ vibrationFactGroup         CONSTANT)
     Q_PROPERTY(FactGroup*           temperature     READ temperatureFactGroup       CONSTANT)
     Q_PROPERTY(FactGroup*           clock           READ clockFactGroup             CONSTANT)
+    Q_PROPERTY(FactGroup*           linkStatistics  READ linkStatisticsFactGroup    CONSTANT)
     Q_PROPERTY(FactGroup*           setpoint        READ setpointFactGroup          CONSTANT)
     Q_PROPERTY(FactGroup*           escStatus       READ escStatusFactGroup         CONSTANT)
     Q_PROPERTY(FactGroup*           estimatorStatus READ estimatorStatusFactGroup   CONSTANT)
@@ -510,6 +519,10 @@ class Vehicle : public VehicleFactGroup
     void setPrearmError(const QString& prearmError);
 
     QmlObjectListModel* cameraTriggerPoints () { return &_cameraTriggerPoints; }
+    TelemetryHistory*   telemetryHistory    () { return _telemetryHistory; }
+
+    /// Latest coalesced position/attitude/velocity state, see stateSnapshotChanged
+    const VehicleStateSnapshot& stateSnapshot() const { return _stateSnapshot; }
 
     //-- Mavlink Logging
     void startMavlinkLog();
@@ -594,22 +607,23 @@ class Vehicle : public VehicleFactGroup
 
     FactGroup* vehicleFactGroup             () { return _vehicleFactGroup; }
     FactGroup* gpsFactGroup                 () { return &_gpsFactGroup; }
-    FactGroup* gps2FactGroup                () { return &_gps2FactGroup; }
-    FactGroup* windFactGroup                () { return &_windFactGroup; }
-    FactGroup* vibrationFactGroup           () { return &_vibrationFactGroup; }
-    FactGroup* temperatureFactGroup         () { return &_temperatureFactGroup; }
+    FactGroup* gps2FactGroup                () { return getFactGroup(_gps2FactGroupName); }
+    FactGroup* windFactGroup                () { return getFactGroup(_windFactGroupName); }
+    FactGroup* vibrationFactGroup           () { return getFactGroup(_vibrationFactGroupName); }
+    FactGroup* temperatureFactGroup         () { return getFactGroup(_temperatureFactGroupName); }
     FactGroup* clockFactGroup               () { return &_clockFactGroup; }
+    FactGroup* linkStatisticsFactGroup      () { return &_linkStatisticsFactGroup; }
     FactGroup* setpointFactGroup            () { return &_setpointFactGroup; }
-    FactGroup* distanceSensorFactGroup      () { return &_distanceSensorFactGroup; }
+    FactGroup* distanceSensorFactGroup      () { return getFactGroup(_distanceSensorFactGroupName); }
     FactGroup* localPositionFactGroup       () { return &_localPositionFactGroup; }
     FactGroup* localPositionSetpointFactGroup() { return &_localPositionSetpointFactGroup; }
-    FactGroup* escStatusFactGroup           () { return &_escStatusFactGroup; }
-    FactGroup* estimatorStatusFactGroup     () { return &_estimatorStatusFactGroup; }
+    FactGroup* escStatusFactGroup           () { return getFactGroup(_escStatusFactGroupName); }
+    FactGroup* estimatorStatusFactGroup     () { return getFactGroup(_estimatorStatusFactGroupName); }
     FactGroup* terrainFactGroup             () { return &_terrainFactGroup; }
-    FactGroup* hygrometerFactGroup          () { return &_hygrometerFactGroup; }
-    FactGroup* generatorFactGroup           () { return &_generatorFactGroup; }
-    FactGroup* efiFactGroup                 () { return &_efiFactGroup; }
-    FactGroup* rpmFactGroup                 () { return &_rpmFactGroup; }
+    FactGroup* hygrometerFactGroup          () { return getFactGroup(_hygrometerFactGroupName); }
+    FactGroup* generatorFactGroup           () { return getFactGroup(_generatorFactGroupName); }
+    FactGroup* efiFactGroup                 () { return getFactGroup(_efiFactGroupName); }
+    FactGroup* rpmFactGroup                 () { return getFactGroup(_rpmFactGroupName); }
     QmlObjectListModel* batteries           () { return &_batteryFactGroupListModel; }
 
     MissionManager*                 missionManager      () { return _missionManager; }
@@ -618,12 +632,16 @@ class Vehicle : public VehicleFactGroup
     ParameterManager*               parameterManager    () { return _parameterManager; }
     ParameterManager*               parameterManager    () const { return _parameterManager; }
     VehicleLinkManager*             vehicleLinkManager  () { return _vehicleLinkManager; }
+    VehicleMessageDecimator*        messageDecimator    () { return _messageDecimator; }
     FTPManager*                     ftpManager          () { return _ftpManager; }
     ComponentInformationManager*    compInfoManager     () { return _componentInformationManager; }
     VehicleObjectAvoidance*         objectAvoidance     () { return _objectAvoidance; }
     Autotune*                       autotune            () const { return _autotune; }
     RemoteIDManager*                remoteIDManager     () { return _remoteIDManager; }
 
+    /// Per message id handler table, also provides the time spent handling each message id
+    const VehicleMessageDispatcher& messageDispatcher   () const { return _messageDispatcher; }
+
     static void showCommandAckError(const mavlink_command_ack_t& ack);
 
     /// Sends the specified MAV_CMD to the vehicle. If no Ack is received command will be retried. If a sendMavCommand is already in progress
@@ -803,7 +821,7 @@ class Vehicle : public VehicleFactGroup
     quint64     mavlinkSentCount        () const{ return _mavlinkSentCount; }        /// Calculated total number of messages sent to us
     quint64     mavlinkReceivedCount    () const{ return _mavlinkReceivedCount; }    /// Total number of sucessful messages received
     quint64     mavlinkLossCount        () const{ return _mavlinkLossCount; }        /// Total number of lost messages
-    float       mavlinkLossPercent      () const{ return _mavlinkLossPercent; }      /// Running loss rate
+    float       mavlinkLossPercent      () const{ return _mavlinkLossPercent; }      /// Loss rate of the last MAVLinkStatistics::kWindowSeconds
 
     bool        isROIEnabled            () const{ return _isROIEnabled; }
 
@@ -826,6 +844,10 @@ public slots:
 
 signals:
     void coordinateChanged              (QGeoCoordinate coordinate);
+    /// Signalled at most once per UI frame with the state collected from all position and attitude messages since the
+    /// last one. Listeners which do not need every single update should use this instead of coordinateChanged and the
+    /// individual Fact signals.
+    void stateSnapshotChanged           (const VehicleStateSnapshot& snapshot);
     void joystickEnabledChanged         (bool enabled);
     void mavlinkMessageReceived         (const mavlink_message_t& message);
     void homePositionChanged            (const QGeoCoordinate& homePosition);
@@ -941,16 +963,18 @@ private slots:
     void _updateHobbsMeter                  ();
     void _vehicleParamLoaded                (bool ready);
     void _sendQGCTimeToVehicle              ();
-    void _mavlinkMessageStatus              (int uasId, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent);
+    void _updateLinkStatistics              ();
     void _orbitTelemetryTimeout             ();
     void _updateFlightTime                  ();
     void _gotProgressUpdate                 (float progressValue);
     void _doSetHomeTerrainReceived          (bool success, QList<double> heights);
     void _updateAltAboveTerrain             ();
     void _altitudeAboveTerrainReceived      (bool sucess, QList<double> heights);
+    void _publishStateSnapshot              ();
 
 private:
     void _loadJoystickSettings          ();
+    void _scheduleStateSnapshot         ();
     void _activeVehicleChanged          (Vehicle* newActiveVehicle);
     void _captureJoystick               ();
     void _handlePing                    (LinkInterface* link, mavlink_message_t& message);
@@ -1099,7 +1123,11 @@ private slots:
 
     QElapsedTimer                   _flightTimer;
     QTimer                          _flightTimeUpdater;
+    QTimer                          _linkStatisticsTimer;
     TrajectoryPoints*               _trajectoryPoints = nullptr;
+    TelemetryHistory*               _telemetryHistory = nullptr;    ///< Last minutes of all FactGroup values
+    QTimer                          _stateSnapshotTimer;            ///< Pending stateSnapshotChanged, single shot
+    VehicleStateSnapshot            _stateSnapshot;
     QmlObjectListModel              _cameraTriggerPoints;
     //QMap<QString, ADSBVehicle*>     _trafficVehicleMap;
 
@@ -1108,7 +1136,7 @@ private slots:
     uint                _messagesReceived = 0;
     uint                _messagesSent = 0;
     uint                _messagesLost = 0;
-    uint8_t             _messageSeq = 0;
+    quint64             _messagesLostAtReset = 0;   ///< Statistics loss count at the last resetCounters
     uint8_t             _compID = 0;
     bool                _heardFrom = false;
 
@@ -1162,6 +1190,9 @@ private slots:
 
     void _waitForMavlinkMessageMessageReceivedHandler(const mavlink_message_t& message);
 
+    /// Registers the message handlers of the vehicle, its managers and fact groups with _messageDispatcher
+    void _buildMessageDispatcher();
+
     // requestMessage handling
 
     typedef struct RequestMessageInfo {
@@ -1240,6 +1271,7 @@ private slots:
     const QString _vibrationFactGroupName =          QStringLiteral("vibration");
     const QString _temperatureFactGroupName =        QStringLiteral("temperature");
     const QString _clockFactGroupName =              QStringLiteral("clock");
+    const QString _linkStatisticsFactGroupName =     QStringLiteral("linkStatistics");
     const QString _setpointFactGroupName =           QStringLiteral("setpoint");
     const QString _distanceSensorFactGroupName =     QStringLiteral("distanceSensor");
     const QString _localPositionFactGroupName =      QStringLiteral("localPosition");
@@ -1254,26 +1286,20 @@ private slots:
 
     VehicleFactGroup*               _vehicleFactGroup;
     VehicleGPSFactGroup             _gpsFactGroup;
-    VehicleGPS2FactGroup            _gps2FactGroup;
-    VehicleWindFactGroup            _windFactGroup;
-    VehicleVibrationFactGroup       _vibrationFactGroup;
-    VehicleTemperatureFactGroup     _temperatureFactGroup;
     VehicleClockFactGroup           _clockFactGroup;
+    VehicleLinkStatisticsFactGroup  _linkStatisticsFactGroup;
     VehicleSetpointFactGroup        _setpointFactGroup;
-    VehicleDistanceSensorFactGroup  _distanceSensorFactGroup;
     VehicleLocalPositionFactGroup   _localPositionFactGroup;
     VehicleLocalPositionSetpointFactGroup _localPositionSetpointFactGroup;
-    VehicleEscStatusFactGroup       _escStatusFactGroup;
-    VehicleEstimatorStatusFactGroup _estimatorStatusFactGroup;
-    VehicleHygrometerFactGroup      _hygrometerFactGroup;
-    VehicleGeneratorFactGroup       _generatorFactGroup;
-    VehicleEFIFactGroup             _efiFactGroup;
-    VehicleRPMFactGroup             _rpmFactGroup;
     TerrainFactGroup                _terrainFactGroup;
     QmlObjectListModel              _batteryFactGroupListModel;
 
     TerrainProtocolHandler* _terrainProtocolHandler = nullptr;
 
+    VehicleMessageDispatcher        _messageDispatcher;
+    bool                            _messageDispatcherDirty     = true; ///< Fact groups changed, handlers must be registered again
+    VehicleMessageDecimator*        _messageDecimator           = nullptr;  ///< Rate limits high rate streams of this vehicle before they are handled
+
     MissionManager*                 _missionManager             = nullptr;
     GeoFenceManager*                _geoFenceManager            = nullptr;
     RallyPointManager*              _rallyPointManager          = nullptr;
@@ -0,0 +1,215 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleMessageDecimator.h"
+#include "LinkInterface.h"
+#include "QGCMAVLink.h"
+#include "QGCLoggingCategory.h"
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(VehicleMessageDecimatorLog, "qgc.vehicle.vehiclemessagedecimator")
+
+VehicleMessageDecimator::VehicleMessageDecimator(const Handler &handler, QObject *parent)
+    : QObject(parent)
+    , _handler(handler)
+{
+    // qCDebug(VehicleMessageDecimatorLog) << Q_FUNC_INFO << this;
+
+    _clock.start();
+
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setTimerType(Qt::PreciseTimer);
+    (void) connect(&_flushTimer, &QTimer::timeout, this, &VehicleMessageDecimator::_flush);
+}
+
+VehicleMessageDecimator::~VehicleMessageDecimator()
+{
+    // qCDebug(VehicleMessageDecimatorLog) << Q_FUNC_INFO << this;
+}
+
+QList<uint32_t> VehicleMessageDecimator::defaultDecimatedMessageIds()
+{
+    static const QList<uint32_t> msgids = {
+        MAVLINK_MSG_ID_ATTITUDE,
+        MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+        MAVLINK_MSG_ID_ATTITUDE_TARGET,
+        MAVLINK_MSG_ID_HIGHRES_IMU,
+        MAVLINK_MSG_ID_RAW_IMU,
+        MAVLINK_MSG_ID_SCALED_IMU,
+        MAVLINK_MSG_ID_SCALED_IMU2,
+        MAVLINK_MSG_ID_SCALED_IMU3,
+        MAVLINK_MSG_ID_SCALED_PRESSURE,
+        MAVLINK_MSG_ID_VFR_HUD,
+        MAVLINK_MSG_ID_ALTITUDE,
+        MAVLINK_MSG_ID_GLOBAL_POSITION_INT,
+        MAVLINK_MSG_ID_LOCAL_POSITION_NED,
+        MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED,
+        MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT,
+        MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT,
+        MAVLINK_MSG_ID_SERVO_OUTPUT_RAW,
+        MAVLINK_MSG_ID_RC_CHANNELS,
+        MAVLINK_MSG_ID_ESC_STATUS,
+        MAVLINK_MSG_ID_ESC_INFO,
+        MAVLINK_MSG_ID_VIBRATION,
+    };
+
+    return msgids;
+}
+
+void VehicleMessageDecimator::setMaxRate(uint32_t msgid, double maxRateHz)
+{
+    if (QGCMAVLink::isLosslessMessage(msgid)) {
+        qCDebug(VehicleMessageDecimatorLog) << "ignoring rate limit for exempt message id" << msgid;
+        return;
+    }
+
+    if (maxRateHz <= 0.) {
+        if (_intervalNSecs.remove(msgid) && !_streams.isEmpty()) {
+            // Anything held back for this id goes out now
+            _flushTimer.start(0);
+            _flushDueNSecs = _clock.nsecsElapsed();
+        }
+        return;
+    }
+
+    _intervalNSecs[msgid] = static_cast<qint64>(1e9 / maxRateHz);
+}
+
+double VehicleMessageDecimator::maxRate(uint32_t msgid) const
+{
+    const qint64 intervalNSecs = _intervalNSecs.value(msgid, 0);
+    return ((intervalNSecs > 0) ? (1e9 / intervalNSecs) : 0.);
+}
+
+void VehicleMessageDecimator::setDefaultMaxRate(double maxRateHz)
+{
+    qCDebug(VehicleMessageDecimatorLog) << "default max rate" << maxRateHz;
+
+    for (const uint32_t msgid : defaultDecimatedMessageIds()) {
+        setMaxRate(msgid, maxRateHz);
+    }
+}
+
+void VehicleMessageDecimator::messageReceived(LinkInterface *link, const mavlink_message_t &message)
+{
+    const auto interval = _intervalNSecs.constFind(message.msgid);
+    if (interval == _intervalNSecs.constEnd()) {
+        _handler(link, message);
+        return;
+    }
+
+    const qint64 nowNSecs = _clock.nsecsElapsed();
+    Stream &stream = _streams[_streamKey(message)];
+
+    if (!stream.pending && ((nowNSecs - stream.lastDeliveredNSecs) >= interval.value())) {
+        _deliver(stream, link, message, nowNSecs);
+        return;
+    }
+
+    if (stream.pending) {
+        _droppedCount++;
+    }
+
+    stream.pending = true;
+    stream.pendingHasLink = (link != nullptr);
+    stream.pendingLink = link;
+    stream.pendingMessage = message;
+
+    _startFlushTimer(stream.lastDeliveredNSecs + interval.value(), nowNSecs);
+}
+
+void VehicleMessageDecimator::_deliver(Stream &stream, LinkInterface *link, const mavlink_message_t &message, qint64 nowNSecs)
+{
+    // The stream is done with before calling out, the handler may cause new streams to be added
+    stream.lastDeliveredNSecs = nowNSecs;
+    stream.pending = false;
+    stream.pendingLink.clear();
+
+    _handler(link, message);
+}
+
+void VehicleMessageDecimator::_startFlushTimer(qint64 dueNSecs, qint64 nowNSecs)
+{
+    if (_flushTimer.isActive() && (_flushDueNSecs <= dueNSecs)) {
+        return;
+    }
+
+    _flushDueNSecs = dueNSecs;
+    const qint64 remainingNSecs = std::max<qint64>(0, dueNSecs - nowNSecs);
+    _flushTimer.start(static_cast<int>((remainingNSecs + 999999) / 1000000));
+}
+
+void VehicleMessageDecimator::_flush()
+{
+    struct DueMessage
+    {
+        bool hasLink;
+        QPointer<LinkInterface> link;
+        mavlink_message_t message;
+    };
+
+    const qint64 nowNSecs = _clock.nsecsElapsed();
+    QList<DueMessage> dueMessages;
+    qint64 nextDueNSecs = std::numeric_limits<qint64>::max();
+
+    for (Stream &stream : _streams) {
+        if (!stream.pending) {
+            continue;
+        }
+
+        const qint64 dueNSecs = stream.lastDeliveredNSecs + _intervalNSecs.value(stream.pendingMessage.msgid, 0);
+        if (dueNSecs <= nowNSecs) {
+            dueMessages.append({ stream.pendingHasLink, stream.pendingLink, stream.pendingMessage });
+            stream.lastDeliveredNSecs = nowNSecs;
+            stream.pending = false;
+            stream.pendingLink.clear();
+        } else {
+            nextDueNSecs = std::min(nextDueNSecs, dueNSecs);
+        }
+    }
+
+    if (nextDueNSecs != std::numeric_limits<qint64>::max()) {
+        _startFlushTimer(nextDueNSecs, nowNSecs);
+    }
+
+    for (const DueMessage &dueMessage : dueMessages) {
+        if (dueMessage.hasLink && !dueMessage.link) {
+            // The link went away while the message was held back
+            continue;
+        }
+        _handler(dueMessage.link.data(), dueMessage.message);
+    }
+}
+
+quint64 VehicleMessageDecimator::_streamKey(const mavlink_message_t &message)
+{
+    uint8_t instance = 0;
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_ESC_STATUS:
+        instance = mavlink_msg_esc_status_get_index(&message);
+        break;
+    case MAVLINK_MSG_ID_ESC_INFO:
+        instance = mavlink_msg_esc_info_get_index(&message);
+        break;
+    case MAVLINK_MSG_ID_SERVO_OUTPUT_RAW:
+        instance = mavlink_msg_servo_output_raw_get_port(&message);
+        break;
+    case MAVLINK_MSG_ID_HIGHRES_IMU:
+        instance = mavlink_msg_highres_imu_get_id(&message);
+        break;
+    default:
+        break;
+    }
+
+    return (static_cast<quint64>(message.msgid)
+            | (static_cast<quint64>(message.sysid) << 24)
+            | (static_cast<quint64>(message.compid) << 32)
+            | (static_cast<quint64>(instance) << 40));
+}
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+
+#include <functional>
+#include <limits>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(VehicleMessageDecimatorLog)
+
+class LinkInterface;
+
+/// Sits between MAVLinkProtocol::messageReceived and the vehicle and limits high rate telemetry streams to a maximum
+/// rate per message id. Within one interval the latest message wins: the first message of an interval is passed on
+/// immediately, later ones replace each other and the last one is passed on when the interval is over. So the vehicle
+/// always ends up with the newest value, only intermediate samples are dropped.
+///
+/// Streams are kept apart by system, component and, for messages which carry one, the instance index. Message ids
+/// which need every sample (QGCMAVLink::isLosslessMessage) are never decimated.
+/// Logging and forwarding happen in MAVLinkProtocol and still see every message.
+class VehicleMessageDecimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Handler = std::function<void(LinkInterface *link, const mavlink_message_t &message)>;
+
+    explicit VehicleMessageDecimator(const Handler &handler, QObject *parent = nullptr);
+    ~VehicleMessageDecimator();
+
+    /// Limits a message id to maxRateHz, 0 removes the limit. Requests for exempt message ids are ignored.
+    void setMaxRate(uint32_t msgid, double maxRateHz);
+    double maxRate(uint32_t msgid) const;
+
+    /// Sets the limit of every message id in defaultDecimatedMessageIds()
+    void setDefaultMaxRate(double maxRateHz);
+
+    /// Passes the message on to the handler now, later or not at all
+    void messageReceived(LinkInterface *link, const mavlink_message_t &message);
+
+    /// Number of messages which were replaced by a newer one before they were passed on
+    quint64 droppedCount() const { return _droppedCount; }
+
+    /// High rate streams which only feed displayed state
+    static QList<uint32_t> defaultDecimatedMessageIds();
+
+private slots:
+    void _flush();
+
+private:
+    static constexpr qint64 kNeverNSecs = std::numeric_limits<qint64>::min() / 2;
+
+    struct Stream
+    {
+        qint64 lastDeliveredNSecs = kNeverNSecs;
+        bool pending = false;
+        bool pendingHasLink = false;
+        QPointer<LinkInterface> pendingLink;
+        mavlink_message_t pendingMessage{};
+    };
+
+    void _deliver(Stream &stream, LinkInterface *link, const mavlink_message_t &message, qint64 nowNSecs);
+    void _startFlushTimer(qint64 dueNSecs, qint64 nowNSecs);
+
+    static quint64 _streamKey(const mavlink_message_t &message);
+
+    Handler _handler;
+    QHash<uint32_t, qint64> _intervalNSecs;     ///< msgid -> minimum interval between delivered messages
+    QHash<quint64, Stream> _streams;
+    QElapsedTimer _clock;
+    QTimer _flushTimer;
+    qint64 _flushDueNSecs = 0;
+    quint64 _droppedCount = 0;
+};
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleMessageDispatcher.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(VehicleMessageDispatcherLog, "qgc.vehicle.vehiclemessagedispatcher")
+
+void VehicleMessageDispatcher::addHandler(const QList<uint32_t> &msgids, const Handler &handler)
+{
+    if (msgids.isEmpty()) {
+        qCWarning(VehicleMessageDispatcherLog) << "Handler registered without message ids";
+        return;
+    }
+
+    _handlers.append({ handler, msgids });
+    _dispatchTable.clear();
+}
+
+void VehicleMessageDispatcher::addHandlerForAllMessages(const Handler &handler)
+{
+    _handlers.append({ handler, {} });
+    _dispatchTable.clear();
+}
+
+void VehicleMessageDispatcher::clearHandlers()
+{
+    _handlers.clear();
+    _dispatchTable.clear();
+    _generation++;
+}
+
+void VehicleMessageDispatcher::dispatch(const mavlink_message_t &message)
+{
+    // Copy the indices, handlers are allowed to register new handlers which resets the table. Once a handler has
+    // cleared the handlers the indices point into a different list, the rest of them are skipped.
+    const QList<int> handlerIndices = _handlerIndices(message.msgid);
+    const quint64 generation = _generation;
+    for (const int index : handlerIndices) {
+        if (generation != _generation) {
+            break;
+        }
+
+        // Called through a copy, registering a handler may reallocate the list while this one runs
+        const Handler handler = _handlers[index].handler;
+        handler(message);
+    }
+}
+
+void VehicleMessageDispatcher::addHandlerTime(uint32_t msgid, qint64 nsecs)
+{
+    HandlerStats &stats = _handlerStats[msgid];
+    stats.messageCount++;
+    stats.handlerNsecs += nsecs;
+}
+
+qsizetype VehicleMessageDispatcher::handlerCount(uint32_t msgid)
+{
+    return _handlerIndices(msgid).count();
+}
+
+const QList<int> &VehicleMessageDispatcher::_handlerIndices(uint32_t msgid)
+{
+    const auto it = _dispatchTable.constFind(msgid);
+    if (it != _dispatchTable.constEnd()) {
+        return it.value();
+    }
+
+    QList<int> handlerIndices;
+    for (int i = 0; i < _handlers.count(); i++) {
+        const QList<uint32_t> &msgids = _handlers[i].msgids;
+        if (msgids.isEmpty() || msgids.contains(msgid)) {
+            handlerIndices.append(i);
+        }
+    }
+
+    qCDebug(VehicleMessageDispatcherLog) << "msgid" << msgid << "handlers" << handlerIndices.count();
+
+    return *_dispatchTable.insert(msgid, handlerIndices);
+}
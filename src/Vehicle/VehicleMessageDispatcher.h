@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+#include <functional>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(VehicleMessageDispatcherLog)
+
+/// Routes incoming messages to the handlers which declared interest in the message id.
+/// Handlers are called in registration order. The handler list for a message id is resolved the first time the id is
+/// seen and cached, so dispatching costs a single hash lookup plus the interested handlers.
+class VehicleMessageDispatcher
+{
+public:
+    using Handler = std::function<void(const mavlink_message_t &message)>;
+
+    struct HandlerStats
+    {
+        quint64 messageCount = 0;   ///< Number of messages of this id handled
+        qint64 handlerNsecs = 0;    ///< Total time spent handling messages of this id
+    };
+
+    VehicleMessageDispatcher() = default;
+
+    void addHandler(uint32_t msgid, const Handler &handler) { addHandler(QList<uint32_t>{ msgid }, handler); }
+    void addHandler(const QList<uint32_t> &msgids, const Handler &handler);
+    void addHandlerForAllMessages(const Handler &handler);
+
+    /// Removes all handlers, collected statistics are kept. Called from a handler, the remaining handlers of the
+    /// message being dispatched are not called.
+    void clearHandlers();
+
+    /// Calls the handlers interested in the message
+    void dispatch(const mavlink_message_t &message);
+
+    /// Adds the time spent handling a message to the statistics for its id
+    void addHandlerTime(uint32_t msgid, qint64 nsecs);
+
+    /// @return Number of handlers interested in the message id
+    qsizetype handlerCount(uint32_t msgid);
+
+    HandlerStats handlerStats(uint32_t msgid) const { return _handlerStats.value(msgid); }
+
+private:
+    const QList<int> &_handlerIndices(uint32_t msgid);
+
+    struct HandlerEntry
+    {
+        Handler handler;
+        QList<uint32_t> msgids;     ///< Empty: all messages
+    };
+
+    QList<HandlerEntry> _handlers;
+    QHash<uint32_t, QList<int>> _dispatchTable;     ///< msgid -> indices into _handlers, built on demand
+    QHash<uint32_t, HandlerStats> _handlerStats;
+    quint64 _generation = 0;    ///< Incremented by clearHandlers
+};
@@ -0,0 +1,45 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QMetaType>
+#include <QtCore/QtNumeric>
+#include <QtPositioning/QGeoCoordinate>
+
+/// Position, attitude, velocity and altitude of a Vehicle taken together at one point in time. Vehicle publishes a
+/// new snapshot at most once per UI frame, no matter how fast the telemetry arrives.
+struct VehicleStateSnapshot
+{
+    Q_GADGET
+
+    Q_PROPERTY(QGeoCoordinate   coordinate          MEMBER coordinate)
+    Q_PROPERTY(double           roll                MEMBER roll)
+    Q_PROPERTY(double           pitch               MEMBER pitch)
+    Q_PROPERTY(double           heading             MEMBER heading)
+    Q_PROPERTY(double           groundSpeed         MEMBER groundSpeed)
+    Q_PROPERTY(double           airSpeed            MEMBER airSpeed)
+    Q_PROPERTY(double           climbRate           MEMBER climbRate)
+    Q_PROPERTY(double           altitudeRelative    MEMBER altitudeRelative)
+    Q_PROPERTY(double           altitudeAMSL        MEMBER altitudeAMSL)
+    Q_PROPERTY(qint64           timestampMSecs      MEMBER timestampMSecs)
+
+public:
+    QGeoCoordinate coordinate;
+    double roll = qQNaN();              ///< degrees
+    double pitch = qQNaN();             ///< degrees
+    double heading = qQNaN();           ///< degrees
+    double groundSpeed = qQNaN();       ///< m/s
+    double airSpeed = qQNaN();          ///< m/s
+    double climbRate = qQNaN();         ///< m/s
+    double altitudeRelative = qQNaN();  ///< m
+    double altitudeAMSL = qQNaN();      ///< m
+    qint64 timestampMSecs = 0;          ///< msecs since epoch the snapshot was taken
+};
+Q_DECLARE_METATYPE(VehicleStateSnapshot)
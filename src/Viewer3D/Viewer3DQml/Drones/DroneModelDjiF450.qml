@@ -45,7 +45,7 @@ Node{
     GeoCoordinateType{
         id: geo2Enu
         gpsRef: body.gpsRef
-        coordinate: body.vehicle.coordinate
+        coordinate: body.vehicle.stateSnapshot.coordinate
     }
 
     Node{
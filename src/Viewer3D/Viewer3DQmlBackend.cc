@@ -38,7 +38,7 @@ void Viewer3DQmlBackend::init(OsmParser* osmThr)
 void Viewer3DQmlBackend::_activeVehicleChangedEvent(Vehicle *vehicle)
 {
     if(_activeVehicle){
-        disconnect(_activeVehicle, &Vehicle::coordinateChanged, this, &Viewer3DQmlBackend::_activeVehicleCoordinateChanged);
+        disconnect(_activeVehicle, &Vehicle::stateSnapshotChanged, this, &Viewer3DQmlBackend::_activeVehicleStateSnapshotChanged);
     }
 
     _activeVehicle = vehicle;
@@ -48,10 +48,15 @@ void Viewer3DQmlBackend::_activeVehicleChangedEvent(Vehicle *vehicle)
         }
     }else{
         _activeVehicleCoordinateChanged(_activeVehicle->coordinate());
-        connect(_activeVehicle, &Vehicle::coordinateChanged, this, &Viewer3DQmlBackend::_activeVehicleCoordinateChanged);
+        connect(_activeVehicle, &Vehicle::stateSnapshotChanged, this, &Viewer3DQmlBackend::_activeVehicleStateSnapshotChanged);
     }
 }
 
+void Viewer3DQmlBackend::_activeVehicleStateSnapshotChanged(const VehicleStateSnapshot &snapshot)
+{
+    _activeVehicleCoordinateChanged(snapshot.coordinate);
+}
+
 void Viewer3DQmlBackend::_activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate)
 {
     if(_gpsRefSet == GPS_REF_NOT_SET){
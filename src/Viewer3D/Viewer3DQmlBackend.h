@@ -17,6 +17,7 @@
 class Viewer3DSettings;
 class Vehicle;
 class OsmParser;
+struct VehicleStateSnapshot;
 
 class Viewer3DQmlBackend : public QObject
 {
@@ -48,4 +49,5 @@ protected slots:
     void _gpsRefChangedEvent(QGeoCoordinate newGpsRef, bool isRefSet);
     void _activeVehicleChangedEvent(Vehicle* vehicle);
     void _activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate);
+    void _activeVehicleStateSnapshotChanged(const VehicleStateSnapshot &snapshot);
 };
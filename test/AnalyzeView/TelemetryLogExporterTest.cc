@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogExporterTest.h"
+#include "TelemetryLogExporter.h"
+#include "MAVLinkLib.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtCore/QtMath>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace
+{
+
+constexpr quint64 kLogStartUSecs = 1700000000000000;
+constexpr int kAttitudeCount = 100;
+constexpr quint64 kAttitudeIntervalUSecs = 10000;
+
+QByteArray _record(quint64 timeUSecs, const mavlink_message_t &message)
+{
+    char buffer[sizeof(quint64) + MAVLINK_MAX_PACKET_LEN];
+    qToBigEndian(timeUSecs, buffer);
+    const uint16_t len = mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t*>(buffer + sizeof(quint64)), &message);
+    return QByteArray(buffer, sizeof(quint64) + len);
+}
+
+/// Log of vehicle 1 with attitude from the autopilot and from a gimbal, plus a few gps positions
+bool _writeVehicleLog(const QString &logFilename)
+{
+    QByteArray log;
+    mavlink_message_t message{};
+    quint64 time = kLogStartUSecs;
+
+    // Not exported, arrives before the heartbeat
+    (void) mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, 0, 0.5f, 0, 0, 0, 0, 0);
+    log.append(_record(time, message));
+
+    (void) mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    log.append(_record(time, message));
+
+    for (int i = 0; i < kAttitudeCount; i++) {
+        time += kAttitudeIntervalUSecs;
+        (void) mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, i, 0.1f, 0, 0, 0, 0, 0);
+        log.append(_record(time, message));
+        (void) mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_GIMBAL, MAVLINK_COMM_0, &message, i, 1.0f, 0, 0, 0, 0, 0);
+        log.append(_record(time, message));
+        // Other vehicle
+        (void) mavlink_msg_attitude_pack_chan(2, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, i, 1.0f, 0, 0, 0, 0, 0);
+        log.append(_record(time, message));
+    }
+
+    for (int i = 0; i < 3; i++) {
+        (void) mavlink_msg_gps_raw_int_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, 0, GPS_FIX_TYPE_3D_FIX, 473977420 + i, 85455940, 488000, 100, 150, 0, 0, 12, 0, 0, 0, 0, 0, 0);
+        log.append(_record(time, message));
+    }
+
+    QFile file(logFilename);
+    return (file.open(QIODevice::WriteOnly) && (file.write(log) == log.size()));
+}
+
+QStringList _readLines(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return {};
+    }
+    return QString::fromUtf8(file.readAll()).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+}
+
+} // namespace
+
+void TelemetryLogExporterTest::_testExportLog()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString logFilename = dir.filePath(QStringLiteral("flight.tlog"));
+    QVERIFY(_writeVehicleLog(logFilename));
+
+    const TelemetryLogExporter::Result result = TelemetryLogExporter::exportLog(logFilename, dir.path());
+    QVERIFY2(result.errorString.isEmpty(), qPrintable(result.errorString));
+    QCOMPARE(result.messageCount, static_cast<quint64>(1 + kAttitudeCount + 3));
+
+    const QString csvDir = dir.filePath(QStringLiteral("flight"));
+    QCOMPARE(result.csvFilenames.count(), static_cast<qsizetype>(2));
+    QVERIFY(result.csvFilenames.contains(QDir(csvDir).filePath(QStringLiteral("vehicle.csv"))));
+    QVERIFY(result.csvFilenames.contains(QDir(csvDir).filePath(QStringLiteral("gps.csv"))));
+
+    // Only the attitude of the autopilot ends up in the vehicle group
+    const QStringList vehicleLines = _readLines(QDir(csvDir).filePath(QStringLiteral("vehicle.csv")));
+    QCOMPARE(vehicleLines.count(), static_cast<qsizetype>(kAttitudeCount + 1));
+    const QStringList header = vehicleLines[0].split(QLatin1Char(','));
+    QCOMPARE(header[0], QStringLiteral("TimeUSecs"));
+    const qsizetype rollColumn = header.indexOf(QStringLiteral("roll"));
+    QVERIFY(rollColumn > 0);
+    for (qsizetype i = 1; i < vehicleLines.count(); i++) {
+        const QStringList values = vehicleLines[i].split(QLatin1Char(','));
+        QCOMPARE(values.count(), header.count());
+        QCOMPARE(values[0].toULongLong(), kLogStartUSecs + (i * kAttitudeIntervalUSecs));
+        QVERIFY(qAbs(values[rollColumn].toDouble() - qRadiansToDegrees(0.1)) < 0.1);
+    }
+
+    const QStringList gpsLines = _readLines(QDir(csvDir).filePath(QStringLiteral("gps.csv")));
+    QCOMPARE(gpsLines.count(), static_cast<qsizetype>(4));
+}
+
+void TelemetryLogExporterTest::_testSampleInterval()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString logFilename = dir.filePath(QStringLiteral("flight.tlog"));
+    QVERIFY(_writeVehicleLog(logFilename));
+
+    const TelemetryLogExporter::Result result = TelemetryLogExporter::exportLog(logFilename, dir.path(), 5 * kAttitudeIntervalUSecs);
+    QVERIFY2(result.errorString.isEmpty(), qPrintable(result.errorString));
+
+    const QStringList vehicleLines = _readLines(QDir(dir.filePath(QStringLiteral("flight"))).filePath(QStringLiteral("vehicle.csv")));
+    QCOMPARE(vehicleLines.count(), static_cast<qsizetype>((kAttitudeCount / 5) + 1));
+}
+
+void TelemetryLogExporterTest::_testParallelExport()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QStringList logFilenames;
+    for (int i = 0; i < 4; i++) {
+        logFilenames.append(dir.filePath(QStringLiteral("flight%1.tlog").arg(i)));
+        QVERIFY(_writeVehicleLog(logFilenames.last()));
+    }
+
+    // Log without a vehicle
+    const QString emptyLogFilename = dir.filePath(QStringLiteral("empty.tlog"));
+    {
+        QFile file(emptyLogFilename);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QVERIFY(file.write(QByteArray(100, '\0')) == 100);
+    }
+    logFilenames.append(emptyLogFilename);
+
+    TelemetryLogExporter exporter;
+    QSignalSpy exportedSpy(&exporter, &TelemetryLogExporter::logExported);
+    QSignalSpy finishedSpy(&exporter, &TelemetryLogExporter::finished);
+
+    exporter.exportLogs(logFilenames, dir.filePath(QStringLiteral("csv")));
+    QVERIFY(finishedSpy.wait(10000));
+    QCOMPARE(exportedSpy.count(), logFilenames.count());
+
+    for (const QList<QVariant> &arguments : std::as_const(exportedSpy)) {
+        const QString logFilename = arguments[0].toString();
+        const QString errorString = arguments[1].toString();
+        if (logFilename == emptyLogFilename) {
+            QVERIFY(!errorString.isEmpty());
+        } else {
+            QVERIFY2(errorString.isEmpty(), qPrintable(errorString));
+            const QString csvFilename = QDir(dir.filePath(QStringLiteral("csv"))).filePath(QFileInfo(logFilename).completeBaseName() + QStringLiteral("/vehicle.csv"));
+            QCOMPARE(_readLines(csvFilename).count(), static_cast<qsizetype>(kAttitudeCount + 1));
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkManagerTest.h"
+#include "LinkManager.h"
+#include "MAVLinkProtocol.h"
+#include "MockLink.h"
+#include "MultiVehicleManager.h"
+#include "QGCMAVLink.h"
+
+#include <QtCore/QSet>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+void LinkManagerTest::init()
+{
+    UnitTest::init();
+
+    QCOMPARE(LinkManager::instance()->links().count(), 0);
+}
+
+void LinkManagerTest::cleanup()
+{
+    if (LinkManager::instance()->links().count()) {
+        LinkManager::instance()->disconnectAll();
+        QTRY_COMPARE_WITH_TIMEOUT(MultiVehicleManager::instance()->vehicles()->count(), 0, 10000);
+        QTRY_COMPARE_WITH_TIMEOUT(LinkManager::instance()->links().count(), 0, 10000);
+    }
+
+    UnitTest::cleanup();
+}
+
+void LinkManagerTest::_testChannelAllocation()
+{
+    LinkManager *const linkManager = LinkManager::instance();
+
+    QList<uint8_t> channels;
+    while (true) {
+        const uint8_t channel = linkManager->allocateMavlinkChannel();
+        if (channel == LinkManager::invalidMavlinkChannel()) {
+            break;
+        }
+        QVERIFY(QGCMAVLink::isValidChannel(channel));
+        QVERIFY(!channels.contains(channel));
+        QVERIFY(mavlink_get_channel_status(channel));
+        QVERIFY(mavlink_get_channel_buffer(channel));
+        channels.append(channel);
+    }
+
+    // Channel 0 is reserved, everything else up to the invalid channel is available without links. The APM firmware
+    // plugin may hold on to one channel for the lifetime of the application.
+    QVERIFY(channels.count() >= (MAVLINK_COMM_NUM_BUFFERS - 2));
+    QVERIFY(!channels.contains(0));
+
+    // Channel state keeps its address for the lifetime of the application
+    const uint8_t channel = channels.last();
+    mavlink_status_t *const status = mavlink_get_channel_status(channel);
+    linkManager->freeMavlinkChannel(channel);
+    QCOMPARE(linkManager->allocateMavlinkChannel(), channel);
+    QCOMPARE(mavlink_get_channel_status(channel), status);
+
+    for (const uint8_t allocated : channels) {
+        linkManager->freeMavlinkChannel(allocated);
+    }
+
+    QVERIFY(!mavlink_get_channel_status(LinkManager::invalidMavlinkChannel()));
+}
+
+void LinkManagerTest::_testManyMockLinks()
+{
+    // Each MockLink takes two channels, well past the former limit of 16 channels
+    constexpr int kLinkCount = 64;
+
+    QHash<LinkInterface*, int> messageCounts;
+    (void) connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::messageReceived, this, [&messageCounts](LinkInterface *link, const mavlink_message_t &message) {
+        Q_UNUSED(message);
+        messageCounts[link]++;
+    });
+
+    QList<MockLink*> mockLinks;
+    for (int i = 0; i < kLinkCount; i++) {
+        MockLink *const mockLink = MockLink::startNoInitialConnectMockLink(false);
+        QVERIFY(mockLink);
+        mockLinks.append(mockLink);
+    }
+    QCOMPARE(LinkManager::instance()->links().count(), kLinkCount);
+
+    QSet<uint8_t> channels;
+    for (const MockLink *mockLink : std::as_const(mockLinks)) {
+        const uint8_t channel = mockLink->mavlinkChannel();
+        QVERIFY(QGCMAVLink::isValidChannel(channel));
+        QVERIFY(!channels.contains(channel));
+        channels.insert(channel);
+    }
+
+    // Every link is decoded, not just the first 16 channels
+    for (MockLink *mockLink : std::as_const(mockLinks)) {
+        QTRY_VERIFY_WITH_TIMEOUT(messageCounts.value(mockLink) > 0, 10000);
+    }
+
+    (void) disconnect(MAVLinkProtocol::instance(), &MAVLinkProtocol::messageReceived, this, nullptr);
+}
@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkOutboundQueueTest.h"
+#include "LinkOutboundQueue.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QTest>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/// Frame carrying the producer and its sequence number
+QByteArray _frame(int producer, int sequence)
+{
+    return QByteArray::number(producer) + ':' + QByteArray::number(sequence);
+}
+
+bool _push(LinkOutboundQueue &queue, LinkOutboundQueue::Priority priority, const QByteArray &frame)
+{
+    return queue.push(priority, frame.constData(), static_cast<int>(frame.size()));
+}
+
+} // namespace
+
+void LinkOutboundQueueTest::_testPriorityOrder()
+{
+    LinkOutboundQueue queue;
+    QVERIFY(queue.isEmpty());
+
+    QVERIFY(_push(queue, LinkOutboundQueue::PriorityBulk, "bulk1"));
+    QVERIFY(_push(queue, LinkOutboundQueue::PriorityNormal, "normal1"));
+    QVERIFY(_push(queue, LinkOutboundQueue::PriorityBulk, "bulk2"));
+    QVERIFY(_push(queue, LinkOutboundQueue::PriorityHigh, "high1"));
+    QVERIFY(_push(queue, LinkOutboundQueue::PriorityNormal, "normal2"));
+    QVERIFY(_push(queue, LinkOutboundQueue::PriorityHigh, "high2"));
+    QVERIFY(!queue.isEmpty());
+
+    const QList<QByteArray> expected = { "high1", "high2", "normal1", "normal2", "bulk1", "bulk2" };
+    QList<QByteArray> popped;
+    QByteArray frame;
+    while (queue.pop(frame)) {
+        popped.append(frame);
+    }
+
+    QCOMPARE(popped, expected);
+    QVERIFY(queue.isEmpty());
+}
+
+void LinkOutboundQueueTest::_testRejectedFrames()
+{
+    LinkOutboundQueue queue;
+
+    const QByteArray tooLong(LinkOutboundQueue::kMaxFrameLength + 1, 'x');
+    QVERIFY(!_push(queue, LinkOutboundQueue::PriorityNormal, tooLong));
+    QVERIFY(queue.isEmpty());
+
+    const int capacity = LinkOutboundQueue::capacity(LinkOutboundQueue::PriorityBulk);
+    for (int i = 0; i < capacity; i++) {
+        QVERIFY(_push(queue, LinkOutboundQueue::PriorityBulk, _frame(0, i)));
+    }
+    QVERIFY(!_push(queue, LinkOutboundQueue::PriorityBulk, _frame(0, capacity)));
+    QCOMPARE(queue.overflowCount(), 1ULL);
+
+    // A full bulk ring does not hold back the other classes
+    QVERIFY(_push(queue, LinkOutboundQueue::PriorityHigh, "high"));
+
+    QByteArray frame;
+    QVERIFY(queue.pop(frame));
+    QCOMPARE(frame, QByteArray("high"));
+    QVERIFY(queue.pop(frame));
+    QCOMPARE(frame, _frame(0, 0));
+    QVERIFY(_push(queue, LinkOutboundQueue::PriorityBulk, _frame(0, capacity)));
+
+    int count = 0;
+    while (queue.pop(frame)) {
+        QCOMPARE(frame, _frame(0, count + 1));
+        count++;
+    }
+    QCOMPARE(count, capacity);
+}
+
+void LinkOutboundQueueTest::_testConcurrentProducers()
+{
+    constexpr int kProducerCount = 4;
+    constexpr int kFramesPerProducer = 20000;
+
+    LinkOutboundQueue queue;
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kProducerCount; producer++) {
+        producers.emplace_back([&queue, producer]() {
+            const LinkOutboundQueue::Priority priority = (producer == 0) ? LinkOutboundQueue::PriorityHigh : LinkOutboundQueue::PriorityNormal;
+            for (int sequence = 0; sequence < kFramesPerProducer; sequence++) {
+                const QByteArray frame = _frame(producer, sequence);
+                while (!_push(queue, priority, frame)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    QList<int> nextSequence(kProducerCount, 0);
+    int received = 0;
+    bool inOrder = true;
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray frame;
+    while ((received < (kProducerCount * kFramesPerProducer)) && (timer.elapsed() < 30000)) {
+        if (!queue.pop(frame)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const QList<QByteArray> parts = frame.split(':');
+        const int producer = parts[0].toInt();
+        const int sequence = parts[1].toInt();
+        inOrder = inOrder && (sequence == nextSequence[producer]);
+        nextSequence[producer] = sequence + 1;
+        received++;
+    }
+
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    QCOMPARE(received, kProducerCount * kFramesPerProducer);
+    QVERIFY(inOrder);
+    QVERIFY(!queue.pop(frame));
+}
+
+void LinkOutboundQueueTest::_testMessagePriority()
+{
+    QCOMPARE(LinkOutboundQueue::priorityForMessage(MAVLINK_MSG_ID_MANUAL_CONTROL), LinkOutboundQueue::PriorityHigh);
+    QCOMPARE(LinkOutboundQueue::priorityForMessage(MAVLINK_MSG_ID_HEARTBEAT), LinkOutboundQueue::PriorityHigh);
+    QCOMPARE(LinkOutboundQueue::priorityForMessage(MAVLINK_MSG_ID_COMMAND_LONG), LinkOutboundQueue::PriorityCommand);
+    QCOMPARE(LinkOutboundQueue::priorityForMessage(MAVLINK_MSG_ID_GPS_RTCM_DATA), LinkOutboundQueue::PriorityRtk);
+    QCOMPARE(LinkOutboundQueue::priorityForMessage(MAVLINK_MSG_ID_ATTITUDE), LinkOutboundQueue::PriorityNormal);
+    QCOMPARE(LinkOutboundQueue::priorityForMessage(MAVLINK_MSG_ID_PARAM_REQUEST_READ), LinkOutboundQueue::PriorityBulk);
+    QCOMPARE(LinkOutboundQueue::priorityForMessage(MAVLINK_MSG_ID_MISSION_ITEM_INT), LinkOutboundQueue::PriorityBulk);
+    QCOMPARE(LinkOutboundQueue::priorityForMessage(MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL), LinkOutboundQueue::PriorityBulk);
+}
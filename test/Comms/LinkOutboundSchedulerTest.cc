@@ -0,0 +1,184 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkOutboundSchedulerTest.h"
+#include "LinkOutboundScheduler.h"
+
+#include <QtTest/QTest>
+
+namespace
+{
+
+constexpr qint64 kMSecsToNSecs = 1000 * 1000;
+
+void _fill(LinkOutboundQueue &queue, LinkOutboundQueue::Priority priority, int count, int length)
+{
+    const QByteArray frame(length, static_cast<char>('0' + priority));
+    for (int i = 0; i < count; i++) {
+        QVERIFY(queue.push(priority, frame.constData(), length));
+    }
+}
+
+} // namespace
+
+void LinkOutboundSchedulerTest::_testWeightedFairShare()
+{
+    LinkOutboundQueue queue;
+    LinkOutboundScheduler scheduler(&queue);
+
+    constexpr int frameLength = 100;
+    constexpr int framesPerClass = 60;
+    for (int priority = LinkOutboundQueue::PriorityCommand; priority < LinkOutboundQueue::PriorityCount; priority++) {
+        _fill(queue, static_cast<LinkOutboundQueue::Priority>(priority), framesPerClass, frameLength);
+    }
+
+    // Take fewer frames than the command class holds so every class stays busy
+    QList<int> sentBytes(LinkOutboundQueue::PriorityCount, 0);
+    const qint64 nowNSecs = LinkOutboundQueue::nowNSecs();
+    QByteArray frame;
+    for (int i = 0; i < 100; i++) {
+        QVERIFY(scheduler.next(nowNSecs, frame));
+        sentBytes[frame.at(0) - '0'] += frame.size();
+    }
+
+    const int totalWeight = 4 + 3 + 2 + 1;
+    const int totalBytes = 100 * frameLength;
+    for (int priority = LinkOutboundQueue::PriorityCommand; priority < LinkOutboundQueue::PriorityCount; priority++) {
+        const int expectedBytes = (totalBytes * LinkOutboundScheduler::weight(static_cast<LinkOutboundQueue::Priority>(priority))) / totalWeight;
+        QVERIFY2(qAbs(sentBytes[priority] - expectedBytes) <= (LinkOutboundQueue::kMaxFrameLength * 4), qPrintable(QStringLiteral("class %1 sent %2 expected %3").arg(priority).arg(sentBytes[priority]).arg(expectedBytes)));
+    }
+}
+
+void LinkOutboundSchedulerTest::_testControlBypassesBudget()
+{
+    LinkOutboundQueue queue;
+    LinkOutboundScheduler scheduler(&queue);
+    scheduler.setConfiguredByteRate(1000);
+
+    _fill(queue, LinkOutboundQueue::PriorityBulk, 20, 100);
+
+    const qint64 nowNSecs = LinkOutboundQueue::nowNSecs();
+    QByteArray frame;
+    int sent = 0;
+    while (scheduler.next(nowNSecs, frame)) {
+        sent++;
+    }
+    QVERIFY(sent > 0);
+    QVERIFY(sent < 20);
+    QVERIFY(scheduler.waitMSecs() > 0);
+
+    _fill(queue, LinkOutboundQueue::PriorityHigh, 1, 20);
+    QVERIFY(scheduler.next(nowNSecs, frame));
+    QCOMPARE(frame.size(), 20);
+    QVERIFY(!scheduler.next(nowNSecs, frame));
+}
+
+void LinkOutboundSchedulerTest::_testByteRatePacing()
+{
+    LinkOutboundQueue queue;
+    LinkOutboundScheduler scheduler(&queue);
+    constexpr int byteRate = 1000;
+    scheduler.setConfiguredByteRate(byteRate);
+    QCOMPARE(scheduler.byteRate(), byteRate);
+
+    constexpr int frameLength = 100;
+    _fill(queue, LinkOutboundQueue::PriorityNormal, 200, frameLength);
+
+    // Two simulated seconds in 10 msec steps
+    const qint64 startNSecs = LinkOutboundQueue::nowNSecs();
+    int sentBytes = 0;
+    QByteArray frame;
+    for (int step = 0; step <= 200; step++) {
+        while (scheduler.next(startNSecs + (step * 10 * kMSecsToNSecs), frame)) {
+            sentBytes += frame.size();
+        }
+    }
+
+    // Two seconds of budget plus the initial burst, which is two full frames at this rate
+    const int burstBytes = 2 * LinkOutboundQueue::kMaxFrameLength;
+    QVERIFY2(sentBytes >= (2 * byteRate), qPrintable(QString::number(sentBytes)));
+    QVERIFY2(sentBytes <= ((2 * byteRate) + burstBytes + frameLength), qPrintable(QString::number(sentBytes)));
+}
+
+void LinkOutboundSchedulerTest::_testRadioStatus()
+{
+    LinkOutboundQueue queue;
+    LinkOutboundScheduler scheduler(&queue);
+    QCOMPARE(scheduler.byteRate(), 0);
+
+    // A radio of unknown rate does not pace a link without a configured rate
+    scheduler.radioStatusReceived(100, 0);
+    QCOMPARE(scheduler.byteRate(), 0);
+
+    constexpr int radioByteRate = 5760;
+    scheduler.radioStatusReceived(100, radioByteRate);
+    QCOMPARE(scheduler.byteRate(), radioByteRate);
+
+    scheduler.radioStatusReceived(10, radioByteRate);
+    QCOMPARE(scheduler.byteRate(), radioByteRate / 2);
+    scheduler.radioStatusReceived(40, radioByteRate);
+    const int reducedRate = scheduler.byteRate();
+    QVERIFY(reducedRate < (radioByteRate / 2));
+
+    scheduler.radioStatusReceived(70, radioByteRate);
+    QCOMPARE(scheduler.byteRate(), reducedRate);
+    scheduler.radioStatusReceived(95, radioByteRate);
+    QVERIFY(scheduler.byteRate() > reducedRate);
+
+    // A configured rate wins over the radio rate, the radio still scales it
+    scheduler.setConfiguredByteRate(1000);
+    QVERIFY(scheduler.byteRate() < 1000);
+    for (int i = 0; i < 40; i++) {
+        scheduler.radioStatusReceived(100, radioByteRate);
+    }
+    QCOMPARE(scheduler.byteRate(), 1000);
+}
+
+void LinkOutboundSchedulerTest::_testBulkFrameAllowance()
+{
+    LinkOutboundQueue queue;
+    LinkOutboundScheduler scheduler(&queue);
+    QCOMPARE(scheduler.bulkFrameAllowance(25, 10), 10);
+
+    // Bulk alone gets the whole rate: 1000 bytes/s * 250 msecs / 25 bytes = 10 frames
+    scheduler.setConfiguredByteRate(1000);
+    QCOMPARE(scheduler.bulkFrameAllowance(25, 100), 10);
+
+    _fill(queue, LinkOutboundQueue::PriorityBulk, 8, 25);
+    QCOMPARE(scheduler.bulkFrameAllowance(25, 100), 2);
+
+    // Busy classes shrink the bulk share, but a batch never drops below one frame
+    _fill(queue, LinkOutboundQueue::PriorityCommand, 4, 100);
+    QCOMPARE(scheduler.bulkFrameAllowance(25, 100), 1);
+}
+
+void LinkOutboundSchedulerTest::_testStatistics()
+{
+    LinkOutboundQueue queue;
+    LinkOutboundScheduler scheduler(&queue);
+
+    _fill(queue, LinkOutboundQueue::PriorityNormal, 3, 50);
+    LinkOutboundScheduler::ClassStatistics statistics = scheduler.statistics(LinkOutboundQueue::PriorityNormal);
+    QCOMPARE(statistics.queuedFrames, qsizetype(3));
+    QCOMPARE(statistics.queuedBytes, Q_INT64_C(150));
+    QCOMPARE(statistics.sentFrames, 0ULL);
+
+    const qint64 nowNSecs = LinkOutboundQueue::nowNSecs() + (20 * kMSecsToNSecs);
+    QByteArray frame;
+    QVERIFY(scheduler.next(nowNSecs, frame));
+    QVERIFY(scheduler.next(nowNSecs, frame));
+
+    statistics = scheduler.statistics(LinkOutboundQueue::PriorityNormal);
+    QCOMPARE(statistics.queuedFrames, qsizetype(1));
+    QCOMPARE(statistics.queuedBytes, Q_INT64_C(50));
+    QCOMPARE(statistics.sentFrames, 2ULL);
+    QCOMPARE(statistics.sentBytes, 100ULL);
+    QVERIFY(statistics.averageLatencyMSecs >= 20.);
+    QVERIFY(statistics.maxLatencyMSecs >= statistics.averageLatencyMSecs);
+}
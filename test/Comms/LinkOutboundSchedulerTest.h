@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class LinkOutboundSchedulerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testWeightedFairShare();
+    void _testControlBypassesBudget();
+    void _testByteRatePacing();
+    void _testRadioStatus();
+    void _testBulkFrameAllowance();
+    void _testStatistics();
+};
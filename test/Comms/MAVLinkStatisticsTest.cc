@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkStatisticsTest.h"
+#include "MAVLinkStatistics.h"
+
+#include <QtTest/QTest>
+
+namespace
+{
+
+mavlink_message_t _message(uint8_t seq, uint32_t msgid = MAVLINK_MSG_ID_HEARTBEAT, uint8_t sysid = 1, uint8_t compid = MAV_COMP_ID_AUTOPILOT1)
+{
+    mavlink_message_t message{};
+    message.seq = seq;
+    message.msgid = msgid;
+    message.sysid = sysid;
+    message.compid = compid;
+    return message;
+}
+
+constexpr qint64 kSecond = 1000000;
+
+} // namespace
+
+void MAVLinkStatisticsTest::_testLoss()
+{
+    MAVLinkStatistics statistics;
+
+    // The first message only sets the expected sequence
+    statistics.record(_message(250), kSecond);
+    statistics.record(_message(251), kSecond);
+    // 252..254 lost
+    statistics.record(_message(255), kSecond);
+    // Wraps, 0 and 1 lost
+    statistics.record(_message(2), kSecond);
+
+    const MAVLinkStatistics::Snapshot snapshot = statistics.snapshot(1, MAV_COMP_ID_AUTOPILOT1, kSecond);
+    QCOMPARE(snapshot.received, 4ULL);
+    QCOMPARE(snapshot.lost, 5ULL);
+    QCOMPARE(snapshot.lossPercent(), (100.0 * 5) / 9);
+}
+
+void MAVLinkStatisticsTest::_testBurstLoss()
+{
+    QCOMPARE(MAVLinkStatistics::burstBin(1), 0);
+    QCOMPARE(MAVLinkStatistics::burstBin(2), 1);
+    QCOMPARE(MAVLinkStatistics::burstBin(3), 2);
+    QCOMPARE(MAVLinkStatistics::burstBin(4), 2);
+    QCOMPARE(MAVLinkStatistics::burstBin(5), 3);
+    QCOMPARE(MAVLinkStatistics::burstBin(64), 6);
+    QCOMPARE(MAVLinkStatistics::burstBin(65), 7);
+    QCOMPARE(MAVLinkStatistics::burstBin(255), 7);
+
+    MAVLinkStatistics statistics;
+    statistics.record(_message(0), kSecond);
+    statistics.record(_message(2), kSecond);      // 1 lost
+    statistics.record(_message(5), kSecond);      // 2 lost
+    statistics.record(_message(6), kSecond);
+    statistics.record(_message(106), kSecond);    // 99 lost
+
+    const MAVLinkStatistics::Snapshot snapshot = statistics.snapshot(1, MAV_COMP_ID_AUTOPILOT1, kSecond);
+    QCOMPARE(snapshot.burstLoss[0], 1ULL);
+    QCOMPARE(snapshot.burstLoss[1], 1ULL);
+    QCOMPARE(snapshot.burstLoss[7], 1ULL);
+    QCOMPARE(snapshot.lost, 102ULL);
+}
+
+void MAVLinkStatisticsTest::_testWindow()
+{
+    MAVLinkStatistics statistics;
+
+    // Heavy loss in the first second only
+    statistics.record(_message(0), kSecond);
+    statistics.record(_message(10), kSecond);
+
+    uint8_t seq = 11;
+    for (qint64 second = 2; second <= 20; second++) {
+        statistics.record(_message(seq++), second * kSecond);
+    }
+
+    MAVLinkStatistics::Snapshot snapshot = statistics.snapshot(1, MAV_COMP_ID_AUTOPILOT1, 20 * kSecond);
+    QCOMPARE(snapshot.lost, 9ULL);
+    QCOMPARE(snapshot.windowLost, 0ULL);
+    QCOMPARE(snapshot.windowReceived, static_cast<quint64>(MAVLinkStatistics::kWindowSeconds));
+    QCOMPARE(snapshot.windowLossPercent(), 0.0);
+
+    // Nothing received recently
+    snapshot = statistics.snapshot(1, MAV_COMP_ID_AUTOPILOT1, 100 * kSecond);
+    QCOMPARE(snapshot.windowReceived, 0ULL);
+}
+
+void MAVLinkStatisticsTest::_testJitter()
+{
+    MAVLinkStatistics steady;
+    MAVLinkStatistics irregular;
+    for (int i = 0; i < 100; i++) {
+        steady.record(_message(static_cast<uint8_t>(i)), i * 20000);
+        irregular.record(_message(static_cast<uint8_t>(i)), (i * 20000) + ((i % 2) ? 5000 : 0));
+    }
+
+    QCOMPARE(steady.snapshot(1, MAV_COMP_ID_AUTOPILOT1, 2 * kSecond).jitterMSecs, 0.0);
+
+    // Intervals alternate between 25 and 15 ms, the estimator converges towards 10 ms
+    const double jitterMSecs = irregular.snapshot(1, MAV_COMP_ID_AUTOPILOT1, 2 * kSecond).jitterMSecs;
+    QVERIFY(jitterMSecs > 9.0);
+    QVERIFY(jitterMSecs <= 10.0);
+}
+
+void MAVLinkStatisticsTest::_testMessageCounts()
+{
+    MAVLinkStatistics statistics;
+
+    uint8_t seq = 0;
+    for (int i = 0; i < 3; i++) {
+        statistics.record(_message(seq++, MAVLINK_MSG_ID_HEARTBEAT), kSecond);
+    }
+    statistics.record(_message(seq++, MAVLINK_MSG_ID_ATTITUDE), kSecond);
+    statistics.record(_message(seq++, 12900), kSecond);
+    statistics.record(_message(seq++, 70000), kSecond);
+
+    const MAVLinkStatistics::Snapshot snapshot = statistics.snapshot(1, MAV_COMP_ID_AUTOPILOT1, kSecond);
+    QCOMPARE(snapshot.messageCounts.count(), static_cast<qsizetype>(4));
+    QCOMPARE(snapshot.messageCounts.value(MAVLINK_MSG_ID_HEARTBEAT), 3ULL);
+    QCOMPARE(snapshot.messageCounts.value(MAVLINK_MSG_ID_ATTITUDE), 1ULL);
+    QCOMPARE(snapshot.messageCounts.value(12900), 1ULL);
+    QCOMPARE(snapshot.messageCounts.value(MAVLinkStatistics::kOtherMessageIds), 1ULL);
+}
+
+void MAVLinkStatisticsTest::_testComponents()
+{
+    MAVLinkStatistics statistics;
+
+    // Each system/component has its own sequence
+    statistics.record(_message(0, MAVLINK_MSG_ID_HEARTBEAT, 1, MAV_COMP_ID_AUTOPILOT1), kSecond);
+    statistics.record(_message(100, MAVLINK_MSG_ID_HEARTBEAT, 1, MAV_COMP_ID_CAMERA), kSecond);
+    statistics.record(_message(200, MAVLINK_MSG_ID_HEARTBEAT, 2, MAV_COMP_ID_AUTOPILOT1), kSecond);
+    statistics.record(_message(1, MAVLINK_MSG_ID_HEARTBEAT, 1, MAV_COMP_ID_AUTOPILOT1), kSecond);
+    statistics.record(_message(101, MAVLINK_MSG_ID_HEARTBEAT, 1, MAV_COMP_ID_CAMERA), kSecond);
+
+    MAVLinkStatistics::Snapshot snapshot = statistics.snapshot(1, MAV_COMP_ID_AUTOPILOT1, kSecond);
+    QCOMPARE(snapshot.received, 2ULL);
+    QCOMPARE(snapshot.lost, 0ULL);
+
+    snapshot = statistics.snapshot(1, MAV_COMP_ID_CAMERA, kSecond);
+    QCOMPARE(snapshot.received, 2ULL);
+    QCOMPARE(snapshot.lost, 0ULL);
+
+    QCOMPARE(statistics.snapshot(2, MAV_COMP_ID_AUTOPILOT1, kSecond).received, 1ULL);
+    QCOMPARE(statistics.snapshot(3, MAV_COMP_ID_AUTOPILOT1, kSecond).received, 0ULL);
+
+    // Endpoints merge
+    snapshot = statistics.snapshot(1, MAV_COMP_ID_AUTOPILOT1, kSecond);
+    snapshot.add(statistics.snapshot(1, MAV_COMP_ID_CAMERA, kSecond));
+    QCOMPARE(snapshot.received, 4ULL);
+    QCOMPARE(snapshot.messageCounts.value(MAVLINK_MSG_ID_HEARTBEAT), 4ULL);
+}
@@ -0,0 +1,246 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogIndexTest.h"
+#include "TelemetryLogIndex.h"
+#include "TelemetryLogWriter.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+namespace
+{
+
+constexpr quint64 kLogStartUSecs = 1700000000000000;
+constexpr quint64 kRecordIntervalUSecs = 20000;
+
+mavlink_message_t _heartbeat(uint8_t sysid, uint8_t autopilot, uint8_t baseMode, uint32_t customMode, uint8_t compid = MAV_COMP_ID_AUTOPILOT1, uint8_t type = MAV_TYPE_QUADROTOR)
+{
+    mavlink_message_t message{};
+    (void) mavlink_msg_heartbeat_pack_chan(sysid, compid, MAVLINK_COMM_0, &message, type, autopilot, baseMode, customMode, MAV_STATE_ACTIVE);
+    return message;
+}
+
+mavlink_message_t _attitude(uint32_t timeBootMs)
+{
+    mavlink_message_t message{};
+    (void) mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, timeBootMs, 0.1f, 0.2f, 0.3f, 0, 0, 0);
+    return message;
+}
+
+QByteArray _record(quint64 timeUSecs, const mavlink_message_t &message)
+{
+    char buffer[TelemetryLogIndex::kMaxRecordSize];
+    qToBigEndian(timeUSecs, buffer);
+    const uint16_t len = mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t*>(buffer + sizeof(quint64)), &message);
+    return QByteArray(buffer, sizeof(quint64) + len);
+}
+
+/// Every tenth record is a heartbeat, the rest are attitude messages
+QByteArray _log(int recordCount, QList<qint64> &recordOffsets)
+{
+    QByteArray log;
+    for (int i = 0; i < recordCount; i++) {
+        recordOffsets.append(log.size());
+        const mavlink_message_t message = ((i % 10) == 0) ? _heartbeat(1, MAV_AUTOPILOT_PX4, 0, 0) : _attitude(i);
+        log.append(_record(kLogStartUSecs + (i * kRecordIntervalUSecs), message));
+    }
+    return log;
+}
+
+} // namespace
+
+void TelemetryLogIndexTest::_testBuild()
+{
+    static constexpr int recordCount = 200;
+
+    QList<qint64> recordOffsets;
+    QByteArray log = _log(recordCount, recordOffsets);
+    QBuffer buffer(&log);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    TelemetryLogIndex index;
+    QVERIFY(index.build(&buffer));
+
+    QCOMPARE(index.recordCount(), static_cast<quint64>(recordCount));
+    QCOMPARE(index.logFileSize(), static_cast<qint64>(log.size()));
+    QCOMPARE(index.startTimeUSecs(), kLogStartUSecs);
+    QCOMPARE(index.endTimeUSecs(), kLogStartUSecs + ((recordCount - 1) * kRecordIntervalUSecs));
+    QCOMPARE(index.messageCounts().value(MAVLINK_MSG_ID_HEARTBEAT), static_cast<quint64>(recordCount / 10));
+    QCOMPARE(index.messageCounts().value(MAVLINK_MSG_ID_ATTITUDE), static_cast<quint64>(recordCount - (recordCount / 10)));
+
+    // One checkpoint every five records
+    const qsizetype recordsPerCheckpoint = TelemetryLogIndex::kCheckpointIntervalUSecs / kRecordIntervalUSecs;
+    QCOMPARE(index.checkpoints().count(), recordCount / recordsPerCheckpoint);
+
+    QCOMPARE(index.checkpointOffset(0), recordOffsets[0]);
+    QCOMPARE(index.checkpointOffset(kLogStartUSecs + 250000), recordOffsets[10]);
+    QCOMPARE(index.checkpointOffset(kLogStartUSecs + 300000), recordOffsets[15]);
+    QCOMPARE(index.checkpointOffset(index.endTimeUSecs() + 1000000), recordOffsets[recordCount - recordsPerCheckpoint]);
+}
+
+void TelemetryLogIndexTest::_testEvents()
+{
+    QByteArray log;
+    quint64 time = kLogStartUSecs;
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, 0, 1)));
+    log.append(_record(time++, _heartbeat(255, MAV_AUTOPILOT_INVALID, MAV_MODE_FLAG_SAFETY_ARMED, 7)));
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, 0, 1)));
+    const qint64 armedOffset = log.size();
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, MAV_MODE_FLAG_SAFETY_ARMED, 1)));
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, MAV_MODE_FLAG_SAFETY_ARMED, 2)));
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, 0, 2)));
+
+    QBuffer buffer(&log);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    TelemetryLogIndex index;
+    QVERIFY(index.build(&buffer));
+
+    const QList<TelemetryLogIndex::Event> &events = index.events();
+    QCOMPARE(events.count(), static_cast<qsizetype>(4));
+    QCOMPARE(events[0].type, TelemetryLogIndex::EventType::ModeChanged);
+    QCOMPARE(events[0].customMode, static_cast<uint32_t>(1));
+    QCOMPARE(events[1].type, TelemetryLogIndex::EventType::Armed);
+    QCOMPARE(events[1].offset, armedOffset);
+    QCOMPARE(events[2].type, TelemetryLogIndex::EventType::ModeChanged);
+    QCOMPARE(events[2].customMode, static_cast<uint32_t>(2));
+    QCOMPARE(events[3].type, TelemetryLogIndex::EventType::Disarmed);
+    for (const TelemetryLogIndex::Event &event : events) {
+        QCOMPARE(event.sysid, static_cast<uint8_t>(1));
+    }
+}
+
+void TelemetryLogIndexTest::_testComponentHeartbeats()
+{
+    QByteArray log;
+    quint64 time = kLogStartUSecs;
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, MAV_MODE_FLAG_SAFETY_ARMED, 3)));
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, 0, 0, MAV_COMP_ID_CAMERA, MAV_TYPE_CAMERA)));
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, MAV_MODE_FLAG_SAFETY_ARMED, 3)));
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_ARDUPILOTMEGA, 0, 9, MAV_COMP_ID_ONBOARD_COMPUTER, MAV_TYPE_ONBOARD_CONTROLLER)));
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, 0, 0, MAV_COMP_ID_AUTOPILOT1, MAV_TYPE_GCS)));
+    log.append(_record(time++, _heartbeat(1, MAV_AUTOPILOT_PX4, MAV_MODE_FLAG_SAFETY_ARMED, 3)));
+
+    QBuffer buffer(&log);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    TelemetryLogIndex index;
+    QVERIFY(index.build(&buffer));
+
+    // Only the initial state of the autopilot, the other components must not produce mode or arming changes
+    const QList<TelemetryLogIndex::Event> &events = index.events();
+    QCOMPARE(events.count(), static_cast<qsizetype>(2));
+    QCOMPARE(events[0].type, TelemetryLogIndex::EventType::ModeChanged);
+    QCOMPARE(events[0].customMode, static_cast<uint32_t>(3));
+    QCOMPARE(events[1].type, TelemetryLogIndex::EventType::Armed);
+    QCOMPARE(index.messageCounts().value(MAVLINK_MSG_ID_HEARTBEAT), static_cast<quint64>(6));
+}
+
+void TelemetryLogIndexTest::_testResync()
+{
+    const QByteArray record1 = _record(kLogStartUSecs, _attitude(1));
+    const QByteArray record2 = _record(kLogStartUSecs + 1000, _attitude(2));
+
+    // Garbage including a stray STX and a truncated frame between the records
+    QByteArray log = record1;
+    log.append(QByteArray("\x01\x02\xfd\x03", 4));
+    log.append(record2.left(record2.size() - 3));
+    log.append(record2);
+
+    QBuffer buffer(&log);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    TelemetryLogIndex index;
+    QVERIFY(index.build(&buffer));
+    QCOMPARE(index.recordCount(), static_cast<quint64>(2));
+    QCOMPARE(index.checkpoints().count(), static_cast<qsizetype>(1));
+    QCOMPARE(index.endTimeUSecs(), kLogStartUSecs + 1000);
+
+    TelemetryLogIndex emptyIndex;
+    QByteArray garbage(1000, '\xfe');
+    QBuffer garbageBuffer(&garbage);
+    QVERIFY(garbageBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(!emptyIndex.build(&garbageBuffer));
+    QVERIFY(emptyIndex.isEmpty());
+}
+
+void TelemetryLogIndexTest::_testSaveLoad()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QList<qint64> recordOffsets;
+    QByteArray log = _log(100, recordOffsets);
+    log.append(_record(kLogStartUSecs + 5000000, _heartbeat(1, MAV_AUTOPILOT_PX4, MAV_MODE_FLAG_SAFETY_ARMED, 3)));
+    QBuffer buffer(&log);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    TelemetryLogIndex index;
+    QVERIFY(index.build(&buffer));
+
+    const QString indexFilename = TelemetryLogIndex::sidecarFileName(dir.filePath(QStringLiteral("test.tlog")));
+    QVERIFY(index.save(indexFilename));
+
+    TelemetryLogIndex loadedIndex;
+    QVERIFY(!loadedIndex.load(indexFilename, log.size() + 1));
+    QVERIFY(loadedIndex.isEmpty());
+    QVERIFY(loadedIndex.load(indexFilename, log.size()));
+
+    QCOMPARE(loadedIndex.startTimeUSecs(), index.startTimeUSecs());
+    QCOMPARE(loadedIndex.endTimeUSecs(), index.endTimeUSecs());
+    QCOMPARE(loadedIndex.recordCount(), index.recordCount());
+    QCOMPARE(loadedIndex.logFileSize(), index.logFileSize());
+    QCOMPARE(loadedIndex.messageCounts(), index.messageCounts());
+    QCOMPARE(loadedIndex.checkpoints().count(), index.checkpoints().count());
+    for (qsizetype i = 0; i < index.checkpoints().count(); i++) {
+        QCOMPARE(loadedIndex.checkpoints()[i].timeUSecs, index.checkpoints()[i].timeUSecs);
+        QCOMPARE(loadedIndex.checkpoints()[i].offset, index.checkpoints()[i].offset);
+    }
+    QCOMPARE(loadedIndex.events().count(), index.events().count());
+    for (qsizetype i = 0; i < index.events().count(); i++) {
+        QCOMPARE(loadedIndex.events()[i].type, index.events()[i].type);
+        QCOMPARE(loadedIndex.events()[i].offset, index.events()[i].offset);
+        QCOMPARE(loadedIndex.events()[i].customMode, index.events()[i].customMode);
+    }
+}
+
+void TelemetryLogIndexTest::_testWriterIndex()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    QList<mavlink_message_t> messages;
+    for (int i = 0; i < 500; i++) {
+        messages.append(((i % 10) == 0) ? _heartbeat(1, MAV_AUTOPILOT_PX4, 0, i) : _attitude(i));
+    }
+
+    TelemetryLogWriter writer;
+    writer.startLogging(&file, 0);
+    for (const mavlink_message_t &message : std::as_const(messages)) {
+        QVERIFY(writer.logMessage(message));
+    }
+    writer.stopLogging();
+
+    const TelemetryLogIndex &writerIndex = writer.logIndex();
+    QCOMPARE(writerIndex.recordCount(), static_cast<quint64>(messages.count()));
+    QCOMPARE(writerIndex.logFileSize(), file.size());
+
+    TelemetryLogIndex scannedIndex;
+    QVERIFY(scannedIndex.build(&file));
+    QCOMPARE(scannedIndex.recordCount(), writerIndex.recordCount());
+    QCOMPARE(scannedIndex.startTimeUSecs(), writerIndex.startTimeUSecs());
+    QCOMPARE(scannedIndex.endTimeUSecs(), writerIndex.endTimeUSecs());
+    QCOMPARE(scannedIndex.messageCounts(), writerIndex.messageCounts());
+    QCOMPARE(scannedIndex.checkpoints().count(), writerIndex.checkpoints().count());
+    QCOMPARE(scannedIndex.events().count(), writerIndex.events().count());
+}
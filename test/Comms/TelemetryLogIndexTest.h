@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class TelemetryLogIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testBuild();
+    void _testEvents();
+    void _testComponentHeartbeats();
+    void _testResync();
+    void _testSaveLoad();
+    void _testWriterIndex();
+};
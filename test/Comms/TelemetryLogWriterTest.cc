@@ -0,0 +1,175 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLogWriterTest.h"
+#include "TelemetryLogWriter.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+namespace
+{
+
+mavlink_message_t _heartbeat(uint8_t sysid, uint32_t customMode)
+{
+    mavlink_message_t message{};
+    (void) mavlink_msg_heartbeat_pack_chan(sysid, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, customMode, MAV_STATE_ACTIVE);
+    return message;
+}
+
+/// Splits tlog data into (timestamp, frame) records
+QList<QPair<quint64, QByteArray>> _readRecords(const QByteArray &data)
+{
+    QList<QPair<quint64, QByteArray>> records;
+
+    qsizetype offset = 0;
+    while ((offset + static_cast<qsizetype>(sizeof(quint64)) + 2) <= data.size()) {
+        const quint64 timestamp = qFromBigEndian<quint64>(data.constData() + offset);
+        offset += sizeof(quint64);
+
+        const uint8_t stx = static_cast<uint8_t>(data[offset]);
+        const uint8_t payloadLen = static_cast<uint8_t>(data[offset + 1]);
+        qsizetype frameLen = (stx == MAVLINK_STX_MAVLINK1) ? (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1) : (MAVLINK_CORE_HEADER_LEN + 1);
+        frameLen += payloadLen + MAVLINK_NUM_CHECKSUM_BYTES;
+        if ((stx == MAVLINK_STX) && (static_cast<uint8_t>(data[offset + 2]) & MAVLINK_IFLAG_SIGNED)) {
+            frameLen += MAVLINK_SIGNATURE_BLOCK_LEN;
+        }
+
+        records.append(qMakePair(timestamp, data.mid(offset, frameLen)));
+        offset += frameLen;
+    }
+
+    return records;
+}
+
+QByteArray _frame(const mavlink_message_t &message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+    return QByteArray(reinterpret_cast<const char*>(buffer), len);
+}
+
+} // namespace
+
+void TelemetryLogWriterTest::_testWriteMessages()
+{
+    static constexpr int messageCount = 1000;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    TelemetryLogWriter writer;
+    QVERIFY(!writer.logMessage(_heartbeat(1, 0)));
+
+    QList<mavlink_message_t> messages;
+    for (int i = 0; i < messageCount; i++) {
+        messages.append(_heartbeat(1, i));
+    }
+
+    // Timestamps start from the wall clock at the time logging starts
+    const qint64 startUsecs = QDateTime::currentMSecsSinceEpoch() * 1000;
+    writer.startLogging(&file, 0);
+    QVERIFY(writer.isLogging());
+    QVERIFY(qAbs(static_cast<qint64>(writer.timestampUsecs()) - startUsecs) < 1000000);
+    for (const mavlink_message_t &message : std::as_const(messages)) {
+        QVERIFY(writer.logMessage(message));
+    }
+    writer.stopLogging();
+    QVERIFY(!writer.isLogging());
+
+    QCOMPARE(writer.droppedRecords(), static_cast<quint64>(0));
+    QCOMPARE(static_cast<qint64>(writer.writtenBytes()), file.size());
+
+    QVERIFY(file.seek(0));
+    const QList<QPair<quint64, QByteArray>> records = _readRecords(file.readAll());
+    QCOMPARE(records.size(), messageCount);
+
+    quint64 lastTimestamp = 0;
+    for (int i = 0; i < records.size(); i++) {
+        QVERIFY(records[i].first >= lastTimestamp);
+        lastTimestamp = records[i].first;
+        QCOMPARE(records[i].second, _frame(messages[i]));
+    }
+}
+
+void TelemetryLogWriterTest::_testSplitSentBytes()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    const QByteArray frame1 = _frame(_heartbeat(1, 1));
+    const QByteArray frame2 = _frame(_heartbeat(2, 2));
+
+    TelemetryLogWriter writer;
+    writer.startLogging(&file, 0);
+    QVERIFY(writer.logBytes(frame1 + frame2));
+    writer.stopLogging();
+
+    QVERIFY(file.seek(0));
+    const QList<QPair<quint64, QByteArray>> records = _readRecords(file.readAll());
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(records[0].second, frame1);
+    QCOMPARE(records[1].second, frame2);
+}
+
+void TelemetryLogWriterTest::_testConcurrentProducers()
+{
+    static constexpr int producerCount = 4;
+    static constexpr int messagesPerProducer = 5000;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    // Packing uses the shared channel status, so it happens up front
+    QList<QList<mavlink_message_t>> messages(producerCount);
+    for (int producer = 0; producer < producerCount; producer++) {
+        for (int i = 0; i < messagesPerProducer; i++) {
+            messages[producer].append(_heartbeat(static_cast<uint8_t>(producer + 1), i));
+        }
+    }
+
+    TelemetryLogWriter writer;
+    writer.startLogging(&file, 50);
+
+    QList<QThread*> producers;
+    for (int producer = 0; producer < producerCount; producer++) {
+        const QList<mavlink_message_t> &producerMessages = messages[producer];
+        producers.append(QThread::create([&writer, &producerMessages]() {
+            for (const mavlink_message_t &message : producerMessages) {
+                (void) writer.logMessage(message);
+            }
+        }));
+        producers.last()->start();
+    }
+    for (QThread *producer : producers) {
+        QVERIFY(producer->wait(10000));
+    }
+    qDeleteAll(producers);
+
+    writer.stopLogging();
+
+    QVERIFY(file.seek(0));
+    const QList<QPair<quint64, QByteArray>> records = _readRecords(file.readAll());
+    QCOMPARE(static_cast<quint64>(records.size()) + writer.droppedRecords(), static_cast<quint64>(producerCount * messagesPerProducer));
+    QVERIFY(writer.maxQueueDepth() <= TelemetryLogWriter::kRingSlots);
+
+    // Records of each producer stay in order
+    QList<int> lastCustomMode(producerCount + 1, -1);
+    for (const QPair<quint64, QByteArray> &record : records) {
+        // MAVLink 2 header: stx, len, incompat, compat, seq, sysid, ...
+        const uint8_t sysid = static_cast<uint8_t>(record.second[5]);
+        QVERIFY((sysid >= 1) && (sysid <= producerCount));
+        const int customMode = qFromLittleEndian<quint32>(record.second.constData() + MAVLINK_CORE_HEADER_LEN + 1);
+        QVERIFY(customMode > lastCustomMode[sysid]);
+        lastCustomMode[sysid] = customMode;
+    }
+}
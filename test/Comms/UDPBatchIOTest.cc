@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UDPBatchIOTest.h"
+#include "UDPBatchIO.h"
+#include "UDPLink.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtNetwork/QUdpSocket>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace
+{
+
+constexpr int kDatagramCount = 200;
+
+QByteArray _payload(int index)
+{
+    return QByteArray::number(index).rightJustified(16, '0');
+}
+
+/// Reads until count datagrams arrived or the timeout expired
+void _receiveAll(UDPBatchIO &batchIO, QUdpSocket &socket, QList<UDPDatagram> &datagrams, qsizetype count)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while ((datagrams.size() < count) && (timer.elapsed() < 5000)) {
+        if (batchIO.receive(&socket, datagrams) == 0) {
+            (void) socket.waitForReadyRead(100);
+        }
+    }
+}
+
+} // namespace
+
+void UDPBatchIOTest::_testReceive()
+{
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    for (int i = 0; i < kDatagramCount; i++) {
+        QCOMPARE(sender.writeDatagram(_payload(i), QHostAddress::LocalHost, receiver.localPort()), static_cast<qint64>(_payload(i).size()));
+    }
+    // Empty datagrams are dropped
+    QCOMPARE(sender.writeDatagram(QByteArray(), QHostAddress::LocalHost, receiver.localPort()), static_cast<qint64>(0));
+
+    UDPBatchIO batchIO;
+    QList<UDPDatagram> datagrams;
+    _receiveAll(batchIO, receiver, datagrams, kDatagramCount);
+
+    QCOMPARE(datagrams.size(), static_cast<qsizetype>(kDatagramCount));
+    for (int i = 0; i < kDatagramCount; i++) {
+        QCOMPARE(datagrams[i].data, _payload(i));
+        QCOMPARE(datagrams[i].senderAddress, QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(datagrams[i].senderPort, sender.localPort());
+    }
+
+    // readyRead must keep working after the descriptor was drained behind the socket's back
+    QSignalSpy readyReadSpy(&receiver, &QUdpSocket::readyRead);
+    QCOMPARE(sender.writeDatagram(_payload(0), QHostAddress::LocalHost, receiver.localPort()), static_cast<qint64>(_payload(0).size()));
+    QVERIFY(readyReadSpy.wait(1000));
+
+    datagrams.clear();
+    (void) batchIO.receive(&receiver, datagrams);
+    QCOMPARE(datagrams.size(), static_cast<qsizetype>(1));
+    QCOMPARE(datagrams[0].data, _payload(0));
+}
+
+void UDPBatchIOTest::_testReceiveLimit()
+{
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    QUdpSocket sender;
+
+    for (int i = 0; i < 10; i++) {
+        (void) sender.writeDatagram(_payload(i), QHostAddress::LocalHost, receiver.localPort());
+    }
+    QVERIFY(receiver.waitForReadyRead(1000));
+
+    UDPBatchIO batchIO;
+    QList<UDPDatagram> datagrams;
+    QCOMPARE(batchIO.receive(&receiver, datagrams, 3), static_cast<qsizetype>(3));
+    QCOMPARE(datagrams.size(), static_cast<qsizetype>(3));
+
+    _receiveAll(batchIO, receiver, datagrams, 10);
+    QCOMPARE(datagrams.size(), static_cast<qsizetype>(10));
+    for (int i = 0; i < 10; i++) {
+        QCOMPARE(datagrams[i].data, _payload(i));
+    }
+}
+
+void UDPBatchIOTest::_testSend()
+{
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::AnyIPv4, 0));
+
+    QList<QUdpSocket*> receivers;
+    QList<std::shared_ptr<UDPClient>> targets;
+    for (int i = 0; i < 3; i++) {
+        QUdpSocket *const receiver = new QUdpSocket(this);
+        QVERIFY(receiver->bind(QHostAddress::LocalHost, 0));
+        receivers.append(receiver);
+        targets.append(std::make_shared<UDPClient>(QHostAddress(QHostAddress::LocalHost), receiver->localPort()));
+    }
+
+    const QByteArray data("batched");
+    QCOMPARE(UDPBatchIO::send(&sender, data, targets), static_cast<qsizetype>(0));
+
+    for (QUdpSocket *receiver : receivers) {
+        UDPBatchIO batchIO;
+        QList<UDPDatagram> datagrams;
+        _receiveAll(batchIO, *receiver, datagrams, 1);
+        QCOMPARE(datagrams.size(), static_cast<qsizetype>(1));
+        QCOMPARE(datagrams[0].data, data);
+        QCOMPARE(datagrams[0].senderPort, sender.localPort());
+    }
+
+    qDeleteAll(receivers);
+}
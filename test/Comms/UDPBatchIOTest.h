@@ -0,0 +1,22 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class UDPBatchIOTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testReceive();
+    void _testReceiveLimit();
+    void _testSend();
+};
@@ -0,0 +1,251 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactGroupTest.h"
+#include "FactGroup.h"
+#include "FactGroupUpdateScheduler.h"
+#include "LinkManager.h"
+#include "MockLink.h"
+#include "MultiVehicleManager.h"
+#include "QmlObjectListModel.h"
+#include "Vehicle.h"
+#include "VehicleTemperatureFactGroup.h"
+
+#include <QtCore/QSet>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace
+{
+
+class TestFactGroup : public FactGroup
+{
+public:
+    explicit TestFactGroup(int updateRateMSecs, QObject *parent = nullptr)
+        : FactGroup(updateRateMSecs, parent)
+    {
+        _addFact(&fact1);
+        _addFact(&fact2);
+    }
+
+    void addFact(Fact *fact) { _addFact(fact); }
+    template<typename T>
+    void addLazyFactGroup(const QString &name) { _addLazyFactGroup<T>(name); }
+
+    Fact fact1 = Fact(0, QStringLiteral("fact1"), FactMetaData::valueTypeDouble);
+    Fact fact2 = Fact(0, QStringLiteral("fact2"), FactMetaData::valueTypeDouble);
+};
+
+class LazyFactGroup : public FactGroup
+{
+public:
+    explicit LazyFactGroup(QObject *parent = nullptr)
+        : FactGroup(1000, parent)
+    {
+        _addFact(&fact);
+    }
+
+    QList<uint32_t> handledMessageIds() const final { return { MAVLINK_MSG_ID_HEARTBEAT }; }
+
+    Fact fact = Fact(0, QStringLiteral("fact"), FactMetaData::valueTypeDouble);
+};
+
+/// Collects the meta data of all Facts of a group and its created sub groups keyed by Fact path
+void _collectMetaData(const FactGroup *factGroup, const QString &prefix, QHash<QString, const FactMetaData*> &metaDataMap)
+{
+    for (const QString &name : factGroup->factNames()) {
+        metaDataMap[prefix + name] = factGroup->getFact(name)->metaData();
+    }
+    for (auto it = factGroup->factGroups().constBegin(); it != factGroup->factGroups().constEnd(); ++it) {
+        _collectMetaData(it.value(), prefix + it.key() + QStringLiteral("."), metaDataMap);
+    }
+}
+
+} // namespace
+
+void FactGroupTest::init()
+{
+    UnitTest::init();
+
+    FactGroupUpdateScheduler::instance()->flush();
+    QCOMPARE(FactGroupUpdateScheduler::instance()->scheduledCount(), static_cast<qsizetype>(0));
+}
+
+void FactGroupTest::_testDeferredUpdate()
+{
+    TestFactGroup factGroup(50);
+    QSignalSpy fact1Spy(&factGroup.fact1, &Fact::valueChanged);
+    QSignalSpy fact2Spy(&factGroup.fact2, &Fact::valueChanged);
+
+    factGroup.fact1.setTelemetryValue(1.0);
+    factGroup.fact1.setTelemetryValue(2.0);
+    QCOMPARE(fact1Spy.count(), 0);
+    QCOMPARE(FactGroupUpdateScheduler::instance()->scheduledCount(), static_cast<qsizetype>(1));
+
+    // Only the changed Fact signals, once with the latest value
+    QTRY_COMPARE(fact1Spy.count(), 1);
+    QCOMPARE(fact1Spy.takeFirst().at(0).toDouble(), 2.0);
+    QCOMPARE(fact2Spy.count(), 0);
+
+    // Nothing is scheduled without changes
+    QCOMPARE(FactGroupUpdateScheduler::instance()->scheduledCount(), static_cast<qsizetype>(0));
+    QTest::qWait(100);
+    QCOMPARE(fact1Spy.count(), 0);
+}
+
+void FactGroupTest::_testSharedUpdatePass()
+{
+    TestFactGroup factGroup1(1000);
+    TestFactGroup factGroup2(1000);
+    QSignalSpy fact1Spy(&factGroup1.fact1, &Fact::valueChanged);
+    QSignalSpy fact2Spy(&factGroup2.fact2, &Fact::valueChanged);
+
+    factGroup1.fact1.setTelemetryValue(1.0);
+    factGroup2.fact2.setTelemetryValue(1.0);
+    QCOMPARE(FactGroupUpdateScheduler::instance()->scheduledCount(), static_cast<qsizetype>(2));
+
+    // Groups with the same rate come due together
+    QTRY_VERIFY_WITH_TIMEOUT((fact1Spy.count() + fact2Spy.count()) > 0, 2000);
+    QCOMPARE(fact1Spy.count(), 1);
+    QCOMPARE(fact2Spy.count(), 1);
+}
+
+void FactGroupTest::_testLiveUpdates()
+{
+    TestFactGroup factGroup(1000);
+    QSignalSpy factSpy(&factGroup.fact1, &Fact::valueChanged);
+
+    factGroup.fact1.setTelemetryValue(1.0);
+    QCOMPARE(factSpy.count(), 0);
+
+    // Switching to live updates sends the pending change right away
+    factGroup.setLiveUpdates(true);
+    QCOMPARE(factSpy.count(), 1);
+    QCOMPARE(FactGroupUpdateScheduler::instance()->scheduledCount(), static_cast<qsizetype>(0));
+
+    factGroup.fact1.setTelemetryValue(2.0);
+    QCOMPARE(factSpy.count(), 2);
+
+    factGroup.setLiveUpdates(false);
+    factGroup.fact1.setTelemetryValue(3.0);
+    QCOMPARE(factSpy.count(), 2);
+    FactGroupUpdateScheduler::instance()->flush();
+    QCOMPARE(factSpy.count(), 3);
+}
+
+void FactGroupTest::_testDeletedFact()
+{
+    TestFactGroup factGroup(1000);
+    Fact *const fact = new Fact(0, QStringLiteral("fact3"), FactMetaData::valueTypeDouble, &factGroup);
+    factGroup.addFact(fact);
+
+    fact->setTelemetryValue(1.0);
+    QCOMPARE(FactGroupUpdateScheduler::instance()->scheduledCount(), static_cast<qsizetype>(1));
+
+    delete fact;
+    QCOMPARE(FactGroupUpdateScheduler::instance()->scheduledCount(), static_cast<qsizetype>(0));
+}
+
+void FactGroupTest::_testLazyFactGroup()
+{
+    TestFactGroup factGroup(1000);
+    QSignalSpy namesSpy(&factGroup, &FactGroup::factGroupNamesChanged);
+
+    factGroup.addLazyFactGroup<LazyFactGroup>(QStringLiteral("lazy"));
+    QCOMPARE(namesSpy.count(), 1);
+    QCOMPARE(factGroup.factGroupNames(), QStringList({ QStringLiteral("lazy") }));
+    QVERIFY(factGroup.factGroups().isEmpty());
+    QCOMPARE(factGroup.lazyFactGroups().value(QStringLiteral("lazy")).handledMessageIds, QList<uint32_t>({ MAVLINK_MSG_ID_HEARTBEAT }));
+
+    // Created on first access, afterwards it is a regular sub group
+    FactGroup *const lazyFactGroup = factGroup.getFactGroup(QStringLiteral("lazy"));
+    QVERIFY(lazyFactGroup);
+    QCOMPARE(lazyFactGroup->parent(), &factGroup);
+    QCOMPARE(factGroup.factGroups().count(), 1);
+    QVERIFY(factGroup.lazyFactGroups().isEmpty());
+    QCOMPARE(factGroup.factGroupNames(), QStringList({ QStringLiteral("lazy") }));
+    QCOMPARE(factGroup.getFactGroup(QStringLiteral("lazy")), lazyFactGroup);
+    QVERIFY(factGroup.factExists(QStringLiteral("lazy.fact")));
+}
+
+void FactGroupTest::_testSharedMetaData()
+{
+    VehicleTemperatureFactGroup factGroup1;
+    VehicleTemperatureFactGroup factGroup2;
+    const qsizetype sharedCount = FactMetaData::sharedMetaDataCount();
+    VehicleTemperatureFactGroup factGroup3;
+    QCOMPARE(FactMetaData::sharedMetaDataCount(), sharedCount);
+
+    FactMetaData *const sharedMetaData = factGroup1.temperature1()->metaData();
+    QVERIFY(sharedMetaData->isShared());
+    QCOMPARE(factGroup2.temperature1()->metaData(), sharedMetaData);
+    QCOMPARE(factGroup3.temperature1()->metaData(), sharedMetaData);
+
+    // Modifying a Fact's meta data gives it a private copy
+    factGroup2.temperature1()->setEnumInfo({ QStringLiteral("Zero") }, { 0 });
+    QVERIFY(factGroup2.temperature1()->metaData() != sharedMetaData);
+    QVERIFY(!factGroup2.temperature1()->metaData()->isShared());
+    QCOMPARE(factGroup2.temperature1()->metaData()->name(), sharedMetaData->name());
+    QCOMPARE(factGroup2.temperature1()->enumStrings(), QStringList({ QStringLiteral("Zero") }));
+    QVERIFY(factGroup1.temperature1()->enumStrings().isEmpty());
+    QCOMPARE(factGroup1.temperature1()->metaData(), sharedMetaData);
+
+    // Assignment never writes through to the shared instance
+    *factGroup3.temperature1() = *factGroup2.temperature1();
+    QVERIFY(factGroup3.temperature1()->metaData() != sharedMetaData);
+    QVERIFY(sharedMetaData->enumStrings().isEmpty());
+}
+
+void FactGroupTest::_benchmarkSharedMetaDataManyVehicles()
+{
+    constexpr int kVehicleCount = 32;
+
+    for (int i = 0; i < kVehicleCount; i++) {
+        QVERIFY(MockLink::startNoInitialConnectMockLink(false));
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(MultiVehicleManager::instance()->vehicles()->count(), kVehicleCount, 10000);
+
+    QHash<QString, const FactMetaData*> referenceMap;
+    QSet<const FactMetaData*> uniqueMetaData;
+    QSet<const FactMetaData*> sharedMetaData;
+    qsizetype factCount = 0;
+    const QmlObjectListModel *const vehicles = MultiVehicleManager::instance()->vehicles();
+    for (int i = 0; i < vehicles->count(); i++) {
+        QHash<QString, const FactMetaData*> metaDataMap;
+        _collectMetaData(vehicles->value<const Vehicle*>(i), QString(), metaDataMap);
+        factCount += metaDataMap.count();
+
+        for (auto it = metaDataMap.constBegin(); it != metaDataMap.constEnd(); ++it) {
+            const FactMetaData *const metaData = it.value();
+            // Json based telemetry meta data is the same instance on every vehicle
+            const auto reference = referenceMap.constFind(it.key());
+            if (reference == referenceMap.constEnd()) {
+                referenceMap.insert(it.key(), metaData);
+            } else if (reference.value()->isShared() && metaData->isShared()) {
+                QCOMPARE(reference.value(), metaData);
+            }
+            uniqueMetaData.insert(metaData);
+            if (metaData->isShared()) {
+                sharedMetaData.insert(metaData);
+            }
+        }
+    }
+    QVERIFY(factCount > 0);
+    QVERIFY(!sharedMetaData.isEmpty());
+    QVERIFY(sharedMetaData.count() <= referenceMap.count());
+
+    const qsizetype sharedBytes = uniqueMetaData.count() * static_cast<qsizetype>(sizeof(FactMetaData));
+    const qsizetype perFactBytes = factCount * static_cast<qsizetype>(sizeof(FactMetaData));
+    qDebug() << "Vehicles:" << kVehicleCount << "Facts:" << factCount << "Meta data instances:" << uniqueMetaData.count()
+             << "Bytes:" << sharedBytes << "instead of" << perFactBytes;
+    QTest::setBenchmarkResult(sharedBytes, QTest::BytesAllocated);
+
+    LinkManager::instance()->disconnectAll();
+    QTRY_COMPARE_WITH_TIMEOUT(MultiVehicleManager::instance()->vehicles()->count(), 0, 10000);
+}
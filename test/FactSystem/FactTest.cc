@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactTest.h"
+#include "Fact.h"
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <limits>
+
+void FactTest::_testTelemetryValueTypes()
+{
+    Fact doubleFact(0, QStringLiteral("double"), FactMetaData::valueTypeDouble);
+    doubleFact.setTelemetryValue(1.5f);
+    QCOMPARE(doubleFact.rawValue().typeId(), QMetaType::Double);
+    QCOMPARE(doubleFact.rawValue().toDouble(), 1.5);
+
+    Fact floatFact(0, QStringLiteral("float"), FactMetaData::valueTypeFloat);
+    floatFact.setTelemetryValue(0.1);
+    QCOMPARE(floatFact.rawValue().typeId(), QMetaType::Float);
+    QCOMPARE(floatFact.rawValue().toFloat(), 0.1f);
+
+    Fact uint8Fact(0, QStringLiteral("uint8"), FactMetaData::valueTypeUint8);
+    uint8Fact.setTelemetryValue(42);
+    QCOMPARE(uint8Fact.rawValue().typeId(), QMetaType::UInt);
+    QCOMPARE(uint8Fact.rawValue().toUInt(), 42U);
+
+    Fact int32Fact(0, QStringLiteral("int32"), FactMetaData::valueTypeInt32);
+    int32Fact.setTelemetryValue(-7.9);
+    QCOMPARE(int32Fact.rawValue().typeId(), QMetaType::Int);
+    QCOMPARE(int32Fact.rawValue().toInt(), -8);
+    int32Fact.setTelemetryValue(qQNaN());
+    QCOMPARE(int32Fact.rawValue().toInt(), 0);
+
+    Fact uint64Fact(0, QStringLiteral("uint64"), FactMetaData::valueTypeUint64);
+    uint64Fact.setTelemetryValue(std::numeric_limits<quint64>::max());
+    QCOMPARE(uint64Fact.rawValue().typeId(), QMetaType::ULongLong);
+    QCOMPARE(uint64Fact.rawValue().toULongLong(), std::numeric_limits<quint64>::max());
+
+    Fact boolFact(0, QStringLiteral("bool"), FactMetaData::valueTypeBool);
+    boolFact.setTelemetryValue(true);
+    QCOMPARE(boolFact.rawValue().typeId(), QMetaType::Bool);
+    QCOMPARE(boolFact.rawValue().toBool(), true);
+
+    // Types without inline storage fall back to setRawValue
+    Fact stringFact(0, QStringLiteral("string"), FactMetaData::valueTypeString);
+    stringFact.setTelemetryValue(3);
+    QCOMPARE(stringFact.rawValue().toString(), QStringLiteral("3"));
+}
+
+void FactTest::_testTelemetryValueChanged()
+{
+    Fact fact(0, QStringLiteral("double"), FactMetaData::valueTypeDouble);
+    QSignalSpy valueSpy(&fact, &Fact::valueChanged);
+    QSignalSpy rawValueSpy(&fact, &Fact::rawValueChanged);
+
+    fact.setTelemetryValue(2.0);
+    QCOMPARE(valueSpy.count(), 1);
+    QCOMPARE(rawValueSpy.count(), 1);
+    QCOMPARE(valueSpy.takeFirst().at(0).toDouble(), 2.0);
+
+    fact.setTelemetryValue(2);
+    QCOMPARE(valueSpy.count(), 0);
+    QCOMPARE(rawValueSpy.count(), 1);
+
+    fact.setTelemetryValue(qQNaN());
+    fact.setTelemetryValue(qQNaN());
+    QCOMPARE(valueSpy.count(), 1);
+    QVERIFY(qIsNaN(fact.rawValue().toDouble()));
+}
+
+void FactTest::_testTelemetryValueDeferred()
+{
+    Fact fact(0, QStringLiteral("double"), FactMetaData::valueTypeDouble);
+    fact.setSendValueChangedSignals(false);
+    QSignalSpy valueSpy(&fact, &Fact::valueChanged);
+
+    fact.setTelemetryValue(1.0);
+    fact.setTelemetryValue(2.0);
+    QCOMPARE(valueSpy.count(), 0);
+
+    fact.sendDeferredValueChangedSignal();
+    QCOMPARE(valueSpy.count(), 1);
+    QCOMPARE(valueSpy.takeFirst().at(0).toDouble(), 2.0);
+
+    fact.sendDeferredValueChangedSignal();
+    QCOMPARE(valueSpy.count(), 0);
+}
+
+void FactTest::_testTelemetryValueMixed()
+{
+    Fact fact(0, QStringLiteral("int16"), FactMetaData::valueTypeInt16);
+    QSignalSpy valueSpy(&fact, &Fact::valueChanged);
+
+    fact.setTelemetryValue(5);
+    fact.setRawValue(6);
+    QCOMPARE(fact.rawValue().toInt(), 6);
+    QCOMPARE(valueSpy.count(), 2);
+
+    // The inline value follows setRawValue, repeating it is no change
+    fact.setTelemetryValue(6);
+    QCOMPARE(valueSpy.count(), 2);
+
+    fact.setTelemetryValue(7);
+    QCOMPARE(fact.rawValue().toInt(), 7);
+    QCOMPARE(fact.cookedValue().toInt(), 7);
+    QCOMPARE(valueSpy.count(), 3);
+}
+
+void FactTest::_testTelemetryValueMetaData()
+{
+    // The meta data type wins over the type the Fact was constructed with, as in setRawValue
+    Fact fact(0, QStringLiteral("count"), FactMetaData::valueTypeInt32);
+    fact.setMetaData(new FactMetaData(FactMetaData::valueTypeUint32, &fact));
+    fact.setTelemetryValue(5);
+    QCOMPARE(fact.rawValue().typeId(), QMetaType::UInt);
+    QCOMPARE(fact.rawValue().toUInt(), 5U);
+
+    // Same conversions as setRawValue
+    const QList<double> values = { 21.5, -21.5, 40000.4, -7.9, 1e6 };
+    for (const FactMetaData::ValueType_t type : { FactMetaData::valueTypeInt16, FactMetaData::valueTypeUint8, FactMetaData::valueTypeInt32, FactMetaData::valueTypeFloat, FactMetaData::valueTypeBool }) {
+        for (const double value : values) {
+            Fact telemetryFact(0, QStringLiteral("telemetry"), type);
+            Fact rawFact(0, QStringLiteral("raw"), type);
+            telemetryFact.setTelemetryValue(value);
+            rawFact.setRawValue(value);
+            QCOMPARE(telemetryFact.rawValue(), rawFact.rawValue());
+        }
+    }
+}
@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryHistoryTest.h"
+#include "FactGroup.h"
+#include "FactGroupUpdateScheduler.h"
+#include "TelemetryHistory.h"
+
+#include <QtTest/QTest>
+
+#include <limits>
+
+namespace
+{
+
+constexpr qint64 kMaxTime = std::numeric_limits<qint64>::max();
+
+class TestFactGroup : public FactGroup
+{
+public:
+    explicit TestFactGroup(QObject *parent = nullptr)
+        : FactGroup(100, parent)
+    {
+        _addFact(&value);
+        _addFact(&text);
+    }
+
+    void addFactGroup(FactGroup *factGroup, const QString &name) { _addFactGroup(factGroup, name); }
+
+    Fact value = Fact(0, QStringLiteral("value"), FactMetaData::valueTypeDouble);
+    Fact text = Fact(0, QStringLiteral("text"), FactMetaData::valueTypeString);
+};
+
+} // namespace
+
+void TelemetryHistoryTest::_testRingBuffer()
+{
+    // One second at 100 msecs keeps 11 samples
+    TelemetryHistory history(1);
+    Fact fact(0, QStringLiteral("fact"), FactMetaData::valueTypeDouble);
+    history.addFact(&fact, QStringLiteral("fact"), 100);
+    const int series = history.seriesIndex(QStringLiteral("fact"));
+    QCOMPARE(series, 0);
+
+    for (int i = 0; i < 15; i++) {
+        history.record(series, i * 100, i);
+    }
+
+    // The oldest samples are overwritten, the result wraps around the end of the buffer
+    const TelemetryHistory::Samples samples = history.samples(series, 0, kMaxTime);
+    QCOMPARE(samples.count(), static_cast<qsizetype>(11));
+    QVERIFY(!samples.timesMSecs[1].empty());
+    for (qsizetype i = 0; i < samples.count(); i++) {
+        QCOMPARE(samples.timeMSecs(i), static_cast<qint64>((i + 4) * 100));
+        QCOMPARE(samples.value(i), static_cast<double>(i + 4));
+    }
+}
+
+void TelemetryHistoryTest::_testRange()
+{
+    TelemetryHistory history(60);
+    Fact fact(0, QStringLiteral("fact"), FactMetaData::valueTypeDouble);
+    history.addFact(&fact, QStringLiteral("fact"), 100);
+    const int series = history.seriesIndex(QStringLiteral("fact"));
+
+    for (int i = 0; i < 100; i++) {
+        history.record(series, i * 100, i);
+    }
+
+    TelemetryHistory::Samples samples = history.samples(series, 1000, 2000);
+    QCOMPARE(samples.count(), static_cast<qsizetype>(11));
+    QCOMPARE(samples.timeMSecs(0), 1000LL);
+    QCOMPARE(samples.timeMSecs(10), 2000LL);
+
+    samples = history.samples(series, 1050, 1150);
+    QCOMPARE(samples.count(), static_cast<qsizetype>(1));
+    QCOMPARE(samples.value(0), 11.0);
+
+    QCOMPARE(history.samples(series, 20000, 30000).count(), static_cast<qsizetype>(0));
+    QCOMPARE(history.samples(-1, 0, kMaxTime).count(), static_cast<qsizetype>(0));
+    QCOMPARE(history.seriesIndex(QStringLiteral("unknown")), -1);
+}
+
+void TelemetryHistoryTest::_testTimeOrder()
+{
+    TelemetryHistory history(60);
+    Fact fact(0, QStringLiteral("fact"), FactMetaData::valueTypeDouble);
+    history.addFact(&fact, QStringLiteral("fact"), 100);
+    const int series = history.seriesIndex(QStringLiteral("fact"));
+
+    // A time going backwards does not break the order range queries rely on
+    history.record(series, 1000, 1.0);
+    history.record(series, 500, 2.0);
+    history.record(series, 1100, 3.0);
+
+    const TelemetryHistory::Samples samples = history.samples(series, 1000, 1000);
+    QCOMPARE(samples.count(), static_cast<qsizetype>(2));
+    QCOMPARE(samples.value(0), 1.0);
+    QCOMPARE(samples.value(1), 2.0);
+    QCOMPARE(history.samples(series, 1001, kMaxTime).count(), static_cast<qsizetype>(1));
+
+    // The clock is monotonic
+    const qint64 nowMSecs = history.nowMSecs();
+    QVERIFY(nowMSecs >= 0);
+    QVERIFY(history.nowMSecs() >= nowMSecs);
+}
+
+void TelemetryHistoryTest::_testDownsampleMinMax()
+{
+    TelemetryHistory history(600);
+    Fact fact(0, QStringLiteral("fact"), FactMetaData::valueTypeDouble);
+    history.addFact(&fact, QStringLiteral("fact"), 100);
+    const int series = history.seriesIndex(QStringLiteral("fact"));
+
+    for (int i = 0; i < 1000; i++) {
+        history.record(series, i * 100, (i == 500) ? 100.0 : ((i == 700) ? -100.0 : 0.0));
+    }
+    history.record(series, 1000 * 100, qQNaN());
+
+    const QList<QPointF> points = history.downsample(series, 0, kMaxTime, 20, TelemetryHistory::DownsampleMinMax);
+    QVERIFY(points.count() <= 20);
+
+    // Spikes survive
+    bool foundMax = false;
+    bool foundMin = false;
+    for (qsizetype i = 0; i < points.count(); i++) {
+        foundMax |= (points[i].y() == 100.0);
+        foundMin |= (points[i].y() == -100.0);
+        QVERIFY(!qIsNaN(points[i].y()));
+        if (i > 0) {
+            QVERIFY(points[i].x() > points[i - 1].x());
+        }
+    }
+    QVERIFY(foundMax);
+    QVERIFY(foundMin);
+}
+
+void TelemetryHistoryTest::_testDownsampleLTTB()
+{
+    TelemetryHistory history(600);
+    Fact fact(0, QStringLiteral("fact"), FactMetaData::valueTypeDouble);
+    history.addFact(&fact, QStringLiteral("fact"), 100);
+    const int series = history.seriesIndex(QStringLiteral("fact"));
+
+    for (int i = 0; i < 1000; i++) {
+        history.record(series, i * 100, (i == 500) ? 100.0 : qSin(i / 50.0));
+    }
+
+    const QList<QPointF> points = history.downsample(series, 0, kMaxTime, 50, TelemetryHistory::DownsampleLTTB);
+    QCOMPARE(points.count(), static_cast<qsizetype>(50));
+    QCOMPARE(points.first().x(), 0.0);
+    QCOMPARE(points.last().x(), 99900.0);
+
+    bool foundSpike = false;
+    for (const QPointF &point : points) {
+        foundSpike |= (point.y() == 100.0);
+    }
+    QVERIFY(foundSpike);
+
+    // Fewer samples than points are returned as is
+    QCOMPARE(history.downsample(series, 0, 900, 50, TelemetryHistory::DownsampleLTTB).count(), static_cast<qsizetype>(10));
+}
+
+void TelemetryHistoryTest::_testFactGroup()
+{
+    TelemetryHistory history;
+    TestFactGroup factGroup;
+    TestFactGroup *const subGroup = new TestFactGroup(&factGroup);
+    factGroup.setTelemetryHistory(&history);
+
+    // Sub groups added after the history are recorded as well, string Facts are not
+    TestFactGroup *const laterGroup = new TestFactGroup(&factGroup);
+    factGroup.addFactGroup(laterGroup, QStringLiteral("later"));
+    factGroup.addFactGroup(subGroup, QStringLiteral("sub"));
+    QCOMPARE(history.seriesNames(), QStringList({ QStringLiteral("later.value"), QStringLiteral("sub.value"), QStringLiteral("value") }));
+
+    factGroup.value.setTelemetryValue(1.0);
+    subGroup->value.setTelemetryValue(2.0);
+    FactGroupUpdateScheduler::instance()->flush();
+
+    factGroup.value.setTelemetryValue(3.0);
+    FactGroupUpdateScheduler::instance()->flush();
+
+    TelemetryHistory::Samples samples = history.samples(history.seriesIndex(QStringLiteral("value")), 0, kMaxTime);
+    QCOMPARE(samples.count(), static_cast<qsizetype>(2));
+    QCOMPARE(samples.value(0), 1.0);
+    QCOMPARE(samples.value(1), 3.0);
+
+    samples = history.samples(history.seriesIndex(QStringLiteral("sub.value")), 0, kMaxTime);
+    QCOMPARE(samples.count(), static_cast<qsizetype>(1));
+    QCOMPARE(samples.value(0), 2.0);
+
+    QCOMPARE(history.samples(history.seriesIndex(QStringLiteral("later.value")), 0, kMaxTime).count(), static_cast<qsizetype>(0));
+}
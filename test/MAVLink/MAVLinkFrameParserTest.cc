@@ -0,0 +1,301 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFrameParserTest.h"
+#include "LinkManager.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkSigning.h"
+#include "QGCMAVLink.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QRandomGenerator>
+#include <QtTest/QTest>
+
+namespace
+{
+
+void _compareMessages(const QList<mavlink_message_t> &actual, const QList<mavlink_message_t> &expected)
+{
+    QCOMPARE(actual.size(), expected.size());
+    for (qsizetype i = 0; i < actual.size(); i++) {
+        const mavlink_message_t &a = actual[i];
+        const mavlink_message_t &e = expected[i];
+        QCOMPARE(a.magic, e.magic);
+        QCOMPARE(a.msgid, e.msgid);
+        QCOMPARE(a.seq, e.seq);
+        QCOMPARE(a.sysid, e.sysid);
+        QCOMPARE(a.compid, e.compid);
+        QCOMPARE(a.len, e.len);
+        QCOMPARE(a.checksum, e.checksum);
+        QCOMPARE(a.incompat_flags, e.incompat_flags);
+        QCOMPARE(a.compat_flags, e.compat_flags);
+        QVERIFY(memcmp(_MAV_PAYLOAD(&a), _MAV_PAYLOAD(&e), MAVLINK_MAX_PAYLOAD_LEN) == 0);
+    }
+}
+
+void _resetChannel(uint8_t channel)
+{
+    *mavlink_get_channel_status(channel) = mavlink_status_t{};
+    mavlink_reset_channel_status(channel);
+}
+
+} // namespace
+
+void MAVLinkFrameParserTest::init()
+{
+    UnitTest::init();
+
+    LinkManager *const linkManager = LinkManager::instance();
+    _encodeChannel = linkManager->allocateMavlinkChannel();
+    _referenceChannel = linkManager->allocateMavlinkChannel();
+    _parserChannel = linkManager->allocateMavlinkChannel();
+    QVERIFY(QGCMAVLink::isValidChannel(_encodeChannel));
+    QVERIFY(QGCMAVLink::isValidChannel(_referenceChannel));
+    QVERIFY(QGCMAVLink::isValidChannel(_parserChannel));
+}
+
+void MAVLinkFrameParserTest::cleanup()
+{
+    LinkManager *const linkManager = LinkManager::instance();
+    for (const uint8_t channel : { _encodeChannel, _referenceChannel, _parserChannel }) {
+        if (!QGCMAVLink::isValidChannel(channel)) {
+            continue;
+        }
+        // Leave the channels as a link would find them
+        (void) MAVLinkSigning::initSigning(static_cast<mavlink_channel_t>(channel), QByteArrayView(), nullptr);
+        _resetChannel(channel);
+        linkManager->freeMavlinkChannel(channel);
+    }
+    _encodeChannel = _referenceChannel = _parserChannel = LinkManager::invalidMavlinkChannel();
+
+    UnitTest::cleanup();
+}
+
+QByteArray MAVLinkFrameParserTest::_generateStream(int messageCount, bool addNoise) const
+{
+    QRandomGenerator random(1234);
+    QByteArray stream;
+
+    _resetChannel(_encodeChannel);
+    mavlink_status_t *const encodeStatus = mavlink_get_channel_status(_encodeChannel);
+
+    for (int i = 0; i < messageCount; i++) {
+        if ((i % 7) == 0) {
+            encodeStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        } else {
+            encodeStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        }
+
+        const uint8_t sysid = 1 + (i % 3);
+        mavlink_message_t message;
+        switch (i % 3) {
+        case 0:
+            (void) mavlink_msg_heartbeat_pack_chan(sysid, MAV_COMP_ID_AUTOPILOT1, _encodeChannel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, MAV_MODE_FLAG_CUSTOM_MODE_ENABLED, i, MAV_STATE_ACTIVE);
+            break;
+        case 1:
+            // Mostly zero fields, exercises MAVLink 2 payload truncation
+            (void) mavlink_msg_attitude_pack_chan(sysid, MAV_COMP_ID_AUTOPILOT1, _encodeChannel, &message, i, 0.1f * i, 0.f, 0.f, 0.f, 0.f, 0.f);
+            break;
+        default:
+            (void) mavlink_msg_global_position_int_pack_chan(sysid, MAV_COMP_ID_AUTOPILOT1, _encodeChannel, &message, i, 473977418 + i, 85455939 + i, 488000, 10000, 1, 2, 3, 9000);
+            break;
+        }
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+        QByteArray frame(reinterpret_cast<const char*>(buffer), len);
+
+        if (addNoise) {
+            if ((i % 11) == 5) {
+                // Corrupt a payload byte so the frame fails its CRC check
+                frame[frame.size() - 3] = static_cast<char>(frame[frame.size() - 3] ^ 0x5A);
+            }
+            if ((i % 5) == 0) {
+                const int noiseLen = random.bounded(1, 8);
+                for (int j = 0; j < noiseLen; j++) {
+                    stream.append(static_cast<char>(random.bounded(256)));
+                }
+            }
+        }
+
+        stream.append(frame);
+    }
+
+    return stream;
+}
+
+QList<mavlink_message_t> MAVLinkFrameParserTest::_parsePerByte(uint8_t channel, const QByteArray &data)
+{
+    QList<mavlink_message_t> messages;
+
+    _resetChannel(channel);
+    for (const char byte : data) {
+        mavlink_message_t message;
+        mavlink_status_t status;
+        if (mavlink_parse_char(channel, static_cast<uint8_t>(byte), &message, &status) == MAVLINK_FRAMING_OK) {
+            messages.append(message);
+        }
+    }
+
+    return messages;
+}
+
+void MAVLinkFrameParserTest::_testMatchesPerByteParser()
+{
+    const QByteArray stream = _generateStream(500, true);
+    const QList<mavlink_message_t> expected = _parsePerByte(_referenceChannel, stream);
+    QVERIFY(!expected.isEmpty());
+
+    _resetChannel(_parserChannel);
+    MAVLinkFrameParser parser(_parserChannel);
+    QList<mavlink_message_t> actual;
+    (void) parser.parse(stream, actual);
+
+    _compareMessages(actual, expected);
+    QVERIFY(parser.bulkFrameCount() > 0);
+
+    const mavlink_status_t *const referenceStatus = mavlink_get_channel_status(_referenceChannel);
+    const mavlink_status_t *const parserStatus = mavlink_get_channel_status(_parserChannel);
+    QCOMPARE(parserStatus->packet_rx_success_count, referenceStatus->packet_rx_success_count);
+    QCOMPARE(parserStatus->current_rx_seq, referenceStatus->current_rx_seq);
+    QCOMPARE(parserStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1, referenceStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1);
+}
+
+void MAVLinkFrameParserTest::_testSplitFrames()
+{
+    const QByteArray stream = _generateStream(500, true);
+    const QList<mavlink_message_t> expected = _parsePerByte(_referenceChannel, stream);
+
+    _resetChannel(_parserChannel);
+    MAVLinkFrameParser parser(_parserChannel);
+    QList<mavlink_message_t> actual;
+
+    QRandomGenerator random(4321);
+    qsizetype offset = 0;
+    while (offset < stream.size()) {
+        const qsizetype chunkLen = qMin<qsizetype>(random.bounded(1, 64), stream.size() - offset);
+        (void) parser.parse(reinterpret_cast<const uint8_t*>(stream.constData()) + offset, chunkLen, actual);
+        offset += chunkLen;
+    }
+
+    _compareMessages(actual, expected);
+    QVERIFY(parser.byteFrameCount() > 0);
+}
+
+void MAVLinkFrameParserTest::_testSignedFrames()
+{
+    static constexpr const char *signingKey = "frame_parser_key";
+    static constexpr qsizetype messageCount = 10;
+
+    _resetChannel(_encodeChannel);
+    _resetChannel(_parserChannel);
+    QVERIFY(MAVLinkSigning::initSigning(static_cast<mavlink_channel_t>(_encodeChannel), signingKey, MAVLinkSigning::insecureConnectionAccceptUnsignedCallback));
+    QVERIFY(MAVLinkSigning::initSigning(static_cast<mavlink_channel_t>(_parserChannel), signingKey, MAVLinkSigning::insecureConnectionAccceptUnsignedCallback));
+
+    QByteArray stream;
+    for (qsizetype i = 0; i < messageCount; i++) {
+        mavlink_message_t message;
+        (void) mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _encodeChannel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+        stream.append(reinterpret_cast<const char*>(buffer), len);
+    }
+
+    MAVLinkFrameParser parser(_parserChannel);
+    QList<mavlink_message_t> messages;
+    QCOMPARE(parser.parse(stream, messages), messageCount);
+    QCOMPARE(parser.bulkFrameCount(), static_cast<quint64>(0));
+    for (const mavlink_message_t &message : messages) {
+        QVERIFY(message.incompat_flags & MAVLINK_IFLAG_SIGNED);
+    }
+
+    // Unsigned heartbeats are rejected on an insecure signed channel
+    messages.clear();
+    (void) MAVLinkSigning::initSigning(static_cast<mavlink_channel_t>(_encodeChannel), QByteArrayView(), nullptr);
+    mavlink_message_t message;
+    (void) mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, _encodeChannel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+    QCOMPARE(parser.parse(buffer, len, messages), static_cast<qsizetype>(0));
+}
+
+/// Uses the tlog specified by QGC_BENCHMARK_TLOG if set, generated traffic otherwise.
+/// Tlog timestamps are left in the stream, both parsers have to skip over them.
+QByteArray MAVLinkFrameParserTest::_benchmarkData() const
+{
+    const QString tlogPath = qEnvironmentVariable("QGC_BENCHMARK_TLOG");
+    if (!tlogPath.isEmpty()) {
+        QFile tlog(tlogPath);
+        if (tlog.open(QIODevice::ReadOnly)) {
+            return tlog.readAll();
+        }
+        qWarning() << "Unable to open benchmark tlog" << tlogPath << tlog.errorString();
+    }
+
+    return _generateStream(20000, false);
+}
+
+void MAVLinkFrameParserTest::_testPrivateStatus()
+{
+    // Two senders interleave their data in small chunks, as datagrams of several vehicles on one UDP port do
+    const QByteArray stream = _generateStream(300, true);
+    const QList<mavlink_message_t> expected = _parsePerByte(_referenceChannel, stream);
+
+    _resetChannel(_parserChannel);
+    const mavlink_status_t channelStatus = *mavlink_get_channel_status(_parserChannel);
+    MAVLinkFrameParser parsers[2] = { MAVLinkFrameParser(_parserChannel, true), MAVLinkFrameParser(_parserChannel, true) };
+    QList<mavlink_message_t> actual[2];
+
+    QRandomGenerator random(5678);
+    qsizetype offset = 0;
+    while (offset < stream.size()) {
+        const qsizetype chunkLen = qMin<qsizetype>(random.bounded(1, 64), stream.size() - offset);
+        for (int i = 0; i < 2; i++) {
+            (void) parsers[i].parse(reinterpret_cast<const uint8_t*>(stream.constData()) + offset, chunkLen, actual[i]);
+        }
+        offset += chunkLen;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        QVERIFY(parsers[i].hasPrivateStatus());
+        _compareMessages(actual[i], expected);
+    }
+
+    // The channel itself is untouched
+    QCOMPARE(mavlink_get_channel_status(_parserChannel)->packet_rx_success_count, channelStatus.packet_rx_success_count);
+    QCOMPARE(mavlink_get_channel_status(_parserChannel)->parse_state, channelStatus.parse_state);
+}
+
+void MAVLinkFrameParserTest::_benchmarkPerByteParser()
+{
+    const QByteArray data = _benchmarkData();
+    qsizetype frameCount = 0;
+
+    QBENCHMARK {
+        frameCount = _parsePerByte(_referenceChannel, data).size();
+    }
+
+    QVERIFY(frameCount > 0);
+}
+
+void MAVLinkFrameParserTest::_benchmarkFrameParser()
+{
+    const QByteArray data = _benchmarkData();
+    qsizetype frameCount = 0;
+    QList<mavlink_message_t> messages;
+
+    QBENCHMARK {
+        _resetChannel(_parserChannel);
+        MAVLinkFrameParser parser(_parserChannel);
+        messages.clear();
+        frameCount = parser.parse(data, messages);
+    }
+
+    QVERIFY(frameCount > 0);
+}
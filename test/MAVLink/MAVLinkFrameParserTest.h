@@ -0,0 +1,41 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MAVLinkFrameParserTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkFrameParserTest() = default;
+
+private slots:
+    void init() final;
+    void cleanup() final;
+
+    void _testMatchesPerByteParser();
+    void _testSplitFrames();
+    void _testSignedFrames();
+    void _testPrivateStatus();
+    void _benchmarkPerByteParser();
+    void _benchmarkFrameParser();
+
+private:
+    QByteArray _generateStream(int messageCount, bool addNoise) const;
+    QByteArray _benchmarkData() const;
+    static QList<mavlink_message_t> _parsePerByte(uint8_t channel, const QByteArray &data);
+
+    /// Reserved from LinkManager for each test, so links can not be handed the same channels meanwhile
+    uint8_t _encodeChannel = UINT8_MAX;
+    uint8_t _referenceChannel = UINT8_MAX;
+    uint8_t _parserChannel = UINT8_MAX;
+};
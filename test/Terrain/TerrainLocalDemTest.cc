@@ -0,0 +1,443 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainLocalDemTest.h"
+#include "TerrainDemFile.h"
+#include "TerrainLocalDem.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace
+{
+
+template<typename T>
+void appendLittleEndian(QByteArray &data, T value)
+{
+    const qsizetype offset = data.size();
+    data.resize(offset + sizeof(T));
+    qToLittleEndian<T>(value, data.data() + offset);
+}
+
+/// Expected elevation of the test GeoTIFF at a longitude, sample values are at the pixel centers
+double expectedElevation(double lon)
+{
+    return (100. + ((lon - 8.0) / 0.0005) - 0.5);
+}
+
+} // namespace
+
+bool TerrainLocalDemTest::_writeGeoTiff(const QString &filePath, float constantElevation, int width, int height)
+{
+    struct Entry {
+        quint16 tag;
+        quint16 type;
+        quint32 count;
+        quint32 value;
+    };
+
+    constexpr quint16 kShort = 3;
+    constexpr quint16 kLong = 4;
+    constexpr quint16 kDouble = 12;
+    constexpr int kEntryCount = 11;
+
+    // Header, directory, then the values which do not fit into an entry and the samples
+    constexpr quint32 ifdOffset = 8;
+    constexpr quint32 pixelScaleOffset = ifdOffset + 2 + (kEntryCount * 12) + 4;
+    constexpr quint32 tiepointOffset = pixelScaleOffset + (3 * 8);
+    constexpr quint32 geoKeysOffset = tiepointOffset + (6 * 8);
+    constexpr quint32 samplesOffset = geoKeysOffset + (16 * 2);
+
+    const Entry entries[kEntryCount] = {
+        { 256, kLong, 1, static_cast<quint32>(width) },
+        { 257, kLong, 1, static_cast<quint32>(height) },
+        { 258, kShort, 1, 32 },                     // BitsPerSample
+        { 259, kShort, 1, 1 },                      // No compression
+        { 273, kLong, 1, samplesOffset },           // One strip
+        { 277, kShort, 1, 1 },                      // SamplesPerPixel
+        { 278, kLong, 1, static_cast<quint32>(height) }, // RowsPerStrip
+        { 339, kShort, 1, 3 },                      // Float samples
+        { 33550, kDouble, 3, pixelScaleOffset },
+        { 33922, kDouble, 6, tiepointOffset },
+        { 34735, kShort, 16, geoKeysOffset },
+    };
+
+    QByteArray data("II");
+    appendLittleEndian<quint16>(data, 42);
+    appendLittleEndian<quint32>(data, ifdOffset);
+
+    appendLittleEndian<quint16>(data, kEntryCount);
+    for (const Entry &entry : entries) {
+        appendLittleEndian<quint16>(data, entry.tag);
+        appendLittleEndian<quint16>(data, entry.type);
+        appendLittleEndian<quint32>(data, entry.count);
+        if ((entry.type == kShort) && (entry.count == 1)) {
+            appendLittleEndian<quint16>(data, static_cast<quint16>(entry.value));
+            appendLittleEndian<quint16>(data, 0);
+        } else {
+            appendLittleEndian<quint32>(data, entry.value);
+        }
+    }
+    appendLittleEndian<quint32>(data, 0);
+
+    for (const double value : { kTiffScale, kTiffScale, 0. }) {
+        appendLittleEndian<double>(data, value);
+    }
+    for (const double value : { 0., 0., 0., 8.0, 47.02, 0. }) {
+        appendLittleEndian<double>(data, value);
+    }
+    // Geographic model, PixelIsArea, WGS84
+    for (const quint16 value : { 1, 1, 0, 3, 1024, 0, 1, 2, 1025, 0, 1, 1, 2048, 0, 1, 4326 }) {
+        appendLittleEndian<quint16>(data, value);
+    }
+
+    if (data.size() != static_cast<qsizetype>(samplesOffset)) {
+        return false;
+    }
+
+    for (int row = 0; row < height; row++) {
+        for (int column = 0; column < width; column++) {
+            appendLittleEndian<float>(data, qIsNaN(constantElevation) ? static_cast<float>(kBaseElevation + column) : constantElevation);
+        }
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    return (file.write(data) == data.size());
+}
+
+void TerrainLocalDemTest::_testHgtFile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath("N47E008.hgt");
+
+    // SRTM3, big endian, the value of each sample is its row
+    constexpr int kSamples = 1201;
+    QByteArray data;
+    data.reserve(kSamples * kSamples * 2);
+    for (int row = 0; row < kSamples; row++) {
+        const qint16 value = qToBigEndian<qint16>(static_cast<qint16>(row));
+        for (int column = 0; column < kSamples; column++) {
+            data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(data) == data.size());
+    file.close();
+
+    const TerrainDemFile demFile(filePath);
+    QVERIFY(demFile.isValid());
+    QCOMPARE(demFile.width(), kSamples);
+    QCOMPARE(demFile.height(), kSamples);
+
+    // The outermost samples are on the cell edges, their pixels reach half a sample beyond
+    const double halfSample = 0.5 / (kSamples - 1);
+    QVERIFY(qAbs(demFile.southLat() - (47. - halfSample)) < 1e-9);
+    QVERIFY(qAbs(demFile.northLat() - (48. + halfSample)) < 1e-9);
+    QVERIFY(qAbs(demFile.westLon() - (8. - halfSample)) < 1e-9);
+    QVERIFY(qAbs(demFile.eastLon() - (9. + halfSample)) < 1e-9);
+    QVERIFY(qAbs(demFile.sampleSpacingMeters() - 63.) < 1.);
+
+    double column = 0.;
+    double row = 0.;
+    QVERIFY(demFile.rasterPosition(47.5, 8.25, column, row));
+    QVERIFY(qAbs(column - 300.) < 1e-6);
+    QVERIFY(qAbs(row - 600.) < 1e-6);
+    QVERIFY(qAbs(demFile.elevation(column, row) - 600.) < 1e-6);
+    QVERIFY(qAbs(demFile.elevation(10., 20.5) - 20.5) < 1e-6);
+    QVERIFY(qIsNaN(demFile.elevation(-1., 0.)));
+}
+
+void TerrainLocalDemTest::_testGeoTiffFile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath("dem.tif");
+    QVERIFY(_writeGeoTiff(filePath));
+
+    const TerrainDemFile demFile(filePath);
+    QVERIFY(demFile.isValid());
+    QCOMPARE(demFile.width(), kTiffWidth);
+    QCOMPARE(demFile.height(), kTiffHeight);
+    QVERIFY(qAbs(demFile.southLat() - 47.0) < 1e-9);
+    QVERIFY(qAbs(demFile.northLat() - 47.02) < 1e-9);
+    QVERIFY(qAbs(demFile.westLon() - 8.0) < 1e-9);
+    QVERIFY(qAbs(demFile.eastLon() - 8.03) < 1e-9);
+
+    // Tie point on the pixel corner, samples at the pixel centers
+    double column = 0.;
+    double row = 0.;
+    QVERIFY(demFile.rasterPosition(47.02 - (kTiffScale / 2.), 8.0 + (kTiffScale / 2.), column, row));
+    QVERIFY(qAbs(column) < 1e-6);
+    QVERIFY(qAbs(row) < 1e-6);
+    QVERIFY(qAbs(demFile.elevation(0., 0.) - kBaseElevation) < 1e-6);
+    QVERIFY(qAbs(demFile.elevation(12.5, 7.) - (kBaseElevation + 12.5)) < 1e-6);
+}
+
+void TerrainLocalDemTest::_testInvalidFiles()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    TerrainLocalDem localDem(tempDir.filePath("localdem.qgcterrain"));
+    QString errorString;
+
+    // Missing file
+    QVERIFY(!localDem.importFile(tempDir.filePath("N47E008.hgt"), errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    const auto writeFile = [&tempDir](const QString &fileName, const QByteArray &data) {
+        QFile file(tempDir.filePath(fileName));
+        if (file.open(QIODevice::WriteOnly)) {
+            (void) file.write(data);
+        }
+        return file.fileName();
+    };
+
+    // Size which is neither SRTM1 nor SRTM3
+    errorString.clear();
+    QVERIFY(!localDem.importFile(writeFile(QStringLiteral("N47E008.hgt"), QByteArray(1000, '\0')), errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    // Name which does not give the location
+    errorString.clear();
+    QVERIFY(!localDem.importFile(writeFile(QStringLiteral("dem.hgt"), QByteArray(1201 * 1201 * 2, '\0')), errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    // Not a TIFF
+    errorString.clear();
+    QVERIFY(!localDem.importFile(writeFile(QStringLiteral("dem.tif"), QByteArray("not a tiff file")), errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    // Unsupported type
+    errorString.clear();
+    QVERIFY(!localDem.importFile(writeFile(QStringLiteral("dem.txt"), QByteArray("100")), errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    QVERIFY(localDem.isEmpty());
+}
+
+void TerrainLocalDemTest::_testImportQueries()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString tiffPath = tempDir.filePath("dem.tif");
+    QVERIFY(_writeGeoTiff(tiffPath));
+
+    TerrainLocalDem localDem(tempDir.filePath("localdem.qgcterrain"));
+    QVERIFY(localDem.isEmpty());
+
+    QSignalSpy spyDataChanged(&localDem, &TerrainLocalDem::dataChanged);
+    QString errorString;
+    QVERIFY(localDem.importFile(tiffPath, errorString));
+    QVERIFY(errorString.isEmpty());
+    QVERIFY(!localDem.isEmpty());
+    QCOMPARE(spyDataChanged.count(), 1);
+
+    // Values are whole meters, looked up in cells of about the raster resolution
+    constexpr double kTolerance = 2.;
+
+    QList<double> altitudes;
+    const QList<QGeoCoordinate> coordinates = { QGeoCoordinate(47.005, 8.005), QGeoCoordinate(47.012, 8.018), QGeoCoordinate(47.015, 8.025) };
+    QVERIFY(localDem.altitudes(coordinates, altitudes));
+    QCOMPARE(altitudes.count(), coordinates.count());
+    for (qsizetype i = 0; i < coordinates.count(); i++) {
+        QVERIFY(qAbs(altitudes[i] - expectedElevation(coordinates[i].longitude())) < kTolerance);
+    }
+
+    // Any coordinate outside of the imported data fails the query
+    QVERIFY(!localDem.altitudes({ QGeoCoordinate(47.005, 8.005), QGeoCoordinate(47.5, 8.5) }, altitudes));
+    QVERIFY(altitudes.isEmpty());
+
+    double distanceBetween = 0.;
+    double finalDistanceBetween = 0.;
+    const QGeoCoordinate fromCoord(47.005, 8.005);
+    const QGeoCoordinate toCoord(47.005, 8.025);
+    QVERIFY(localDem.pathAltitudes(fromCoord, toCoord, distanceBetween, finalDistanceBetween, altitudes));
+    QVERIFY(altitudes.count() > 2);
+    QVERIFY(distanceBetween > 0.);
+    QVERIFY(distanceBetween <= localDem.valueSpacingMeters(fromCoord) * 1.01);
+    QVERIFY(qAbs(altitudes.first() - expectedElevation(fromCoord.longitude())) < kTolerance);
+    QVERIFY(qAbs(altitudes.last() - expectedElevation(toCoord.longitude())) < kTolerance);
+    for (qsizetype i = 1; i < altitudes.count(); i++) {
+        QVERIFY(altitudes[i] >= altitudes[i - 1]);
+    }
+
+    QVERIFY(!localDem.pathAltitudes(QGeoCoordinate(47.5, 8.5), QGeoCoordinate(47.5, 8.6), distanceBetween, finalDistanceBetween, altitudes));
+
+    double minHeight = 0.;
+    double maxHeight = 0.;
+    QList<QList<double>> carpet;
+    const QGeoCoordinate swCoord(47.005, 8.005);
+    const QGeoCoordinate neCoord(47.015, 8.025);
+    QVERIFY(localDem.carpetAltitudes(swCoord, neCoord, false, minHeight, maxHeight, carpet));
+    QVERIFY(carpet.count() > 1);
+    QVERIFY(qAbs(minHeight - expectedElevation(swCoord.longitude())) < kTolerance);
+    QVERIFY(qAbs(maxHeight - expectedElevation(neCoord.longitude())) < kTolerance);
+    for (const QList<double> &carpetRow : carpet) {
+        QCOMPARE(carpetRow.count(), carpet.first().count());
+        QVERIFY(qAbs(carpetRow.first() - expectedElevation(swCoord.longitude())) < kTolerance);
+        QVERIFY(qAbs(carpetRow.last() - expectedElevation(neCoord.longitude())) < kTolerance);
+    }
+
+    QVERIFY(localDem.carpetAltitudes(swCoord, neCoord, true, minHeight, maxHeight, carpet));
+    QVERIFY(carpet.isEmpty());
+    QVERIFY(qAbs(minHeight - expectedElevation(swCoord.longitude())) < kTolerance);
+    QVERIFY(qAbs(maxHeight - expectedElevation(neCoord.longitude())) < kTolerance);
+
+    QVERIFY(!localDem.carpetAltitudes(swCoord, QGeoCoordinate(47.5, 8.5), false, minHeight, maxHeight, carpet));
+}
+
+void TerrainLocalDemTest::_testOverviews()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString tiffPath = tempDir.filePath("dem.tif");
+    QVERIFY(_writeGeoTiff(tiffPath));
+
+    const QString databasePath = tempDir.filePath("localdem.qgcterrain");
+    {
+        TerrainLocalDem localDem(databasePath);
+        QString errorString;
+        QVERIFY(localDem.importFile(tiffPath, errorString));
+    }
+
+    // Imported terrain is kept in the file
+    TerrainLocalDem localDem(databasePath);
+    QVERIFY(!localDem.isEmpty());
+
+    // A level 1 value covers two values of level 0 in each direction
+    const QGeoCoordinate coordinate(47.013, 8.013);
+    QVERIFY(qAbs((localDem.valueSpacingMeters(coordinate, 1) / localDem.valueSpacingMeters(coordinate, 0)) - 2.) < 1e-6);
+
+    QList<double> altitudes;
+    QVERIFY(localDem.altitudes({ coordinate }, altitudes, 1));
+    QCOMPARE(altitudes.count(), qsizetype(1));
+    QVERIFY(qAbs(altitudes.first() - expectedElevation(coordinate.longitude())) < 4.);
+}
+
+void TerrainLocalDemTest::_testReimportAndClear()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString tiffPath = tempDir.filePath("dem.tif");
+    QVERIFY(_writeGeoTiff(tiffPath));
+    const QString constantTiffPath = tempDir.filePath("constant.tif");
+    QVERIFY(_writeGeoTiff(constantTiffPath, 250.f));
+
+    TerrainLocalDem localDem(tempDir.filePath("localdem.qgcterrain"));
+    QString errorString;
+    QVERIFY(localDem.importFile(tiffPath, errorString));
+
+    const QGeoCoordinate coordinate(47.013, 8.013);
+    QList<double> altitudes;
+    QVERIFY(localDem.altitudes({ coordinate }, altitudes));
+    QVERIFY(qAbs(altitudes.first() - expectedElevation(coordinate.longitude())) < 2.);
+
+    // A later import replaces the data it overlaps, in all levels
+    QVERIFY(localDem.importFile(constantTiffPath, errorString));
+    QVERIFY(localDem.altitudes({ coordinate }, altitudes));
+    QCOMPARE(altitudes.first(), 250.);
+    QVERIFY(localDem.altitudes({ coordinate }, altitudes, 1));
+    QCOMPARE(altitudes.first(), 250.);
+
+    QSignalSpy spyDataChanged(&localDem, &TerrainLocalDem::dataChanged);
+    localDem.clear();
+    QCOMPARE(spyDataChanged.count(), 1);
+    QVERIFY(localDem.isEmpty());
+    QVERIFY(!localDem.altitudes({ coordinate }, altitudes));
+}
+
+void TerrainLocalDemTest::_testReimportOverviews()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString tiffPath = tempDir.filePath("dem.tif");
+    QVERIFY(_writeGeoTiff(tiffPath, 250.f));
+    // 47.015-47.02 N, 8.000-8.005 E, within a single level 0 tile
+    const QString smallTiffPath = tempDir.filePath("small.tif");
+    QVERIFY(_writeGeoTiff(smallTiffPath, 500.f, 10, 10));
+
+    TerrainLocalDem localDem(tempDir.filePath("localdem.qgcterrain"));
+    QString errorString;
+    QVERIFY(localDem.importFile(tiffPath, errorString));
+    QVERIFY(localDem.importFile(smallTiffPath, errorString));
+
+    // The overviews built by the larger import show the smaller one as well
+    const QGeoCoordinate coordinate(47.0175, 8.0025);
+    QList<double> altitudes;
+    for (int level = 0; level <= 2; level++) {
+        QVERIFY(localDem.altitudes({ coordinate }, altitudes, level));
+        QCOMPARE(altitudes.first(), 500.);
+    }
+}
+
+void TerrainLocalDemTest::_testStartImport()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString tiffPath = tempDir.filePath("dem.tif");
+    QVERIFY(_writeGeoTiff(tiffPath));
+
+    TerrainLocalDem localDem(tempDir.filePath("localdem.qgcterrain"));
+    QSignalSpy spyFinished(&localDem, &TerrainLocalDem::importFinished);
+    QSignalSpy spyProgress(&localDem, &TerrainLocalDem::importProgress);
+    QSignalSpy spyDataChanged(&localDem, &TerrainLocalDem::dataChanged);
+
+    QVERIFY(localDem.startImport(tiffPath));
+    QVERIFY(localDem.importing());
+    QVERIFY(!localDem.startImport(tiffPath));
+
+    QVERIFY(spyFinished.wait(10000));
+    QVERIFY(spyFinished.first().at(0).toBool());
+    QVERIFY(!localDem.importing());
+    QCOMPARE(spyDataChanged.count(), 1);
+    QVERIFY(!spyProgress.isEmpty());
+    QCOMPARE(spyProgress.last().at(0).toInt(), 100);
+
+    const QGeoCoordinate coordinate(47.013, 8.013);
+    QList<double> altitudes;
+    QVERIFY(localDem.altitudes({ coordinate }, altitudes));
+    QVERIFY(qAbs(altitudes.first() - expectedElevation(coordinate.longitude())) < 2.);
+
+    // Failures are reported the same way
+    QVERIFY(localDem.startImport(tempDir.filePath("missing.tif")));
+    QVERIFY(spyFinished.wait(10000));
+    QVERIFY(!spyFinished.last().at(0).toBool());
+    QVERIFY(!spyFinished.last().at(1).toString().isEmpty());
+    QVERIFY(localDem.altitudes({ coordinate }, altitudes));
+}
+
+void TerrainLocalDemTest::_testCancelImport()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString tiffPath = tempDir.filePath("dem.tif");
+    QVERIFY(_writeGeoTiff(tiffPath));
+
+    const QString databasePath = tempDir.filePath("localdem.qgcterrain");
+    TerrainLocalDem localDem(databasePath);
+    QSignalSpy spyFinished(&localDem, &TerrainLocalDem::importFinished);
+
+    // A canceled import is dropped even when the worker already completed it
+    QVERIFY(localDem.startImport(tiffPath));
+    localDem.cancelImport();
+    QVERIFY(spyFinished.wait(10000));
+    QVERIFY(!spyFinished.first().at(0).toBool());
+    QVERIFY(localDem.isEmpty());
+    QVERIFY(!QFile::exists(databasePath + QStringLiteral(".import")));
+}
@@ -0,0 +1,41 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtCore/QtNumeric>
+
+class TerrainLocalDemTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testHgtFile();
+    void _testGeoTiffFile();
+    void _testInvalidFiles();
+    void _testImportQueries();
+    void _testOverviews();
+    void _testReimportAndClear();
+    void _testReimportOverviews();
+    void _testStartImport();
+    void _testCancelImport();
+
+private:
+    /// Writes a little endian, uncompressed, geographic GeoTIFF with its north west corner at 47.02 N, 8.00 E in samples
+    /// of 0.0005 degrees, by default covering 47.00-47.02 N, 8.00-8.03 E. Sample values are kBaseElevation plus the
+    /// column, or constantElevation if given.
+    static bool _writeGeoTiff(const QString &filePath, float constantElevation = qQNaN(), int width = kTiffWidth, int height = kTiffHeight);
+
+    static constexpr int kTiffWidth = 60;
+    static constexpr int kTiffHeight = 40;
+    static constexpr double kTiffScale = 0.0005;
+    static constexpr double kBaseElevation = 100.;
+};
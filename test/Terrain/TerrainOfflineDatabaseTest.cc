@@ -0,0 +1,283 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainOfflineDatabaseTest.h"
+#include "TerrainOfflineDatabase.h"
+#include "TerrainTile.h"
+#include "TerrainTileCache.h"
+#include "TerrainTileCopernicus.h"
+#include "QGCMapUrlEngine.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <limits>
+
+QByteArray TerrainOfflineDatabaseTest::_tileData(int16_t elevation)
+{
+    QJsonArray row;
+    for (int i = 0; i < 37; i++) {
+        row.append(elevation);
+    }
+    QJsonArray carpet;
+    for (int i = 0; i < 37; i++) {
+        carpet.append(row);
+    }
+
+    const QJsonObject data{
+        { "bounds", QJsonObject{ { "sw", QJsonArray{ 47.0, 8.0 } }, { "ne", QJsonArray{ 47.01, 8.01 } } } },
+        { "stats", QJsonObject{ { "min", elevation }, { "max", elevation }, { "avg", elevation } } },
+        { "carpet", carpet },
+    };
+    const QJsonObject root{ { "status", "success" }, { "data", data } };
+
+    return TerrainTileCopernicus::serializeFromData(QJsonDocument(root).toJson());
+}
+
+void TerrainOfflineDatabaseTest::_testEmptyDatabase()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    TerrainOfflineDatabase database(tempDir.filePath("terrain.qgcterrain"));
+    QCOMPARE(database.tileCount(), qsizetype(0));
+    QVERIFY(!database.contains(1));
+    QVERIFY(!database.tile(1));
+
+    // Nothing to write
+    QVERIFY(database.flush());
+    QVERIFY(!QFile::exists(database.filePath()));
+}
+
+void TerrainOfflineDatabaseTest::_testAddFlushReopen()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath("terrain.qgcterrain");
+
+    const quint64 tileId1 = TerrainTileCache::tileId(0, 100, 200, 1);
+    const quint64 tileId2 = TerrainTileCache::tileId(0, 101, 200, 1);
+    const quint64 tileId3 = TerrainTileCache::tileId(0, 100, 201, 1);
+    const QGeoCoordinate coordinate(47.005, 8.005);
+
+    {
+        TerrainOfflineDatabase database(filePath);
+        QVERIFY(database.addTile(tileId2, _tileData(20)));
+        QVERIFY(database.addTile(tileId1, _tileData(10)));
+        QCOMPARE(database.tileCount(), qsizetype(2));
+
+        // Pending tiles are visible before they are written
+        QVERIFY(database.tile(tileId1));
+        QCOMPARE(database.tile(tileId1)->elevation(coordinate), 10.);
+
+        QVERIFY(database.flush());
+        QVERIFY(QFile::exists(filePath));
+
+        // Adding to an existing file merges with what is in it
+        const std::shared_ptr<const TerrainTile> tileBeforeRewrite = database.tile(tileId2);
+        QVERIFY(database.addTile(tileId3, _tileData(30)));
+        QVERIFY(database.flush());
+        QCOMPARE(database.tileCount(), qsizetype(3));
+
+        // Tiles handed out before the file was rewritten stay valid
+        QCOMPARE(tileBeforeRewrite->elevation(coordinate), 20.);
+    }
+
+    TerrainOfflineDatabase database(filePath);
+    QCOMPARE(database.tileCount(), qsizetype(3));
+    QVERIFY(database.contains(tileId1));
+    QVERIFY(database.contains(tileId2));
+    QVERIFY(database.contains(tileId3));
+    QVERIFY(!database.contains(TerrainTileCache::tileId(0, 102, 200, 1)));
+
+    QCOMPARE(database.tile(tileId1)->elevation(coordinate), 10.);
+    QCOMPARE(database.tile(tileId2)->elevation(coordinate), 20.);
+    QCOMPARE(database.tile(tileId3)->elevation(coordinate), 30.);
+}
+
+void TerrainOfflineDatabaseTest::_testReplaceTile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath("terrain.qgcterrain");
+
+    const quint64 tileId = TerrainTileCache::tileId(0, 100, 200, 1);
+    const QGeoCoordinate coordinate(47.005, 8.005);
+
+    TerrainOfflineDatabase database(filePath);
+    QVERIFY(database.addTile(tileId, _tileData(10)));
+    QVERIFY(database.flush());
+
+    QVERIFY(database.addTile(tileId, _tileData(15)));
+    QCOMPARE(database.tileCount(), qsizetype(1));
+    QCOMPARE(database.tile(tileId)->elevation(coordinate), 15.);
+
+    QVERIFY(database.flush());
+    QCOMPARE(database.tileCount(), qsizetype(1));
+    QCOMPARE(database.tile(tileId)->elevation(coordinate), 15.);
+}
+
+void TerrainOfflineDatabaseTest::_testAppendAndCompact()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath("terrain.qgcterrain");
+
+    const quint64 tileId1 = TerrainTileCache::tileId(0, 100, 200, 1);
+    const quint64 tileId2 = TerrainTileCache::tileId(0, 101, 200, 1);
+    const QGeoCoordinate coordinate(47.005, 8.005);
+    const QByteArray tileData1 = _tileData(10);
+
+    TerrainOfflineDatabase database(filePath);
+    QVERIFY(database.addTile(tileId1, tileData1));
+    QVERIFY(database.flush());
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray firstContents = file.readAll();
+    file.close();
+
+    // The written tile stays where it is, the new tile and index go after it
+    QVERIFY(database.addTile(tileId2, _tileData(20)));
+    QVERIFY(database.flush());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray secondContents = file.readAll();
+    file.close();
+    QVERIFY(secondContents.size() > firstContents.size());
+    QCOMPARE(secondContents.mid(24, tileData1.size()), tileData1);
+    QCOMPARE(secondContents.mid(24, tileData1.size()), firstContents.mid(24, tileData1.size()));
+
+    // Replacing a tile over and over does not grow the file without bound
+    for (int i = 0; i < 20; i++) {
+        QVERIFY(database.addTile(tileId1, _tileData(static_cast<int16_t>(100 + i))));
+        QVERIFY(database.flush());
+        QVERIFY(QFileInfo(filePath).size() < (3 * secondContents.size()));
+    }
+
+    QCOMPARE(database.tileCount(), qsizetype(2));
+    QCOMPARE(database.tile(tileId1)->elevation(coordinate), 119.);
+    QCOMPARE(database.tile(tileId2)->elevation(coordinate), 20.);
+
+    TerrainOfflineDatabase reopened(filePath);
+    QCOMPARE(reopened.tileCount(), qsizetype(2));
+    QCOMPARE(reopened.tile(tileId1)->elevation(coordinate), 119.);
+    QCOMPARE(reopened.tile(tileId2)->elevation(coordinate), 20.);
+}
+
+void TerrainOfflineDatabaseTest::_testInvalidTile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    TerrainOfflineDatabase database(tempDir.filePath("terrain.qgcterrain"));
+    QVERIFY(!database.addTile(1, QByteArray("not a tile")));
+    QCOMPARE(database.tileCount(), qsizetype(0));
+
+    QVERIFY(!database.addCachedTile(QStringLiteral("bad hash"), _tileData(10)));
+    QCOMPARE(database.tileCount(), qsizetype(0));
+}
+
+void TerrainOfflineDatabaseTest::_testCorruptFile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath("terrain.qgcterrain");
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    (void) file.write(QByteArray(64, 'x'));
+    file.close();
+
+    TerrainOfflineDatabase database(filePath);
+    QCOMPARE(database.tileCount(), qsizetype(0));
+
+    // A corrupt file is replaced by the next write
+    const quint64 tileId = TerrainTileCache::tileId(0, 100, 200, 1);
+    QVERIFY(database.addTile(tileId, _tileData(10)));
+    QVERIFY(database.flush());
+    QCOMPARE(database.tileCount(), qsizetype(1));
+    QVERIFY(database.tile(tileId));
+}
+
+void TerrainOfflineDatabaseTest::_testCorruptIndexEntry()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath("terrain.qgcterrain");
+
+    const quint64 tileId1 = TerrainTileCache::tileId(0, 100, 200, 1);
+    const quint64 tileId2 = TerrainTileCache::tileId(0, 101, 200, 1);
+    {
+        TerrainOfflineDatabase database(filePath);
+        QVERIFY(database.addTile(tileId1, _tileData(10)));
+        QVERIFY(database.addTile(tileId2, _tileData(20)));
+        QVERIFY(database.flush());
+    }
+
+    // Point the first index entry far past the end, so offset + length wraps around. The index offset follows
+    // magic, version and tile count in the header.
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(16));
+    quint64 indexOffset = 0;
+    QCOMPARE(file.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset)), qint64(sizeof(indexOffset)));
+    QVERIFY(file.seek(static_cast<qint64>(indexOffset) + 8));
+    const quint64 badOffset = std::numeric_limits<quint64>::max() - 8;
+    QCOMPARE(file.write(reinterpret_cast<const char*>(&badOffset), sizeof(badOffset)), qint64(sizeof(badOffset)));
+    file.close();
+
+    TerrainOfflineDatabase database(filePath);
+    QVERIFY(!database.tile(tileId1));
+    QVERIFY(database.tile(tileId2));
+
+    // Writing drops the damaged entry and keeps the rest
+    const quint64 tileId3 = TerrainTileCache::tileId(0, 102, 200, 1);
+    QVERIFY(database.addTile(tileId3, _tileData(30)));
+    QVERIFY(database.flush());
+    QCOMPARE(database.tileCount(), qsizetype(2));
+    QVERIFY(!database.contains(tileId1));
+    QVERIFY(database.tile(tileId2));
+    QVERIFY(database.tile(tileId3));
+}
+
+void TerrainOfflineDatabaseTest::_testProviders()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath("terrain.qgcterrain");
+
+    const quint64 tileId = TerrainTileCache::tileId(0, 100, 200, 1);
+    const QGeoCoordinate coordinate(47.005, 8.005);
+    const quint32 providerA = TerrainOfflineDatabase::providerKey(QStringLiteral("Provider A"));
+    const quint32 providerB = TerrainOfflineDatabase::providerKey(QStringLiteral("Provider B"));
+    QVERIFY(providerA != providerB);
+
+    {
+        TerrainOfflineDatabase database(filePath);
+        QVERIFY(database.addTile(tileId, _tileData(10), providerA));
+        QVERIFY(database.addTile(tileId, _tileData(20), providerB));
+        QVERIFY(!database.contains(tileId));
+
+        // Tiles from the map tile cache are keyed by the provider in their hash, registered or not
+        QVERIFY(database.addCachedTile(UrlFactory::getTileHash(QStringLiteral("Provider C"), 101, 200, 1), _tileData(30)));
+        QVERIFY(database.flush());
+    }
+
+    // Keys are derived from the provider name, so they hold across runs whatever map ids are assigned
+    TerrainOfflineDatabase database(filePath);
+    QCOMPARE(database.tileCount(), qsizetype(3));
+    QCOMPARE(database.tile(tileId, providerA)->elevation(coordinate), 10.);
+    QCOMPARE(database.tile(tileId, providerB)->elevation(coordinate), 20.);
+    QVERIFY(database.contains(TerrainTileCache::tileId(0, 101, 200, 1), TerrainOfflineDatabase::providerKey(QStringLiteral("Provider C"))));
+}
@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class TerrainOfflineDatabaseTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testEmptyDatabase();
+    void _testAddFlushReopen();
+    void _testReplaceTile();
+    void _testAppendAndCompact();
+    void _testInvalidTile();
+    void _testCorruptFile();
+    void _testCorruptIndexEntry();
+    void _testProviders();
+
+private:
+    static QByteArray _tileData(int16_t elevation);
+};
@@ -10,13 +10,87 @@
 #include "TerrainQueryTest.h"
 #include "TerrainTileManager.h"
 #include "TerrainQuery.h"
+#include "TerrainTileCopernicus.h"
 
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QtMath>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
 
+#include <utility>
+
 /// Point Nemo is a point on Earth furthest from land
 static const QGeoCoordinate pointNemo = QGeoCoordinate(-48.875556, -123.392500);
 
+namespace
+{
+
+/// Records the tiles the manager wants instead of downloading them, the test answers them through _downloadFinished
+class DownloadRecordingTileManager : public TerrainTileManager
+{
+public:
+    QList<std::pair<quint64, QGeoTileSpec>> requestedTiles;
+
+private:
+    void _downloadTile(quint64 tileId, const QGeoTileSpec &spec) final { requestedTiles.append({ tileId, spec }); }
+};
+
+/// Serialized tile of constant elevation covering the tile of spec
+QByteArray _tileData(const QGeoTileSpec &spec, int16_t elevation)
+{
+    QJsonArray row;
+    for (int i = 0; i < 37; i++) {
+        row.append(elevation);
+    }
+    QJsonArray carpet;
+    for (int i = 0; i < 37; i++) {
+        carpet.append(row);
+    }
+
+    const double swLat = (spec.y() * TerrainTileCopernicus::kTileSizeDegrees) - 90.0;
+    const double swLon = (spec.x() * TerrainTileCopernicus::kTileSizeDegrees) - 180.0;
+    const double neLat = swLat + TerrainTileCopernicus::kTileSizeDegrees;
+    const double neLon = swLon + TerrainTileCopernicus::kTileSizeDegrees;
+
+    const QJsonObject data{
+        { "bounds", QJsonObject{ { "sw", QJsonArray{ swLat, swLon } }, { "ne", QJsonArray{ neLat, neLon } } } },
+        { "stats", QJsonObject{ { "min", elevation }, { "max", elevation }, { "avg", elevation } } },
+        { "carpet", carpet },
+    };
+    const QJsonObject root{ { "status", "success" }, { "data", data } };
+
+    return TerrainTileCopernicus::serializeFromData(QJsonDocument(root).toJson());
+}
+
+int _tileX(double longitude)
+{
+    return qFloor((longitude + 180.0) / TerrainTileCopernicus::kTileSizeDegrees);
+}
+
+/// Coordinates in the centers of tileCount tiles west to east of Point Nemo
+QList<QGeoCoordinate> _coordinatesInTiles(qsizetype tileCount)
+{
+    const int tileY = qFloor((pointNemo.latitude() + 90.0) / TerrainTileCopernicus::kTileSizeDegrees);
+    const double lat = ((tileY + 0.5) * TerrainTileCopernicus::kTileSizeDegrees) - 90.0;
+
+    QList<QGeoCoordinate> coordinates;
+    for (qsizetype i = 0; i < tileCount; i++) {
+        const double lon = ((_tileX(pointNemo.longitude()) + i + 0.5) * TerrainTileCopernicus::kTileSizeDegrees) - 180.0;
+        coordinates.append(QGeoCoordinate(lat, lon));
+    }
+    return coordinates;
+}
+
+/// Each tile reports a different height, derived from its x
+int16_t _tileElevation(int tileX)
+{
+    return static_cast<int16_t>(tileX % 1000);
+}
+
+} // namespace
+
 const UnitTestTerrainQuery::Flat10Region UnitTestTerrainQuery::flat10Region{{
     pointNemo,
     QGeoCoordinate{
@@ -195,6 +269,115 @@ void TerrainQueryTest::_testRequestCarpetHeights()
     QVERIFY(arguments.at(3).toList().constFirst().toList().constFirst().toDouble() == UnitTestTerrainQuery::Flat10Region::amslElevation);
 }
 
+void TerrainQueryTest::_testTileManagerBatchedDownload()
+{
+    DownloadRecordingTileManager manager;
+    TerrainTileManager &tileManager = manager;
+    UnitTestTerrainQuery* const query = new UnitTestTerrainQuery(this);
+    QSignalSpy spy(query, &UnitTestTerrainQuery::coordinateHeightsReceived);
+    QVERIFY(spy.isValid());
+
+    // All missing tiles of a query are requested together
+    const QList<QGeoCoordinate> coordinates = _coordinatesInTiles(3);
+    manager.addCoordinateQuery(query, coordinates);
+    QCOMPARE(manager.requestedTiles.count(), static_cast<qsizetype>(3));
+    QCOMPARE(spy.count(), 0);
+
+    // Answered once the last of its tiles arrived, in any order
+    const std::pair<quint64, QGeoTileSpec> lastTile = manager.requestedTiles.takeLast();
+    for (const auto &[tileId, spec] : std::as_const(manager.requestedTiles)) {
+        tileManager._downloadFinished(tileId, _tileData(spec, _tileElevation(spec.x())));
+        QCOMPARE(spy.count(), 0);
+    }
+    tileManager._downloadFinished(lastTile.first, _tileData(lastTile.second, _tileElevation(lastTile.second.x())));
+    QCOMPARE(spy.count(), 1);
+
+    const QVariantList arguments = spy.takeFirst();
+    QVERIFY(arguments.at(0).toBool());
+    const QList<double> heights = arguments.at(1).value<QList<double>>();
+    QCOMPARE(heights.count(), coordinates.count());
+    for (qsizetype i = 0; i < coordinates.count(); i++) {
+        QCOMPARE(heights[i], static_cast<double>(_tileElevation(_tileX(coordinates[i].longitude()))));
+    }
+    QCOMPARE(tileManager._downloadsInFlight, 0);
+}
+
+void TerrainQueryTest::_testTileManagerTileFailure()
+{
+    DownloadRecordingTileManager manager;
+    TerrainTileManager &tileManager = manager;
+    UnitTestTerrainQuery* const query = new UnitTestTerrainQuery(this);
+    QSignalSpy spy(query, &UnitTestTerrainQuery::coordinateHeightsReceived);
+    QVERIFY(spy.isValid());
+
+    const QList<QGeoCoordinate> coordinates = _coordinatesInTiles(3);
+    manager.addCoordinateQuery(query, coordinates);
+    QCOMPARE(manager.requestedTiles.count(), static_cast<qsizetype>(3));
+
+    // One failed tile fails the query right away, the others still complete
+    const auto [tileId0, spec0] = manager.requestedTiles[0];
+    const auto [tileId1, spec1] = manager.requestedTiles[1];
+    const auto [tileId2, spec2] = manager.requestedTiles[2];
+    tileManager._downloadFinished(tileId0, _tileData(spec0, 10));
+    QCOMPARE(spy.count(), 0);
+    tileManager._downloadFinished(tileId1, QByteArray());
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(!spy.takeFirst().at(0).toBool());
+    tileManager._downloadFinished(tileId2, _tileData(spec2, 20));
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(tileManager._downloadsInFlight, 0);
+
+    // The failed tile is requested again by the next query, the ones which arrived are cached
+    manager.requestedTiles.clear();
+    manager.addCoordinateQuery(query, coordinates);
+    QCOMPARE(manager.requestedTiles.count(), static_cast<qsizetype>(1));
+    QCOMPARE(manager.requestedTiles.first().first, tileId1);
+    tileManager._downloadFinished(tileId1, _tileData(spec1, 15));
+    QCOMPARE(spy.count(), 1);
+    const QVariantList arguments = spy.takeFirst();
+    QVERIFY(arguments.at(0).toBool());
+    QCOMPARE(arguments.at(1).value<QList<double>>().count(), coordinates.count());
+}
+
+void TerrainQueryTest::_testTileManagerDownloadLimit()
+{
+    DownloadRecordingTileManager manager;
+    TerrainTileManager &tileManager = manager;
+    UnitTestTerrainQuery* const query = new UnitTestTerrainQuery(this);
+    QSignalSpy spy(query, &UnitTestTerrainQuery::coordinateHeightsReceived);
+    QVERIFY(spy.isValid());
+
+    static constexpr qsizetype maxDownloads = TerrainTileManager::kMaxConcurrentDownloads;
+    static constexpr qsizetype tileCount = maxDownloads + 4;
+    const QList<QGeoCoordinate> coordinates = _coordinatesInTiles(tileCount);
+    manager.addCoordinateQuery(query, coordinates);
+    QCOMPARE(manager.requestedTiles.count(), maxDownloads);
+    QCOMPARE(tileManager._downloadQueue.count(), tileCount - maxDownloads);
+
+    // A second query sharing tiles with the first does not request them twice
+    UnitTestTerrainQuery* const sharingQuery = new UnitTestTerrainQuery(this);
+    QSignalSpy sharingSpy(sharingQuery, &UnitTestTerrainQuery::coordinateHeightsReceived);
+    QVERIFY(sharingSpy.isValid());
+    manager.addCoordinateQuery(sharingQuery, { coordinates.first(), coordinates.last() });
+    QCOMPARE(manager.requestedTiles.count(), maxDownloads);
+
+    // Every finished download starts the next waiting one
+    qsizetype answered = 0;
+    while (answered < manager.requestedTiles.count()) {
+        const auto [tileId, spec] = manager.requestedTiles[answered++];
+        tileManager._downloadFinished(tileId, _tileData(spec, 10));
+        QVERIFY(tileManager._downloadsInFlight <= TerrainTileManager::kMaxConcurrentDownloads);
+        QCOMPARE(manager.requestedTiles.count(), qMin(tileCount, maxDownloads + answered));
+    }
+
+    QCOMPARE(manager.requestedTiles.count(), tileCount);
+    QCOMPARE(tileManager._downloadsInFlight, 0);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(spy.takeFirst().at(0).toBool());
+    QCOMPARE(sharingSpy.count(), 1);
+    QVERIFY(sharingSpy.takeFirst().at(0).toBool());
+}
+
 // Test Requires Internet, so disable by default.
 // Or, check if internet and elevation server are available?
 #if 0
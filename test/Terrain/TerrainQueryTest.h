@@ -88,5 +88,8 @@ private slots:
     void _testRequestCoordinateHeights();
     void _testRequestPathHeights();
     void _testRequestCarpetHeights();
+    void _testTileManagerBatchedDownload();
+    void _testTileManagerTileFailure();
+    void _testTileManagerDownloadLimit();
     // void _testTerrainAtCoordinateQuery();
 };
@@ -0,0 +1,155 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileCacheTest.h"
+#include "TerrainTileCache.h"
+#include "TerrainTileCopernicus.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+#include <atomic>
+
+std::shared_ptr<const TerrainTile> TerrainTileCacheTest::_tile(int16_t elevation)
+{
+    QJsonArray row;
+    for (int i = 0; i < 37; i++) {
+        row.append(elevation);
+    }
+    QJsonArray carpet;
+    for (int i = 0; i < 37; i++) {
+        carpet.append(row);
+    }
+
+    const QJsonObject data{
+        { "bounds", QJsonObject{ { "sw", QJsonArray{ 47.0, 8.0 } }, { "ne", QJsonArray{ 47.01, 8.01 } } } },
+        { "stats", QJsonObject{ { "min", elevation }, { "max", elevation }, { "avg", elevation } } },
+        { "carpet", carpet },
+    };
+    const QJsonObject root{ { "status", "success" }, { "data", data } };
+
+    return std::make_shared<const TerrainTile>(TerrainTileCopernicus::serializeFromData(QJsonDocument(root).toJson()));
+}
+
+void TerrainTileCacheTest::_testTileId()
+{
+    QCOMPARE_NE(TerrainTileCache::tileId(1, 10, 20, 1), TerrainTileCache::tileId(1, 20, 10, 1));
+    QCOMPARE_NE(TerrainTileCache::tileId(1, 10, 20, 1), TerrainTileCache::tileId(2, 10, 20, 1));
+    QCOMPARE_NE(TerrainTileCache::tileId(1, 10, 20, 1), TerrainTileCache::tileId(1, 10, 20, 2));
+    QCOMPARE(TerrainTileCache::tileId(1, 10, 20, 1), TerrainTileCache::tileId(1, 10, 20, 1));
+}
+
+void TerrainTileCacheTest::_testHitsAndMisses()
+{
+    TerrainTileCache cache;
+    const std::shared_ptr<const TerrainTile> tile = _tile(10);
+    QVERIFY(tile->isValid());
+
+    QVERIFY(!cache.tile(1));
+    cache.insert(1, tile);
+    QCOMPARE(cache.tile(1), tile);
+
+    // A second tile for the same id is ignored
+    cache.insert(1, _tile(20));
+    QCOMPARE(cache.tile(1), tile);
+
+    const TerrainTileCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.hits, 2ULL);
+    QCOMPARE(statistics.misses, 1ULL);
+    QCOMPARE(statistics.insertions, 1ULL);
+    QCOMPARE(statistics.evictions, 0ULL);
+    QCOMPARE(statistics.tileCount, qsizetype(1));
+    QCOMPARE(statistics.bytes, static_cast<qint64>(tile->byteSize()));
+}
+
+void TerrainTileCacheTest::_testLeastRecentlyUsedEviction()
+{
+    const qint64 tileBytes = _tile(0)->byteSize();
+    TerrainTileCache cache(4 * tileBytes);
+
+    for (quint64 id = 1; id <= 4; id++) {
+        cache.insert(id, _tile(static_cast<int16_t>(id)));
+    }
+    QCOMPARE(cache.statistics().tileCount, qsizetype(4));
+
+    // Makes 1 the most recently used, 2 is now the oldest
+    QVERIFY(cache.tile(1));
+
+    cache.insert(5, _tile(5));
+
+    QVERIFY(cache.contains(1));
+    QVERIFY(!cache.contains(2));
+    QVERIFY(cache.contains(5));
+    QVERIFY(cache.statistics().bytes <= cache.budgetBytes());
+    QCOMPARE_GE(cache.statistics().evictions, 1ULL);
+}
+
+void TerrainTileCacheTest::_testShrinkBudget()
+{
+    const qint64 tileBytes = _tile(0)->byteSize();
+    TerrainTileCache cache(10 * tileBytes);
+
+    for (quint64 id = 1; id <= 10; id++) {
+        cache.insert(id, _tile(static_cast<int16_t>(id)));
+    }
+    const std::shared_ptr<const TerrainTile> held = cache.tile(1);
+
+    cache.setBudgetBytes(2 * tileBytes);
+    QVERIFY(cache.statistics().bytes <= (2 * tileBytes));
+    QVERIFY(cache.contains(1));
+
+    // Evicted tiles stay usable while they are held
+    cache.clear();
+    QVERIFY(!cache.contains(1));
+    QCOMPARE(held->avgElevation(), 1.);
+}
+
+void TerrainTileCacheTest::_testConcurrentReaders()
+{
+    TerrainTileCache cache(8 * _tile(0)->byteSize());
+    QList<std::shared_ptr<const TerrainTile>> tiles;
+    for (int i = 0; i < 16; i++) {
+        tiles.append(_tile(static_cast<int16_t>(i)));
+    }
+
+    std::atomic<bool> stop = false;
+    std::atomic<quint64> lookups = 0;
+    QList<QThread*> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.append(QThread::create([&cache, &stop, &lookups]() {
+            quint64 id = 0;
+            while (!stop.load()) {
+                const std::shared_ptr<const TerrainTile> tile = cache.tile(id++ % 16);
+                if (tile) {
+                    (void) tile->avgElevation();
+                }
+                (void) lookups.fetch_add(1);
+            }
+        }));
+        readers.last()->start();
+    }
+
+    for (int round = 0; round < 200; round++) {
+        const int id = round % 16;
+        cache.insert(id, tiles[id]);
+    }
+
+    stop = true;
+    for (QThread *reader : readers) {
+        QVERIFY(reader->wait(5000));
+        delete reader;
+    }
+
+    const TerrainTileCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.hits + statistics.misses, lookups.load());
+    QVERIFY(statistics.bytes <= statistics.budgetBytes);
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <memory>
+
+class TerrainTile;
+
+class TerrainTileCacheTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testTileId();
+    void _testHitsAndMisses();
+    void _testLeastRecentlyUsedEviction();
+    void _testShrinkBudget();
+    void _testConcurrentReaders();
+
+private:
+    static std::shared_ptr<const TerrainTile> _tile(int16_t elevation);
+};
@@ -10,4 +10,165 @@
 #include "TerrainTileTest.h"
 #include "TerrainTile.h"
 
+#include <QtCore/QRandomGenerator>
 #include <QtTest/QTest>
+
+#include <cstring>
+
+QByteArray TerrainTileTest::_tileData(int gridSize)
+{
+    TerrainTile::TileInfo_t tileInfo{};
+    tileInfo.swLat = _swLat;
+    tileInfo.swLon = _swLon;
+    tileInfo.neLat = _swLat + _tileSizeDegrees;
+    tileInfo.neLon = _swLon + _tileSizeDegrees;
+    tileInfo.minElevation = 0;
+    tileInfo.maxElevation = static_cast<int16_t>(((gridSize - 1) * 100) + (gridSize - 1));
+    tileInfo.gridSizeLat = static_cast<int16_t>(gridSize);
+    tileInfo.gridSizeLon = static_cast<int16_t>(gridSize);
+
+    QByteArray data(static_cast<qsizetype>(sizeof(tileInfo)), Qt::Uninitialized);
+    (void) memcpy(data.data(), &tileInfo, sizeof(tileInfo));
+    for (int row = 0; row < gridSize; row++) {
+        for (int column = 0; column < gridSize; column++) {
+            const int16_t value = static_cast<int16_t>((row * 100) + column);
+            (void) data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+
+    return data;
+}
+
+QList<QGeoCoordinate> TerrainTileTest::_randomCoordinates(int count)
+{
+    QRandomGenerator random(1234);
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(count);
+    for (int i = 0; i < count; i++) {
+        coordinates.append(QGeoCoordinate(_swLat + (random.generateDouble() * _tileSizeDegrees), _swLon + (random.generateDouble() * _tileSizeDegrees)));
+    }
+
+    return coordinates;
+}
+
+void TerrainTileTest::_testInvalidData()
+{
+    QVERIFY(!TerrainTile(QByteArray(10, 0)).isValid());
+
+    // Header only, grid missing
+    const QByteArray data = _tileData(4);
+    QVERIFY(!TerrainTile(data.left(static_cast<qsizetype>(sizeof(TerrainTile::TileInfo_t)))).isValid());
+    QVERIFY(!TerrainTile(data.chopped(1)).isValid());
+    QVERIFY(TerrainTile(data).isValid());
+}
+
+void TerrainTileTest::_testElevation()
+{
+    const TerrainTile tile(_tileData(4));
+    QVERIFY(tile.isValid());
+    QCOMPARE(tile.gridSizeLat(), 4);
+    QCOMPARE(tile.gridSizeLon(), 4);
+
+    const double cellSize = _tileSizeDegrees / 4;
+    QCOMPARE(tile.elevation(QGeoCoordinate(_swLat + (0.5 * cellSize), _swLon + (0.5 * cellSize))), 0.);
+    QCOMPARE(tile.elevation(QGeoCoordinate(_swLat + (2.5 * cellSize), _swLon + (1.5 * cellSize))), 201.);
+    QCOMPARE(tile.elevation(QGeoCoordinate(_swLat + (3.9 * cellSize), _swLon + (3.9 * cellSize))), 303.);
+
+    QVERIFY(qIsNaN(tile.elevation(QGeoCoordinate(_swLat - cellSize, _swLon))));
+    QVERIFY(qIsNaN(tile.elevation(QGeoCoordinate(_swLat, _swLon + _tileSizeDegrees + cellSize))));
+}
+
+void TerrainTileTest::_testElevationsMatchElevation()
+{
+    const TerrainTile tile(_tileData(_benchmarkGridSize));
+    QList<QGeoCoordinate> coordinates = _randomCoordinates(1000);
+    coordinates.append(QGeoCoordinate(_swLat - 1, _swLon));
+    coordinates.append(QGeoCoordinate(_swLat, _swLon + 1));
+
+    QList<double> elevations(coordinates.count());
+    tile.elevations(coordinates, elevations);
+
+    for (qsizetype i = 0; i < coordinates.count(); i++) {
+        const double elevation = tile.elevation(coordinates[i]);
+        if (qIsNaN(elevation)) {
+            QVERIFY(qIsNaN(elevations[i]));
+        } else {
+            QCOMPARE(elevations[i], elevation);
+        }
+    }
+}
+
+void TerrainTileTest::_testBilinearElevations()
+{
+    const TerrainTile tile(_tileData(4));
+    const double cellSize = _tileSizeDegrees / 4;
+
+    const QList<QGeoCoordinate> coordinates = {
+        // Cell centers hold the exact grid value
+        QGeoCoordinate(_swLat + (1.5 * cellSize), _swLon + (2.5 * cellSize)),
+        // Half way between four cell centers
+        QGeoCoordinate(_swLat + (2.0 * cellSize), _swLon + (2.0 * cellSize)),
+        // Quarter of the way east from a center
+        QGeoCoordinate(_swLat + (0.5 * cellSize), _swLon + (0.75 * cellSize)),
+        // Flat between the outermost centers and the edge
+        QGeoCoordinate(_swLat + (0.1 * cellSize), _swLon + (0.1 * cellSize)),
+        QGeoCoordinate(_swLat - cellSize, _swLon),
+    };
+
+    QList<double> elevations(coordinates.count());
+    tile.elevations(coordinates, elevations, true);
+
+    QCOMPARE_LE(qAbs(elevations[0] - 102.), 1e-6);
+    QCOMPARE_LE(qAbs(elevations[1] - 151.5), 1e-6);
+    QCOMPARE_LE(qAbs(elevations[2] - 0.25), 1e-6);
+    QCOMPARE_LE(qAbs(elevations[3]), 1e-6);
+    QVERIFY(qIsNaN(elevations[4]));
+}
+
+void TerrainTileTest::_benchmarkElevation()
+{
+    const TerrainTile tile(_tileData(_benchmarkGridSize));
+    const QList<QGeoCoordinate> coordinates = _randomCoordinates(_benchmarkCoordinateCount);
+    double sum = 0;
+
+    QBENCHMARK {
+        sum = 0;
+        for (const QGeoCoordinate &coordinate : coordinates) {
+            sum += tile.elevation(coordinate);
+        }
+    }
+
+    QVERIFY(sum > 0);
+}
+
+void TerrainTileTest::_benchmarkElevations()
+{
+    const TerrainTile tile(_tileData(_benchmarkGridSize));
+    const QList<QGeoCoordinate> coordinates = _randomCoordinates(_benchmarkCoordinateCount);
+    QList<double> elevations(coordinates.count());
+
+    QBENCHMARK {
+        tile.elevations(coordinates, elevations);
+    }
+
+    QVERIFY(elevations.first() >= 0);
+}
+
+void TerrainTileTest::_benchmarkElevationsBilinear()
+{
+    const TerrainTile tile(_tileData(_benchmarkGridSize));
+    const QList<QGeoCoordinate> coordinates = _randomCoordinates(_benchmarkCoordinateCount);
+    QList<double> latitudes;
+    QList<double> longitudes;
+    for (const QGeoCoordinate &coordinate : coordinates) {
+        latitudes.append(coordinate.latitude());
+        longitudes.append(coordinate.longitude());
+    }
+    QList<double> elevations(coordinates.count());
+
+    QBENCHMARK {
+        tile.elevations(latitudes, longitudes, elevations, true);
+    }
+
+    QVERIFY(elevations.first() >= 0);
+}
@@ -11,9 +11,29 @@
 
 #include "UnitTest.h"
 
+#include <QtPositioning/QGeoCoordinate>
+
 class TerrainTileTest : public UnitTest
 {
     Q_OBJECT
 
 private slots:
+    void _testInvalidData();
+    void _testElevation();
+    void _testElevationsMatchElevation();
+    void _testBilinearElevations();
+    void _benchmarkElevation();
+    void _benchmarkElevations();
+    void _benchmarkElevationsBilinear();
+
+private:
+    /// Tile of gridSize x gridSize cells, the value of a cell is (row * 100) + column
+    static QByteArray _tileData(int gridSize);
+    static QList<QGeoCoordinate> _randomCoordinates(int count);
+
+    static constexpr double _swLat = 47.0;
+    static constexpr double _swLon = 8.0;
+    static constexpr double _tileSizeDegrees = 0.01;
+    static constexpr int _benchmarkGridSize = 37;
+    static constexpr int _benchmarkCoordinateCount = 1000000;
 };
@@ -20,6 +20,7 @@
 // #include "MavlinkLogTest.h"
 #include "LogDownloadTest.h"
 #include "PX4LogParserTest.h"
+#include "TelemetryLogExporterTest.h"
 // #include "ULogParserTest.h"
 
 
@@ -31,12 +32,22 @@
 #include "QGCCameraManagerTest.h"
 
 // Comms
+#include "LinkManagerTest.h"
+#include "LinkOutboundQueueTest.h"
+#include "LinkOutboundSchedulerTest.h"
+#include "MAVLinkStatisticsTest.h"
 #include "QGCSerialPortInfoTest.h"
+#include "TelemetryLogIndexTest.h"
+#include "TelemetryLogWriterTest.h"
+#include "UDPBatchIOTest.h"
 
 // FactSystem
+#include "FactGroupTest.h"
 #include "FactSystemTestGeneric.h"
 #include "FactSystemTestPX4.h"
+#include "FactTest.h"
 #include "ParameterManagerTest.h"
+#include "TelemetryHistoryTest.h"
 
 // FollowMe
 #include "FollowMeTest.h"
@@ -45,6 +56,7 @@
 #include "GpsTest.h"
 
 // MAVLink
+#include "MAVLinkFrameParserTest.h"
 #include "StatusTextHandlerTest.h"
 #include "SigningTest.h"
 
@@ -79,12 +91,16 @@
 // QmlControls
 
 // Terrain
+#include "TerrainLocalDemTest.h"
+#include "TerrainOfflineDatabaseTest.h"
 #include "TerrainQueryTest.h"
+#include "TerrainTileCacheTest.h"
 #include "TerrainTileTest.h"
 
 // UI
 
 // Utilities
+#include "QGCSignalCoalescerTest.h"
 // Audio
 #include "AudioOutputTest.h"
 // Compression
@@ -107,6 +123,9 @@
 // #include "SendMavCommandWithHandlerTest.h"
 // #include "SendMavCommandWithSignalingTest.h"
 #include "VehicleLinkManagerTest.h"
+#include "VehicleMessageDecimatorTest.h"
+#include "VehicleMessageDispatcherTest.h"
+#include "VehicleStateSnapshotTest.h"
 
 // Missing
 // #include "FlightGearUnitTest.h"
@@ -127,6 +146,7 @@ int runTests(bool stress, QStringView unitTestOptions)
     // UT_REGISTER_TEST(MavlinkLogTest)
     UT_REGISTER_TEST(LogDownloadTest)
     UT_REGISTER_TEST(PX4LogParserTest)
+    UT_REGISTER_TEST(TelemetryLogExporterTest)
     // UT_REGISTER_TEST(ULogParserTest)
 
     // AutoPilotPlugins
@@ -136,12 +156,22 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(QGCCameraManagerTest)
 
     // Comms
+    UT_REGISTER_TEST(LinkManagerTest)
+    UT_REGISTER_TEST(LinkOutboundQueueTest)
+    UT_REGISTER_TEST(LinkOutboundSchedulerTest)
+    UT_REGISTER_TEST(MAVLinkStatisticsTest)
     UT_REGISTER_TEST(QGCSerialPortInfoTest)
+    UT_REGISTER_TEST(TelemetryLogIndexTest)
+    UT_REGISTER_TEST(TelemetryLogWriterTest)
+    UT_REGISTER_TEST(UDPBatchIOTest)
 
     // FactSystem
+    UT_REGISTER_TEST(FactGroupTest)
     UT_REGISTER_TEST(FactSystemTestGeneric)
     UT_REGISTER_TEST(FactSystemTestPX4)
+    UT_REGISTER_TEST(FactTest)
     UT_REGISTER_TEST(ParameterManagerTest)
+    UT_REGISTER_TEST(TelemetryHistoryTest)
 
     // FollowMe
     UT_REGISTER_TEST(FollowMeTest)
@@ -150,6 +180,7 @@ int runTests(bool stress, QStringView unitTestOptions)
     // UT_REGISTER_TEST(GpsTest)
 
     // MAVLink
+    UT_REGISTER_TEST(MAVLinkFrameParserTest)
     UT_REGISTER_TEST(StatusTextHandlerTest)
     UT_REGISTER_TEST(SigningTest)
 
@@ -182,12 +213,16 @@ int runTests(bool stress, QStringView unitTestOptions)
     // QmlControls
 
     // Terrain
+    UT_REGISTER_TEST(TerrainLocalDemTest)
+    UT_REGISTER_TEST(TerrainOfflineDatabaseTest)
     UT_REGISTER_TEST(TerrainQueryTest)
+    UT_REGISTER_TEST(TerrainTileCacheTest)
     UT_REGISTER_TEST(TerrainTileTest)
 
     // UI
 
     // Utilities
+    UT_REGISTER_TEST(QGCSignalCoalescerTest)
     // Audio
     UT_REGISTER_TEST(AudioOutputTest)
     // Compression
@@ -210,6 +245,9 @@ int runTests(bool stress, QStringView unitTestOptions)
     // UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
     // UT_REGISTER_TEST(SendMavCommandWithSignalingTest)
     UT_REGISTER_TEST(VehicleLinkManagerTest)
+    UT_REGISTER_TEST(VehicleMessageDecimatorTest)
+    UT_REGISTER_TEST(VehicleMessageDispatcherTest)
+    UT_REGISTER_TEST(VehicleStateSnapshotTest)
 
     // Missing
     // UT_REGISTER_TEST(FlightGearUnitTest)
@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCSignalCoalescerTest.h"
+#include "QGCSignalCoalescer.h"
+
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+namespace
+{
+
+constexpr int kBurstCount = 1000;
+
+} // namespace
+
+void QGCSignalCoalescerTest::_testLatestWins()
+{
+    CoalescerTestSender sender;
+    CoalescerTestReceiver receiver;
+    (void) QGCSignalCoalescer::connect(&sender, &CoalescerTestSender::valueChanged, &receiver, &CoalescerTestReceiver::setValue);
+
+    for (int i = 0; i < 100; i++) {
+        emit sender.valueChanged(i);
+    }
+    // Never called synchronously
+    QCOMPARE(receiver.callCount(), 0);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.callCount(), 1);
+    QCOMPARE(receiver.lastValue(), 99);
+
+    emit sender.valueChanged(200);
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.callCount(), 2);
+    QCOMPARE(receiver.lastValue(), 200);
+}
+
+void QGCSignalCoalescerTest::_testNoArguments()
+{
+    CoalescerTestSender sender;
+    CoalescerTestReceiver receiver;
+    (void) QGCSignalCoalescer::connect(&sender, &CoalescerTestSender::changed, &receiver, &CoalescerTestReceiver::changed);
+
+    // Slots can also drop the signal arguments
+    int functorCount = 0;
+    (void) QGCSignalCoalescer::connect(&sender, &CoalescerTestSender::valueChanged, &receiver, [&functorCount]() { functorCount++; });
+
+    for (int i = 0; i < 10; i++) {
+        emit sender.changed();
+        emit sender.valueChanged(i);
+    }
+    QCoreApplication::processEvents();
+    QCOMPARE(receiver.callCount(), 1);
+    QCOMPARE(functorCount, 1);
+}
+
+void QGCSignalCoalescerTest::_testCrossThread()
+{
+    CoalescerTestSender sender;
+    CoalescerTestReceiver receiver;
+    (void) QGCSignalCoalescer::connect(&sender, &CoalescerTestSender::valueChanged, &receiver, &CoalescerTestReceiver::setValue);
+
+    QThread *const thread = QThread::create([&sender]() {
+        for (int i = 0; i < kBurstCount; i++) {
+            emit sender.valueChanged(i);
+        }
+    });
+    thread->start();
+    QVERIFY(thread->wait(5000));
+    delete thread;
+
+    QTRY_COMPARE(receiver.lastValue(), kBurstCount - 1);
+    QVERIFY(receiver.callCount() >= 1);
+    QVERIFY(receiver.callCount() <= kBurstCount);
+}
+
+void QGCSignalCoalescerTest::_testReceiverDestroyed()
+{
+    CoalescerTestSender sender;
+    CoalescerTestReceiver *receiver = new CoalescerTestReceiver();
+    (void) QGCSignalCoalescer::connect(&sender, &CoalescerTestSender::valueChanged, receiver, &CoalescerTestReceiver::setValue);
+
+    emit sender.valueChanged(1);
+    delete receiver;
+
+    // Pending call is dropped together with the receiver, further emissions go nowhere
+    QCoreApplication::processEvents();
+    emit sender.valueChanged(2);
+    QCoreApplication::processEvents();
+}
+
+void QGCSignalCoalescerTest::_benchmarkQueuedConnection()
+{
+    CoalescerTestSender sender;
+    CoalescerTestReceiver receiver;
+    (void) connect(&sender, &CoalescerTestSender::valueChanged, &receiver, &CoalescerTestReceiver::setValue, Qt::QueuedConnection);
+
+    QBENCHMARK {
+        for (int i = 0; i < kBurstCount; i++) {
+            emit sender.valueChanged(i);
+        }
+        QCoreApplication::processEvents();
+    }
+
+    QCOMPARE(receiver.lastValue(), kBurstCount - 1);
+}
+
+void QGCSignalCoalescerTest::_benchmarkCoalescedConnection()
+{
+    CoalescerTestSender sender;
+    CoalescerTestReceiver receiver;
+    (void) QGCSignalCoalescer::connect(&sender, &CoalescerTestSender::valueChanged, &receiver, &CoalescerTestReceiver::setValue);
+
+    QBENCHMARK {
+        for (int i = 0; i < kBurstCount; i++) {
+            emit sender.valueChanged(i);
+        }
+        QCoreApplication::processEvents();
+    }
+
+    QCOMPARE(receiver.lastValue(), kBurstCount - 1);
+}
@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class CoalescerTestSender : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void valueChanged(int value);
+    void changed();
+};
+
+class CoalescerTestReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    void setValue(int value) { _lastValue = value; _callCount++; }
+    void changed() { _callCount++; }
+
+    int lastValue() const { return _lastValue; }
+    int callCount() const { return _callCount; }
+
+private:
+    int _lastValue = -1;
+    int _callCount = 0;
+};
+
+class QGCSignalCoalescerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testLatestWins();
+    void _testNoArguments();
+    void _testCrossThread();
+    void _testReceiverDestroyed();
+    void _benchmarkQueuedConnection();
+    void _benchmarkCoalescedConnection();
+};
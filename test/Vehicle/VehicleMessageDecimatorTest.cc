@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleMessageDecimatorTest.h"
+#include "VehicleMessageDecimator.h"
+
+#include <QtTest/QTest>
+
+namespace
+{
+
+mavlink_message_t _attitude(uint32_t timeBootMs)
+{
+    mavlink_message_t message{};
+    (void) mavlink_msg_attitude_pack_chan(1, 1, MAVLINK_COMM_0, &message, timeBootMs, 0, 0, 0, 0, 0, 0);
+    return message;
+}
+
+mavlink_message_t _escStatus(uint8_t index)
+{
+    const int32_t rpm[4]{};
+    const float voltage[4]{};
+    const float current[4]{};
+
+    mavlink_message_t message{};
+    (void) mavlink_msg_esc_status_pack_chan(1, 1, MAVLINK_COMM_0, &message, index, 0, rpm, voltage, current);
+    return message;
+}
+
+} // namespace
+
+void VehicleMessageDecimatorTest::_exemptMessageTest()
+{
+    int count = 0;
+    VehicleMessageDecimator decimator([&count](LinkInterface *, const mavlink_message_t &) { count++; });
+
+    decimator.setMaxRate(MAVLINK_MSG_ID_COMMAND_ACK, 1);
+    QCOMPARE(decimator.maxRate(MAVLINK_MSG_ID_COMMAND_ACK), 0.);
+
+    mavlink_message_t message{};
+    (void) mavlink_msg_command_ack_pack_chan(1, 1, MAVLINK_COMM_0, &message, MAV_CMD_COMPONENT_ARM_DISARM, MAV_RESULT_ACCEPTED, 0, 0, 0, 0);
+    for (int i = 0; i < 10; i++) {
+        decimator.messageReceived(nullptr, message);
+    }
+
+    QCOMPARE(count, 10);
+    QCOMPARE(decimator.droppedCount(), 0ULL);
+
+    // Message ids without a limit pass straight through
+    for (uint32_t i = 0; i < 10; i++) {
+        decimator.messageReceived(nullptr, _attitude(i));
+    }
+    QCOMPARE(count, 20);
+}
+
+void VehicleMessageDecimatorTest::_latestWinsTest()
+{
+    QList<uint32_t> delivered;
+    VehicleMessageDecimator decimator([&delivered](LinkInterface *, const mavlink_message_t &message) {
+        delivered.append(mavlink_msg_attitude_get_time_boot_ms(&message));
+    });
+    decimator.setMaxRate(MAVLINK_MSG_ID_ATTITUDE, 10);
+
+    for (uint32_t i = 1; i <= 5; i++) {
+        decimator.messageReceived(nullptr, _attitude(i));
+    }
+
+    // The first message goes out right away, the rest wait for the interval
+    QCOMPARE(delivered, QList<uint32_t>({ 1 }));
+    QCOMPARE(decimator.droppedCount(), 3ULL);
+
+    QTRY_COMPARE_WITH_TIMEOUT(delivered.count(), qsizetype(2), 1000);
+    QCOMPARE(delivered.last(), 5U);
+
+    QTest::qWait(200);
+    QCOMPARE(delivered.count(), qsizetype(2));
+}
+
+void VehicleMessageDecimatorTest::_instanceStreamsTest()
+{
+    QList<uint8_t> delivered;
+    VehicleMessageDecimator decimator([&delivered](LinkInterface *, const mavlink_message_t &message) {
+        delivered.append(mavlink_msg_esc_status_get_index(&message));
+    });
+    decimator.setMaxRate(MAVLINK_MSG_ID_ESC_STATUS, 1);
+
+    // Each group of four ESCs is a stream of its own
+    decimator.messageReceived(nullptr, _escStatus(0));
+    decimator.messageReceived(nullptr, _escStatus(4));
+    decimator.messageReceived(nullptr, _escStatus(0));
+
+    QCOMPARE(delivered, QList<uint8_t>({ 0, 4 }));
+}
+
+void VehicleMessageDecimatorTest::_removeLimitTest()
+{
+    QList<uint32_t> delivered;
+    VehicleMessageDecimator decimator([&delivered](LinkInterface *, const mavlink_message_t &message) {
+        delivered.append(mavlink_msg_attitude_get_time_boot_ms(&message));
+    });
+    decimator.setDefaultMaxRate(1);
+    QCOMPARE(decimator.maxRate(MAVLINK_MSG_ID_ATTITUDE), 1.);
+
+    decimator.messageReceived(nullptr, _attitude(1));
+    decimator.messageReceived(nullptr, _attitude(2));
+    QCOMPARE(delivered.count(), qsizetype(1));
+
+    // The held back message is flushed as soon as the limit is gone
+    decimator.setDefaultMaxRate(0);
+    QCOMPARE(decimator.maxRate(MAVLINK_MSG_ID_ATTITUDE), 0.);
+    QTRY_COMPARE_WITH_TIMEOUT(delivered.count(), qsizetype(2), 500);
+    QCOMPARE(delivered.last(), 2U);
+
+    decimator.messageReceived(nullptr, _attitude(3));
+    QCOMPARE(delivered.count(), qsizetype(3));
+}
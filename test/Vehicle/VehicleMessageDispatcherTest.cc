@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleMessageDispatcherTest.h"
+#include "VehicleMessageDispatcher.h"
+
+#include <QtTest/QTest>
+
+namespace
+{
+
+mavlink_message_t _message(uint32_t msgid)
+{
+    mavlink_message_t message{};
+    message.msgid = msgid;
+    return message;
+}
+
+} // namespace
+
+void VehicleMessageDispatcherTest::_dispatchByMessageIdTest()
+{
+    VehicleMessageDispatcher dispatcher;
+    int heartbeatCount = 0;
+    int attitudeCount = 0;
+    int allCount = 0;
+
+    dispatcher.addHandler(MAVLINK_MSG_ID_HEARTBEAT, [&heartbeatCount](const mavlink_message_t &) { heartbeatCount++; });
+    dispatcher.addHandler({ MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_ATTITUDE_QUATERNION }, [&attitudeCount](const mavlink_message_t &) { attitudeCount++; });
+    dispatcher.addHandlerForAllMessages([&allCount](const mavlink_message_t &) { allCount++; });
+
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_HEARTBEAT));
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_ATTITUDE));
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_ATTITUDE_QUATERNION));
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_VFR_HUD));
+
+    QCOMPARE(heartbeatCount, 1);
+    QCOMPARE(attitudeCount, 2);
+    QCOMPARE(allCount, 4);
+
+    QCOMPARE(dispatcher.handlerCount(MAVLINK_MSG_ID_HEARTBEAT), static_cast<qsizetype>(2));
+    QCOMPARE(dispatcher.handlerCount(MAVLINK_MSG_ID_VFR_HUD), static_cast<qsizetype>(1));
+
+    // Handlers added after the table was built must be picked up
+    dispatcher.addHandler(MAVLINK_MSG_ID_VFR_HUD, [](const mavlink_message_t &) {});
+    QCOMPARE(dispatcher.handlerCount(MAVLINK_MSG_ID_VFR_HUD), static_cast<qsizetype>(2));
+
+    dispatcher.clearHandlers();
+    QCOMPARE(dispatcher.handlerCount(MAVLINK_MSG_ID_HEARTBEAT), static_cast<qsizetype>(0));
+}
+
+void VehicleMessageDispatcherTest::_handlerOrderTest()
+{
+    VehicleMessageDispatcher dispatcher;
+    QList<int> calls;
+
+    dispatcher.addHandler(MAVLINK_MSG_ID_HEARTBEAT, [&calls](const mavlink_message_t &) { calls.append(1); });
+    dispatcher.addHandlerForAllMessages([&calls](const mavlink_message_t &) { calls.append(2); });
+    dispatcher.addHandler(MAVLINK_MSG_ID_HEARTBEAT, [&calls](const mavlink_message_t &) { calls.append(3); });
+
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_HEARTBEAT));
+    QCOMPARE(calls, QList<int>({ 1, 2, 3 }));
+}
+
+void VehicleMessageDispatcherTest::_reregisterFromHandlerTest()
+{
+    VehicleMessageDispatcher dispatcher;
+    QList<int> calls;
+
+    // The first handler replaces all handlers, none of the old ones may run for the rest of the message
+    dispatcher.addHandler(MAVLINK_MSG_ID_HEARTBEAT, [&dispatcher, &calls](const mavlink_message_t &) {
+        calls.append(1);
+        dispatcher.clearHandlers();
+        dispatcher.addHandler(MAVLINK_MSG_ID_HEARTBEAT, [&calls](const mavlink_message_t &) { calls.append(3); });
+        dispatcher.addHandler(MAVLINK_MSG_ID_HEARTBEAT, [&calls](const mavlink_message_t &) { calls.append(4); });
+    });
+    dispatcher.addHandler(MAVLINK_MSG_ID_HEARTBEAT, [&calls](const mavlink_message_t &) { calls.append(2); });
+
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_HEARTBEAT));
+    QCOMPARE(calls, QList<int>({ 1 }));
+
+    calls.clear();
+    dispatcher.dispatch(_message(MAVLINK_MSG_ID_HEARTBEAT));
+    QCOMPARE(calls, QList<int>({ 3, 4 }));
+}
+
+void VehicleMessageDispatcherTest::_handlerStatsTest()
+{
+    VehicleMessageDispatcher dispatcher;
+
+    QCOMPARE(dispatcher.handlerStats(MAVLINK_MSG_ID_HEARTBEAT).messageCount, static_cast<quint64>(0));
+
+    dispatcher.addHandlerTime(MAVLINK_MSG_ID_HEARTBEAT, 1000);
+    dispatcher.addHandlerTime(MAVLINK_MSG_ID_HEARTBEAT, 3000);
+    dispatcher.addHandlerTime(MAVLINK_MSG_ID_ATTITUDE, 500);
+
+    const VehicleMessageDispatcher::HandlerStats stats = dispatcher.handlerStats(MAVLINK_MSG_ID_HEARTBEAT);
+    QCOMPARE(stats.messageCount, static_cast<quint64>(2));
+    QCOMPARE(stats.handlerNsecs, static_cast<qint64>(4000));
+    QCOMPARE(dispatcher.handlerStats(MAVLINK_MSG_ID_ATTITUDE).messageCount, static_cast<quint64>(1));
+}
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleStateSnapshotTest.h"
+#include "FactGroupUpdateScheduler.h"
+#include "MAVLinkProtocol.h"
+#include "MockLink.h"
+#include "Vehicle.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QtMath>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace
+{
+
+void _sendPosition(Vehicle *vehicle, MockLink *link, int index)
+{
+    mavlink_message_t message{};
+
+    (void) mavlink_msg_global_position_int_pack_chan(
+        static_cast<uint8_t>(vehicle->id()),
+        static_cast<uint8_t>(vehicle->compId()),
+        link->mavlinkChannel(),
+        &message,
+        static_cast<uint32_t>(index),
+        473977420 + index,      // lat
+        85455940,               // lon
+        488000,                 // alt
+        10000,                  // relative_alt
+        100, 0, 0,              // vx, vy, vz
+        0                       // hdg
+    );
+    emit MAVLinkProtocol::instance()->messageReceived(link, message);
+
+    (void) mavlink_msg_attitude_pack_chan(
+        static_cast<uint8_t>(vehicle->id()),
+        static_cast<uint8_t>(vehicle->compId()),
+        link->mavlinkChannel(),
+        &message,
+        static_cast<uint32_t>(index),
+        0.1f, 0.2f, 0.3f,       // roll, pitch, yaw
+        0, 0, 0                 // rates
+    );
+    emit MAVLinkProtocol::instance()->messageReceived(link, message);
+}
+
+} // namespace
+
+void VehicleStateSnapshotTest::_snapshotContentTest()
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    // MockLink sends its own positions as well, so compare against the state at the time of publishing
+    bool matchesVehicle = true;
+    (void) connect(_vehicle, &Vehicle::stateSnapshotChanged, this, [this, &matchesVehicle](const VehicleStateSnapshot &snapshot) {
+        matchesVehicle = matchesVehicle && (snapshot.coordinate == _vehicle->coordinate())
+            && (snapshot.altitudeRelative == _vehicle->altitudeRelative()->rawValue().toDouble());
+    });
+
+    QSignalSpy snapshotSpy(_vehicle, &Vehicle::stateSnapshotChanged);
+    for (int i = 0; i < 10; i++) {
+        _sendPosition(_vehicle, _mockLink, i);
+    }
+    QCOMPARE(snapshotSpy.count(), 0);
+
+    // All ten updates are published together
+    QVERIFY(snapshotSpy.wait(1000));
+    QCOMPARE(snapshotSpy.count(), 1);
+    QVERIFY(matchesVehicle);
+
+    const VehicleStateSnapshot snapshot = _vehicle->stateSnapshot();
+    QVERIFY(snapshot.coordinate.isValid());
+    QVERIFY(qAbs(snapshot.roll - qRadiansToDegrees(0.1)) < 0.001);
+    QVERIFY(qAbs(snapshot.pitch - qRadiansToDegrees(0.2)) < 0.001);
+    QVERIFY(snapshot.timestampMSecs > 0);
+
+    (void) disconnect(_vehicle, &Vehicle::stateSnapshotChanged, this, nullptr);
+}
+
+void VehicleStateSnapshotTest::_benchmarkSignalRate()
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    QSignalSpy coordinateSpy(_vehicle, &Vehicle::coordinateChanged);
+    QSignalSpy snapshotSpy(_vehicle, &Vehicle::stateSnapshotChanged);
+
+    // Telemetry at roughly 1kHz for one second
+    constexpr int kDurationMSecs = 1000;
+    QElapsedTimer timer;
+    timer.start();
+    int index = 0;
+    while (timer.elapsed() < kDurationMSecs) {
+        _sendPosition(_vehicle, _mockLink, index++);
+        QTest::qWait(1);
+    }
+    QTest::qWait(FactGroupUpdateScheduler::instance()->tickIntervalMSecs() * 2);
+
+    const double seconds = timer.elapsed() / 1000.0;
+    const double coordinateRate = coordinateSpy.count() / seconds;
+    const double snapshotRate = snapshotSpy.count() / seconds;
+    qDebug() << "Messages:" << (index * 2) << "coordinateChanged/s:" << coordinateRate << "stateSnapshotChanged/s:" << snapshotRate;
+
+    QVERIFY(snapshotSpy.count() > 0);
+    QVERIFY(snapshotSpy.count() <= coordinateSpy.count());
+    // At most one snapshot per frame, with slack for timer jitter
+    QVERIFY(snapshotRate <= ((1000.0 / FactGroupUpdateScheduler::instance()->tickIntervalMSecs()) * 1.5));
+    QTest::setBenchmarkResult(snapshotRate, QTest::Events);
+}